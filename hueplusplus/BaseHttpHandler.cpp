@@ -23,6 +23,7 @@
 #include "include/BaseHttpHandler.h"
 
 #include "include/HueExceptionMacro.h"
+#include "include/NumberFormat.h"
 
 std::string BaseHttpHandler::sendGetHTTPBody(const std::string& msg, const std::string& adr, int port) const
 {
@@ -41,10 +42,22 @@ std::string BaseHttpHandler::sendGetHTTPBody(const std::string& msg, const std::
     return response;
 }
 
+nlohmann::json BaseHttpHandler::sendGetHTTPJson(const std::string& msg, const std::string& adr, int port) const
+{
+    return nlohmann::json::parse(sendGetHTTPBody(msg, adr, port));
+}
+
 std::string BaseHttpHandler::sendHTTPRequest(const std::string& method, const std::string& uri,
     const std::string& contentType, const std::string& body, const std::string& adr, int port) const
+{
+    return sendGetHTTPBody(buildHTTPRequest(method, uri, contentType, body), adr, port);
+}
+
+std::string BaseHttpHandler::buildHTTPRequest(
+    const std::string& method, const std::string& uri, const std::string& contentType, const std::string& body)
 {
     std::string request;
+    request.reserve(method.size() + uri.size() + contentType.size() + body.size() + 64);
     // Protocol reference:
     // https://www.w3.org/Protocols/rfc2616/rfc2616-sec5.html Request-Line
     request.append(method); // Method
@@ -60,12 +73,12 @@ std::string BaseHttpHandler::sendHTTPRequest(const std::string& method, const st
     request.append("\r\n"); // Entity ending
     request.append("Content-Length:"); // entity-header
     request.append(" "); // Separation
-    request.append(std::to_string(body.size())); // length
+    utils::appendUnsigned(request, body.size()); // length
     request.append("\r\n\r\n"); // Entity ending & Request-Line ending
     request.append(body); // message-body
     request.append("\r\n\r\n"); // Ending
 
-    return sendGetHTTPBody(request.c_str(), adr, port);
+    return request;
 }
 
 std::string BaseHttpHandler::GETString(const std::string& uri, const std::string& contentType, const std::string& body,
@@ -95,23 +108,35 @@ std::string BaseHttpHandler::DELETEString(const std::string& uri, const std::str
 nlohmann::json BaseHttpHandler::GETJson(
     const std::string& uri, const nlohmann::json& body, const std::string& adr, int port) const
 {
-    return nlohmann::json::parse(GETString(uri, "application/json", body.dump(), adr, port));
+    return sendGetHTTPJson(buildHTTPRequest("GET", uri, "application/json", body.dump()), adr, port);
+}
+
+std::string BaseHttpHandler::GETRaw(
+    const std::string& uri, const std::string& body, const std::string& adr, int port) const
+{
+    return GETString(uri, "application/json", body, adr, port);
 }
 
 nlohmann::json BaseHttpHandler::POSTJson(
     const std::string& uri, const nlohmann::json& body, const std::string& adr, int port) const
 {
-    return nlohmann::json::parse(POSTString(uri, "application/json", body.dump(), adr, port));
+    return sendGetHTTPJson(buildHTTPRequest("POST", uri, "application/json", body.dump()), adr, port);
 }
 
 nlohmann::json BaseHttpHandler::PUTJson(
     const std::string& uri, const nlohmann::json& body, const std::string& adr, int port) const
 {
-    return nlohmann::json::parse(PUTString(uri, "application/json", body.dump(), adr, port));
+    return sendGetHTTPJson(buildHTTPRequest("PUT", uri, "application/json", body.dump()), adr, port);
+}
+
+std::string BaseHttpHandler::PUTRaw(
+    const std::string& uri, const std::string& body, const std::string& adr, int port) const
+{
+    return PUTString(uri, "application/json", body, adr, port);
 }
 
 nlohmann::json BaseHttpHandler::DELETEJson(
     const std::string& uri, const nlohmann::json& body, const std::string& adr, int port) const
 {
-    return nlohmann::json::parse(DELETEString(uri, "application/json", body.dump(), adr, port));
+    return sendGetHTTPJson(buildHTTPRequest("DELETE", uri, "application/json", body.dump()), adr, port);
 }
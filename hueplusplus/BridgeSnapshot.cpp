@@ -0,0 +1,263 @@
+/**
+    \file BridgeSnapshot.cpp
+    Copyright Notice\n
+    Copyright (C) 2017  Jan Rogall		- developer\n
+    Copyright (C) 2017  Moritz Wirger	- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "include/BridgeSnapshot.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "include/HueExceptionMacro.h"
+
+constexpr uint32_t BridgeSnapshot::version;
+
+namespace
+{
+    const char magic[4] = {'H', 'U', 'E', 'S'};
+
+    void writeU32(std::ostream& stream, uint32_t value)
+    {
+        // Always little endian, so snapshots can be moved between machines
+        char bytes[4] = {static_cast<char>(value & 0xFF), static_cast<char>((value >> 8) & 0xFF),
+            static_cast<char>((value >> 16) & 0xFF), static_cast<char>((value >> 24) & 0xFF)};
+        stream.write(bytes, sizeof(bytes));
+    }
+
+    void writeString(std::ostream& stream, const std::string& value)
+    {
+        writeU32(stream, static_cast<uint32_t>(value.size()));
+        stream.write(value.data(), value.size());
+    }
+
+    void readBytes(std::istream& stream, char* bytes, std::size_t size)
+    {
+        if (!stream.read(bytes, size))
+        {
+            throw HueException(CURRENT_FILE_INFO, "Snapshot is truncated");
+        }
+    }
+
+    uint32_t readU32(std::istream& stream)
+    {
+        unsigned char bytes[4];
+        readBytes(stream, reinterpret_cast<char*>(bytes), sizeof(bytes));
+        return static_cast<uint32_t>(bytes[0]) | (static_cast<uint32_t>(bytes[1]) << 8)
+            | (static_cast<uint32_t>(bytes[2]) << 16) | (static_cast<uint32_t>(bytes[3]) << 24);
+    }
+
+    std::string readString(std::istream& stream)
+    {
+        uint32_t size = readU32(stream);
+        std::string result;
+        // Read in chunks so a corrupted size does not allocate huge amounts of memory
+        char buffer[256];
+        while (size > 0)
+        {
+            std::size_t chunk = size < sizeof(buffer) ? size : sizeof(buffer);
+            readBytes(stream, buffer, chunk);
+            result.append(buffer, chunk);
+            size -= static_cast<uint32_t>(chunk);
+        }
+        return result;
+    }
+
+    void writeBytes(std::ostream& stream, const std::vector<uint8_t>& value)
+    {
+        writeU32(stream, static_cast<uint32_t>(value.size()));
+        stream.write(reinterpret_cast<const char*>(value.data()), value.size());
+    }
+
+    ColorType toColorType(uint64_t value)
+    {
+        if (value > ColorType::GAMUT_C_TEMPERATURE)
+        {
+            throw HueException(CURRENT_FILE_INFO, "Snapshot contains invalid color type");
+        }
+        return static_cast<ColorType>(value);
+    }
+
+    const nlohmann::json& getMember(const nlohmann::json& json, const char* key)
+    {
+        auto it = json.find(key);
+        if (it == json.end())
+        {
+            throw HueException(CURRENT_FILE_INFO, std::string("Snapshot is missing ") + key);
+        }
+        return *it;
+    }
+
+    uint64_t getUnsigned(const nlohmann::json& json, const char* key)
+    {
+        const nlohmann::json& value = getMember(json, key);
+        if (!value.is_number_unsigned())
+        {
+            throw HueException(CURRENT_FILE_INFO, std::string("Snapshot has invalid ") + key);
+        }
+        return value.get<uint64_t>();
+    }
+
+    const std::string& getString(const nlohmann::json& json, const char* key)
+    {
+        const nlohmann::json& value = getMember(json, key);
+        if (!value.is_string())
+        {
+            throw HueException(CURRENT_FILE_INFO, std::string("Snapshot has invalid ") + key);
+        }
+        return value.get_ref<const std::string&>();
+    }
+} // namespace
+
+void BridgeSnapshot::write(std::ostream& stream) const
+{
+    stream.write(magic, sizeof(magic));
+    writeU32(stream, version);
+    writeString(stream, ip);
+    writeU32(stream, static_cast<uint32_t>(port));
+    writeString(stream, username);
+    writeU32(stream, static_cast<uint32_t>(lights.size()));
+    for (const Light& light : lights)
+    {
+        writeU32(stream, static_cast<uint32_t>(light.id));
+        writeString(stream, light.modelId);
+        writeU32(stream, static_cast<uint32_t>(light.colorType));
+        writeBytes(stream, nlohmann::json::to_cbor(light.state));
+    }
+    if (!stream)
+    {
+        throw HueException(CURRENT_FILE_INFO, "Could not write snapshot");
+    }
+}
+
+BridgeSnapshot BridgeSnapshot::read(std::istream& stream)
+{
+    char fileMagic[sizeof(magic)];
+    readBytes(stream, fileMagic, sizeof(fileMagic));
+    if (!std::equal(std::begin(magic), std::end(magic), std::begin(fileMagic)))
+    {
+        throw HueException(CURRENT_FILE_INFO, "Stream does not contain a bridge snapshot");
+    }
+    uint32_t fileVersion = readU32(stream);
+    if (fileVersion != 1 && fileVersion != version)
+    {
+        throw HueException(CURRENT_FILE_INFO, "Snapshot version " + std::to_string(fileVersion) + " is not supported");
+    }
+    BridgeSnapshot result;
+    result.ip = readString(stream);
+    result.port = static_cast<int>(readU32(stream));
+    result.username = readString(stream);
+    uint32_t lightCount = readU32(stream);
+    for (uint32_t i = 0; i < lightCount; ++i)
+    {
+        Light light;
+        light.id = static_cast<int>(readU32(stream));
+        light.modelId = readString(stream);
+        light.colorType = toColorType(readU32(stream));
+        if (fileVersion == 1)
+        {
+            light.state = nlohmann::json::parse(readString(stream));
+        }
+        else
+        {
+            light.state = nlohmann::json::from_cbor(readString(stream));
+        }
+        result.lights.push_back(std::move(light));
+    }
+    return result;
+}
+
+nlohmann::json BridgeSnapshot::toJson() const
+{
+    nlohmann::json jsonLights = nlohmann::json::array();
+    for (const Light& light : lights)
+    {
+        jsonLights.push_back({{"id", static_cast<uint32_t>(light.id)}, {"modelid", light.modelId},
+            {"colortype", static_cast<uint32_t>(light.colorType)}, {"state", light.state}});
+    }
+    return {{"version", version}, {"ip", ip}, {"port", static_cast<uint32_t>(port)}, {"username", username},
+        {"lights", std::move(jsonLights)}};
+}
+
+BridgeSnapshot BridgeSnapshot::fromJson(const nlohmann::json& json)
+{
+    if (!json.is_object())
+    {
+        throw HueException(CURRENT_FILE_INFO, "Json does not contain a bridge snapshot");
+    }
+    uint64_t jsonVersion = getUnsigned(json, "version");
+    if (jsonVersion != version)
+    {
+        throw HueException(CURRENT_FILE_INFO, "Snapshot version " + std::to_string(jsonVersion) + " is not supported");
+    }
+    BridgeSnapshot result;
+    result.ip = getString(json, "ip");
+    result.port = static_cast<int>(getUnsigned(json, "port"));
+    result.username = getString(json, "username");
+    const nlohmann::json& jsonLights = getMember(json, "lights");
+    if (!jsonLights.is_array())
+    {
+        throw HueException(CURRENT_FILE_INFO, "Snapshot has invalid lights");
+    }
+    result.lights.reserve(jsonLights.size());
+    for (const nlohmann::json& jsonLight : jsonLights)
+    {
+        if (!jsonLight.is_object())
+        {
+            throw HueException(CURRENT_FILE_INFO, "Snapshot has invalid lights");
+        }
+        Light light;
+        light.id = static_cast<int>(getUnsigned(jsonLight, "id"));
+        light.modelId = getString(jsonLight, "modelid");
+        light.colorType = toColorType(getUnsigned(jsonLight, "colortype"));
+        light.state = getMember(jsonLight, "state");
+        result.lights.push_back(std::move(light));
+    }
+    return result;
+}
+
+std::vector<uint8_t> BridgeSnapshot::encode(SnapshotEncoding encoding) const
+{
+    const nlohmann::json json = toJson();
+    switch (encoding)
+    {
+    case SnapshotEncoding::CBOR:
+        return nlohmann::json::to_cbor(json);
+    case SnapshotEncoding::MSGPACK:
+        return nlohmann::json::to_msgpack(json);
+    default:
+    {
+        const std::string text = json.dump();
+        return std::vector<uint8_t>(text.begin(), text.end());
+    }
+    }
+}
+
+BridgeSnapshot BridgeSnapshot::decode(const std::vector<uint8_t>& data, SnapshotEncoding encoding)
+{
+    switch (encoding)
+    {
+    case SnapshotEncoding::CBOR:
+        return fromJson(nlohmann::json::from_cbor(data));
+    case SnapshotEncoding::MSGPACK:
+        return fromJson(nlohmann::json::from_msgpack(data));
+    default:
+        return fromJson(nlohmann::json::parse(data.begin(), data.end()));
+    }
+}
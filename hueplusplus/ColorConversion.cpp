@@ -0,0 +1,1161 @@
+/**
+    \file ColorConversion.cpp
+    Copyright Notice\n
+    Copyright (C) 2017  Jan Rogall		- developer\n
+    Copyright (C) 2017  Moritz Wirger	- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "include/ColorConversion.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "include/SimdSupport.h"
+
+// The SIMD kernels use floating point, fixed point builds convert all colors with integers
+#ifdef HUEPLUSPLUS_FIXED_POINT
+#undef HUEPLUSPLUS_SSE2
+#undef HUEPLUSPLUS_AVX2
+#endif
+
+namespace
+{
+#ifdef HUEPLUSPLUS_FIXED_POINT
+    constexpr bool fixedPoint = true;
+#else
+    constexpr bool fixedPoint = false;
+#endif
+
+    // Wide gamut conversion matrix from linear RGB to XYZ
+    constexpr float matrix[3][3] = {{0.664511f, 0.154324f, 0.162028f}, {0.283881f, 0.668433f, 0.047685f},
+        {0.000088f, 0.072310f, 0.986039f}};
+
+    // std::log and std::exp are not constexpr, so the tables use their own implementations in double precision
+
+    // Natural logarithm for x > 0
+    constexpr double constLog(double x)
+    {
+        const double ln2 = 0.69314718055994530942;
+        // Reduce to x = m * 2^e with m in [0.5, 1]
+        int e = 0;
+        while (x > 1.0)
+        {
+            x /= 2;
+            ++e;
+        }
+        while (x < 0.5)
+        {
+            x *= 2;
+            --e;
+        }
+        // ln(m) = 2 * atanh(z) with z = (m - 1) / (m + 1) in [-1/3, 0]
+        const double z = (x - 1) / (x + 1);
+        const double z2 = z * z;
+        double power = z;
+        double sum = 0;
+        for (int n = 1; n < 60; n += 2)
+        {
+            sum += power / n;
+            power *= z2;
+        }
+        return 2 * sum + e * ln2;
+    }
+
+    // Exponential function for x <= 0
+    constexpr double constExp(double x)
+    {
+        // exp(x) = exp(x / 64)^64, the taylor series converges quickly for small arguments
+        const double reduced = x / 64;
+        double term = 1;
+        double sum = 1;
+        for (int n = 1; n < 25; ++n)
+        {
+            term *= reduced / n;
+            sum += term;
+        }
+        for (int i = 0; i < 6; ++i)
+        {
+            sum *= sum;
+        }
+        return sum;
+    }
+
+    // Linear value of an sRGB component in [0, 1], the formula previously used in SimpleColorHueStrategy::setColorRGB
+    constexpr float constSrgbToLinear(float value)
+    {
+        return (value > 0.04045f) ? float(constExp(double(2.4f) * constLog((value + 0.055f) / (1.0f + 0.055f))))
+                                  : (value / 12.92f);
+    }
+
+    constexpr int coarseSize = 4096;
+
+    struct GammaTables
+    {
+        // Linear value of every 8 bit sRGB component
+        float linear[256];
+        // Linear value halfway between sRGB components i and i + 1, rounding boundary for the inverse
+        float threshold[255];
+        // sRGB component of the linear values i / coarseSize. Thresholds are further apart than 1 / coarseSize,
+        // so the exact component is at most one larger.
+        uint8_t coarse[coarseSize + 1];
+    };
+
+    constexpr GammaTables createGammaTables()
+    {
+        GammaTables result{};
+        for (int i = 0; i < 256; ++i)
+        {
+            result.linear[i] = constSrgbToLinear(float(i) / 255);
+        }
+        for (int i = 0; i < 255; ++i)
+        {
+            result.threshold[i] = constSrgbToLinear((i + 0.5f) / 255);
+        }
+        int component = 0;
+        for (int i = 0; i <= coarseSize; ++i)
+        {
+            while (component < 255 && result.threshold[component] <= float(i) / coarseSize)
+            {
+                ++component;
+            }
+            result.coarse[i] = static_cast<uint8_t>(component);
+        }
+        return result;
+    }
+
+    constexpr GammaTables gammaTables = createGammaTables();
+
+    static_assert(gammaTables.linear[0] == 0.0f, "Black must stay black");
+    static_assert(gammaTables.linear[255] > 0.99999f && gammaTables.linear[255] < 1.00001f, "White must stay white");
+    static_assert(gammaTables.threshold[127] > gammaTables.linear[127]
+            && gammaTables.threshold[127] < gammaTables.linear[128],
+        "Thresholds must lie between the linear values");
+    static_assert(gammaTables.threshold[1] - gammaTables.threshold[0] > 1.0f / coarseSize,
+        "Coarse table must have at most one threshold per entry");
+
+    void convertFloat(const uint8_t* r, const uint8_t* g, const uint8_t* b, std::size_t count, float* x, float* y,
+        float* brightness)
+    {
+        const float* gamma = gammaTables.linear;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const float red = gamma[r[i]];
+            const float green = gamma[g[i]];
+            const float blue = gamma[b[i]];
+            const float X = red * matrix[0][0] + green * matrix[0][1] + blue * matrix[0][2];
+            const float Y = red * matrix[1][0] + green * matrix[1][1] + blue * matrix[1][2];
+            const float Z = red * matrix[2][0] + green * matrix[2][1] + blue * matrix[2][2];
+            const float sum = X + Y + Z;
+            x[i] = sum > 0.0f ? X / sum : 0.0f;
+            y[i] = sum > 0.0f ? Y / sum : 0.0f;
+            if (brightness)
+            {
+                brightness[i] = Y;
+            }
+        }
+    }
+
+    // Fixed point conversion for processors where float division is slow, linear components are Q16
+    // and the matrix is Q14, so the sum of XYZ fits into 32 bits.
+    struct FixedTables
+    {
+        uint32_t linear[256];
+        uint32_t matrix[3][3];
+    };
+
+    constexpr FixedTables createFixedTables()
+    {
+        FixedTables result{};
+        for (int i = 0; i < 256; ++i)
+        {
+            result.linear[i] = static_cast<uint32_t>(gammaTables.linear[i] * 65535.0f + 0.5f);
+        }
+        for (int row = 0; row < 3; ++row)
+        {
+            for (int column = 0; column < 3; ++column)
+            {
+                result.matrix[row][column] = static_cast<uint32_t>(matrix[row][column] * 16384.0f + 0.5f);
+            }
+        }
+        return result;
+    }
+
+    constexpr FixedTables fixedTables = createFixedTables();
+
+    static_assert(fixedTables.linear[255] == 65535, "White must stay white");
+    static_assert(uint64_t(65535) * (fixedTables.matrix[0][0] + fixedTables.matrix[0][1] + fixedTables.matrix[0][2]
+                          + fixedTables.matrix[1][0] + fixedTables.matrix[1][1] + fixedTables.matrix[1][2]
+                          + fixedTables.matrix[2][0] + fixedTables.matrix[2][1] + fixedTables.matrix[2][2])
+            <= 0xFFFFFFFFu,
+        "Sum of XYZ must fit into 32 bits");
+
+    void convertFixed(const uint8_t* r, const uint8_t* g, const uint8_t* b, std::size_t count, float* x, float* y,
+        float* brightness)
+    {
+        const uint32_t* gamma = fixedTables.linear;
+        const auto& m = fixedTables.matrix;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const uint32_t red = gamma[r[i]];
+            const uint32_t green = gamma[g[i]];
+            const uint32_t blue = gamma[b[i]];
+            uint32_t X = red * m[0][0] + green * m[0][1] + blue * m[0][2];
+            uint32_t Y = red * m[1][0] + green * m[1][1] + blue * m[1][2];
+            const uint32_t Z = red * m[2][0] + green * m[2][1] + blue * m[2][2];
+            if (brightness)
+            {
+                // Y is Q30
+                brightness[i] = Y * (1.0f / (1u << 30));
+            }
+            uint32_t sum = X + Y + Z;
+            if (sum == 0)
+            {
+                x[i] = 0.0f;
+                y[i] = 0.0f;
+                continue;
+            }
+            // Reduce to 16 bits, so a single 32 bit division gives the reciprocal with enough precision
+            int shift = 0;
+            for (int step = 8; step > 0; step /= 2)
+            {
+                if ((sum >> (shift + step)) > 0xFFFFu)
+                {
+                    shift += step;
+                }
+            }
+            if ((sum >> shift) > 0xFFFFu)
+            {
+                ++shift;
+            }
+            sum >>= shift;
+            X >>= shift;
+            Y >>= shift;
+            const uint32_t reciprocal = 0xFFFFFFFFu / sum;
+            x[i] = static_cast<uint32_t>((uint64_t(X) * reciprocal) >> 16) * (1.0f / 65536);
+            y[i] = static_cast<uint32_t>((uint64_t(Y) * reciprocal) >> 16) * (1.0f / 65536);
+        }
+    }
+
+    void convertScalar(const uint8_t* r, const uint8_t* g, const uint8_t* b, std::size_t count, float* x, float* y,
+        float* brightness)
+    {
+        if (fixedPoint)
+        {
+            convertFixed(r, g, b, count, x, y, brightness);
+        }
+        else
+        {
+            convertFloat(r, g, b, count, x, y, brightness);
+        }
+    }
+
+#ifdef HUEPLUSPLUS_SSE2
+    // Converts 4 colors at a time, the gamma table has no gather instruction in SSE2
+    std::size_t convertSSE2(const uint8_t* r, const uint8_t* g, const uint8_t* b, std::size_t count, float* x,
+        float* y, float* brightness)
+    {
+        const float* gamma = gammaTables.linear;
+        const __m128 zero = _mm_setzero_ps();
+        std::size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            const __m128 red = _mm_setr_ps(gamma[r[i]], gamma[r[i + 1]], gamma[r[i + 2]], gamma[r[i + 3]]);
+            const __m128 green = _mm_setr_ps(gamma[g[i]], gamma[g[i + 1]], gamma[g[i + 2]], gamma[g[i + 3]]);
+            const __m128 blue = _mm_setr_ps(gamma[b[i]], gamma[b[i + 1]], gamma[b[i + 2]], gamma[b[i + 3]]);
+            const __m128 X = _mm_add_ps(_mm_add_ps(_mm_mul_ps(red, _mm_set1_ps(matrix[0][0])),
+                                            _mm_mul_ps(green, _mm_set1_ps(matrix[0][1]))),
+                _mm_mul_ps(blue, _mm_set1_ps(matrix[0][2])));
+            const __m128 Y = _mm_add_ps(_mm_add_ps(_mm_mul_ps(red, _mm_set1_ps(matrix[1][0])),
+                                            _mm_mul_ps(green, _mm_set1_ps(matrix[1][1]))),
+                _mm_mul_ps(blue, _mm_set1_ps(matrix[1][2])));
+            const __m128 Z = _mm_add_ps(_mm_add_ps(_mm_mul_ps(red, _mm_set1_ps(matrix[2][0])),
+                                            _mm_mul_ps(green, _mm_set1_ps(matrix[2][1]))),
+                _mm_mul_ps(blue, _mm_set1_ps(matrix[2][2])));
+            const __m128 sum = _mm_add_ps(_mm_add_ps(X, Y), Z);
+            // Black gives 0 / 0, the mask replaces it with 0
+            const __m128 valid = _mm_cmpgt_ps(sum, zero);
+            _mm_storeu_ps(x + i, _mm_and_ps(valid, _mm_div_ps(X, sum)));
+            _mm_storeu_ps(y + i, _mm_and_ps(valid, _mm_div_ps(Y, sum)));
+            if (brightness)
+            {
+                _mm_storeu_ps(brightness + i, Y);
+            }
+        }
+        return i;
+    }
+#endif
+
+#ifdef HUEPLUSPLUS_AVX2
+    __attribute__((target("avx2"))) __m256 gatherAVX2(const float* gamma, const uint8_t* values)
+    {
+        const __m256i indices = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(values)));
+        return _mm256_i32gather_ps(gamma, indices, 4);
+    }
+
+    __attribute__((target("avx2"))) __m256 rowAVX2(__m256 red, __m256 green, __m256 blue, const float* row)
+    {
+        return _mm256_add_ps(
+            _mm256_add_ps(_mm256_mul_ps(red, _mm256_set1_ps(row[0])), _mm256_mul_ps(green, _mm256_set1_ps(row[1]))),
+            _mm256_mul_ps(blue, _mm256_set1_ps(row[2])));
+    }
+
+    // Converts 8 colors at a time, the gamma table is read with gather instructions
+    __attribute__((target("avx2"))) std::size_t convertAVX2(const uint8_t* r, const uint8_t* g, const uint8_t* b,
+        std::size_t count, float* x, float* y, float* brightness)
+    {
+        const float* gamma = gammaTables.linear;
+        const __m256 zero = _mm256_setzero_ps();
+        std::size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            const __m256 red = gatherAVX2(gamma, r + i);
+            const __m256 green = gatherAVX2(gamma, g + i);
+            const __m256 blue = gatherAVX2(gamma, b + i);
+            const __m256 X = rowAVX2(red, green, blue, matrix[0]);
+            const __m256 Y = rowAVX2(red, green, blue, matrix[1]);
+            const __m256 Z = rowAVX2(red, green, blue, matrix[2]);
+            const __m256 sum = _mm256_add_ps(_mm256_add_ps(X, Y), Z);
+            // Black gives 0 / 0, the mask replaces it with 0
+            const __m256 valid = _mm256_cmp_ps(sum, zero, _CMP_GT_OQ);
+            _mm256_storeu_ps(x + i, _mm256_and_ps(valid, _mm256_div_ps(X, sum)));
+            _mm256_storeu_ps(y + i, _mm256_and_ps(valid, _mm256_div_ps(Y, sum)));
+            if (brightness)
+            {
+                _mm256_storeu_ps(brightness + i, Y);
+            }
+        }
+        return i;
+    }
+#endif
+
+    struct Matrix
+    {
+        float m[3][3];
+    };
+
+    // Inverse of the conversion matrix, computed in double precision from the adjugate
+    constexpr Matrix invertMatrix()
+    {
+        Matrix result{};
+        double determinant = 0;
+        for (int column = 0; column < 3; ++column)
+        {
+            const int c0 = (column + 1) % 3;
+            const int c1 = (column + 2) % 3;
+            determinant
+                += matrix[0][column] * (double(matrix[1][c0]) * matrix[2][c1] - double(matrix[1][c1]) * matrix[2][c0]);
+        }
+        for (int row = 0; row < 3; ++row)
+        {
+            for (int column = 0; column < 3; ++column)
+            {
+                // Cofactor of the transposed element
+                const int r0 = (column + 1) % 3;
+                const int r1 = (column + 2) % 3;
+                const int c0 = (row + 1) % 3;
+                const int c1 = (row + 2) % 3;
+                const double cofactor
+                    = double(matrix[r0][c0]) * matrix[r1][c1] - double(matrix[r0][c1]) * matrix[r1][c0];
+                result.m[row][column] = float(cofactor / determinant);
+            }
+        }
+        return result;
+    }
+
+    // Conversion matrix from XYZ to linear RGB
+    constexpr Matrix inverseMatrix = invertMatrix();
+
+    // Linear RGB with the largest component 1 for a chromaticity
+    void xyToLinear(XY xy, float (&rgb)[3])
+    {
+        if (xy.y <= 0.0f)
+        {
+            rgb[0] = rgb[1] = rgb[2] = 0.0f;
+            return;
+        }
+        // Luminance is normalized afterwards, so Y = 1 is enough
+        const float X = xy.x / xy.y;
+        const float Z = (1.0f - xy.x - xy.y) / xy.y;
+        float maximum = 0.0f;
+        for (int i = 0; i < 3; ++i)
+        {
+            // Negative components are outside of the RGB gamut
+            rgb[i] = std::max(inverseMatrix.m[i][0] * X + inverseMatrix.m[i][1] + inverseMatrix.m[i][2] * Z, 0.0f);
+            maximum = std::max(maximum, rgb[i]);
+        }
+        for (float& component : rgb)
+        {
+            component = maximum > 0.0f ? component / maximum : 0.0f;
+        }
+    }
+
+    // sRGB components of a hue and saturation with full value, 6 sectors of the hue circle
+    RGB hsvToSrgb(uint16_t hue, uint8_t saturation)
+    {
+        const float h = hue * (6.0f / 65536.0f);
+        const int sector = std::min(static_cast<int>(h), 5);
+        const float fraction = h - sector;
+        const float s = std::min(saturation, uint8_t(254)) / 254.0f;
+        const float p = 1.0f - s;
+        const float q = 1.0f - s * fraction;
+        const float t = 1.0f - s * (1.0f - fraction);
+        const float sectors[6][3]
+            = {{1.0f, t, p}, {q, 1.0f, p}, {p, 1.0f, t}, {p, q, 1.0f}, {t, p, 1.0f}, {1.0f, p, q}};
+        const float* c = sectors[sector];
+        return {static_cast<uint8_t>(c[0] * 255.0f + 0.5f), static_cast<uint8_t>(c[1] * 255.0f + 0.5f),
+            static_cast<uint8_t>(c[2] * 255.0f + 0.5f)};
+    }
+
+    // Applies the brightness to linear RGB and converts to sRGB
+    RGB linearToRGB(const float (&rgb)[3], uint8_t brightness)
+    {
+        const float scale = std::min(brightness, uint8_t(254)) / 254.0f;
+        return {ColorConversion::linearToSrgb(rgb[0] * scale), ColorConversion::linearToSrgb(rgb[1] * scale),
+            ColorConversion::linearToSrgb(rgb[2] * scale)};
+    }
+
+    // Planckian locus approximation by Kim et al., valid from 1667 K to 25000 K
+    constexpr XY planckianXY(double kelvin)
+    {
+        const double t = 1000.0 / kelvin;
+        const double x = kelvin < 4000.0
+            ? ((-0.2661239 * t - 0.2343589) * t + 0.8776956) * t + 0.179910
+            : ((-3.0258469 * t + 2.1070379) * t + 0.2226347) * t + 0.240390;
+        double y = 0;
+        if (kelvin < 2222.0)
+        {
+            y = ((-1.1063814 * x - 1.34811020) * x + 2.18555832) * x - 0.20219683;
+        }
+        else if (kelvin < 4000.0)
+        {
+            y = ((-0.9549476 * x - 1.37418593) * x + 2.09137015) * x - 0.16748867;
+        }
+        else
+        {
+            y = ((3.0817580 * x - 5.87338670) * x + 3.75112997) * x - 0.37001483;
+        }
+        return {float(x), float(y)};
+    }
+
+    constexpr unsigned int minMired = 40;
+    constexpr unsigned int maxMired = 600;
+
+    struct PlanckianTable
+    {
+        XY xy[maxMired - minMired + 1];
+    };
+
+    constexpr PlanckianTable createPlanckianTable()
+    {
+        PlanckianTable result{};
+        for (unsigned int mired = minMired; mired <= maxMired; ++mired)
+        {
+            result.xy[mired - minMired] = planckianXY(1000000.0 / mired);
+        }
+        return result;
+    }
+
+    // Chromaticity of every color temperature in mired
+    constexpr PlanckianTable planckianTable = createPlanckianTable();
+
+    // Gamut with precomputed edges for the closest point search
+    struct Triangle
+    {
+        float vx[3];
+        float vy[3];
+        // Edge from vertex i to vertex i + 1
+        float ex[3];
+        float ey[3];
+        // Inverse squared length of the edges
+        float invLength[3];
+        // 1 if the vertices are counterclockwise, otherwise -1
+        float orientation;
+    };
+
+    constexpr Triangle createTriangle(const ColorConversion::Gamut& gamut)
+    {
+        Triangle result{};
+        const XY vertices[3] = {gamut.red, gamut.green, gamut.blue};
+        for (int i = 0; i < 3; ++i)
+        {
+            const XY& next = vertices[(i + 1) % 3];
+            result.vx[i] = vertices[i].x;
+            result.vy[i] = vertices[i].y;
+            result.ex[i] = next.x - vertices[i].x;
+            result.ey[i] = next.y - vertices[i].y;
+            const float length = result.ex[i] * result.ex[i] + result.ey[i] * result.ey[i];
+            result.invLength[i] = length > 0.0f ? 1.0f / length : 0.0f;
+        }
+        const float area = result.ex[0] * (result.vy[2] - result.vy[0]) - result.ey[0] * (result.vx[2] - result.vx[0]);
+        result.orientation = area < 0.0f ? -1.0f : 1.0f;
+        return result;
+    }
+
+    // Gamuts published by Philips for the color lights
+    constexpr ColorConversion::Gamut gamutA{{0.704f, 0.296f}, {0.2151f, 0.7106f}, {0.138f, 0.08f}};
+    constexpr ColorConversion::Gamut gamutB{{0.675f, 0.322f}, {0.409f, 0.518f}, {0.167f, 0.04f}};
+    constexpr ColorConversion::Gamut gamutC{{0.6915f, 0.3083f}, {0.17f, 0.7f}, {0.1532f, 0.0475f}};
+    constexpr Triangle triangleA = createTriangle(gamutA);
+    constexpr Triangle triangleB = createTriangle(gamutB);
+    constexpr Triangle triangleC = createTriangle(gamutC);
+
+    const Triangle* getTriangle(ColorType colorType)
+    {
+        switch (colorType)
+        {
+        case ColorType::GAMUT_A:
+        case ColorType::GAMUT_A_TEMPERATURE:
+            return &triangleA;
+        case ColorType::GAMUT_B:
+        case ColorType::GAMUT_B_TEMPERATURE:
+            return &triangleB;
+        case ColorType::GAMUT_C:
+        case ColorType::GAMUT_C_TEMPERATURE:
+            return &triangleC;
+        default:
+            return nullptr;
+        }
+    }
+
+    bool isInTriangle(XY xy, const Triangle& triangle)
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            const float dx = xy.x - triangle.vx[i];
+            const float dy = xy.y - triangle.vy[i];
+            if ((triangle.ex[i] * dy - triangle.ey[i] * dx) * triangle.orientation < 0.0f)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    XY clampScalar(XY xy, const Triangle& triangle)
+    {
+        bool inside = true;
+        XY closest = xy;
+        float closestDistance = std::numeric_limits<float>::max();
+        for (int i = 0; i < 3; ++i)
+        {
+            const float dx = xy.x - triangle.vx[i];
+            const float dy = xy.y - triangle.vy[i];
+            inside = inside && (triangle.ex[i] * dy - triangle.ey[i] * dx) * triangle.orientation >= 0.0f;
+            // Projection onto the edge, limited to the vertices
+            const float t
+                = std::min(std::max((dx * triangle.ex[i] + dy * triangle.ey[i]) * triangle.invLength[i], 0.0f), 1.0f);
+            const float px = triangle.vx[i] + t * triangle.ex[i];
+            const float py = triangle.vy[i] + t * triangle.ey[i];
+            const float distance = (xy.x - px) * (xy.x - px) + (xy.y - py) * (xy.y - py);
+            if (distance < closestDistance)
+            {
+                closestDistance = distance;
+                closest = {px, py};
+            }
+        }
+        return inside ? xy : closest;
+    }
+
+    // Triangle with Q14 coordinates, so all products of coordinates fit into 32 bits.
+    // The vertices are rounded toward the inside, so every point of it is inside of the float triangle as well.
+    struct FixedTriangle
+    {
+        int32_t vx[3];
+        int32_t vy[3];
+        int32_t ex[3];
+        int32_t ey[3];
+        // 2^44 / squared length of the edges, multiplying a Q28 dot product gives the projection in Q14 after >> 30
+        int64_t invLength[3];
+        int32_t orientation;
+        // Centroid, which is always inside
+        int32_t centerX;
+        int32_t centerY;
+    };
+
+    constexpr int32_t toFixed(float value)
+    {
+        return static_cast<int32_t>(value * 16384.0f + (value < 0.0f ? -0.5f : 0.5f));
+    }
+
+    // Like isInTriangle, but false on the edges
+    constexpr bool isStrictlyInTriangle(double x, double y, const Triangle& triangle)
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            const double cross = triangle.ex[i] * (y - triangle.vy[i]) - triangle.ey[i] * (x - triangle.vx[i]);
+            if (cross * triangle.orientation <= 0.0)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    constexpr FixedTriangle createFixedTriangle(const Triangle& triangle)
+    {
+        FixedTriangle result{};
+        for (int i = 0; i < 3; ++i)
+        {
+            // Closest grid point next to the vertex that is inside, the rounded vertex for degenerate triangles
+            const int32_t roundedX = toFixed(triangle.vx[i]);
+            const int32_t roundedY = toFixed(triangle.vy[i]);
+            result.vx[i] = roundedX;
+            result.vy[i] = roundedY;
+            double closest = 1.0;
+            for (int32_t y = roundedY - 2; y <= roundedY + 2; ++y)
+            {
+                for (int32_t x = roundedX - 2; x <= roundedX + 2; ++x)
+                {
+                    const double dx = x / 16384.0 - triangle.vx[i];
+                    const double dy = y / 16384.0 - triangle.vy[i];
+                    if (dx * dx + dy * dy < closest && isStrictlyInTriangle(x / 16384.0, y / 16384.0, triangle))
+                    {
+                        closest = dx * dx + dy * dy;
+                        result.vx[i] = x;
+                        result.vy[i] = y;
+                    }
+                }
+            }
+        }
+        result.centerX = (result.vx[0] + result.vx[1] + result.vx[2]) / 3;
+        result.centerY = (result.vy[0] + result.vy[1] + result.vy[2]) / 3;
+        for (int i = 0; i < 3; ++i)
+        {
+            result.ex[i] = result.vx[(i + 1) % 3] - result.vx[i];
+            result.ey[i] = result.vy[(i + 1) % 3] - result.vy[i];
+            const int64_t length = int64_t(result.ex[i]) * result.ex[i] + int64_t(result.ey[i]) * result.ey[i];
+            result.invLength[i] = length > 0 ? (int64_t(1) << 44) / length : 0;
+        }
+        result.orientation = triangle.orientation < 0.0f ? -1 : 1;
+        return result;
+    }
+
+    constexpr FixedTriangle fixedTriangleA = createFixedTriangle(triangleA);
+    constexpr FixedTriangle fixedTriangleB = createFixedTriangle(triangleB);
+    constexpr FixedTriangle fixedTriangleC = createFixedTriangle(triangleC);
+
+    const FixedTriangle* getFixedTriangle(ColorType colorType)
+    {
+        switch (colorType)
+        {
+        case ColorType::GAMUT_A:
+        case ColorType::GAMUT_A_TEMPERATURE:
+            return &fixedTriangleA;
+        case ColorType::GAMUT_B:
+        case ColorType::GAMUT_B_TEMPERATURE:
+            return &fixedTriangleB;
+        case ColorType::GAMUT_C:
+        case ColorType::GAMUT_C_TEMPERATURE:
+            return &fixedTriangleC;
+        default:
+            return nullptr;
+        }
+    }
+
+    bool isInFixedTriangle(int32_t x, int32_t y, const FixedTriangle& triangle)
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            if ((triangle.ex[i] * (y - triangle.vy[i]) - triangle.ey[i] * (x - triangle.vx[i])) * triangle.orientation
+                < 0)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Same as clampScalar without floating point division, colors are limited to [0, 1] to avoid overflows.
+    // triangle must be created from floatTriangle, which decides whether a color is inside exactly.
+    XY clampFixed(XY xy, const Triangle& floatTriangle, const FixedTriangle& triangle)
+    {
+        if (isInTriangle(xy, floatTriangle))
+        {
+            return xy;
+        }
+        const int32_t x = toFixed(std::min(std::max(xy.x, 0.0f), 1.0f));
+        const int32_t y = toFixed(std::min(std::max(xy.y, 0.0f), 1.0f));
+        // Closest point in Q28
+        int32_t closestX = x * 16384;
+        int32_t closestY = y * 16384;
+        int64_t closestDistance = std::numeric_limits<int64_t>::max();
+        for (int i = 0; i < 3; ++i)
+        {
+            const int32_t dx = x - triangle.vx[i];
+            const int32_t dy = y - triangle.vy[i];
+            const int32_t dot = dx * triangle.ex[i] + dy * triangle.ey[i];
+            const int32_t t = static_cast<int32_t>(
+                std::min(std::max((dot * triangle.invLength[i]) >> 30, int64_t(0)), int64_t(1) << 14));
+            // Offset from the closest point on the edge in Q28, rounding the point to Q14 first would change
+            // the distance of far away colors by more than the difference between the edges
+            const int32_t ox = dx * 16384 - t * triangle.ex[i];
+            const int32_t oy = dy * 16384 - t * triangle.ey[i];
+            const int64_t distance = int64_t(ox) * ox + int64_t(oy) * oy;
+            if (distance < closestDistance)
+            {
+                closestDistance = distance;
+                closestX = triangle.vx[i] * 16384 + t * triangle.ex[i];
+                closestY = triangle.vy[i] * 16384 + t * triangle.ey[i];
+            }
+        }
+        // Rounding to Q14 can leave the point just outside of an edge, so the nearest of the 4 surrounding
+        // grid points that is inside is used
+        int32_t resultX = (closestX + 8192) >> 14;
+        int32_t resultY = (closestY + 8192) >> 14;
+        int64_t resultDistance = std::numeric_limits<int64_t>::max();
+        for (int32_t gridX = closestX >> 14; gridX <= (closestX >> 14) + 1; ++gridX)
+        {
+            for (int32_t gridY = closestY >> 14; gridY <= (closestY >> 14) + 1; ++gridY)
+            {
+                const int64_t ox = int64_t(gridX) * 16384 - closestX;
+                const int64_t oy = int64_t(gridY) * 16384 - closestY;
+                if (ox * ox + oy * oy < resultDistance && isInFixedTriangle(gridX, gridY, triangle))
+                {
+                    resultDistance = ox * ox + oy * oy;
+                    resultX = gridX;
+                    resultY = gridY;
+                }
+            }
+        }
+        // Only happens in very acute corners, move toward the center until the point is inside
+        while (!isInFixedTriangle(resultX, resultY, triangle))
+        {
+            resultX += (resultX < triangle.centerX) - (resultX > triangle.centerX);
+            resultY += (resultY < triangle.centerY) - (resultY > triangle.centerY);
+        }
+        return {resultX * (1.0f / 16384), resultY * (1.0f / 16384)};
+    }
+
+#ifdef HUEPLUSPLUS_SSE2
+    // Selects b where mask is set, otherwise a
+    __m128 selectSSE2(__m128 mask, __m128 a, __m128 b)
+    {
+        return _mm_or_ps(_mm_and_ps(mask, b), _mm_andnot_ps(mask, a));
+    }
+
+    // Same computation as clampScalar for 4 colors at a time
+    std::size_t clampSSE2(float* x, float* y, std::size_t count, const Triangle& triangle)
+    {
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 orientation = _mm_set1_ps(triangle.orientation);
+        std::size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            const __m128 pointX = _mm_loadu_ps(x + i);
+            const __m128 pointY = _mm_loadu_ps(y + i);
+            __m128 inside = _mm_cmpeq_ps(zero, zero);
+            __m128 closestX = pointX;
+            __m128 closestY = pointY;
+            __m128 closestDistance = _mm_set1_ps(std::numeric_limits<float>::max());
+            for (int edge = 0; edge < 3; ++edge)
+            {
+                const __m128 ex = _mm_set1_ps(triangle.ex[edge]);
+                const __m128 ey = _mm_set1_ps(triangle.ey[edge]);
+                const __m128 vx = _mm_set1_ps(triangle.vx[edge]);
+                const __m128 vy = _mm_set1_ps(triangle.vy[edge]);
+                const __m128 dx = _mm_sub_ps(pointX, vx);
+                const __m128 dy = _mm_sub_ps(pointY, vy);
+                const __m128 cross = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(ex, dy), _mm_mul_ps(ey, dx)), orientation);
+                inside = _mm_and_ps(inside, _mm_cmpge_ps(cross, zero));
+                const __m128 dot = _mm_add_ps(_mm_mul_ps(dx, ex), _mm_mul_ps(dy, ey));
+                const __m128 t = _mm_min_ps(
+                    _mm_max_ps(_mm_mul_ps(dot, _mm_set1_ps(triangle.invLength[edge])), zero), one);
+                const __m128 px = _mm_add_ps(vx, _mm_mul_ps(t, ex));
+                const __m128 py = _mm_add_ps(vy, _mm_mul_ps(t, ey));
+                const __m128 distX = _mm_sub_ps(pointX, px);
+                const __m128 distY = _mm_sub_ps(pointY, py);
+                const __m128 distance = _mm_add_ps(_mm_mul_ps(distX, distX), _mm_mul_ps(distY, distY));
+                const __m128 closer = _mm_cmplt_ps(distance, closestDistance);
+                closestDistance = selectSSE2(closer, closestDistance, distance);
+                closestX = selectSSE2(closer, closestX, px);
+                closestY = selectSSE2(closer, closestY, py);
+            }
+            _mm_storeu_ps(x + i, selectSSE2(inside, closestX, pointX));
+            _mm_storeu_ps(y + i, selectSSE2(inside, closestY, pointY));
+        }
+        return i;
+    }
+#endif
+
+#ifdef HUEPLUSPLUS_AVX2
+    // Same computation as clampScalar for 8 colors at a time
+    __attribute__((target("avx2"))) std::size_t clampAVX2(
+        float* x, float* y, std::size_t count, const Triangle& triangle)
+    {
+        const __m256 zero = _mm256_setzero_ps();
+        const __m256 one = _mm256_set1_ps(1.0f);
+        const __m256 orientation = _mm256_set1_ps(triangle.orientation);
+        std::size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            const __m256 pointX = _mm256_loadu_ps(x + i);
+            const __m256 pointY = _mm256_loadu_ps(y + i);
+            __m256 inside = _mm256_cmp_ps(zero, zero, _CMP_EQ_OQ);
+            __m256 closestX = pointX;
+            __m256 closestY = pointY;
+            __m256 closestDistance = _mm256_set1_ps(std::numeric_limits<float>::max());
+            for (int edge = 0; edge < 3; ++edge)
+            {
+                const __m256 ex = _mm256_set1_ps(triangle.ex[edge]);
+                const __m256 ey = _mm256_set1_ps(triangle.ey[edge]);
+                const __m256 vx = _mm256_set1_ps(triangle.vx[edge]);
+                const __m256 vy = _mm256_set1_ps(triangle.vy[edge]);
+                const __m256 dx = _mm256_sub_ps(pointX, vx);
+                const __m256 dy = _mm256_sub_ps(pointY, vy);
+                const __m256 cross
+                    = _mm256_mul_ps(_mm256_sub_ps(_mm256_mul_ps(ex, dy), _mm256_mul_ps(ey, dx)), orientation);
+                inside = _mm256_and_ps(inside, _mm256_cmp_ps(cross, zero, _CMP_GE_OQ));
+                const __m256 dot = _mm256_add_ps(_mm256_mul_ps(dx, ex), _mm256_mul_ps(dy, ey));
+                const __m256 t = _mm256_min_ps(
+                    _mm256_max_ps(_mm256_mul_ps(dot, _mm256_set1_ps(triangle.invLength[edge])), zero), one);
+                const __m256 px = _mm256_add_ps(vx, _mm256_mul_ps(t, ex));
+                const __m256 py = _mm256_add_ps(vy, _mm256_mul_ps(t, ey));
+                const __m256 distX = _mm256_sub_ps(pointX, px);
+                const __m256 distY = _mm256_sub_ps(pointY, py);
+                const __m256 distance = _mm256_add_ps(_mm256_mul_ps(distX, distX), _mm256_mul_ps(distY, distY));
+                const __m256 closer = _mm256_cmp_ps(distance, closestDistance, _CMP_LT_OQ);
+                closestDistance = _mm256_blendv_ps(closestDistance, distance, closer);
+                closestX = _mm256_blendv_ps(closestX, px, closer);
+                closestY = _mm256_blendv_ps(closestY, py, closer);
+            }
+            _mm256_storeu_ps(x + i, _mm256_blendv_ps(closestX, pointX, inside));
+            _mm256_storeu_ps(y + i, _mm256_blendv_ps(closestY, pointY, inside));
+        }
+        return i;
+    }
+#endif
+
+    void clampBatch(float* x, float* y, std::size_t count, const Triangle& triangle, ColorConversion::Simd simd)
+    {
+        std::size_t done = 0;
+        switch (simd)
+        {
+#ifdef HUEPLUSPLUS_AVX2
+        case ColorConversion::Simd::AVX2:
+            done = clampAVX2(x, y, count, triangle);
+            break;
+#endif
+#ifdef HUEPLUSPLUS_SSE2
+        case ColorConversion::Simd::SSE2:
+            done = clampSSE2(x, y, count, triangle);
+            break;
+#endif
+        default:
+            break;
+        }
+        // Remaining colors that do not fill a whole register
+        const FixedTriangle fixedTriangle = fixedPoint ? createFixedTriangle(triangle) : FixedTriangle{};
+        for (std::size_t i = done; i < count; ++i)
+        {
+            const XY clamped
+                = fixedPoint ? clampFixed({x[i], y[i]}, triangle, fixedTriangle) : clampScalar({x[i], y[i]}, triangle);
+            x[i] = clamped.x;
+            y[i] = clamped.y;
+        }
+    }
+} // namespace
+
+ColorConversion::Simd ColorConversion::getSupportedSimd()
+{
+    return fixedPoint ? Simd::NONE : utils::getProcessorSimd();
+}
+
+float ColorConversion::srgbToLinear(uint8_t value)
+{
+    return gammaTables.linear[value];
+}
+
+uint8_t ColorConversion::linearToSrgb(float value)
+{
+    // Number of thresholds below value is the closest sRGB component
+    if (!(value > 0.0f))
+    {
+        return 0;
+    }
+    if (value >= 1.0f)
+    {
+        return 255;
+    }
+    const uint8_t component = gammaTables.coarse[static_cast<int>(value * coarseSize)];
+    return (component < 255 && gammaTables.threshold[component] <= value) ? component + 1 : component;
+}
+
+RGB ColorConversion::xyToRGB(XY xy, uint8_t brightness)
+{
+    float rgb[3];
+    xyToLinear(xy, rgb);
+    return linearToRGB(rgb, brightness);
+}
+
+RGB ColorConversion::hueSaturationToRGB(uint16_t hue, uint8_t saturation, uint8_t brightness)
+{
+    // Components are sRGB, brightness is applied in linear space like for the other color modes
+    const RGB srgb = hsvToSrgb(hue, saturation);
+    const float rgb[3] = {srgbToLinear(srgb.r), srgbToLinear(srgb.g), srgbToLinear(srgb.b)};
+    return linearToRGB(rgb, brightness);
+}
+
+XY ColorConversion::hueSaturationToXY(uint16_t hue, uint8_t saturation, ColorType colorType)
+{
+    const RGB srgb = hsvToSrgb(hue, saturation);
+    // Uses the precomputed triangle of the gamut
+    return clampToGamut(rgbToXY(srgb.r, srgb.g, srgb.b), colorType);
+}
+
+HueSaturation ColorConversion::xyToHueSaturation(XY xy, ColorType colorType)
+{
+    float rgb[3];
+    xyToLinear(clampToGamut(xy, colorType), rgb);
+    const int r = linearToSrgb(rgb[0]);
+    const int g = linearToSrgb(rgb[1]);
+    const int b = linearToSrgb(rgb[2]);
+    const int maximum = std::max(std::max(r, g), b);
+    const int range = maximum - std::min(std::min(r, g), b);
+    if (range == 0)
+    {
+        return {0, 0};
+    }
+    // Position in the 6 sectors of the hue circle, like in hsvToSrgb
+    float sector = 0.0f;
+    if (maximum == r)
+    {
+        sector = static_cast<float>(g - b) / range;
+        if (sector < 0.0f)
+        {
+            sector += 6.0f;
+        }
+    }
+    else if (maximum == g)
+    {
+        sector = 2.0f + static_cast<float>(b - r) / range;
+    }
+    else
+    {
+        sector = 4.0f + static_cast<float>(r - g) / range;
+    }
+    const int hue = static_cast<int>(sector * (65536.0f / 6.0f) + 0.5f) & 0xFFFF;
+    return {hue, (range * 254 + maximum / 2) / maximum};
+}
+
+XY ColorConversion::colorTemperatureToXY(unsigned int mired)
+{
+    return planckianTable.xy[std::min(std::max(mired, minMired), maxMired) - minMired];
+}
+
+unsigned int ColorConversion::xyToColorTemperature(XY xy)
+{
+    unsigned int closest = minMired;
+    float closestDistance = std::numeric_limits<float>::max();
+    for (unsigned int mired = minMired; mired <= maxMired; ++mired)
+    {
+        const XY& locus = planckianTable.xy[mired - minMired];
+        const float distance = (xy.x - locus.x) * (xy.x - locus.x) + (xy.y - locus.y) * (xy.y - locus.y);
+        if (distance < closestDistance)
+        {
+            closestDistance = distance;
+            closest = mired;
+        }
+    }
+    return closest;
+}
+
+RGB ColorConversion::colorTemperatureToRGB(unsigned int mired, uint8_t brightness)
+{
+    return xyToRGB(colorTemperatureToXY(mired), brightness);
+}
+
+RGB ColorConversion::stateToRGB(const LightState& state)
+{
+    if (!state.on)
+    {
+        return {0, 0, 0};
+    }
+    switch (state.colormode)
+    {
+    case ColorMode::XY:
+        return xyToRGB(state.xy, state.bri);
+    case ColorMode::HS:
+        return hueSaturationToRGB(state.hue, state.sat, state.bri);
+    case ColorMode::CT:
+        return colorTemperatureToRGB(state.ct, state.bri);
+    default:
+    {
+        // White light
+        const float rgb[3] = {1.0f, 1.0f, 1.0f};
+        return linearToRGB(rgb, state.bri);
+    }
+    }
+}
+
+void ColorConversion::xyToRGB(
+    const float* x, const float* y, const uint8_t* brightness, std::size_t count, uint8_t* r, uint8_t* g, uint8_t* b)
+{
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const RGB rgb = xyToRGB({x[i], y[i]}, brightness[i]);
+        r[i] = rgb.r;
+        g[i] = rgb.g;
+        b[i] = rgb.b;
+    }
+}
+
+void ColorConversion::hueSaturationToRGB(const uint16_t* hue, const uint8_t* saturation, const uint8_t* brightness,
+    std::size_t count, uint8_t* r, uint8_t* g, uint8_t* b)
+{
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const RGB rgb = hueSaturationToRGB(hue[i], saturation[i], brightness[i]);
+        r[i] = rgb.r;
+        g[i] = rgb.g;
+        b[i] = rgb.b;
+    }
+}
+
+void ColorConversion::colorTemperatureToRGB(
+    const uint16_t* mired, const uint8_t* brightness, std::size_t count, uint8_t* r, uint8_t* g, uint8_t* b)
+{
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const RGB rgb = colorTemperatureToRGB(mired[i], brightness[i]);
+        r[i] = rgb.r;
+        g[i] = rgb.g;
+        b[i] = rgb.b;
+    }
+}
+
+void ColorConversion::stateToRGB(const LightState* states, std::size_t count, RGB* rgb)
+{
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        rgb[i] = stateToRGB(states[i]);
+    }
+}
+
+XY ColorConversion::rgbToXY(uint8_t r, uint8_t g, uint8_t b, float* brightness)
+{
+    XY result;
+    convertScalar(&r, &g, &b, 1, &result.x, &result.y, brightness);
+    return result;
+}
+
+XY ColorConversion::rgbToXYFixed(uint8_t r, uint8_t g, uint8_t b, float* brightness)
+{
+    XY result;
+    convertFixed(&r, &g, &b, 1, &result.x, &result.y, brightness);
+    return result;
+}
+
+void ColorConversion::rgbToXY(
+    const uint8_t* r, const uint8_t* g, const uint8_t* b, std::size_t count, float* x, float* y, float* brightness)
+{
+    rgbToXY(r, g, b, count, x, y, brightness, getSupportedSimd());
+}
+
+void ColorConversion::rgbToXY(const uint8_t* r, const uint8_t* g, const uint8_t* b, std::size_t count, float* x,
+    float* y, float* brightness, Simd simd)
+{
+    const Simd supported = getSupportedSimd();
+    if (simd > supported)
+    {
+        simd = supported;
+    }
+    std::size_t done = 0;
+    switch (simd)
+    {
+#ifdef HUEPLUSPLUS_AVX2
+    case Simd::AVX2:
+        done = convertAVX2(r, g, b, count, x, y, brightness);
+        break;
+#endif
+#ifdef HUEPLUSPLUS_SSE2
+    case Simd::SSE2:
+        done = convertSSE2(r, g, b, count, x, y, brightness);
+        break;
+#endif
+    default:
+        break;
+    }
+    // Remaining colors that do not fill a whole register
+    convertScalar(r + done, g + done, b + done, count - done, x + done, y + done,
+        brightness ? brightness + done : nullptr);
+}
+
+const ColorConversion::Gamut* ColorConversion::getGamut(ColorType colorType)
+{
+    switch (colorType)
+    {
+    case ColorType::GAMUT_A:
+    case ColorType::GAMUT_A_TEMPERATURE:
+        return &gamutA;
+    case ColorType::GAMUT_B:
+    case ColorType::GAMUT_B_TEMPERATURE:
+        return &gamutB;
+    case ColorType::GAMUT_C:
+    case ColorType::GAMUT_C_TEMPERATURE:
+        return &gamutC;
+    default:
+        return nullptr;
+    }
+}
+
+bool ColorConversion::isInGamut(XY xy, const Gamut& gamut)
+{
+    return isInTriangle(xy, createTriangle(gamut));
+}
+
+XY ColorConversion::clampToGamut(XY xy, const Gamut& gamut)
+{
+    if (fixedPoint)
+    {
+        return clampToGamutFixed(xy, gamut);
+    }
+    return clampScalar(xy, createTriangle(gamut));
+}
+
+XY ColorConversion::clampToGamut(XY xy, ColorType colorType)
+{
+    if (fixedPoint)
+    {
+        return clampToGamutFixed(xy, colorType);
+    }
+    const Triangle* triangle = getTriangle(colorType);
+    return triangle ? clampScalar(xy, *triangle) : xy;
+}
+
+XY ColorConversion::clampToGamutFixed(XY xy, const Gamut& gamut)
+{
+    const Triangle triangle = createTriangle(gamut);
+    return clampFixed(xy, triangle, createFixedTriangle(triangle));
+}
+
+XY ColorConversion::clampToGamutFixed(XY xy, ColorType colorType)
+{
+    const Triangle* triangle = getTriangle(colorType);
+    return triangle ? clampFixed(xy, *triangle, *getFixedTriangle(colorType)) : xy;
+}
+
+void ColorConversion::clampToGamut(float* x, float* y, std::size_t count, const Gamut& gamut)
+{
+    clampBatch(x, y, count, createTriangle(gamut), getSupportedSimd());
+}
+
+void ColorConversion::clampToGamut(float* x, float* y, std::size_t count, const Gamut& gamut, Simd simd)
+{
+    clampBatch(x, y, count, createTriangle(gamut), std::min(simd, getSupportedSimd()));
+}
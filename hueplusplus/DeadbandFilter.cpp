@@ -0,0 +1,183 @@
+/**
+    \file DeadbandFilter.cpp
+    Copyright Notice\n
+    Copyright (C) 2017  Jan Rogall		- developer\n
+    Copyright (C) 2017  Moritz Wirger	- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "include/DeadbandFilter.h"
+
+#include <cstdlib>
+
+#include "include/TransitionEngine.h"
+
+namespace
+{
+    constexpr uint16_t hsFields = StateRequest::HUE | StateRequest::SAT;
+
+    // Color fields of a request that belong to the color mode
+    uint16_t getModeFields(ColorMode mode)
+    {
+        switch (mode)
+        {
+        case ColorMode::XY:
+            return StateRequest::XY;
+        case ColorMode::HS:
+            return hsFields;
+        case ColorMode::CT:
+            return StateRequest::CT;
+        default:
+            return 0;
+        }
+    }
+
+    int countFields(uint16_t fields)
+    {
+        int count = 0;
+        for (; fields != 0; fields &= fields - 1)
+        {
+            ++count;
+        }
+        return count;
+    }
+} // namespace
+
+DeadbandFilter::DeadbandFilter(float maxDistance, unsigned int maxMired) : maxDistance(maxDistance), maxMired(maxMired)
+{}
+
+float DeadbandFilter::getMaxDistance() const
+{
+    return maxDistance;
+}
+
+unsigned int DeadbandFilter::getMaxMired() const
+{
+    return maxMired;
+}
+
+bool DeadbandFilter::apply(StateRequest& request, const LightState& state)
+{
+    const LightState& requested = request.getState();
+    uint16_t colorRequest = 0;
+    for (uint16_t field : {StateRequest::HUE, StateRequest::SAT, StateRequest::XY, StateRequest::CT})
+    {
+        if (request.has(static_cast<StateRequest::Field>(field)))
+        {
+            colorRequest |= field;
+        }
+    }
+    const uint16_t modeFields = getModeFields(state.colormode);
+    // Complete hs and xy colors are compared by the color they show, so switching between both modes is filtered too
+    const bool colorSwitch = (state.colormode == ColorMode::XY || state.colormode == ColorMode::HS)
+        && (colorRequest == StateRequest::XY || colorRequest == hsFields);
+    // Changes of a light that is off or turned off, other color mode switches and effects are always visible
+    const bool filterable = state.on && (!request.has(StateRequest::ON) || requested.on)
+        && ((colorRequest & ~modeFields) == 0 || colorSwitch) && !request.has(StateRequest::ALERT)
+        && !request.has(StateRequest::EFFECT);
+    if (!filterable)
+    {
+        ++passedRequests;
+        return true;
+    }
+
+    uint16_t removed = 0;
+    if (request.has(StateRequest::CT) && static_cast<unsigned int>(std::abs(requested.ct - state.ct)) <= maxMired)
+    {
+        request.remove(StateRequest::CT);
+        removed |= StateRequest::CT;
+    }
+    // Color and brightness are compared together, because both change the perceived color
+    LightState next = state;
+    uint16_t compared = 0;
+    if (request.has(StateRequest::BRI))
+    {
+        next.bri = requested.bri;
+        compared |= StateRequest::BRI;
+    }
+    if (request.has(StateRequest::XY))
+    {
+        next.xy = requested.xy;
+        next.colormode = ColorMode::XY;
+        compared |= StateRequest::XY;
+    }
+    if (request.has(StateRequest::HUE))
+    {
+        next.hue = requested.hue;
+        next.colormode = ColorMode::HS;
+        compared |= StateRequest::HUE;
+    }
+    if (request.has(StateRequest::SAT))
+    {
+        next.sat = requested.sat;
+        next.colormode = ColorMode::HS;
+        compared |= StateRequest::SAT;
+    }
+    if (request.has(StateRequest::CT))
+    {
+        // Larger color temperature changes are visible regardless of the brightness
+        compared = 0;
+    }
+    if (compared != 0
+        // Requested xy colors are not clamped either, so both sides are compared outside of any gamut
+        && TransitionEngine::distance(
+               TransitionEngine::getColor(state, ColorType::NONE), TransitionEngine::getColor(next, ColorType::NONE))
+            <= maxDistance)
+    {
+        for (uint16_t field : {StateRequest::BRI, StateRequest::XY, StateRequest::HUE, StateRequest::SAT})
+        {
+            if (compared & field)
+            {
+                request.remove(static_cast<StateRequest::Field>(field));
+            }
+        }
+        removed |= compared;
+    }
+    suppressedFields += countFields(removed);
+
+    // A transition time alone does not change anything, neither does turning on a light that is already on
+    const bool visible = request.has(StateRequest::BRI) || (colorRequest & ~removed) != 0;
+    if (removed != 0 && !visible)
+    {
+        ++suppressedRequests;
+        return false;
+    }
+    ++passedRequests;
+    return true;
+}
+
+uint64_t DeadbandFilter::getPassedRequests() const
+{
+    return passedRequests;
+}
+
+uint64_t DeadbandFilter::getSuppressedRequests() const
+{
+    return suppressedRequests;
+}
+
+uint64_t DeadbandFilter::getSuppressedFields() const
+{
+    return suppressedFields;
+}
+
+void DeadbandFilter::resetCounters()
+{
+    passedRequests = 0;
+    suppressedRequests = 0;
+    suppressedFields = 0;
+}
@@ -0,0 +1,72 @@
+/**
+    \file EmulatedColorTemperatureStrategy.cpp
+    Copyright Notice\n
+    Copyright (C) 2017  Jan Rogall		- developer\n
+    Copyright (C) 2017  Moritz Wirger	- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "include/EmulatedColorTemperatureStrategy.h"
+
+#include <algorithm>
+
+#include "include/ColorConversion.h"
+
+namespace
+{
+    // Color temperature closest to the color of a light, clamped to the range of the color temperature lights
+    unsigned int ClosestColorTemperature(const LightState& state, ColorType colorType)
+    {
+        unsigned int mired = state.ct;
+        switch (state.colormode)
+        {
+        case ColorMode::XY:
+            mired = ColorConversion::xyToColorTemperature(state.xy);
+            break;
+        case ColorMode::HS:
+            // The xy the light shows for this hue and saturation
+            mired = ColorConversion::xyToColorTemperature(
+                ColorConversion::hueSaturationToXY(state.hue, state.sat, colorType));
+            break;
+        case ColorMode::CT:
+            break;
+        default:
+            return mired;
+        }
+        return std::min(std::max(mired, 153u), 500u);
+    }
+} // namespace
+
+bool EmulatedColorTemperatureStrategy::setColorTemperature(
+    unsigned int mired, uint8_t transition, HueLight& light) const
+{
+    mired = std::min(std::max(mired, 153u), 500u);
+    const XY xy = ColorConversion::colorTemperatureToXY(mired);
+    // setColorXY clamps to the gamut and only sends what changed
+    return light.setColorXY(xy.x, xy.y, transition);
+}
+
+unsigned int EmulatedColorTemperatureStrategy::getColorTemperature(HueLight& light) const
+{
+    light.refreshState();
+    return ClosestColorTemperature(light.getState(), light.getColorType());
+}
+
+unsigned int EmulatedColorTemperatureStrategy::getColorTemperature(const HueLight& light) const
+{
+    return ClosestColorTemperature(light.getState(), light.getColorType());
+}
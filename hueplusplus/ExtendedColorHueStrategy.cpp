@@ -22,254 +22,17 @@
 
 #include "include/ExtendedColorHueStrategy.h"
 
-#include <cmath>
-#include <iostream>
-#include <thread>
-
-#include "include/HueConfig.h"
-
 bool ExtendedColorHueStrategy::alertHueSaturation(uint16_t hue, uint8_t sat, HueLight& light) const
 {
-    light.refreshState();
-    std::string cType = light.state["state"]["colormode"].get<std::string>();
-    bool on = light.state["state"]["on"].get<bool>();
-    if (cType == "hs")
-    {
-        uint16_t oldHue = light.state["state"]["hue"].get<uint16_t>();
-        uint8_t oldSat = light.state["state"]["sat"].get<uint8_t>();
-        if (!light.setColorHueSaturation(hue, sat, 1))
-        {
-            return false;
-        }
-        std::this_thread::sleep_for(std::chrono::milliseconds(c_PRE_ALERT_DELAY));
-        if (!light.alert())
-        {
-            return false;
-        }
-        std::this_thread::sleep_for(std::chrono::milliseconds(c_POST_ALERT_DELAY));
-        if (!on)
-        {
-            light.setColorHueSaturation(oldHue, oldSat, 1);
-            return light.OffNoRefresh(1);
-        }
-        else
-        {
-            return light.setColorHueSaturation(oldHue, oldSat, 1);
-        }
-    }
-    else if (cType == "xy")
-    {
-        float oldX = light.state["state"]["xy"][0].get<float>();
-        float oldY = light.state["state"]["xy"][1].get<float>();
-        if (!light.setColorHueSaturation(hue, sat, 1))
-        {
-            return false;
-        }
-        std::this_thread::sleep_for(std::chrono::milliseconds(c_PRE_ALERT_DELAY));
-        if (!light.alert())
-        {
-            return false;
-        }
-        std::this_thread::sleep_for(std::chrono::milliseconds(c_POST_ALERT_DELAY));
-        if (!on)
-        {
-            light.setColorXY(oldX, oldY, 1);
-            return light.OffNoRefresh(1);
-        }
-        else
-        {
-            return light.setColorXY(oldX, oldY, 1);
-        }
-    }
-    else if (cType == "ct")
-    {
-        uint16_t oldCT = light.state["state"]["ct"].get<uint16_t>();
-        if (!light.setColorHueSaturation(hue, sat, 1))
-        {
-            return false;
-        }
-        std::this_thread::sleep_for(std::chrono::milliseconds(c_PRE_ALERT_DELAY));
-        if (!light.alert())
-        {
-            return false;
-        }
-        std::this_thread::sleep_for(std::chrono::milliseconds(c_POST_ALERT_DELAY));
-        if (!on)
-        {
-            light.setColorTemperature(oldCT, 1);
-            return light.OffNoRefresh(1);
-        }
-        else
-        {
-            return light.setColorTemperature(oldCT, 1);
-        }
-    }
-    else
-    {
-        return false;
-    }
+    return alertColor(light, true, [&]() { return light.setColorHueSaturation(hue, sat, 1); });
 }
 
 bool ExtendedColorHueStrategy::alertXY(float x, float y, HueLight& light) const
 {
-    light.refreshState();
-    std::string cType = light.state["state"]["colormode"].get<std::string>();
-    bool on = light.state["state"]["on"].get<bool>();
-    if (cType == "hs")
-    {
-        uint16_t oldHue = light.state["state"]["hue"].get<uint16_t>();
-        uint8_t oldSat = light.state["state"]["sat"].get<uint8_t>();
-        if (!light.setColorXY(x, y, 1))
-        {
-            return false;
-        }
-        std::this_thread::sleep_for(std::chrono::milliseconds(c_PRE_ALERT_DELAY));
-        if (!light.alert())
-        {
-            return false;
-        }
-        std::this_thread::sleep_for(std::chrono::milliseconds(c_POST_ALERT_DELAY));
-        if (!on)
-        {
-            light.setColorHueSaturation(oldHue, oldSat, 1);
-            return light.OffNoRefresh(1);
-        }
-        else
-        {
-            return light.setColorHueSaturation(oldHue, oldSat, 1);
-        }
-    }
-    else if (cType == "xy")
-    {
-        float oldX = light.state["state"]["xy"][0].get<float>();
-        float oldY = light.state["state"]["xy"][1].get<float>();
-        if (!light.setColorXY(x, y, 1))
-        {
-            return false;
-        }
-        std::this_thread::sleep_for(std::chrono::milliseconds(c_PRE_ALERT_DELAY));
-        if (!light.alert())
-        {
-            return false;
-        }
-        std::this_thread::sleep_for(std::chrono::milliseconds(c_POST_ALERT_DELAY));
-        if (!on)
-        {
-            light.setColorXY(oldX, oldY, 1);
-            return light.OffNoRefresh(1);
-        }
-        else
-        {
-            return light.setColorXY(oldX, oldY, 1);
-        }
-    }
-    else if (cType == "ct")
-    {
-        uint16_t oldCT = light.state["state"]["ct"].get<uint16_t>();
-        if (!light.setColorXY(x, y, 1))
-        {
-            return false;
-        }
-        std::this_thread::sleep_for(std::chrono::milliseconds(c_PRE_ALERT_DELAY));
-        if (!light.alert())
-        {
-            return false;
-        }
-        std::this_thread::sleep_for(std::chrono::milliseconds(c_POST_ALERT_DELAY));
-        if (!on)
-        {
-            light.setColorTemperature(oldCT, 1);
-            return light.OffNoRefresh(1);
-        }
-        else
-        {
-            return light.setColorTemperature(oldCT, 1);
-        }
-    }
-    else
-    {
-        return false;
-    }
+    return alertColor(light, true, [&]() { return light.setColorXY(x, y, 1); });
 }
 
 bool ExtendedColorHueStrategy::alertRGB(uint8_t r, uint8_t g, uint8_t b, HueLight& light) const
 {
-    light.refreshState();
-    std::string cType = light.state["state"]["colormode"].get<std::string>();
-    bool on = light.state["state"]["on"].get<bool>();
-    if (cType == "hs")
-    {
-        uint16_t oldHue = light.state["state"]["hue"].get<uint16_t>();
-        uint8_t oldSat = light.state["state"]["sat"].get<uint8_t>();
-        if (!light.setColorRGB(r, g, b, 1))
-        {
-            return false;
-        }
-        std::this_thread::sleep_for(std::chrono::milliseconds(c_PRE_ALERT_DELAY));
-        if (!light.alert())
-        {
-            return false;
-        }
-        std::this_thread::sleep_for(std::chrono::milliseconds(c_POST_ALERT_DELAY));
-        if (!on)
-        {
-            light.setColorHueSaturation(oldHue, oldSat, 1);
-            return light.OffNoRefresh(1);
-        }
-        else
-        {
-            return light.setColorHueSaturation(oldHue, oldSat, 1);
-        }
-    }
-    else if (cType == "xy")
-    {
-        float oldX = light.state["state"]["xy"][0].get<float>();
-        float oldY = light.state["state"]["xy"][1].get<float>();
-        if (!light.setColorRGB(r, g, b, 1))
-        {
-            return false;
-        }
-        std::this_thread::sleep_for(std::chrono::milliseconds(c_PRE_ALERT_DELAY));
-        if (!light.alert())
-        {
-            return false;
-        }
-        std::this_thread::sleep_for(std::chrono::milliseconds(c_POST_ALERT_DELAY));
-        if (!on)
-        {
-            light.setColorXY(oldX, oldY, 1);
-            return light.OffNoRefresh(1);
-        }
-        else
-        {
-            return light.setColorXY(oldX, oldY, 1);
-        }
-    }
-    else if (cType == "ct")
-    {
-        uint16_t oldCT = light.state["state"]["ct"].get<uint16_t>();
-        if (!light.setColorRGB(r, g, b, 1))
-        {
-            return false;
-        }
-        std::this_thread::sleep_for(std::chrono::milliseconds(c_PRE_ALERT_DELAY));
-        if (!light.alert())
-        {
-            return false;
-        }
-        std::this_thread::sleep_for(std::chrono::milliseconds(c_POST_ALERT_DELAY));
-        if (!on)
-        {
-            light.setColorTemperature(oldCT, 1);
-            return light.OffNoRefresh(1);
-        }
-        else
-        {
-            return light.setColorTemperature(oldCT, 1);
-        }
-    }
-    else
-    {
-        return false;
-    }
+    return alertColor(light, true, [&]() { return light.setColorRGB(r, g, b, 1); });
 }
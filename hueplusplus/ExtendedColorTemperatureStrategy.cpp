@@ -34,16 +34,17 @@ bool ExtendedColorTemperatureStrategy::setColorTemperature(
     unsigned int mired, uint8_t transition, HueLight& light) const
 {
     light.refreshState();
-    nlohmann::json request = nlohmann::json::object();
+    const LightState state = light.getState();
+    StateRequest request;
     if (transition != 4)
     {
-        request["transitiontime"] = transition;
+        request.setTransition(transition);
     }
-    if (light.state["state"]["on"] != true)
+    if (!state.on)
     {
-        request["on"] = true;
+        request.setOn(true);
     }
-    if (light.state["state"]["ct"] != mired || light.state["state"]["colormode"] != "ct")
+    if (!state.has(LightState::CT) || state.ct != mired || state.colormode != ColorMode::CT)
     {
         if (mired > 500)
         {
@@ -53,30 +54,29 @@ bool ExtendedColorTemperatureStrategy::setColorTemperature(
         {
             mired = 153;
         }
-        request["ct"] = mired;
+        request.setColorTemperature(static_cast<uint16_t>(mired));
     }
 
-    if (!request.count("on") && !request.count("ct"))
+    if (!request.has(StateRequest::ON) && !request.has(StateRequest::CT))
     {
         // Nothing needs to be changed
         return true;
     }
 
-    nlohmann::json reply = light.SendPutRequest(request, "/state", CURRENT_FILE_INFO);
-
     // Check whether request was successful
-    return utils::validateReplyForLight(request, reply, light.id);
+    return light.SendStateRequest(request, CURRENT_FILE_INFO).isSuccess();
 }
 
 bool ExtendedColorTemperatureStrategy::alertTemperature(unsigned int mired, HueLight& light) const
 {
     light.refreshState();
-    std::string cType = light.state["state"]["colormode"].get<std::string>();
-    bool on = light.state["state"]["on"].get<bool>();
-    if (cType == "hs")
+    const LightState state = light.getState();
+    ColorMode cType = state.colormode;
+    bool on = state.on;
+    if (cType == ColorMode::HS)
     {
-        uint16_t oldHue = light.state["state"]["hue"].get<uint16_t>();
-        uint8_t oldSat = light.state["state"]["sat"].get<uint8_t>();
+        uint16_t oldHue = state.hue;
+        uint8_t oldSat = state.sat;
         if (!light.setColorTemperature(mired, 1))
         {
             return false;
@@ -97,10 +97,10 @@ bool ExtendedColorTemperatureStrategy::alertTemperature(unsigned int mired, HueL
             return light.setColorHueSaturation(oldHue, oldSat, 1);
         }
     }
-    else if (cType == "xy")
+    else if (cType == ColorMode::XY)
     {
-        float oldX = light.state["state"]["xy"][0].get<float>();
-        float oldY = light.state["state"]["xy"][1].get<float>();
+        float oldX = state.xy.x;
+        float oldY = state.xy.y;
         if (!light.setColorTemperature(mired, 1))
         {
             return false;
@@ -121,9 +121,9 @@ bool ExtendedColorTemperatureStrategy::alertTemperature(unsigned int mired, HueL
             return light.setColorXY(oldX, oldY, 1);
         }
     }
-    else if (cType == "ct")
+    else if (cType == ColorMode::CT)
     {
-        uint16_t oldCT = light.state["state"]["ct"].get<uint16_t>();
+        uint16_t oldCT = state.ct;
         if (!light.setColorTemperature(mired, 1))
         {
             return false;
@@ -28,9 +28,12 @@
 #include <cstring>
 #include <iostream>
 #include <locale>
+#include <mutex>
+#include <shared_mutex>
 #include <stdexcept>
 #include <thread>
 
+#include "include/EmulatedColorTemperatureStrategy.h"
 #include "include/ExtendedColorHueStrategy.h"
 #include "include/ExtendedColorTemperatureStrategy.h"
 #include "include/HueExceptionMacro.h"
@@ -142,10 +145,43 @@ Hue::Hue(
       extendedColorHueStrategy(std::make_shared<ExtendedColorHueStrategy>()),
       simpleColorTemperatureStrategy(std::make_shared<SimpleColorTemperatureStrategy>()),
       extendedColorTemperatureStrategy(std::make_shared<ExtendedColorTemperatureStrategy>()),
+      emulatedColorTemperatureStrategy(std::make_shared<EmulatedColorTemperatureStrategy>()),
       http_handler(std::move(handler)),
       commands(ip, port, username, http_handler)
 {}
 
+Hue::Hue(const Hue& other) : Hue(other, std::shared_lock<SharedMutex>(other.stateMutex)) {}
+
+Hue::Hue(const Hue& other, const std::shared_lock<SharedMutex>& /*otherLock*/)
+    : ip(other.ip),
+      username(other.username),
+      port(other.port),
+      lightStates(other.lightStates),
+      diffState(other.diffState),
+      lights(other.lights),
+      simpleBrightnessStrategy(other.simpleBrightnessStrategy),
+      simpleColorHueStrategy(other.simpleColorHueStrategy),
+      extendedColorHueStrategy(other.extendedColorHueStrategy),
+      simpleColorTemperatureStrategy(other.simpleColorTemperatureStrategy),
+      extendedColorTemperatureStrategy(other.extendedColorTemperatureStrategy),
+      emulatedColorTemperatureStrategy(other.emulatedColorTemperatureStrategy),
+      http_handler(other.http_handler),
+      commands(other.commands),
+      stateDiff(other.stateDiff)
+{}
+
+Hue& Hue::operator=(const Hue& other)
+{
+    if (this != &other)
+    {
+        // Copying first means the two locks are never held at once
+        Hue copy(other);
+        std::lock_guard<SharedMutex> lock(stateMutex);
+        *this = std::move(copy);
+    }
+    return *this;
+}
+
 std::string Hue::getBridgeIP()
 {
     return ip;
@@ -222,73 +258,40 @@ void Hue::setPort(const int port)
 
 HueLight& Hue::getLight(int id)
 {
-    auto pos = lights.find(id);
-    if (pos != lights.end())
-    {
-        pos->second.refreshState();
-        return pos->second;
-    }
-    refreshState();
-    if (!state["lights"].count(std::to_string(id)))
-    {
-        std::cerr << "Error in Hue getLight(): light with id " << id << " is not valid\n";
-        throw HueException(CURRENT_FILE_INFO, "Light id is not valid");
-    }
-    // std::cout << state["lights"][std::to_string(id)] << std::endl;
-    std::string type = state["lights"][std::to_string(id)]["modelid"].get<std::string>();
-    // std::cout << type << std::endl;
-    if (type == "LCT001" || type == "LCT002" || type == "LCT003" || type == "LCT007" || type == "LLM001")
+    LightInfo lightState;
+    bool found = false;
     {
-        // HueExtendedColorLight Gamut B
-        HueLight light = HueLight(
-            id, commands, simpleBrightnessStrategy, extendedColorTemperatureStrategy, extendedColorHueStrategy);
-        light.colorType = ColorType::GAMUT_B;
-        lights.emplace(id, light);
-        return lights.find(id)->second;
-    }
-    else if (type == "LCT010" || type == "LCT011" || type == "LCT012" || type == "LCT014" || type == "LCT015"
-        || type == "LCT016" || type == "LLC020" || type == "LST002")
-    {
-        // HueExtendedColorLight Gamut C
-        HueLight light = HueLight(
-            id, commands, simpleBrightnessStrategy, extendedColorTemperatureStrategy, extendedColorHueStrategy);
-        light.colorType = ColorType::GAMUT_C;
-        lights.emplace(id, light);
-        return lights.find(id)->second;
-    }
-    else if (type == "LST001" || type == "LLC005" || type == "LLC006" || type == "LLC007" || type == "LLC010"
-        || type == "LLC011" || type == "LLC012" || type == "LLC013" || type == "LLC014")
-    {
-        // HueColorLight Gamut A
-        HueLight light = HueLight(id, commands, simpleBrightnessStrategy, nullptr, simpleColorHueStrategy);
-        light.colorType = ColorType::GAMUT_A;
-        lights.emplace(id, light);
-        return lights.find(id)->second;
+        std::shared_lock<SharedMutex> lock(stateMutex);
+        auto pos = lights.find(id);
+        if (pos != lights.end())
+        {
+            return pos->second;
+        }
+        auto statePos = lightStates.find(id);
+        if (statePos != lightStates.end())
+        {
+            lightState = statePos->second;
+            found = true;
+        }
     }
-    else if (type == "LWB004" || type == "LWB006" || type == "LWB007" || type == "LWB010" || type == "LWB014"
-        || type == "LDF001" || type == "LDF002" || type == "LDD001" || type == "LDD002" || type == "MWM001")
+    if (!found)
     {
-        // HueDimmableLight No Color Type
-        HueLight light = HueLight(id, commands, simpleBrightnessStrategy, nullptr, nullptr);
-        light.colorType = ColorType::NONE;
-        lights.emplace(id, light);
-        return lights.find(id)->second;
+        // Light may have been added since the last refresh
+        refreshState();
+        std::shared_lock<SharedMutex> lock(stateMutex);
+        auto statePos = lightStates.find(id);
+        if (statePos != lightStates.end())
+        {
+            lightState = statePos->second;
+            found = true;
+        }
     }
-    else if (type == "LLM010" || type == "LLM011" || type == "LLM012" || type == "LTW001" || type == "LTW004"
-        || type == "LTW010" || type == "LTW011" || type == "LTW012" || type == "LTW013" || type == "LTW014"
-        || type == "LTW015" || type == "LTP001" || type == "LTP002" || type == "LTP003" || type == "LTP004"
-        || type == "LTP005" || type == "LTD003" || type == "LTF001" || type == "LTF002" || type == "LTC001"
-        || type == "LTC002" || type == "LTC003" || type == "LTC004" || type == "LTC011" || type == "LTC012"
-        || type == "LTD001" || type == "LTD002" || type == "LFF001" || type == "LTT001" || type == "LDT001")
+    if (!found)
     {
-        // HueTemperatureLight
-        HueLight light = HueLight(id, commands, simpleBrightnessStrategy, simpleColorTemperatureStrategy, nullptr);
-        light.colorType = ColorType::TEMPERATURE;
-        lights.emplace(id, light);
-        return lights.find(id)->second;
+        std::cerr << "Error in Hue getLight(): light with id " << id << " is not valid\n";
+        throw HueException(CURRENT_FILE_INFO, "Light id is not valid");
     }
-    std::cerr << "Could not determine HueLight type:" << type << "!\n";
-    throw HueException(CURRENT_FILE_INFO, "Could not determine HueLight type!");
+    return createLight(id, std::move(lightState));
 }
 
 bool Hue::removeLight(int id)
@@ -296,8 +299,9 @@ bool Hue::removeLight(int id)
     nlohmann::json result
         = commands.DELETERequest("/lights/" + std::to_string(id), nlohmann::json::object(), CURRENT_FILE_INFO);
     bool success = utils::safeGetMember(result, 0, "success") == "/lights/" + std::to_string(id) + " deleted";
-    if (success && lights.count(id) != 0)
+    if (success)
     {
+        std::lock_guard<SharedMutex> lock(stateMutex);
         lights.erase(id);
     }
     return success;
@@ -306,12 +310,29 @@ bool Hue::removeLight(int id)
 std::vector<std::reference_wrapper<HueLight>> Hue::getAllLights()
 {
     refreshState();
-    nlohmann::json lightsState = state["lights"];
-    for (nlohmann::json::iterator it = lightsState.begin(); it != lightsState.end(); ++it)
+    std::map<int, LightInfo> lightsState;
     {
-        getLight(std::stoi(it.key()));
+        std::shared_lock<SharedMutex> lock(stateMutex);
+        lightsState = lightStates;
+    }
+    for (auto& entry : lightsState)
+    {
+        LightInfo& lightState = entry.second;
+        std::shared_lock<SharedMutex> lock(stateMutex);
+        auto pos = lights.find(entry.first);
+        if (pos != lights.end())
+        {
+            // Cached lights are updated from the same request
+            pos->second.applyState(std::move(lightState.text), lightState);
+        }
+        else
+        {
+            lock.unlock();
+            createLight(entry.first, std::move(lightState));
+        }
     }
     std::vector<std::reference_wrapper<HueLight>> result;
+    std::shared_lock<SharedMutex> lock(stateMutex);
     for (auto& entry : lights)
     {
         result.emplace_back(entry.second);
@@ -322,35 +343,25 @@ std::vector<std::reference_wrapper<HueLight>> Hue::getAllLights()
 bool Hue::lightExists(int id)
 {
     refreshState();
-    auto pos = lights.find(id);
-    if (pos != lights.end())
-    {
-        return true;
-    }
-    if (state["lights"].count(std::to_string(id)))
-    {
-        return true;
-    }
-    return false;
+    const Hue& constThis = *this;
+    return constThis.lightExists(id);
 }
 
 bool Hue::lightExists(int id) const
 {
+    std::shared_lock<SharedMutex> lock(stateMutex);
     auto pos = lights.find(id);
     if (pos != lights.end())
     {
         return true;
     }
-    if (state["lights"].count(std::to_string(id)))
-    {
-        return true;
-    }
-    return false;
+    return lightStates.count(id) != 0;
 }
 
 std::string Hue::getPictureOfLight(int id) const
 {
     std::string ret = "";
+    std::shared_lock<SharedMutex> lock(stateMutex);
     auto pos = lights.find(id);
     if (pos != lights.end())
     {
@@ -483,21 +494,215 @@ std::string Hue::getPictureOfModel(const std::string& model_id) const
     return ret;
 }
 
+BridgeSnapshot Hue::createSnapshot() const
+{
+    BridgeSnapshot snapshot;
+    snapshot.ip = ip;
+    snapshot.port = port;
+    snapshot.username = username;
+    std::shared_lock<SharedMutex> lock(stateMutex);
+    for (const auto& entry : lights)
+    {
+        const HueLight& light = entry.second;
+        snapshot.lights.push_back(
+            BridgeSnapshot::Light{light.getId(), light.getModelId(), light.getColorType(), light.getRawState()});
+    }
+    return snapshot;
+}
+
+void Hue::restoreSnapshot(const BridgeSnapshot& snapshot)
+{
+    ip = snapshot.ip;
+    port = snapshot.port;
+    username = snapshot.username;
+    commands = HueCommandAPI(ip, port, username, http_handler);
+    std::map<uint8_t, HueLight> restoredLights;
+    std::map<int, LightInfo> lightsState;
+    for (const BridgeSnapshot::Light& entry : snapshot.lights)
+    {
+        std::string text = entry.state.dump();
+        LightInfo lightState = LightStateParser::parseLight(text);
+        lightState.id = entry.id;
+        lightState.text = std::move(text);
+        HueLight light(entry.id, commands, lightState);
+        setLightType(light, entry.colorType);
+        restoredLights.emplace(entry.id, std::move(light));
+        lightsState.emplace(entry.id, std::move(lightState));
+    }
+    std::lock_guard<SharedMutex> lock(stateMutex);
+    lights = std::move(restoredLights);
+    lightStates = std::move(lightsState);
+    diffState = nullptr;
+}
+
+void Hue::reconcile()
+{
+    refreshState();
+    std::lock_guard<SharedMutex> lock(stateMutex);
+    // Unknown models are rejected before any light is changed
+    for (const auto& entry : lights)
+    {
+        auto lightIt = lightStates.find(entry.first);
+        if (lightIt != lightStates.end() && lightIt->second.modelId != entry.second.getModelId())
+        {
+            getKnownColorTypeOfModel(lightIt->second.modelId);
+        }
+    }
+    for (auto it = lights.begin(); it != lights.end();)
+    {
+        auto lightIt = lightStates.find(it->first);
+        if (lightIt == lightStates.end())
+        {
+            // Light was removed while the snapshot was stored
+            it = lights.erase(it);
+            continue;
+        }
+        HueLight& light = it->second;
+        LightInfo lightState = lightIt->second;
+        if (lightState.modelId != light.getModelId())
+        {
+            // Light was replaced by a different model with the same id
+            setLightType(light, getKnownColorTypeOfModel(lightState.modelId));
+        }
+        light.applyState(std::move(lightState.text), lightState);
+        ++it;
+    }
+}
+
+HueLight& Hue::createLight(int id, LightInfo lightState)
+{
+    ColorType colorType = getKnownColorTypeOfModel(lightState.modelId);
+    HueLight light = HueLight(id, commands, lightState);
+    setLightType(light, colorType);
+    std::lock_guard<SharedMutex> lock(stateMutex);
+    // If another thread created the light in the meantime, that one is returned
+    return lights.emplace(id, std::move(light)).first->second;
+}
+
+ColorType Hue::getColorTypeOfModel(const std::string& type)
+{
+    if (type == "LCT001" || type == "LCT002" || type == "LCT003" || type == "LCT007" || type == "LLM001")
+    {
+        // HueExtendedColorLight Gamut B
+        return ColorType::GAMUT_B;
+    }
+    else if (type == "LCT010" || type == "LCT011" || type == "LCT012" || type == "LCT014" || type == "LCT015"
+        || type == "LCT016" || type == "LLC020" || type == "LST002")
+    {
+        // HueExtendedColorLight Gamut C
+        return ColorType::GAMUT_C;
+    }
+    else if (type == "LST001" || type == "LLC005" || type == "LLC006" || type == "LLC007" || type == "LLC010"
+        || type == "LLC011" || type == "LLC012" || type == "LLC013" || type == "LLC014")
+    {
+        // HueColorLight Gamut A
+        return ColorType::GAMUT_A;
+    }
+    else if (type == "LWB004" || type == "LWB006" || type == "LWB007" || type == "LWB010" || type == "LWB014"
+        || type == "LDF001" || type == "LDF002" || type == "LDD001" || type == "LDD002" || type == "MWM001")
+    {
+        // HueDimmableLight No Color Type
+        return ColorType::NONE;
+    }
+    else if (type == "LLM010" || type == "LLM011" || type == "LLM012" || type == "LTW001" || type == "LTW004"
+        || type == "LTW010" || type == "LTW011" || type == "LTW012" || type == "LTW013" || type == "LTW014"
+        || type == "LTW015" || type == "LTP001" || type == "LTP002" || type == "LTP003" || type == "LTP004"
+        || type == "LTP005" || type == "LTD003" || type == "LTF001" || type == "LTF002" || type == "LTC001"
+        || type == "LTC002" || type == "LTC003" || type == "LTC004" || type == "LTC011" || type == "LTC012"
+        || type == "LTD001" || type == "LTD002" || type == "LFF001" || type == "LTT001" || type == "LDT001")
+    {
+        // HueTemperatureLight
+        return ColorType::TEMPERATURE;
+    }
+    return ColorType::UNDEFINED;
+}
+
+ColorType Hue::getKnownColorTypeOfModel(const std::string& modelId)
+{
+    ColorType colorType = getColorTypeOfModel(modelId);
+    if (colorType == ColorType::UNDEFINED)
+    {
+        std::cerr << "Could not determine HueLight type:" << modelId << "!\n";
+        throw HueException(CURRENT_FILE_INFO, "Could not determine HueLight type!");
+    }
+    return colorType;
+}
+
+void Hue::setLightType(HueLight& light, ColorType colorType) const
+{
+    std::shared_ptr<const BrightnessStrategy> brightness;
+    std::shared_ptr<const ColorTemperatureStrategy> colorTemperature;
+    std::shared_ptr<const ColorHueStrategy> colorHue;
+    switch (colorType)
+    {
+    case ColorType::GAMUT_B:
+    case ColorType::GAMUT_C:
+        brightness = simpleBrightnessStrategy;
+        colorTemperature = extendedColorTemperatureStrategy;
+        colorHue = extendedColorHueStrategy;
+        break;
+    case ColorType::GAMUT_A:
+        brightness = simpleBrightnessStrategy;
+        colorTemperature = emulatedColorTemperatureStrategy;
+        colorHue = simpleColorHueStrategy;
+        break;
+    case ColorType::NONE:
+        brightness = simpleBrightnessStrategy;
+        break;
+    case ColorType::TEMPERATURE:
+        brightness = simpleBrightnessStrategy;
+        colorTemperature = simpleColorTemperatureStrategy;
+        break;
+    default:
+        break;
+    }
+    // The light may be used by other threads while reconcile changes its type, so all members change at once
+    std::lock_guard<SharedMutex> lock(light.stateMutex);
+    light.colorType = colorType;
+    light.brightnessStrategy = std::move(brightness);
+    light.colorTemperatureStrategy = std::move(colorTemperature);
+    light.colorHueStrategy = std::move(colorHue);
+}
+
 void Hue::refreshState()
 {
     if (username.empty())
     {
         return;
     }
-    nlohmann::json answer = commands.GETRequest("", nlohmann::json::object(), CURRENT_FILE_INFO);
-    if (answer.is_object() && answer.count("lights"))
+    std::string answer = commands.GETRaw("");
+    bool hasLights = false;
+    std::vector<LightInfo> parsed = LightStateParser::parseBridgeState(answer, hasLights);
+    if (hasLights)
     {
-        state = answer;
+        std::map<int, LightInfo> lightsState;
+        for (LightInfo& lightState : parsed)
+        {
+            lightsState.emplace(lightState.id, std::move(lightState));
+        }
+        // The json tree is only needed to compare it with the next state
+        nlohmann::json answerJson;
+        if (stateDiff.hasSubscribers())
+        {
+            answerJson = nlohmann::json::parse(answer);
+        }
+        std::vector<StateChange> changes;
+        {
+            std::lock_guard<SharedMutex> lock(stateMutex);
+            if (!diffState.is_null() && !answerJson.is_null())
+            {
+                changes = StateDiff::compare(diffState, answerJson);
+            }
+            lightStates = std::move(lightsState);
+            diffState = std::move(answerJson);
+        }
+        // Subscribers are notified without holding the lock, so they can use the bridge
+        stateDiff.notify(changes);
     }
     else
     {
-        std::cout << "Answer in Hue::refreshState of http_handler->GETJson(...) is "
+        std::cout << "Answer in Hue::refreshState of http_handler->GETRaw(...) is "
                      "not expected!\nAnswer:\n\t"
-                  << answer.dump() << std::endl;
+                  << answer << std::endl;
     }
 }
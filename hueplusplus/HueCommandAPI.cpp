@@ -32,8 +32,8 @@ namespace
 {
     // Runs functor with appropriate timeout and retries when timed out or connection reset
     template <typename Timeout, typename Fun>
-    nlohmann::json RunWithTimeout(
-        std::shared_ptr<Timeout> timeout, std::chrono::steady_clock::duration minDelay, Fun fun)
+    auto RunWithTimeout(std::shared_ptr<Timeout> timeout, std::chrono::steady_clock::duration minDelay, Fun fun)
+        -> decltype(fun())
     {
         auto now = std::chrono::steady_clock::now();
         std::lock_guard<std::mutex> lock(timeout->mutex);
@@ -43,7 +43,7 @@ namespace
         }
         try
         {
-            nlohmann::json response = fun();
+            auto response = fun();
             timeout->timeout = now + minDelay;
             return response;
         }
@@ -53,7 +53,7 @@ namespace
             {
                 // Happens when hue is too busy, wait and try again (once)
                 std::this_thread::sleep_for(minDelay);
-                nlohmann::json v = fun();
+                auto v = fun();
                 timeout->timeout = std::chrono::steady_clock::now() + minDelay;
                 return v;
             }
@@ -61,13 +61,77 @@ namespace
             throw;
         }
     }
+
+    // Returns the object containing the "error" member or nullptr if response is no error
+    template <typename Json>
+    const Json* FindError(const Json& response)
+    {
+        if (response.count("error"))
+        {
+            return &response;
+        }
+        else if (response.is_array() && response.size() > 0 && response[0].count("error"))
+        {
+            return &response[0];
+        }
+        return nullptr;
+    }
+
+    // Throws an exception if response contains an error, like HueCommandAPI::HandleError
+    void HandleArenaError(FileInfo fileInfo, const ArenaJson& response)
+    {
+        const ArenaJson* error = FindError(response);
+        if (error)
+        {
+            // Only happens on errors, so the conversion does not matter
+            throw HueAPIResponseException::Create(std::move(fileInfo), nlohmann::json::parse(error->dump()));
+        }
+    }
+
+    // Like RunWithTimeout, but failures of the request are returned instead of thrown
+    template <typename Timeout, typename Fun>
+    auto TryRunWithTimeout(
+        FileInfo fileInfo, std::shared_ptr<Timeout> timeout, std::chrono::steady_clock::duration minDelay, Fun fun)
+        -> Result<decltype(fun())>
+    {
+        try
+        {
+            return RunWithTimeout(std::move(timeout), minDelay, fun);
+        }
+        catch (const std::system_error& e)
+        {
+            return HueError(fileInfo, e.code(), e.what(), std::current_exception());
+        }
+        catch (const HueException& e)
+        {
+            return HueError(fileInfo, e.what());
+        }
+        catch (const nlohmann::json::exception& e)
+        {
+            return HueError(fileInfo, e.what());
+        }
+    }
+
+    // Returns the response or the error it contains
+    Result<nlohmann::json> CheckError(FileInfo fileInfo, Result<nlohmann::json> response)
+    {
+        if (response.ok())
+        {
+            const nlohmann::json* error = FindError(response.get());
+            if (error)
+            {
+                return HueError::fromResponse(fileInfo, *error);
+            }
+        }
+        return response;
+    }
 } // namespace
 
 HueCommandAPI::HueCommandAPI(
     const std::string& ip, const int port, const std::string& username, std::shared_ptr<const IHttpHandler> httpHandler)
     : ip(ip),
       port(port),
-      username(username),
+      apiPrefix("/api/" + username),
       httpHandler(std::move(httpHandler)),
       timeout(new TimeoutData{std::chrono::steady_clock::now(), {}})
 {}
@@ -84,6 +148,59 @@ nlohmann::json HueCommandAPI::PUTRequest(
         RunWithTimeout(timeout, minDelay, [&]() { return httpHandler->PUTJson(CombinedPath(path), request, ip); }));
 }
 
+utils::ReplyValidation HueCommandAPI::PUTRequest(
+    const std::string& path, const StateRequest& request, FileInfo fileInfo) const
+{
+    thread_local std::string body;
+    thread_local JsonArena arena;
+    request.serialize(body);
+    const std::string response
+        = RunWithTimeout(timeout, minDelay, [&]() { return httpHandler->PUTRaw(CombinedPath(path), body, ip); });
+
+    // Reply must be destroyed before the scope resets the arena
+    JsonArena::Scope scope(arena);
+    const ArenaJson reply = ArenaJson::parse(response);
+    HandleArenaError(std::move(fileInfo), reply);
+    return utils::validateReply(request, reply, path);
+}
+
+Result<nlohmann::json> HueCommandAPI::tryPUTRequest(
+    const std::string& path, const nlohmann::json& request, FileInfo fileInfo) const
+{
+    return CheckError(fileInfo, TryRunWithTimeout(fileInfo, timeout, minDelay, [&]() {
+        return httpHandler->PUTJson(CombinedPath(path), request, ip);
+    }));
+}
+
+Result<utils::ReplyValidation> HueCommandAPI::tryPUTRequest(
+    const std::string& path, const StateRequest& request, FileInfo fileInfo) const
+{
+    thread_local std::string body;
+    thread_local JsonArena arena;
+    request.serialize(body);
+    Result<std::string> response = TryRunWithTimeout(
+        fileInfo, timeout, minDelay, [&]() { return httpHandler->PUTRaw(CombinedPath(path), body, ip); });
+    if (!response.ok())
+    {
+        return response.getError();
+    }
+
+    // Reply must be destroyed before the scope resets the arena
+    JsonArena::Scope scope(arena);
+    const ArenaJson reply = ArenaJson::parse(response.get(), nullptr, false);
+    if (reply.is_discarded())
+    {
+        return HueError(fileInfo, "Failed to parse response");
+    }
+    const ArenaJson* error = FindError(reply);
+    if (error)
+    {
+        // Only happens on errors, so the conversion does not matter
+        return HueError::fromResponse(fileInfo, nlohmann::json::parse(error->dump()));
+    }
+    return utils::validateReply(request, reply, path);
+}
+
 nlohmann::json HueCommandAPI::GETRequest(const std::string& path, const nlohmann::json& request) const
 {
     return GETRequest(path, request, CURRENT_FILE_INFO);
@@ -96,6 +213,25 @@ nlohmann::json HueCommandAPI::GETRequest(
         RunWithTimeout(timeout, minDelay, [&]() { return httpHandler->GETJson(CombinedPath(path), request, ip); }));
 }
 
+Result<nlohmann::json> HueCommandAPI::tryGETRequest(
+    const std::string& path, const nlohmann::json& request, FileInfo fileInfo) const
+{
+    return CheckError(fileInfo, TryRunWithTimeout(fileInfo, timeout, minDelay, [&]() {
+        return httpHandler->GETJson(CombinedPath(path), request, ip);
+    }));
+}
+
+std::string HueCommandAPI::GETRaw(const std::string& path) const
+{
+    return RunWithTimeout(timeout, minDelay, [&]() { return httpHandler->GETRaw(CombinedPath(path), "{}", ip); });
+}
+
+Result<std::string> HueCommandAPI::tryGETRaw(const std::string& path, FileInfo fileInfo) const
+{
+    return TryRunWithTimeout(
+        fileInfo, timeout, minDelay, [&]() { return httpHandler->GETRaw(CombinedPath(path), "{}", ip); });
+}
+
 nlohmann::json HueCommandAPI::DELETERequest(const std::string& path, const nlohmann::json& request) const
 {
     return DELETERequest(path, request, CURRENT_FILE_INFO);
@@ -108,23 +244,29 @@ nlohmann::json HueCommandAPI::DELETERequest(
         RunWithTimeout(timeout, minDelay, [&]() { return httpHandler->DELETEJson(CombinedPath(path), request, ip); }));
 }
 
-nlohmann::json HueCommandAPI::HandleError(FileInfo fileInfo, const nlohmann::json& response) const
+Result<nlohmann::json> HueCommandAPI::tryDELETERequest(
+    const std::string& path, const nlohmann::json& request, FileInfo fileInfo) const
 {
-    if (response.count("error"))
-    {
-        throw HueAPIResponseException::Create(std::move(fileInfo), response);
-    }
-    else if (response.is_array() && response.size() > 0 && response[0].count("error"))
+    return CheckError(fileInfo, TryRunWithTimeout(fileInfo, timeout, minDelay, [&]() {
+        return httpHandler->DELETEJson(CombinedPath(path), request, ip);
+    }));
+}
+
+nlohmann::json HueCommandAPI::HandleError(FileInfo fileInfo, nlohmann::json response) const
+{
+    const nlohmann::json* error = FindError(response);
+    if (error)
     {
-        throw HueAPIResponseException::Create(std::move(fileInfo), response[0]);
+        throw HueAPIResponseException::Create(std::move(fileInfo), *error);
     }
     return response;
 }
 
 std::string HueCommandAPI::CombinedPath(const std::string& path) const
 {
-    std::string result = "/api/";
-    result.append(username);
+    std::string result;
+    result.reserve(apiPrefix.size() + path.size() + 1);
+    result.append(apiPrefix);
     // If path does not begin with '/', insert it unless it is empty
     if (!path.empty() && path.front() != '/')
     {
@@ -90,11 +90,11 @@ std::string HueAPIResponseException::GetMessage(int error, const std::string& ad
 
 std::string FileInfo::ToString() const
 {
-    if (filename.empty() || line < 0)
+    if (filename == nullptr || line < 0)
     {
         return "Unknown file";
     }
-    std::string result = func;
+    std::string result = func != nullptr ? func : "";
     result.append(" in ");
     result.append(filename);
     result.append(":");
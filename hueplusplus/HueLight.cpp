@@ -24,12 +24,27 @@
 
 #include <cmath>
 #include <iostream>
+#include <mutex>
+#include <shared_mutex>
 #include <thread>
 
+#include "include/ColorConversion.h"
 #include "include/HueExceptionMacro.h"
+#include "include/NumberFormat.h"
 #include "include/Utils.h"
 #include "include/json/json.hpp"
 
+namespace
+{
+    std::string lightPath(int id, const char* subPath)
+    {
+        std::string result = "/lights/";
+        utils::appendInt(result, id);
+        result.append(subPath);
+        return result;
+    }
+} // namespace
+
 bool HueLight::On(uint8_t transition)
 {
     refreshState();
@@ -45,12 +60,23 @@ bool HueLight::Off(uint8_t transition)
 bool HueLight::isOn()
 {
     refreshState();
-    return state["state"]["on"].get<bool>();
+    return getState().on;
 }
 
 bool HueLight::isOn() const
 {
-    return state["state"]["on"].get<bool>();
+    return getState().on;
+}
+
+RGB HueLight::getColorRGB() const
+{
+    return ColorConversion::stateToRGB(getState());
+}
+
+RGB HueLight::getColorRGB()
+{
+    refreshState();
+    return ColorConversion::stateToRGB(getState());
 }
 
 int HueLight::getId() const
@@ -60,70 +86,64 @@ int HueLight::getId() const
 
 std::string HueLight::getType() const
 {
-    return state["type"].get<std::string>();
+    std::shared_lock<SharedMutex> lock(stateMutex);
+    return fields.getString(LightField::TYPE);
 }
 
 std::string HueLight::getName()
 {
     refreshState();
-    return state["name"].get<std::string>();
+    std::shared_lock<SharedMutex> lock(stateMutex);
+    return fields.getString(LightField::NAME);
 }
 
 std::string HueLight::getName() const
 {
-    return state["name"].get<std::string>();
+    std::shared_lock<SharedMutex> lock(stateMutex);
+    return fields.getString(LightField::NAME);
 }
 
 std::string HueLight::getModelId() const
 {
-    return state["modelid"].get<std::string>();
+    std::shared_lock<SharedMutex> lock(stateMutex);
+    return fields.getString(LightField::MODELID);
 }
 
 std::string HueLight::getUId() const
 {
-    if (state.count("uniqueid"))
-    {
-        return state["uniqueid"].get<std::string>();
-    }
-    return std::string();
+    std::shared_lock<SharedMutex> lock(stateMutex);
+    return fields.getString(LightField::UNIQUEID);
 }
 
 std::string HueLight::getManufacturername() const
 {
-    if (state.count("manufacturername"))
-    {
-        return state["manufacturername"].get<std::string>();
-    }
-    return std::string();
+    std::shared_lock<SharedMutex> lock(stateMutex);
+    return fields.getString(LightField::MANUFACTURERNAME);
 }
 
 std::string HueLight::getProductname() const
 {
-    if (state.count("productname"))
-    {
-        return state["productname"].get<std::string>();
-    }
-    return std::string();
+    std::shared_lock<SharedMutex> lock(stateMutex);
+    return fields.getString(LightField::PRODUCTNAME);
 }
 
 std::string HueLight::getLuminaireUId() const
 {
-    if (state.count("luminaireuniqueid"))
-    {
-        return state["luminaireuniqueid"].get<std::string>();
-    }
-    return std::string();
+    std::shared_lock<SharedMutex> lock(stateMutex);
+    return fields.getString(LightField::LUMINAIREUNIQUEID);
 }
 
 std::string HueLight::getSwVersion()
 {
     refreshState();
-    return state["swversion"].get<std::string>();
+    std::shared_lock<SharedMutex> lock(stateMutex);
+    return fields.getString(LightField::SWVERSION);
 }
 
 std::string HueLight::getSwVersion() const
 {
-    return state["swversion"].get<std::string>();
+    std::shared_lock<SharedMutex> lock(stateMutex);
+    return fields.getString(LightField::SWVERSION);
 }
 
 bool HueLight::setName(const std::string& name)
@@ -133,32 +153,131 @@ bool HueLight::setName(const std::string& name)
     nlohmann::json reply = SendPutRequest(request, "/name", CURRENT_FILE_INFO);
 
     // Check whether request was successful
-    return utils::safeGetMember(reply, 0, "success", "/lights/" + std::to_string(id) + "/name") == name;
+    return utils::safeGetMember(reply, 0, "success", path + "/name") == name;
+}
+
+LightState HueLight::getState() const
+{
+    std::shared_lock<SharedMutex> lock(stateMutex);
+    return state;
+}
+
+nlohmann::json HueLight::getRawState() const
+{
+    std::shared_lock<SharedMutex> lock(stateMutex);
+    return fields.getJson();
+}
+
+nlohmann::json HueLight::getField(LightField field) const
+{
+    std::shared_lock<SharedMutex> lock(stateMutex);
+    return fields.get(field);
 }
 
 ColorType HueLight::getColorType() const
 {
+    std::shared_lock<SharedMutex> lock(stateMutex);
     return colorType;
 }
 
+std::shared_ptr<const BrightnessStrategy> HueLight::loadBrightnessStrategy() const
+{
+    std::shared_lock<SharedMutex> lock(stateMutex);
+    return brightnessStrategy;
+}
+
+std::shared_ptr<const ColorTemperatureStrategy> HueLight::loadColorTemperatureStrategy() const
+{
+    std::shared_lock<SharedMutex> lock(stateMutex);
+    return colorTemperatureStrategy;
+}
+
+std::shared_ptr<const ColorHueStrategy> HueLight::loadColorHueStrategy() const
+{
+    std::shared_lock<SharedMutex> lock(stateMutex);
+    return colorHueStrategy;
+}
+
 unsigned int HueLight::KelvinToMired(unsigned int kelvin) const
 {
-    return int(0.5f + (1000000 / kelvin));
+    // Integer only, so it is cheap on embedded platforms without floating point unit
+    return kelvin ? 1000000u / kelvin : 0;
 }
 
 unsigned int HueLight::MiredToKelvin(unsigned int mired) const
 {
-    return int(0.5f + (1000000 / mired));
+    return mired ? 1000000u / mired : 0;
 }
 
 bool HueLight::alert()
 {
-    nlohmann::json request;
-    request["alert"] = "select";
+    StateRequest request;
+    request.setAlert(Alert::SELECT);
+
+    // Check whether request was successful
+    return SendStateRequest(request, CURRENT_FILE_INFO).isSuccess();
+}
 
-    nlohmann::json reply = SendPutRequest(request, "/state", CURRENT_FILE_INFO);
+Result<utils::ReplyValidation> HueLight::trySetState(const StateRequest& request)
+{
+    const std::shared_ptr<DeadbandFilter> filter = getDeadbandFilter();
+    if (filter)
+    {
+        StateRequest filtered = request;
+        if (!filter->apply(filtered, getState()))
+        {
+            return utils::ReplyValidation();
+        }
+        Result<utils::ReplyValidation> result = commands.tryPUTRequest(statePath, filtered, CURRENT_FILE_INFO);
+        if (result.ok())
+        {
+            applyAccepted(filtered, result.get());
+        }
+        return result;
+    }
+    Result<utils::ReplyValidation> result = commands.tryPUTRequest(statePath, request, CURRENT_FILE_INFO);
+    if (result.ok())
+    {
+        applyAccepted(request, result.get());
+    }
+    return result;
+}
 
-    return utils::validateReplyForLight(request, reply, id);
+void HueLight::setDeadbandFilter(std::shared_ptr<DeadbandFilter> filter)
+{
+    std::lock_guard<SharedMutex> lock(stateMutex);
+    deadbandFilter = std::move(filter);
+}
+
+std::shared_ptr<DeadbandFilter> HueLight::getDeadbandFilter() const
+{
+    std::shared_lock<SharedMutex> lock(stateMutex);
+    return deadbandFilter;
+}
+
+Result<void> HueLight::tryRefreshState()
+{
+    Result<std::string> answer = commands.tryGETRaw(path, CURRENT_FILE_INFO);
+    if (!answer.ok())
+    {
+        return answer.getError();
+    }
+    try
+    {
+        if (!applyState(std::move(answer.get())))
+        {
+            return HueError(CURRENT_FILE_INFO, "Response has no state");
+        }
+    }
+    catch (const HueAPIResponseException& e)
+    {
+        return HueError(CURRENT_FILE_INFO, e.GetErrorNumber(), e.GetAddress(), e.GetDescription());
+    }
+    catch (const nlohmann::json::exception& e)
+    {
+        return HueError(CURRENT_FILE_INFO, e.what());
+    }
+    return Result<void>();
 }
 
 HueLight::HueLight(int id, const HueCommandAPI& commands) : HueLight(id, commands, nullptr, nullptr, nullptr) {}
@@ -167,6 +286,8 @@ HueLight::HueLight(int id, const HueCommandAPI& commands, std::shared_ptr<const
     std::shared_ptr<const ColorTemperatureStrategy> colorTempStrategy,
     std::shared_ptr<const ColorHueStrategy> colorHueStrategy)
     : id(id),
+      path(lightPath(id, "")),
+      statePath(lightPath(id, "/state")),
       brightnessStrategy(std::move(brightnessStrategy)),
       colorTemperatureStrategy(std::move(colorTempStrategy)),
       colorHueStrategy(std::move(colorHueStrategy)),
@@ -176,57 +297,130 @@ HueLight::HueLight(int id, const HueCommandAPI& commands, std::shared_ptr<const
     refreshState();
 }
 
+HueLight::HueLight(int id, const HueCommandAPI& commands, LightInfo initialState)
+    : id(id),
+      path(lightPath(id, "")),
+      statePath(lightPath(id, "/state")),
+      colorType(ColorType::UNDEFINED),
+      commands(commands)
+{
+    std::string text = std::move(initialState.text);
+    applyState(std::move(text), initialState);
+}
+
+HueLight::HueLight(const HueLight& other) : HueLight(other, std::shared_lock<SharedMutex>(other.stateMutex)) {}
+
+HueLight::HueLight(const HueLight& other, const std::shared_lock<SharedMutex>& /*otherLock*/)
+    : id(other.id),
+      path(other.path),
+      statePath(other.statePath),
+      state(other.state),
+      fields(other.fields),
+      colorType(other.colorType),
+      brightnessStrategy(other.brightnessStrategy),
+      colorTemperatureStrategy(other.colorTemperatureStrategy),
+      colorHueStrategy(other.colorHueStrategy),
+      commands(other.commands),
+      deadbandFilter(other.deadbandFilter)
+{}
+
+HueLight& HueLight::operator=(const HueLight& other)
+{
+    if (this != &other)
+    {
+        // Copying first means the two locks are never held at once
+        HueLight copy(other);
+        std::lock_guard<SharedMutex> lock(stateMutex);
+        *this = std::move(copy);
+    }
+    return *this;
+}
+
 bool HueLight::OnNoRefresh(uint8_t transition)
 {
-    nlohmann::json request = nlohmann::json::object();
+    StateRequest request;
     if (transition != 4)
     {
-        request["transitiontime"] = transition;
+        request.setTransition(transition);
     }
-    if (state["state"]["on"] != true)
+    if (!getState().on)
     {
-        request["on"] = true;
+        request.setOn(true);
     }
 
-    if (!request.count("on"))
+    if (!request.has(StateRequest::ON))
     {
         // Nothing needs to be changed
         return true;
     }
 
-    nlohmann::json reply = SendPutRequest(request, "/state", CURRENT_FILE_INFO);
-
     // Check whether request was successful
-    return utils::validateReplyForLight(request, reply, id);
+    return SendStateRequest(request, CURRENT_FILE_INFO).isSuccess();
 }
 
 bool HueLight::OffNoRefresh(uint8_t transition)
 {
-    nlohmann::json request = nlohmann::json::object();
+    StateRequest request;
     if (transition != 4)
     {
-        request["transitiontime"] = transition;
+        request.setTransition(transition);
     }
-    if (state["state"]["on"] != false)
+    const LightState current = getState();
+    if (!current.has(LightState::ON) || current.on)
     {
-        request["on"] = false;
+        request.setOn(false);
     }
 
-    if (!request.count("on"))
+    if (!request.has(StateRequest::ON))
     {
         // Nothing needs to be changed
         return true;
     }
 
-    nlohmann::json reply = SendPutRequest(request, "/state", CURRENT_FILE_INFO);
-
     // Check whether request was successful
-    return utils::validateReplyForLight(request, reply, id);
+    return SendStateRequest(request, CURRENT_FILE_INFO).isSuccess();
 }
 
 nlohmann::json HueLight::SendPutRequest(const nlohmann::json& request, const std::string& subPath, FileInfo fileInfo)
 {
-    return commands.PUTRequest("/lights/" + std::to_string(id) + subPath, request, std::move(fileInfo));
+    return commands.PUTRequest(path + subPath, request, std::move(fileInfo));
+}
+
+utils::ReplyValidation HueLight::SendStateRequest(const StateRequest& request, FileInfo fileInfo)
+{
+    const std::shared_ptr<DeadbandFilter> filter = getDeadbandFilter();
+    if (filter)
+    {
+        StateRequest filtered = request;
+        if (!filter->apply(filtered, getState()))
+        {
+            return utils::ReplyValidation();
+        }
+        const utils::ReplyValidation result = commands.PUTRequest(statePath, filtered, std::move(fileInfo));
+        applyAccepted(filtered, result);
+        return result;
+    }
+    const utils::ReplyValidation result = commands.PUTRequest(statePath, request, std::move(fileInfo));
+    applyAccepted(request, result);
+    return result;
+}
+
+void HueLight::applyAccepted(const StateRequest& request, const utils::ReplyValidation& result)
+{
+    if (result.unexpected)
+    {
+        return;
+    }
+    StateRequest accepted = request;
+    for (uint16_t field = 1; field <= StateRequest::TRANSITION; field <<= 1)
+    {
+        if (result.isMismatched(static_cast<StateRequest::Field>(field)))
+        {
+            accepted.remove(static_cast<StateRequest::Field>(field));
+        }
+    }
+    std::lock_guard<SharedMutex> lock(stateMutex);
+    accepted.applyTo(state);
 }
 
 void HueLight::refreshState()
@@ -234,19 +428,39 @@ void HueLight::refreshState()
     // std::chrono::steady_clock::time_point start =
     // std::chrono::steady_clock::now(); std::cout << "\tRefreshing lampstate of
     // lamp with id: " << id << ", ip: " << ip << "\n";
-    nlohmann::json answer
-        = commands.GETRequest("/lights/" + std::to_string(id), nlohmann::json::object(), CURRENT_FILE_INFO);
-    if (answer.count("state"))
+    std::string answer = commands.GETRaw(path);
+    LightInfo light = LightStateParser::parseLight(answer);
+    if (light.hasState)
     {
-        state = answer;
+        applyState(std::move(answer), light);
     }
     else
     {
         std::cout << "Answer in HueLight::refreshState of "
-                     "http_handler->GETJson(...) is not expected!\nAnswer:\n\t"
-                  << answer.dump() << std::endl;
+                     "http_handler->GETRaw(...) is not expected!\nAnswer:\n\t"
+                  << answer << std::endl;
     }
     // std::cout << "\tRefresh state took: " <<
     // std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now()
     // - start).count() << "ms" << std::endl;
 }
+
+bool HueLight::applyState(std::string lightState)
+{
+    LightInfo light = LightStateParser::parseLight(lightState);
+    return applyState(std::move(lightState), light);
+}
+
+bool HueLight::applyState(std::string lightState, LightInfo& light)
+{
+    if (!light.hasState)
+    {
+        return false;
+    }
+    LightFields resolved(std::move(lightState), light);
+    std::lock_guard<SharedMutex> lock(stateMutex);
+    state = light.state;
+    // Old reply is destroyed by resolved after the lock is released
+    fields.swap(resolved);
+    return true;
+}
@@ -0,0 +1,147 @@
+/**
+    \file JsonArena.cpp
+    Copyright Notice\n
+    Copyright (C) 2018  Jan Rogall		- developer\n
+    Copyright (C) 2018  Moritz Wirger	- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "include/JsonArena.h"
+
+#include <cstdlib>
+
+namespace
+{
+    thread_local JsonArena* currentArena = nullptr;
+
+    // Size of JsonArena::Block, rounded up so the data of each block is aligned like malloc
+    constexpr std::size_t blockHeaderSize = (sizeof(void*) + sizeof(std::size_t) + alignof(std::max_align_t) - 1)
+        / alignof(std::max_align_t) * alignof(std::max_align_t);
+
+    // Padding that is needed to align address
+    std::size_t getPadding(const char* address, std::size_t alignment)
+    {
+        return (alignment - reinterpret_cast<std::uintptr_t>(address) % alignment) % alignment;
+    }
+} // namespace
+
+JsonArena::Scope::Scope(JsonArena& arena) : arena(arena), previous(currentArena)
+{
+    currentArena = &arena;
+    ++arena.scopeCount;
+}
+
+JsonArena::Scope::~Scope()
+{
+    currentArena = previous;
+    // Allocations of enclosing scopes with the same arena are still in use
+    if (--arena.scopeCount == 0)
+    {
+        arena.reset();
+    }
+}
+
+JsonArena::JsonArena(std::size_t blockSize) : blockSize(blockSize) {}
+
+JsonArena::~JsonArena()
+{
+    while (blocks)
+    {
+        Block* next = blocks->next;
+        std::free(blocks);
+        blocks = next;
+    }
+}
+
+void* JsonArena::allocate(std::size_t size, std::size_t alignment)
+{
+    ++allocationCount;
+    if (blocks)
+    {
+        char* next = reinterpret_cast<char*>(blocks) + blockHeaderSize + offset;
+        const std::size_t padding = getPadding(next, alignment);
+        if (offset + padding + size <= blocks->size)
+        {
+            offset += padding + size;
+            return next + padding;
+        }
+    }
+    addBlock(size + alignment);
+    char* next = reinterpret_cast<char*>(blocks) + blockHeaderSize;
+    const std::size_t padding = getPadding(next, alignment);
+    offset = padding + size;
+    return next + padding;
+}
+
+bool JsonArena::owns(const void* p) const
+{
+    const char* address = static_cast<const char*>(p);
+    for (const Block* block = blocks; block; block = block->next)
+    {
+        const char* begin = reinterpret_cast<const char*>(block) + blockHeaderSize;
+        if (address >= begin && address < begin + block->size)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void JsonArena::reset()
+{
+    if (blocks)
+    {
+        // Keep the oldest block, it has the default size unless a larger allocation came first
+        while (blocks->next)
+        {
+            Block* next = blocks->next;
+            std::free(blocks);
+            blocks = next;
+        }
+    }
+    offset = 0;
+    allocationCount = 0;
+}
+
+std::size_t JsonArena::getBlockCount() const
+{
+    std::size_t count = 0;
+    for (const Block* block = blocks; block; block = block->next)
+    {
+        ++count;
+    }
+    return count;
+}
+
+JsonArena* JsonArena::current()
+{
+    return currentArena;
+}
+
+void JsonArena::addBlock(std::size_t size)
+{
+    const std::size_t capacity = size > blockSize ? size : blockSize;
+    void* memory = std::malloc(blockHeaderSize + capacity);
+    if (!memory)
+    {
+        throw std::bad_alloc();
+    }
+    Block* block = static_cast<Block*>(memory);
+    block->next = blocks;
+    block->size = capacity;
+    blocks = block;
+}
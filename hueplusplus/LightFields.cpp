@@ -0,0 +1,203 @@
+/**
+    \file LightFields.cpp
+    Copyright Notice\n
+    Copyright (C) 2017  Jan Rogall		- developer\n
+    Copyright (C) 2017  Moritz Wirger	- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "include/LightFields.h"
+
+namespace
+{
+    struct FieldPath
+    {
+        bool inState; //!< True if the member is part of the "state" object
+        const char* key;
+    };
+
+    // Must be in the same order as LightField
+    const FieldPath fieldPaths[] = {{false, "type"}, {false, "name"}, {false, "modelid"}, {false, "uniqueid"},
+        {false, "manufacturername"}, {false, "productname"}, {false, "luminaireuniqueid"}, {false, "swversion"},
+        {false, "state"}, {true, "on"}, {true, "bri"}, {true, "hue"}, {true, "sat"}, {true, "xy"}, {true, "ct"},
+        {true, "colormode"}, {true, "effect"}, {true, "alert"}, {true, "reachable"}};
+
+    const nlohmann::json* findMember(const nlohmann::json* object, const char* key)
+    {
+        if (object == nullptr || !object->is_object())
+        {
+            return nullptr;
+        }
+        auto it = object->find(key);
+        return it == object->end() ? nullptr : &*it;
+    }
+
+    std::string* getStringMember(LightInfo& light, LightField field)
+    {
+        switch (field)
+        {
+        case LightField::TYPE:
+            return &light.type;
+        case LightField::NAME:
+            return &light.name;
+        case LightField::MODELID:
+            return &light.modelId;
+        case LightField::UNIQUEID:
+            return &light.uniqueId;
+        case LightField::MANUFACTURERNAME:
+            return &light.manufacturerName;
+        case LightField::PRODUCTNAME:
+            return &light.productName;
+        case LightField::LUMINAIREUNIQUEID:
+            return &light.luminaireUniqueId;
+        case LightField::SWVERSION:
+            return &light.swVersion;
+        default:
+            return nullptr;
+        }
+    }
+} // namespace
+
+constexpr std::size_t LightFields::stringCount;
+
+LightFields::LightFields() : decoded(false) {}
+
+LightFields::LightFields(std::string reply) : LightFields()
+{
+    LightInfo light = LightStateParser::parseLight(reply);
+    LightFields parsed(std::move(reply), light);
+    swap(parsed);
+}
+
+LightFields::LightFields(std::string reply, LightInfo& light) : text(std::move(reply)), decoded(false)
+{
+    for (std::size_t i = 0; i < stringCount; ++i)
+    {
+        const LightField field = static_cast<LightField>(i);
+        if (isHot(field))
+        {
+            strings[i].swap(*getStringMember(light, field));
+        }
+    }
+}
+
+LightFields::LightFields(const LightFields& other) : text(other.text), decoded(false)
+{
+    for (std::size_t i = 0; i < stringCount; ++i)
+    {
+        if (isHot(static_cast<LightField>(i)))
+        {
+            strings[i] = other.strings[i];
+        }
+    }
+}
+
+LightFields::LightFields(LightFields&& other) noexcept : LightFields()
+{
+    swap(other);
+}
+
+LightFields& LightFields::operator=(const LightFields& other)
+{
+    LightFields copy(other);
+    swap(copy);
+    return *this;
+}
+
+LightFields& LightFields::operator=(LightFields&& other) noexcept
+{
+    LightFields moved(std::move(other));
+    swap(moved);
+    return *this;
+}
+
+bool LightFields::isHot(LightField field)
+{
+    switch (field)
+    {
+    case LightField::TYPE:
+    case LightField::NAME:
+    case LightField::MODELID:
+        return true;
+    default:
+        return false;
+    }
+}
+
+std::string LightFields::getString(LightField field) const
+{
+    const std::size_t i = static_cast<std::size_t>(field);
+    if (i >= stringCount)
+    {
+        return std::string();
+    }
+    if (!isHot(field))
+    {
+        decode();
+    }
+    return strings[i];
+}
+
+nlohmann::json LightFields::get(LightField field) const
+{
+    const nlohmann::json reply = getJson();
+    const FieldPath& path = fieldPaths[static_cast<std::size_t>(field)];
+    const nlohmann::json* member = findMember(path.inState ? findMember(&reply, "state") : &reply, path.key);
+    return member == nullptr ? nlohmann::json() : *member;
+}
+
+nlohmann::json LightFields::getJson() const
+{
+    if (text.empty())
+    {
+        return nlohmann::json();
+    }
+    return nlohmann::json::parse(text);
+}
+
+void LightFields::swap(LightFields& other) noexcept
+{
+    text.swap(other.text);
+    strings.swap(other.strings);
+    decoded = other.decoded.exchange(decoded);
+}
+
+void LightFields::decode() const
+{
+    if (decoded.load(std::memory_order_acquire))
+    {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(decodeMutex);
+    if (decoded.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+    if (!text.empty())
+    {
+        LightInfo light = LightStateParser::parseLight(text);
+        for (std::size_t i = 0; i < stringCount; ++i)
+        {
+            const LightField field = static_cast<LightField>(i);
+            if (!isHot(field))
+            {
+                strings[i].swap(*getStringMember(light, field));
+            }
+        }
+    }
+    decoded.store(true, std::memory_order_release);
+}
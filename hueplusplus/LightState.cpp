@@ -0,0 +1,163 @@
+/**
+    \file LightState.cpp
+    Copyright Notice\n
+    Copyright (C) 2017  Jan Rogall		- developer\n
+    Copyright (C) 2017  Moritz Wirger	- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "include/LightState.h"
+
+#include "include/Utils.h"
+
+namespace
+{
+    const nlohmann::json* findMember(const nlohmann::json& state, const char* key)
+    {
+        auto it = state.find(key);
+        return it == state.end() ? nullptr : &*it;
+    }
+
+    // The decode functions return whether the member was present and valid
+
+    template <typename T>
+    bool decodeNumber(const nlohmann::json* member, T& value)
+    {
+        if (member == nullptr)
+        {
+            return false;
+        }
+        if (member->is_number_float())
+        {
+            value = utils::convertNumber<T>(member->get<double>());
+        }
+        else if (member->is_number_unsigned())
+        {
+            value = utils::convertNumber<T>(member->get<std::uint64_t>());
+        }
+        else if (member->is_number_integer())
+        {
+            value = utils::convertNumber<T>(member->get<std::int64_t>());
+        }
+        else
+        {
+            return false;
+        }
+        return true;
+    }
+
+    bool decodeBool(const nlohmann::json* member, bool& value)
+    {
+        if (member != nullptr && member->is_boolean())
+        {
+            value = member->get<bool>();
+            return true;
+        }
+        return false;
+    }
+
+    template <typename T>
+    bool decodeEnum(const nlohmann::json* member, T& value, T (*parse)(const std::string&))
+    {
+        if (member != nullptr && member->is_string())
+        {
+            value = parse(member->get_ref<const std::string&>());
+            return true;
+        }
+        return false;
+    }
+
+    bool decodeXY(const nlohmann::json* member, XY& value)
+    {
+        if (member != nullptr && member->is_array() && member->size() == 2 && (*member)[0].is_number()
+            && (*member)[1].is_number())
+        {
+            value.x = (*member)[0].get<float>();
+            value.y = (*member)[1].get<float>();
+            return true;
+        }
+        return false;
+    }
+
+    void addMember(LightState& state, LightState::Member member, bool present)
+    {
+        if (present)
+        {
+            state.members |= member;
+        }
+    }
+} // namespace
+
+LightState LightState::fromJson(const nlohmann::json& state)
+{
+    LightState result;
+    if (!state.is_object())
+    {
+        return result;
+    }
+    addMember(result, LightState::ON, decodeBool(findMember(state, "on"), result.on));
+    addMember(result, LightState::REACHABLE, decodeBool(findMember(state, "reachable"), result.reachable));
+    addMember(result, LightState::BRI, decodeNumber(findMember(state, "bri"), result.bri));
+    addMember(result, LightState::HUE, decodeNumber(findMember(state, "hue"), result.hue));
+    addMember(result, LightState::SAT, decodeNumber(findMember(state, "sat"), result.sat));
+    addMember(result, LightState::CT, decodeNumber(findMember(state, "ct"), result.ct));
+    addMember(result, LightState::XY, decodeXY(findMember(state, "xy"), result.xy));
+    addMember(result, LightState::COLORMODE,
+        decodeEnum(findMember(state, "colormode"), result.colormode, &parseColorMode));
+    addMember(result, LightState::EFFECT, decodeEnum(findMember(state, "effect"), result.effect, &parseEffect));
+    addMember(result, LightState::ALERT, decodeEnum(findMember(state, "alert"), result.alert, &parseAlert));
+    return result;
+}
+
+ColorMode parseColorMode(const std::string& mode)
+{
+    if (mode == "hs")
+    {
+        return ColorMode::HS;
+    }
+    else if (mode == "xy")
+    {
+        return ColorMode::XY;
+    }
+    else if (mode == "ct")
+    {
+        return ColorMode::CT;
+    }
+    return ColorMode::NONE;
+}
+
+Effect parseEffect(const std::string& effect)
+{
+    if (effect == "colorloop")
+    {
+        return Effect::COLORLOOP;
+    }
+    return Effect::NONE;
+}
+
+Alert parseAlert(const std::string& alert)
+{
+    if (alert == "select")
+    {
+        return Alert::SELECT;
+    }
+    else if (alert == "lselect")
+    {
+        return Alert::LSELECT;
+    }
+    return Alert::NONE;
+}
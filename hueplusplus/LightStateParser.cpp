@@ -0,0 +1,464 @@
+/**
+    \file LightStateParser.cpp
+    Copyright Notice\n
+    Copyright (C) 2017  Jan Rogall		- developer\n
+    Copyright (C) 2017  Moritz Wirger	- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "include/LightStateParser.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+
+#include "include/HueExceptionMacro.h"
+#include "include/Utils.h"
+#include "include/json/json.hpp"
+
+namespace
+{
+    // Reads a string like the input adapter of nlohmann::json, but also tells how many characters were read.
+    // The lexer reads single character tokens without looking ahead, so after '{' or '}' was reported
+    // the position is right behind it.
+    class CountingInputAdapter : public nlohmann::detail::input_adapter_protocol
+    {
+    public:
+        explicit CountingInputAdapter(const std::string& text) : text(text) {}
+
+        std::char_traits<char>::int_type get_character() override
+        {
+            if (position < text.size())
+            {
+                return std::char_traits<char>::to_int_type(text[position++]);
+            }
+            return std::char_traits<char>::eof();
+        }
+
+        const std::string& getText() const { return text; }
+        std::size_t getPosition() const { return position; }
+
+    private:
+        const std::string& text;
+        std::size_t position = 0;
+    };
+
+    // Receives the parser events and fills the lights.
+    //
+    // depth is incremented by every object and array, keys[depth] holds the current key of the object at depth.
+    // For lightDepth 1 the root object is the light, for 2 it contains the lights by id and for 3 the lights
+    // are in the "lights" member of the root object.
+    // Error responses are recognized like HueCommandAPI::HandleError does, by an "error" member of the root
+    // object or of the first element of the root array.
+    // The text of each light is copied from the input when more than one light can be parsed.
+    class LightSaxHandler : public nlohmann::json::json_sax_t
+    {
+    public:
+        LightSaxHandler(int lightDepth, std::vector<LightInfo>& lights, const CountingInputAdapter& input)
+            : lightDepth(lightDepth), lights(lights), input(input)
+        {
+            keys.resize(lightDepth + 2);
+        }
+
+        bool null() override
+        {
+            countRootElement();
+            invalidateXy();
+            return true;
+        }
+        bool boolean(bool val) override
+        {
+            countRootElement();
+            invalidateXy();
+            if (isStateMember())
+            {
+                const std::string& key = keys[depth];
+                if (key == "on")
+                {
+                    current.state.on = val;
+                    current.state.members |= LightState::ON;
+                }
+                else if (key == "reachable")
+                {
+                    current.state.reachable = val;
+                    current.state.members |= LightState::REACHABLE;
+                }
+            }
+            return true;
+        }
+        bool number_integer(number_integer_t val) override
+        {
+            countRootElement();
+            if (isErrorMember() && errorKey == "type")
+            {
+                errorCode = static_cast<int>(val);
+                return true;
+            }
+            number(val);
+            return true;
+        }
+        bool number_unsigned(number_unsigned_t val) override
+        {
+            countRootElement();
+            if (isErrorMember() && errorKey == "type")
+            {
+                errorCode = static_cast<int>(val);
+                return true;
+            }
+            number(val);
+            return true;
+        }
+        bool number_float(number_float_t val, const string_t& /*s*/) override
+        {
+            countRootElement();
+            number(val);
+            return true;
+        }
+        bool string(string_t& val) override
+        {
+            countRootElement();
+            invalidateXy();
+            if (isErrorMember())
+            {
+                if (errorKey == "address")
+                {
+                    errorAddress.swap(val);
+                }
+                else if (errorKey == "description")
+                {
+                    errorDescription.swap(val);
+                }
+            }
+            else if (isLightMember())
+            {
+                std::string* target = getStringMember(keys[depth]);
+                if (target)
+                {
+                    target->swap(val);
+                }
+            }
+            else if (isStateMember())
+            {
+                const std::string& key = keys[depth];
+                if (key == "colormode")
+                {
+                    current.state.colormode = parseColorMode(val);
+                    current.state.members |= LightState::COLORMODE;
+                }
+                else if (key == "effect")
+                {
+                    current.state.effect = parseEffect(val);
+                    current.state.members |= LightState::EFFECT;
+                }
+                else if (key == "alert")
+                {
+                    current.state.alert = parseAlert(val);
+                    current.state.members |= LightState::ALERT;
+                }
+            }
+            return true;
+        }
+        bool start_object(std::size_t /*elements*/) override
+        {
+            invalidateXy();
+            countRootElement();
+            ++depth;
+            if (isErrorObject())
+            {
+                errorDepth = depth;
+            }
+            if (depth == std::max(lightDepth - 1, 1) && isInLights())
+            {
+                foundLights = true;
+            }
+            if (depth == lightDepth && isInLights())
+            {
+                inLight = true;
+                current = LightInfo();
+                if (lightDepth > 1)
+                {
+                    current.id = std::atoi(keys[lightDepth - 1].c_str());
+                    lightBegin = input.getPosition() - 1;
+                }
+            }
+            if (isStateMember())
+            {
+                current.hasState = true;
+            }
+            if (depth <= lightDepth + 1)
+            {
+                keys[depth].clear();
+            }
+            return true;
+        }
+        bool key(string_t& val) override
+        {
+            if (isInErrorContainer(depth) && val == "error")
+            {
+                hasError = true;
+            }
+            if (depth == errorDepth)
+            {
+                errorKey = val;
+            }
+            if (depth <= lightDepth + 1)
+            {
+                // Deeper keys are never needed
+                keys[depth].swap(val);
+            }
+            return true;
+        }
+        bool end_object() override
+        {
+            if (depth == lightDepth && inLight)
+            {
+                inLight = false;
+                if (lightDepth > 1)
+                {
+                    current.text.assign(input.getText(), lightBegin, input.getPosition() - lightBegin);
+                }
+                lights.push_back(std::move(current));
+            }
+            if (depth == errorDepth)
+            {
+                errorDepth = 0;
+            }
+            --depth;
+            return true;
+        }
+        bool start_array(std::size_t /*elements*/) override
+        {
+            invalidateXy();
+            countRootElement();
+            if (depth == 0)
+            {
+                rootIsArray = true;
+            }
+            if (isStateMember() && keys[depth] == "xy")
+            {
+                inXy = true;
+                xyIndex = 0;
+            }
+            ++depth;
+            return true;
+        }
+        bool end_array() override
+        {
+            --depth;
+            if (inXy && isStateMember())
+            {
+                // Only complete coordinates are used
+                if (xyIndex == 2)
+                {
+                    current.state.xy = xy;
+                    current.state.members |= LightState::XY;
+                }
+                inXy = false;
+            }
+            return true;
+        }
+        bool parse_error(
+            std::size_t /*position*/, const std::string& /*last_token*/, const nlohmann::detail::exception& ex) override
+        {
+            // The text parser reports syntax errors and numbers that do not fit into a double,
+            // rethrow them with their concrete type like the DOM parser does
+            if (const auto* parseError = dynamic_cast<const nlohmann::json::parse_error*>(&ex))
+            {
+                throw *parseError;
+            }
+            if (const auto* outOfRange = dynamic_cast<const nlohmann::json::out_of_range*>(&ex))
+            {
+                throw *outOfRange;
+            }
+            throw nlohmann::json::other_error::create(ex.id, ex.what());
+        }
+
+        bool hasLights() const { return foundLights; }
+
+        // Throws HueAPIResponseException if the response was an error
+        void checkError() const
+        {
+            if (hasError)
+            {
+                throw HueAPIResponseException(CURRENT_FILE_INFO, errorCode, errorAddress, errorDescription);
+            }
+        }
+
+    private:
+        // Values other than numbers make the xy array invalid
+        void invalidateXy()
+        {
+            if (inXy && depth == lightDepth + 2)
+            {
+                xyIndex = 3;
+            }
+        }
+        void countRootElement()
+        {
+            if (depth == 1 && rootIsArray)
+            {
+                ++rootElements;
+            }
+        }
+        bool isInLights() const { return !rootIsArray && (lightDepth != 3 || keys[1] == "lights"); }
+        // Object that may contain the "error" member, the root object or the first element of the root array
+        bool isInErrorContainer(int containerDepth) const
+        {
+            return rootIsArray ? containerDepth == 2 && rootElements == 1 : containerDepth == 1;
+        }
+        bool isErrorObject() const { return isInErrorContainer(depth - 1) && keys[depth - 1] == "error"; }
+        bool isErrorMember() const { return errorDepth != 0 && depth == errorDepth; }
+        bool isLightMember() const { return inLight && depth == lightDepth; }
+        bool isStateMember() const { return inLight && depth == lightDepth + 1 && keys[lightDepth] == "state"; }
+
+        std::string* getStringMember(const std::string& key)
+        {
+            if (key == "name")
+            {
+                return &current.name;
+            }
+            else if (key == "type")
+            {
+                return &current.type;
+            }
+            else if (key == "modelid")
+            {
+                return &current.modelId;
+            }
+            else if (key == "uniqueid")
+            {
+                return &current.uniqueId;
+            }
+            else if (key == "manufacturername")
+            {
+                return &current.manufacturerName;
+            }
+            else if (key == "productname")
+            {
+                return &current.productName;
+            }
+            else if (key == "luminaireuniqueid")
+            {
+                return &current.luminaireUniqueId;
+            }
+            else if (key == "swversion")
+            {
+                return &current.swVersion;
+            }
+            return nullptr;
+        }
+
+        // Converts like LightState::fromJson, so the results match
+        template <typename T>
+        void number(T val)
+        {
+            if (inXy && depth == lightDepth + 2)
+            {
+                if (xyIndex == 0)
+                {
+                    xy.x = static_cast<float>(val);
+                }
+                else if (xyIndex == 1)
+                {
+                    xy.y = static_cast<float>(val);
+                }
+                ++xyIndex;
+            }
+            else if (isStateMember())
+            {
+                const std::string& key = keys[depth];
+                if (key == "bri")
+                {
+                    current.state.bri = utils::convertNumber<uint8_t>(val);
+                    current.state.members |= LightState::BRI;
+                }
+                else if (key == "hue")
+                {
+                    current.state.hue = utils::convertNumber<uint16_t>(val);
+                    current.state.members |= LightState::HUE;
+                }
+                else if (key == "sat")
+                {
+                    current.state.sat = utils::convertNumber<uint8_t>(val);
+                    current.state.members |= LightState::SAT;
+                }
+                else if (key == "ct")
+                {
+                    current.state.ct = utils::convertNumber<uint16_t>(val);
+                    current.state.members |= LightState::CT;
+                }
+            }
+        }
+
+    private:
+        int lightDepth;
+        std::vector<LightInfo>& lights;
+        const CountingInputAdapter& input;
+        std::size_t lightBegin = 0;
+        bool foundLights = false;
+        std::vector<std::string> keys;
+        LightInfo current;
+        int depth = 0;
+        bool inLight = false;
+        bool inXy = false;
+        int xyIndex = 0;
+        XY xy = {0.0f, 0.0f};
+        bool rootIsArray = false;
+        int rootElements = 0;
+        bool hasError = false;
+        int errorDepth = 0;
+        std::string errorKey;
+        int errorCode = -1;
+        std::string errorAddress;
+        std::string errorDescription;
+    };
+} // namespace
+
+LightInfo LightStateParser::parseLight(const std::string& body)
+{
+    bool hasLight = false;
+    std::vector<LightInfo> lights = parse(body, 1, hasLight);
+    return lights.empty() ? LightInfo() : std::move(lights.front());
+}
+
+std::vector<LightInfo> LightStateParser::parseLights(const std::string& body)
+{
+    bool hasLights = false;
+    return parse(body, 2, hasLights);
+}
+
+std::vector<LightInfo> LightStateParser::parseBridgeState(const std::string& body)
+{
+    bool hasLights = false;
+    return parse(body, 3, hasLights);
+}
+
+std::vector<LightInfo> LightStateParser::parseBridgeState(const std::string& body, bool& hasLights)
+{
+    return parse(body, 3, hasLights);
+}
+
+std::vector<LightInfo> LightStateParser::parse(const std::string& body, int lightDepth, bool& hasLights)
+{
+    std::vector<LightInfo> lights;
+    auto input = std::make_shared<CountingInputAdapter>(body);
+    LightSaxHandler handler(lightDepth, lights, *input);
+    nlohmann::detail::parser<nlohmann::json>(nlohmann::detail::input_adapter_t(input)).sax_parse(&handler);
+    handler.checkError();
+    hasLights = handler.hasLights();
+    return lights;
+}
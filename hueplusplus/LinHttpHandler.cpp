@@ -25,8 +25,10 @@
 #include <chrono>
 #include <cstring>
 #include <iostream>
+#include <istream>
 #include <memory>
 #include <stdexcept>
+#include <streambuf>
 #include <system_error>
 
 #include <arpa/inet.h>
@@ -38,6 +40,8 @@
 #include <sys/socket.h> // socket, connect
 #include <unistd.h> // read, write, close
 
+#include "include/HueExceptionMacro.h"
+
 class SocketCloser
 {
 public:
@@ -48,6 +52,93 @@ private:
     int s;
 };
 
+namespace
+{
+    // Looks up the host, connects the socket and sends the whole message
+    void connectAndSend(int socketFD, const std::string& msg, const std::string& adr, int port)
+    {
+        // lookup ip address
+        hostent* server;
+        server = gethostbyname(adr.c_str());
+        if (server == NULL)
+        {
+            int errCode = errno;
+            std::cerr << "LinHttpHandler: Failed to find host with address " << adr << ": " << std::strerror(errCode)
+                      << "\n";
+            throw(std::system_error(errCode, std::generic_category(), "LinHttpHandler: gethostbyname"));
+        }
+
+        // fill in the structure
+        sockaddr_in server_addr;
+        memset(&server_addr, 0, sizeof(server_addr));
+        server_addr.sin_family = AF_INET;
+        server_addr.sin_port = htons(port);
+        memcpy(&server_addr.sin_addr.s_addr, server->h_addr, server->h_length);
+
+        // connect the socket
+        if (connect(socketFD, (struct sockaddr*)&server_addr, sizeof(server_addr)) < 0)
+        {
+            int errCode = errno;
+            std::cerr << "LinHttpHandler: Failed to connect socket: " << std::strerror(errCode) << "\n";
+            throw(std::system_error(errCode, std::generic_category(), "LinHttpHandler: Failed to connect socket"));
+        }
+
+        // send the request
+        size_t total = msg.length();
+        size_t sent = 0;
+        do
+        {
+            ssize_t bytes = write(socketFD, msg.c_str() + sent, total - sent);
+            if (bytes < 0)
+            {
+                int errCode = errno;
+                std::cerr << "LinHttpHandler: Failed to write message to socket: " << std::strerror(errCode) << "\n";
+                throw(std::system_error(
+                    errCode, std::generic_category(), "LinHttpHandler: Failed to write message to socket"));
+            }
+            else if (bytes == 0)
+            {
+                break;
+            }
+            else
+            {
+                sent += bytes;
+            }
+        } while (sent < total);
+    }
+
+    // Reads from the socket on demand, so a parser can consume the response while it arrives
+    class SocketStreamBuffer : public std::streambuf
+    {
+    public:
+        explicit SocketStreamBuffer(int socketFD) : socketFD(socketFD) {}
+
+    protected:
+        int_type underflow() override
+        {
+            ssize_t bytes = read(socketFD, buffer, sizeof(buffer));
+            if (bytes < 0)
+            {
+                int errCode = errno;
+                std::cerr << "LinHttpHandler: Failed to read response from socket: " << std::strerror(errCode)
+                          << std::endl;
+                throw(std::system_error(
+                    errCode, std::generic_category(), "LinHttpHandler: Failed to read response from socket"));
+            }
+            else if (bytes == 0)
+            {
+                return traits_type::eof();
+            }
+            setg(buffer, buffer, buffer + bytes);
+            return traits_type::to_int_type(buffer[0]);
+        }
+
+    private:
+        int socketFD;
+        char buffer[2048];
+    };
+} // namespace
+
 std::string LinHttpHandler::send(const std::string& msg, const std::string& adr, int port) const
 {
     // create socket
@@ -61,54 +152,7 @@ std::string LinHttpHandler::send(const std::string& msg, const std::string& adr,
         throw(std::system_error(errCode, std::generic_category(), "LinHttpHandler: Failed to open socket"));
     }
 
-    // lookup ip address
-    hostent* server;
-    server = gethostbyname(adr.c_str());
-    if (server == NULL)
-    {
-        int errCode = errno;
-        std::cerr << "LinHttpHandler: Failed to find host with address " << adr << ": " << std::strerror(errCode)
-                  << "\n";
-        throw(std::system_error(errCode, std::generic_category(), "LinHttpHandler: gethostbyname"));
-    }
-
-    // fill in the structure
-    sockaddr_in server_addr;
-    memset(&server_addr, 0, sizeof(server_addr));
-    server_addr.sin_family = AF_INET;
-    server_addr.sin_port = htons(port);
-    memcpy(&server_addr.sin_addr.s_addr, server->h_addr, server->h_length);
-
-    // connect the socket
-    if (connect(socketFD, (struct sockaddr*)&server_addr, sizeof(server_addr)) < 0)
-    {
-        int errCode = errno;
-        std::cerr << "LinHttpHandler: Failed to connect socket: " << std::strerror(errCode) << "\n";
-        throw(std::system_error(errCode, std::generic_category(), "LinHttpHandler: Failed to connect socket"));
-    }
-
-    // send the request
-    size_t total = msg.length();
-    size_t sent = 0;
-    do
-    {
-        ssize_t bytes = write(socketFD, msg.c_str() + sent, total - sent);
-        if (bytes < 0)
-        {
-            int errCode = errno;
-            std::cerr << "LinHttpHandler: Failed to write message to socket: " << std::strerror(errCode) << "\n";
-            throw(std::system_error(
-                errCode, std::generic_category(), "LinHttpHandler: Failed to write message to socket"));
-        }
-        else if (bytes == 0)
-        {
-            break;
-        }
-        else
-        {
-            sent += bytes;
-        }
-    } while (sent < total);
+    connectAndSend(socketFD, msg, adr, port);
 
     // receive the response
     std::string response;
@@ -136,6 +180,52 @@ std::string LinHttpHandler::send(const std::string& msg, const std::string& adr,
     return response;
 }
 
+nlohmann::json LinHttpHandler::sendGetHTTPJson(const std::string& msg, const std::string& adr, int port) const
+{
+    // create socket
+    int socketFD = socket(AF_INET, SOCK_STREAM, 0);
+
+    SocketCloser closeMySocket(socketFD);
+    if (socketFD < 0)
+    {
+        int errCode = errno;
+        std::cerr << "LinHttpHandler: Failed to open socket: " << std::strerror(errCode) << "\n";
+        throw(std::system_error(errCode, std::generic_category(), "LinHttpHandler: Failed to open socket"));
+    }
+
+    connectAndSend(socketFD, msg, adr, port);
+
+    return receiveJson(socketFD);
+}
+
+nlohmann::json LinHttpHandler::receiveJson(int socketFD)
+{
+    SocketStreamBuffer buffer(socketFD);
+    // skip the header, the body starts after the first empty line
+    const char separator[] = "\r\n\r\n";
+    std::size_t matched = 0;
+    while (matched < 4)
+    {
+        SocketStreamBuffer::int_type c = buffer.sbumpc();
+        if (SocketStreamBuffer::traits_type::eq_int_type(c, SocketStreamBuffer::traits_type::eof()))
+        {
+            std::cerr << "LinHttpHandler: Failed to find body in response\n";
+            throw HueException(CURRENT_FILE_INFO, "Failed to find body in response");
+        }
+        if (SocketStreamBuffer::traits_type::to_char_type(c) == separator[matched])
+        {
+            ++matched;
+        }
+        else
+        {
+            matched = SocketStreamBuffer::traits_type::to_char_type(c) == separator[0] ? 1 : 0;
+        }
+    }
+    // the parser pulls the body from the socket as it arrives
+    std::istream body(&buffer);
+    return nlohmann::json::parse(body);
+}
+
 std::vector<std::string> LinHttpHandler::sendMulticast(
     const std::string& msg, const std::string& adr, int port, int timeout) const
 {
@@ -0,0 +1,69 @@
+/**
+    \file NumberFormat.cpp
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+    Copyright (C) 2020  Moritz Wirger	- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "include/NumberFormat.h"
+
+#include <cmath>
+
+#include "include/json/json.hpp"
+
+namespace utils
+{
+    void appendUnsigned(std::string& out, unsigned long long value)
+    {
+        char buffer[20];
+        char* end = buffer + sizeof(buffer);
+        char* begin = end;
+        do
+        {
+            *--begin = static_cast<char>('0' + value % 10);
+            value /= 10;
+        } while (value != 0);
+        out.append(begin, end);
+    }
+
+    void appendInt(std::string& out, long long value)
+    {
+        if (value < 0)
+        {
+            out.push_back('-');
+            // Negate as unsigned, so the minimum value does not overflow
+            appendUnsigned(out, 0ull - static_cast<unsigned long long>(value));
+        }
+        else
+        {
+            appendUnsigned(out, static_cast<unsigned long long>(value));
+        }
+    }
+
+    void appendFloat(std::string& out, double value)
+    {
+        if (!std::isfinite(value))
+        {
+            out.append("null", 4);
+            return;
+        }
+        char buffer[64];
+        char* end = nlohmann::detail::to_chars(buffer, buffer + sizeof(buffer), value);
+        out.append(buffer, end);
+    }
+} // namespace utils
@@ -0,0 +1,105 @@
+/**
+    \file Result.cpp
+    Copyright Notice\n
+    Copyright (C) 2018  Jan Rogall		- developer\n
+    Copyright (C) 2018  Moritz Wirger	- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "include/Result.h"
+
+#include "include/NumberFormat.h"
+
+HueError::HueError(FileInfo fileInfo, int code, std::string address, std::string description)
+    : type(Type::API_RESPONSE),
+      code(code),
+      address(std::move(address)),
+      description(std::move(description)),
+      fileInfo(fileInfo)
+{}
+
+HueError::HueError(FileInfo fileInfo, std::error_code error, std::string description, std::exception_ptr cause)
+    : type(Type::TRANSPORT),
+      code(error.value()),
+      systemError(error),
+      description(std::move(description)),
+      fileInfo(fileInfo),
+      cause(std::move(cause))
+{}
+
+HueError::HueError(FileInfo fileInfo, std::string description)
+    : type(Type::INVALID_RESPONSE), description(std::move(description)), fileInfo(fileInfo)
+{}
+
+HueError HueError::fromResponse(FileInfo fileInfo, const nlohmann::json& response)
+{
+    int code = -1;
+    std::string address;
+    std::string description;
+    auto error = response.find("error");
+    if (error != response.end() && error->is_object())
+    {
+        auto it = error->find("type");
+        if (it != error->end() && it->is_number_integer())
+        {
+            code = it->get<int>();
+        }
+        it = error->find("address");
+        if (it != error->end() && it->is_string())
+        {
+            address = it->get<std::string>();
+        }
+        it = error->find("description");
+        if (it != error->end() && it->is_string())
+        {
+            description = it->get<std::string>();
+        }
+    }
+    return HueError(fileInfo, code, std::move(address), std::move(description));
+}
+
+std::string HueError::toString() const
+{
+    std::string result = fileInfo.ToString();
+    result.push_back(' ');
+    if (type == Type::API_RESPONSE)
+    {
+        utils::appendInt(result, code);
+        result.push_back(' ');
+        result.append(address);
+        result.push_back(' ');
+    }
+    result.append(description);
+    return result;
+}
+
+void HueError::raise() const
+{
+    switch (type)
+    {
+    case Type::API_RESPONSE:
+        throw HueAPIResponseException(fileInfo, code, address, description);
+    case Type::TRANSPORT:
+        if (cause)
+        {
+            std::rethrow_exception(cause);
+        }
+        throw std::system_error(systemError, description);
+    default:
+        throw HueException(fileInfo, description);
+    }
+}
@@ -32,9 +32,10 @@
 bool SimpleBrightnessStrategy::setBrightness(unsigned int bri, uint8_t transition, HueLight& light) const
 {
     light.refreshState();
+    const LightState state = light.getState();
     if (bri == 0)
     {
-        if (light.state["state"]["on"] == true)
+        if (state.on)
         {
             return light.OffNoRefresh(transition);
         }
@@ -45,44 +46,42 @@ bool SimpleBrightnessStrategy::setBrightness(unsigned int bri, uint8_t transitio
     }
     else
     {
-        nlohmann::json request = nlohmann::json::object();
+        StateRequest request;
         if (transition != 4)
         {
-            request["transitiontime"] = transition;
+            request.setTransition(transition);
         }
-        if (light.state["state"]["on"] != true)
+        if (!state.on)
         {
-            request["on"] = true;
+            request.setOn(true);
         }
-        if (light.state["state"]["bri"] != bri)
+        if (!state.has(LightState::BRI) || state.bri != bri)
         {
             if (bri > 254)
             {
                 bri = 254;
             }
-            request["bri"] = bri;
+            request.setBrightness(static_cast<uint8_t>(bri));
         }
 
-        if (!request.count("on") && !request.count("bri"))
+        if (!request.has(StateRequest::ON) && !request.has(StateRequest::BRI))
         {
             // Nothing needs to be changed
             return true;
         }
 
-        nlohmann::json reply = light.SendPutRequest(request, "/state", CURRENT_FILE_INFO);
-
         // Check whether request was successful
-        return utils::validateReplyForLight(request, reply, light.id);
+        return light.SendStateRequest(request, CURRENT_FILE_INFO).isSuccess();
     }
 }
 
 unsigned int SimpleBrightnessStrategy::getBrightness(HueLight& light) const
 {
     light.refreshState();
-    return light.state["state"]["bri"].get<unsigned int>();
+    return light.getState().bri;
 }
 
 unsigned int SimpleBrightnessStrategy::getBrightness(const HueLight& light) const
 {
-    return light.state["state"]["bri"].get<unsigned int>();
+    return light.getState().bri;
 }
@@ -26,6 +26,7 @@
 #include <iostream>
 #include <thread>
 
+#include "include/ColorConversion.h"
 #include "include/HueConfig.h"
 #include "include/HueExceptionMacro.h"
 #include "include/Utils.h"
@@ -33,136 +34,132 @@
 bool SimpleColorHueStrategy::setColorHue(uint16_t hue, uint8_t transition, HueLight& light) const
 {
     light.refreshState();
-    nlohmann::json request = nlohmann::json::object();
+    const LightState state = light.getState();
+    StateRequest request;
     if (transition != 4)
     {
-        request["transitiontime"] = transition;
+        request.setTransition(transition);
     }
-    if (light.state["state"]["on"] != true)
+    if (!state.on)
     {
-        request["on"] = true;
+        request.setOn(true);
     }
-    if (light.state["state"]["hue"] != hue || light.state["state"]["colormode"] != "hs")
+    if (!state.has(LightState::HUE) || state.hue != hue || state.colormode != ColorMode::HS)
     {
         hue = hue % 65535;
-        request["hue"] = hue;
+        request.setHue(hue);
     }
 
-    if (!request.count("on") && !request.count("hue"))
+    if (!request.has(StateRequest::ON) && !request.has(StateRequest::HUE))
     {
         // Nothing needs to be changed
         return true;
     }
 
-    nlohmann::json reply = light.SendPutRequest(request, "/state", CURRENT_FILE_INFO);
-
     // Check whether request was successful
-    return utils::validateReplyForLight(request, reply, light.id);
+    return light.SendStateRequest(request, CURRENT_FILE_INFO).isSuccess();
 }
 
 bool SimpleColorHueStrategy::setColorSaturation(uint8_t sat, uint8_t transition, HueLight& light) const
 {
     light.refreshState();
-    nlohmann::json request = nlohmann::json::object();
+    const LightState state = light.getState();
+    StateRequest request;
     if (transition != 4)
     {
-        request["transitiontime"] = transition;
+        request.setTransition(transition);
     }
-    if (light.state["state"]["on"] != true)
+    if (!state.on)
     {
-        request["on"] = true;
+        request.setOn(true);
     }
-    if (light.state["state"]["sat"] != sat)
+    if (!state.has(LightState::SAT) || state.sat != sat)
     {
         if (sat > 254)
         {
             sat = 254;
         }
-        request["sat"] = sat;
+        request.setSaturation(sat);
     }
 
-    if (!request.count("on") && !request.count("sat"))
+    if (!request.has(StateRequest::ON) && !request.has(StateRequest::SAT))
     {
         // Nothing needs to be changed
         return true;
     }
 
-    nlohmann::json reply = light.SendPutRequest(request, "/state", CURRENT_FILE_INFO);
-
     // Check whether request was successful
-    return utils::validateReplyForLight(request, reply, light.id);
+    return light.SendStateRequest(request, CURRENT_FILE_INFO).isSuccess();
 }
 
 bool SimpleColorHueStrategy::setColorHueSaturation(uint16_t hue, uint8_t sat, uint8_t transition, HueLight& light) const
 {
     light.refreshState();
-    nlohmann::json request = nlohmann::json::object();
+    const LightState state = light.getState();
+    StateRequest request;
 
     if (transition != 4)
     {
-        request["transitiontime"] = transition;
+        request.setTransition(transition);
     }
-    if (light.state["state"]["on"] != true)
+    if (!state.on)
     {
-        request["on"] = true;
+        request.setOn(true);
     }
-    if (light.state["state"]["hue"] != hue || light.state["state"]["colormode"] != "hs")
+    if (!state.has(LightState::HUE) || state.hue != hue || state.colormode != ColorMode::HS)
     {
         hue = hue % 65535;
-        request["hue"] = hue;
+        request.setHue(hue);
     }
-    if (light.state["state"]["sat"] != sat || light.state["state"]["colormode"] != "hs")
+    if (!state.has(LightState::SAT) || state.sat != sat || state.colormode != ColorMode::HS)
     {
         if (sat > 254)
         {
             sat = 254;
         }
-        request["sat"] = sat;
+        request.setSaturation(sat);
     }
 
-    if (!request.count("on") && !request.count("hue") && !request.count("sat"))
+    if (!request.has(StateRequest::ON) && !request.has(StateRequest::HUE) && !request.has(StateRequest::SAT))
     {
         // Nothing needs to be changed
         return true;
     }
 
-    nlohmann::json reply = light.SendPutRequest(request, "/state", CURRENT_FILE_INFO);
-
     // Check whether request was successful
-    return utils::validateReplyForLight(request, reply, light.id);
+    return light.SendStateRequest(request, CURRENT_FILE_INFO).isSuccess();
 }
 
 bool SimpleColorHueStrategy::setColorXY(float x, float y, uint8_t transition, HueLight& light) const
 {
+    // The bridge moves colors into the gamut of the light, so the unchanged color would never compare equal
+    const XY xy = ColorConversion::clampToGamut({x, y}, light.getColorType());
     light.refreshState();
-    nlohmann::json request = nlohmann::json::object();
+    const LightState state = light.getState();
+    StateRequest request;
 
     if (transition != 4)
     {
-        request["transitiontime"] = transition;
+        request.setTransition(transition);
     }
-    if (light.state["state"]["on"] != true)
+    if (!state.on)
     {
-        request["on"] = true;
+        request.setOn(true);
     }
-    if (std::abs(light.state["state"]["xy"][0].get<float>() - x) > 1E-4f
-        || std::abs(light.state["state"]["xy"][1].get<float>() - y) > 1E-4f
-        || light.state["state"]["colormode"] != "xy")
+    if (!state.has(LightState::XY) || std::abs(state.xy.x - xy.x) > 1E-4f || std::abs(state.xy.y - xy.y) > 1E-4f
+        || state.colormode != ColorMode::XY)
     {
-        request["xy"][0] = x;
-        request["xy"][1] = y;
+        request.setXY(xy.x, xy.y);
     }
 
-    if (!request.count("on") && !request.count("xy"))
+    if (!request.has(StateRequest::ON) && !request.has(StateRequest::XY))
     {
         // Nothing needs to be changed
         return true;
     }
 
-    nlohmann::json reply = light.SendPutRequest(request, "/state", CURRENT_FILE_INFO);
-
     // Check whether request was successful
-    return utils::validateReplyForLight(request, reply, light.id);
+    return light.SendStateRequest(request, CURRENT_FILE_INFO).isSuccess();
 }
 
 bool SimpleColorHueStrategy::setColorRGB(uint8_t r, uint8_t g, uint8_t b, uint8_t transition, HueLight& light) const
@@ -172,257 +169,106 @@ bool SimpleColorHueStrategy::setColorRGB(uint8_t r, uint8_t g, uint8_t b, uint8_
         return light.OffNoRefresh();
     }
 
-    const float red = float(r) / 255;
-    const float green = float(g) / 255;
-    const float blue = float(b) / 255;
-
-    // gamma correction
-    const float redCorrected = (red > 0.04045f) ? pow((red + 0.055f) / (1.0f + 0.055f), 2.4f) : (red / 12.92f);
-    const float greenCorrected = (green > 0.04045f) ? pow((green + 0.055f) / (1.0f + 0.055f), 2.4f) : (green / 12.92f);
-    const float blueCorrected = (blue > 0.04045f) ? pow((blue + 0.055f) / (1.0f + 0.055f), 2.4f) : (blue / 12.92f);
-
-    const float X = redCorrected * 0.664511f + greenCorrected * 0.154324f + blueCorrected * 0.162028f;
-    const float Y = redCorrected * 0.283881f + greenCorrected * 0.668433f + blueCorrected * 0.047685f;
-    const float Z = redCorrected * 0.000088f + greenCorrected * 0.072310f + blueCorrected * 0.986039f;
-
-    const float x = X / (X + Y + Z);
-    const float y = Y / (X + Y + Z);
-
-    return light.setColorXY(x, y, transition);
+    const XY xy = ColorConversion::rgbToXY(r, g, b);
+    return light.setColorXY(xy.x, xy.y, transition);
 }
 
 bool SimpleColorHueStrategy::setColorLoop(bool on, HueLight& light) const
 {
     // colorloop
     light.refreshState();
-    nlohmann::json request = nlohmann::json::object();
+    const LightState state = light.getState();
+    StateRequest request;
 
-    if (light.state["state"]["on"] != true)
+    if (!state.on)
     {
-        request["on"] = true;
+        request.setOn(true);
     }
-    std::string effect;
-    if ((effect = on ? "colorloop" : "none") != light.state["state"]["effect"])
+    Effect effect = on ? Effect::COLORLOOP : Effect::NONE;
+    if (!state.has(LightState::EFFECT) || effect != state.effect)
     {
-        request["effect"] = effect;
+        request.setEffect(effect);
     }
-    if (!request.count("on") && !request.count("effect"))
+    if (!request.has(StateRequest::ON) && !request.has(StateRequest::EFFECT))
     {
         // Nothing needs to be changed
         return true;
     }
 
-    nlohmann::json reply = light.SendPutRequest(request, "/state", CURRENT_FILE_INFO);
-
     // Check whether request was successful
-    return utils::validateReplyForLight(request, reply, light.id);
+    return light.SendStateRequest(request, CURRENT_FILE_INFO).isSuccess();
 }
 
 bool SimpleColorHueStrategy::alertHueSaturation(uint16_t hue, uint8_t sat, HueLight& light) const
 {
-    light.refreshState();
-    std::string cType = light.state["state"]["colormode"].get<std::string>();
-    bool on = light.state["state"]["on"].get<bool>();
-    if (cType == "hs")
-    {
-        uint16_t oldHue = light.state["state"]["hue"].get<uint16_t>();
-        uint8_t oldSat = light.state["state"]["sat"].get<uint8_t>();
-        if (!light.setColorHueSaturation(hue, sat, 1))
-        {
-            return false;
-        }
-        std::this_thread::sleep_for(std::chrono::milliseconds(c_PRE_ALERT_DELAY));
-        if (!light.alert())
-        {
-            return false;
-        }
-        std::this_thread::sleep_for(std::chrono::milliseconds(c_POST_ALERT_DELAY));
-        if (!on)
-        {
-            light.setColorHueSaturation(oldHue, oldSat, 1);
-            return light.OffNoRefresh(1);
-        }
-        else
-        {
-            return light.setColorHueSaturation(oldHue, oldSat, 1);
-        }
-    }
-    else if (cType == "xy")
-    {
-        float oldX = light.state["state"]["xy"][0].get<float>();
-        float oldY = light.state["state"]["xy"][1].get<float>();
-        if (!light.setColorHueSaturation(hue, sat, 1))
-        {
-            return false;
-        }
-        std::this_thread::sleep_for(std::chrono::milliseconds(c_PRE_ALERT_DELAY));
-        if (!light.alert())
-        {
-            return false;
-        }
-        std::this_thread::sleep_for(std::chrono::milliseconds(c_POST_ALERT_DELAY));
-        if (!on)
-        {
-            light.setColorXY(oldX, oldY, 1);
-            return light.OffNoRefresh(1);
-        }
-        else
-        {
-            return light.setColorXY(oldX, oldY, 1);
-        }
-    }
-    else
-    {
-        return false;
-    }
+    return alertColor(light, false, [&]() { return light.setColorHueSaturation(hue, sat, 1); });
 }
 
 bool SimpleColorHueStrategy::alertXY(float x, float y, HueLight& light) const
 {
-    light.refreshState();
-    std::string cType = light.state["state"]["colormode"].get<std::string>();
-    bool on = light.state["state"]["on"].get<bool>();
-    if (cType == "hs")
-    {
-        uint16_t oldHue = light.state["state"]["hue"].get<uint16_t>();
-        uint8_t oldSat = light.state["state"]["sat"].get<uint8_t>();
-        if (!light.setColorXY(x, y, 1))
-        {
-            return false;
-        }
-        std::this_thread::sleep_for(std::chrono::milliseconds(c_PRE_ALERT_DELAY));
-        if (!light.alert())
-        {
-            return false;
-        }
-        std::this_thread::sleep_for(std::chrono::milliseconds(c_POST_ALERT_DELAY));
-        if (!on)
-        {
-            light.setColorHueSaturation(oldHue, oldSat, 1);
-            return light.OffNoRefresh(1);
-        }
-        else
-        {
-            return light.setColorHueSaturation(oldHue, oldSat, 1);
-        }
-    }
-    else if (cType == "xy")
-    {
-        float oldX = light.state["state"]["xy"][0].get<float>();
-        float oldY = light.state["state"]["xy"][1].get<float>();
-        if (!light.setColorXY(x, y, 1))
-        {
-            return false;
-        }
-        std::this_thread::sleep_for(std::chrono::milliseconds(c_PRE_ALERT_DELAY));
-        if (!light.alert())
-        {
-            return false;
-        }
-        std::this_thread::sleep_for(std::chrono::milliseconds(c_POST_ALERT_DELAY));
-        if (!on)
-        {
-            light.setColorXY(oldX, oldY, 1);
-            return light.OffNoRefresh(1);
-        }
-        else
-        {
-            return light.setColorXY(oldX, oldY, 1);
-        }
-    }
-    else
-    {
-        return false;
-    }
+    return alertColor(light, false, [&]() { return light.setColorXY(x, y, 1); });
 }
 
 bool SimpleColorHueStrategy::alertRGB(uint8_t r, uint8_t g, uint8_t b, HueLight& light) const
+{
+    return alertColor(light, false, [&]() { return light.setColorRGB(r, g, b, 1); });
+}
+
+bool SimpleColorHueStrategy::alertColor(
+    HueLight& light, bool restoreTemperature, const std::function<bool()>& setColor)
 {
     light.refreshState();
-    std::string cType = light.state["state"]["colormode"].get<std::string>();
-    bool on = light.state["state"]["on"].get<bool>();
-    if (cType == "hs")
+    const LightState state = light.getState();
+    const bool temperature = state.colormode == ColorMode::CT;
+    if (state.colormode != ColorMode::HS && state.colormode != ColorMode::XY && !(restoreTemperature && temperature))
     {
-        uint16_t oldHue = light.state["state"]["hue"].get<uint16_t>();
-        uint8_t oldSat = light.state["state"]["sat"].get<uint8_t>();
-        if (!light.setColorRGB(r, g, b, 1))
-        {
-            return false;
-        }
-        std::this_thread::sleep_for(std::chrono::milliseconds(c_PRE_ALERT_DELAY));
-        if (!light.alert())
-        {
-            return false;
-        }
-        std::this_thread::sleep_for(std::chrono::milliseconds(c_POST_ALERT_DELAY));
-        if (!on)
-        {
-            light.setColorHueSaturation(oldHue, oldSat, 1);
-            return light.OffNoRefresh(1);
-        }
-        else
-        {
-            return light.setColorHueSaturation(oldHue, oldSat, 1);
-        }
+        return false;
     }
-    else if (cType == "xy")
+    // Colors are restored as xy, whichever mode they were set in
+    const XY previous = state.colormode == ColorMode::HS
+        ? ColorConversion::hueSaturationToXY(state.hue, state.sat, light.getColorType())
+        : state.xy;
+    if (!setColor())
     {
-        float oldX = light.state["state"]["xy"][0].get<float>();
-        float oldY = light.state["state"]["xy"][1].get<float>();
-        if (!light.setColorRGB(r, g, b, 1))
-        {
-            return false;
-        }
-        std::this_thread::sleep_for(std::chrono::milliseconds(c_PRE_ALERT_DELAY));
-        if (!light.alert())
-        {
-            return false;
-        }
-        std::this_thread::sleep_for(std::chrono::milliseconds(c_POST_ALERT_DELAY));
-        if (!on)
-        {
-            light.setColorXY(oldX, oldY, 1);
-            return light.OffNoRefresh(1);
-        }
-        else
-        {
-            return light.setColorXY(oldX, oldY, 1);
-        }
+        return false;
     }
-    else
+    std::this_thread::sleep_for(std::chrono::milliseconds(c_PRE_ALERT_DELAY));
+    if (!light.alert())
     {
         return false;
     }
+    std::this_thread::sleep_for(std::chrono::milliseconds(c_POST_ALERT_DELAY));
+    const bool restored
+        = temperature ? light.setColorTemperature(state.ct, 1) : light.setColorXY(previous.x, previous.y, 1);
+    if (!state.on)
+    {
+        return light.OffNoRefresh(1);
+    }
+    return restored;
 }
 
 std::pair<uint16_t, uint8_t> SimpleColorHueStrategy::getColorHueSaturation(HueLight& light) const
 {
     light.refreshState();
-    return std::make_pair(light.state["state"]["hue"].get<uint16_t>(), light.state["state"]["sat"].get<uint8_t>());
+    const LightState state = light.getState();
+    return std::make_pair(state.hue, state.sat);
 }
 
 std::pair<uint16_t, uint8_t> SimpleColorHueStrategy::getColorHueSaturation(const HueLight& light) const
 {
-    return std::make_pair(light.state["state"]["hue"].get<uint16_t>(), light.state["state"]["sat"].get<uint8_t>());
+    const LightState state = light.getState();
+    return std::make_pair(state.hue, state.sat);
 }
 
 std::pair<float, float> SimpleColorHueStrategy::getColorXY(HueLight& light) const
 {
     light.refreshState();
-    return std::make_pair(light.state["state"]["xy"][0].get<float>(), light.state["state"]["xy"][1].get<float>());
+    const LightState state = light.getState();
+    return std::make_pair(state.xy.x, state.xy.y);
 }
 
 std::pair<float, float> SimpleColorHueStrategy::getColorXY(const HueLight& light) const
 {
-    return std::make_pair(light.state["state"]["xy"][0].get<float>(), light.state["state"]["xy"][1].get<float>());
+    const LightState state = light.getState();
+    return std::make_pair(state.xy.x, state.xy.y);
 }
-/*bool SimpleColorHueStrategy::pointInTriangle(float pointx, float pointy, float
-x0, float y0, float x1, float y1, float x2, float y2)
-{
-float A = (-y1 * x2 + y0*(-x1 + x2) + x0*(y1 - y2) + x1 * y1);
-int8_t sign = A < 0 ? -1 : 1;
-float s = (y0 * x2 - x0 * y2 + (y2 - y0) * pointx + (x0 - x2) * pointy) * sign;
-float t = (x0 * y1 - y0 * x1 + (y0 - y1) * pointx + (x1 - x0) * pointy) * sign;
-
-return s > 0 && t > 0 && (s + t) < A * sign;
-}*/
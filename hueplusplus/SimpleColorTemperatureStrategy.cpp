@@ -33,16 +33,17 @@
 bool SimpleColorTemperatureStrategy::setColorTemperature(unsigned int mired, uint8_t transition, HueLight& light) const
 {
     light.refreshState();
-    nlohmann::json request = nlohmann::json::object();
+    const LightState state = light.getState();
+    StateRequest request;
     if (transition != 4)
     {
-        request["transitiontime"] = transition;
+        request.setTransition(transition);
     }
-    if (light.state["state"]["on"] != true)
+    if (!state.on)
     {
-        request["on"] = true;
+        request.setOn(true);
     }
-    if (light.state["state"]["ct"] != mired)
+    if (!state.has(LightState::CT) || state.ct != mired)
     {
         if (mired > 500)
         {
@@ -52,29 +53,28 @@ bool SimpleColorTemperatureStrategy::setColorTemperature(unsigned int mired, uin
         {
             mired = 153;
         }
-        request["ct"] = mired;
+        request.setColorTemperature(static_cast<uint16_t>(mired));
     }
 
-    if (!request.count("on") && !request.count("ct"))
+    if (!request.has(StateRequest::ON) && !request.has(StateRequest::CT))
     {
         // Nothing needs to be changed
         return true;
     }
 
-    nlohmann::json reply = light.SendPutRequest(request, "/state", CURRENT_FILE_INFO);
-
     // Check whether request was successful
-    return utils::validateReplyForLight(request, reply, light.id);
+    return light.SendStateRequest(request, CURRENT_FILE_INFO).isSuccess();
 }
 
 bool SimpleColorTemperatureStrategy::alertTemperature(unsigned int mired, HueLight& light) const
 {
     light.refreshState();
-    std::string cType = light.state["state"]["colormode"].get<std::string>();
-    bool on = light.state["state"]["on"].get<bool>();
-    if (cType == "ct")
+    const LightState state = light.getState();
+    ColorMode cType = state.colormode;
+    bool on = state.on;
+    if (cType == ColorMode::CT)
     {
-        uint16_t oldCT = light.state["state"]["ct"].get<uint16_t>();
+        uint16_t oldCT = state.ct;
         if (!light.setColorTemperature(mired, 1))
         {
             return false;
@@ -104,10 +104,10 @@ bool SimpleColorTemperatureStrategy::alertTemperature(unsigned int mired, HueLig
 unsigned int SimpleColorTemperatureStrategy::getColorTemperature(HueLight& light) const
 {
     light.refreshState();
-    return light.state["state"]["ct"].get<unsigned int>();
+    return light.getState().ct;
 }
 
 unsigned int SimpleColorTemperatureStrategy::getColorTemperature(const HueLight& light) const
 {
-    return light.state["state"]["ct"].get<unsigned int>();
+    return light.getState().ct;
 }
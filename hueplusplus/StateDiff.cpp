@@ -0,0 +1,245 @@
+/**
+    \file StateDiff.cpp
+    Copyright Notice\n
+    Copyright (C) 2017  Jan Rogall		- developer\n
+    Copyright (C) 2017  Moritz Wirger	- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "include/StateDiff.h"
+
+#include <cstdlib>
+#include <mutex>
+#include <shared_mutex>
+
+namespace
+{
+    // Parses the numeric id of a resource, returns false if key is not a number
+    bool parseId(const std::string& key, int& id)
+    {
+        if (key.empty())
+        {
+            return false;
+        }
+        char* end = nullptr;
+        long value = std::strtol(key.c_str(), &end, 10);
+        if (*end != '\0')
+        {
+            return false;
+        }
+        id = static_cast<int>(value);
+        return true;
+    }
+
+    const nlohmann::json& getMemberOrNull(const nlohmann::json& json, const char* key)
+    {
+        static const nlohmann::json null;
+        if (!json.is_object())
+        {
+            return null;
+        }
+        auto it = json.find(key);
+        return it == json.end() ? null : *it;
+    }
+} // namespace
+
+StateDiff::StateDiff(const StateDiff& other)
+{
+    std::shared_lock<SharedMutex> lock(other.mutex);
+    subscribers = other.subscribers;
+    nextHandle = other.nextHandle;
+}
+
+StateDiff& StateDiff::operator=(const StateDiff& other)
+{
+    if (this != &other)
+    {
+        // Copying first means the two locks are never held at once
+        StateDiff copy(other);
+        std::lock_guard<SharedMutex> lock(mutex);
+        subscribers = std::move(copy.subscribers);
+        nextHandle = copy.nextHandle;
+    }
+    return *this;
+}
+
+int StateDiff::subscribe(Subscriber subscriber)
+{
+    std::lock_guard<SharedMutex> lock(mutex);
+    int handle = nextHandle++;
+    subscribers.emplace(handle, Subscription{false, ResourceType::LIGHT, std::move(subscriber)});
+    return handle;
+}
+
+int StateDiff::subscribe(ResourceType resource, Subscriber subscriber)
+{
+    std::lock_guard<SharedMutex> lock(mutex);
+    int handle = nextHandle++;
+    subscribers.emplace(handle, Subscription{true, resource, std::move(subscriber)});
+    return handle;
+}
+
+void StateDiff::unsubscribe(int handle)
+{
+    std::lock_guard<SharedMutex> lock(mutex);
+    subscribers.erase(handle);
+}
+
+bool StateDiff::hasSubscribers() const
+{
+    std::shared_lock<SharedMutex> lock(mutex);
+    return !subscribers.empty();
+}
+
+std::vector<StateChange> StateDiff::update(const nlohmann::json& previous, const nlohmann::json& current)
+{
+    std::vector<StateChange> changes = compare(previous, current);
+    notify(changes);
+    return changes;
+}
+
+void StateDiff::notify(const std::vector<StateChange>& changes) const
+{
+    if (changes.empty())
+    {
+        return;
+    }
+    std::vector<Subscription> current;
+    {
+        std::shared_lock<SharedMutex> lock(mutex);
+        current.reserve(subscribers.size());
+        for (const auto& entry : subscribers)
+        {
+            current.push_back(entry.second);
+        }
+    }
+    for (const StateChange& change : changes)
+    {
+        for (const Subscription& subscription : current)
+        {
+            if (!subscription.filtered || subscription.resource == change.resource)
+            {
+                subscription.subscriber(change);
+            }
+        }
+    }
+}
+
+std::vector<StateChange> StateDiff::compare(const nlohmann::json& previous, const nlohmann::json& current)
+{
+    std::vector<StateChange> changes;
+    compareCollection(
+        ResourceType::LIGHT, getMemberOrNull(previous, "lights"), getMemberOrNull(current, "lights"), changes);
+    compareCollection(
+        ResourceType::GROUP, getMemberOrNull(previous, "groups"), getMemberOrNull(current, "groups"), changes);
+    compareCollection(
+        ResourceType::SENSOR, getMemberOrNull(previous, "sensors"), getMemberOrNull(current, "sensors"), changes);
+    return changes;
+}
+
+void StateDiff::compareResource(ResourceType resource, int id, const nlohmann::json& previous,
+    const nlohmann::json& current, std::vector<StateChange>& changes)
+{
+    if (previous.is_object() && current.is_object())
+    {
+        std::string path;
+        compareObject(resource, id, path, previous, current, changes);
+    }
+    else if (previous != current)
+    {
+        changes.push_back(StateChange{resource, id, std::string(), previous, current});
+    }
+}
+
+void StateDiff::compareCollection(ResourceType resource, const nlohmann::json& previous,
+    const nlohmann::json& current, std::vector<StateChange>& changes)
+{
+    static const nlohmann::json null;
+    int id = 0;
+    if (previous.is_object())
+    {
+        for (auto it = previous.begin(); it != previous.end(); ++it)
+        {
+            if (!parseId(it.key(), id))
+            {
+                continue;
+            }
+            auto currentIt = current.is_object() ? current.find(it.key()) : current.end();
+            if (!current.is_object() || currentIt == current.end())
+            {
+                // Resource was removed
+                compareResource(resource, id, it.value(), null, changes);
+            }
+            else
+            {
+                compareResource(resource, id, it.value(), currentIt.value(), changes);
+            }
+        }
+    }
+    if (current.is_object())
+    {
+        for (auto it = current.begin(); it != current.end(); ++it)
+        {
+            if (parseId(it.key(), id) && (!previous.is_object() || previous.find(it.key()) == previous.end()))
+            {
+                // Resource was added
+                compareResource(resource, id, null, it.value(), changes);
+            }
+        }
+    }
+}
+
+void StateDiff::compareObject(ResourceType resource, int id, std::string& path, const nlohmann::json& previous,
+    const nlohmann::json& current, std::vector<StateChange>& changes)
+{
+    const std::size_t pathLength = path.size();
+    for (auto it = previous.begin(); it != previous.end(); ++it)
+    {
+        if (pathLength != 0)
+        {
+            path.push_back('/');
+        }
+        path.append(it.key());
+        auto currentIt = current.find(it.key());
+        if (currentIt == current.end())
+        {
+            changes.push_back(StateChange{resource, id, path, it.value(), nullptr});
+        }
+        else if (it->is_object() && currentIt->is_object())
+        {
+            compareObject(resource, id, path, it.value(), currentIt.value(), changes);
+        }
+        else if (it.value() != currentIt.value())
+        {
+            changes.push_back(StateChange{resource, id, path, it.value(), currentIt.value()});
+        }
+        path.resize(pathLength);
+    }
+    for (auto it = current.begin(); it != current.end(); ++it)
+    {
+        if (previous.find(it.key()) == previous.end())
+        {
+            if (pathLength != 0)
+            {
+                path.push_back('/');
+            }
+            path.append(it.key());
+            changes.push_back(StateChange{resource, id, path, nullptr, it.value()});
+            path.resize(pathLength);
+        }
+    }
+}
@@ -0,0 +1,263 @@
+/**
+    \file StateRequest.cpp
+    Copyright Notice\n
+    Copyright (C) 2018  Jan Rogall		- developer\n
+    Copyright (C) 2018  Moritz Wirger	- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "include/StateRequest.h"
+
+#include <cmath>
+
+#include "include/NumberFormat.h"
+
+namespace
+{
+    // Appends ",\"key\":" or "\"key\":" for the first member
+    void appendKey(std::string& out, const char* key)
+    {
+        if (out.size() > 1)
+        {
+            out.push_back(',');
+        }
+        out.push_back('"');
+        out.append(key);
+        out.append("\":", 2);
+    }
+
+    void appendString(std::string& out, const char* value)
+    {
+        out.push_back('"');
+        out.append(value);
+        out.push_back('"');
+    }
+} // namespace
+
+void StateRequest::setOn(bool value)
+{
+    state.on = value;
+    fields |= ON;
+}
+
+void StateRequest::setBrightness(uint8_t value)
+{
+    state.bri = value;
+    fields |= BRI;
+}
+
+void StateRequest::setHue(uint16_t value)
+{
+    state.hue = value;
+    fields |= HUE;
+}
+
+void StateRequest::setSaturation(uint8_t value)
+{
+    state.sat = value;
+    fields |= SAT;
+}
+
+void StateRequest::setXY(float x, float y)
+{
+    state.xy = {x, y};
+    fields |= XY;
+}
+
+void StateRequest::setColorTemperature(uint16_t value)
+{
+    state.ct = value;
+    fields |= CT;
+}
+
+void StateRequest::setAlert(Alert value)
+{
+    state.alert = value;
+    fields |= ALERT;
+}
+
+void StateRequest::setEffect(Effect value)
+{
+    state.effect = value;
+    fields |= EFFECT;
+}
+
+void StateRequest::setTransition(uint16_t value)
+{
+    transition = value;
+    fields |= TRANSITION;
+}
+
+void StateRequest::applyTo(LightState& target) const
+{
+    if (has(ON))
+    {
+        target.on = state.on;
+        target.members |= LightState::ON;
+    }
+    if (has(BRI))
+    {
+        target.bri = state.bri;
+        target.members |= LightState::BRI;
+    }
+    if (has(HUE))
+    {
+        target.hue = state.hue;
+        target.colormode = ColorMode::HS;
+        target.members |= LightState::HUE | LightState::COLORMODE;
+    }
+    if (has(SAT))
+    {
+        target.sat = state.sat;
+        target.colormode = ColorMode::HS;
+        target.members |= LightState::SAT | LightState::COLORMODE;
+    }
+    if (has(XY))
+    {
+        target.xy = state.xy;
+        target.colormode = ColorMode::XY;
+        target.members |= LightState::XY | LightState::COLORMODE;
+    }
+    if (has(CT))
+    {
+        target.ct = state.ct;
+        target.colormode = ColorMode::CT;
+        target.members |= LightState::CT | LightState::COLORMODE;
+    }
+    if (has(EFFECT))
+    {
+        target.effect = state.effect;
+        target.members |= LightState::EFFECT;
+    }
+}
+
+void StateRequest::serialize(std::string& out) const
+{
+    out.clear();
+    out.push_back('{');
+    // Keys are sorted like in nlohmann::json
+    if (has(ALERT))
+    {
+        appendKey(out, "alert");
+        appendString(out, alertToString(state.alert));
+    }
+    if (has(BRI))
+    {
+        appendKey(out, "bri");
+        utils::appendUnsigned(out, state.bri);
+    }
+    if (has(CT))
+    {
+        appendKey(out, "ct");
+        utils::appendUnsigned(out, state.ct);
+    }
+    if (has(EFFECT))
+    {
+        appendKey(out, "effect");
+        appendString(out, effectToString(state.effect));
+    }
+    if (has(HUE))
+    {
+        appendKey(out, "hue");
+        utils::appendUnsigned(out, state.hue);
+    }
+    if (has(ON))
+    {
+        appendKey(out, "on");
+        out.append(state.on ? "true" : "false");
+    }
+    if (has(SAT))
+    {
+        appendKey(out, "sat");
+        utils::appendUnsigned(out, state.sat);
+    }
+    if (has(TRANSITION))
+    {
+        appendKey(out, "transitiontime");
+        utils::appendUnsigned(out, transition);
+    }
+    if (has(XY))
+    {
+        appendKey(out, "xy");
+        out.push_back('[');
+        utils::appendFloat(out, state.xy.x);
+        out.push_back(',');
+        utils::appendFloat(out, state.xy.y);
+        out.push_back(']');
+    }
+    out.push_back('}');
+}
+
+nlohmann::json StateRequest::toJson() const
+{
+    nlohmann::json result = nlohmann::json::object();
+    if (has(ALERT))
+    {
+        result["alert"] = alertToString(state.alert);
+    }
+    if (has(BRI))
+    {
+        result["bri"] = state.bri;
+    }
+    if (has(CT))
+    {
+        result["ct"] = state.ct;
+    }
+    if (has(EFFECT))
+    {
+        result["effect"] = effectToString(state.effect);
+    }
+    if (has(HUE))
+    {
+        result["hue"] = state.hue;
+    }
+    if (has(ON))
+    {
+        result["on"] = state.on;
+    }
+    if (has(SAT))
+    {
+        result["sat"] = state.sat;
+    }
+    if (has(TRANSITION))
+    {
+        result["transitiontime"] = transition;
+    }
+    if (has(XY))
+    {
+        result["xy"] = {state.xy.x, state.xy.y};
+    }
+    return result;
+}
+
+const char* alertToString(Alert alert)
+{
+    switch (alert)
+    {
+    case Alert::SELECT:
+        return "select";
+    case Alert::LSELECT:
+        return "lselect";
+    default:
+        return "none";
+    }
+}
+
+const char* effectToString(Effect effect)
+{
+    return effect == Effect::COLORLOOP ? "colorloop" : "none";
+}
@@ -0,0 +1,273 @@
+/**
+    \file TransitionEngine.cpp
+    Copyright Notice\n
+    Copyright (C) 2017  Jan Rogall		- developer\n
+    Copyright (C) 2017  Moritz Wirger	- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "include/TransitionEngine.h"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+#include "include/ColorConversion.h"
+#include "include/HueExceptionMacro.h"
+
+namespace
+{
+    // Length of one transition time unit of the bridge
+    constexpr std::chrono::milliseconds transitionUnit(100);
+    // Points checked on every segment between two keyframes
+    constexpr int segmentSamples = 16;
+
+    struct Lab
+    {
+        float l;
+        float a;
+        float b;
+    };
+
+    // Color with unrounded brightness
+    struct Color
+    {
+        XY xy;
+        float bri;
+    };
+
+    Lab toOklab(Color color)
+    {
+        const float Y = color.bri / 254.0f;
+        if (color.xy.y <= 0.0f || Y <= 0.0f)
+        {
+            return {0.0f, 0.0f, 0.0f};
+        }
+        const float X = Y * color.xy.x / color.xy.y;
+        const float Z = Y * (1.0f - color.xy.x - color.xy.y) / color.xy.y;
+        const float l = std::cbrt(0.8189330101f * X + 0.3618667424f * Y - 0.1288597137f * Z);
+        const float m = std::cbrt(0.0329845436f * X + 0.9293118715f * Y + 0.0361456387f * Z);
+        const float s = std::cbrt(0.0482003018f * X + 0.2643662691f * Y + 0.6338517070f * Z);
+        return {0.2104542553f * l + 0.7936177850f * m - 0.0040720468f * s,
+            1.9779984951f * l - 2.4285922050f * m + 0.4505937099f * s,
+            0.0259040371f * l + 0.7827717662f * m - 0.8086757660f * s};
+    }
+
+    // Black has no chromaticity, then fallback is used
+    Color fromOklab(Lab lab, XY fallback)
+    {
+        const float l = lab.l + 0.3963377774f * lab.a + 0.2158037573f * lab.b;
+        const float m = lab.l - 0.1055613458f * lab.a - 0.0638541728f * lab.b;
+        const float s = lab.l - 0.0894841775f * lab.a - 1.2914855480f * lab.b;
+        const float l3 = l * l * l;
+        const float m3 = m * m * m;
+        const float s3 = s * s * s;
+        const float X = 1.2270138511f * l3 - 0.5577999807f * m3 + 0.2812561490f * s3;
+        const float Y = -0.0405801784f * l3 + 1.1122568696f * m3 - 0.0716766787f * s3;
+        const float Z = -0.0763812845f * l3 - 0.4214819784f * m3 + 1.5861632204f * s3;
+        const float sum = X + Y + Z;
+        if (Y <= 0.0f || sum <= 0.0f)
+        {
+            return {fallback, 0.0f};
+        }
+        return {{X / sum, Y / sum}, std::min(Y * 254.0f, 254.0f)};
+    }
+
+    float labDistance(Lab a, Lab b)
+    {
+        const float l = a.l - b.l;
+        const float da = a.a - b.a;
+        const float db = a.b - b.b;
+        return std::sqrt(l * l + da * da + db * db);
+    }
+
+    TransitionColor quantize(Color color)
+    {
+        return {color.xy, static_cast<uint8_t>(std::lround(std::max(color.bri, 0.0f)))};
+    }
+
+    Color toColor(TransitionColor color)
+    {
+        return {color.xy, float(color.bri)};
+    }
+
+    // Path of a transition in Oklab
+    class Path
+    {
+    public:
+        Path(TransitionColor from, TransitionColor to, ColorType colorType)
+            : from(from), to(to), fromLab(toOklab(toColor(from))), toLab(toOklab(toColor(to))), colorType(colorType)
+        {}
+
+        Color at(float t) const
+        {
+            const Lab lab{fromLab.l + (toLab.l - fromLab.l) * t, fromLab.a + (toLab.a - fromLab.a) * t,
+                fromLab.b + (toLab.b - fromLab.b) * t};
+            Color color = fromOklab(lab, t < 0.5f ? from.xy : to.xy);
+            color.xy = ColorConversion::clampToGamut(color.xy, colorType);
+            return color;
+        }
+
+    private:
+        TransitionColor from;
+        TransitionColor to;
+        Lab fromLab;
+        Lab toLab;
+        ColorType colorType;
+    };
+
+    // Largest distance between the path and the linear fade of the bridge from start to end
+    float segmentError(const Path& path, Color start, Color end, int startStep, int endStep, int steps)
+    {
+        float error = 0.0f;
+        for (int i = 1; i < segmentSamples; ++i)
+        {
+            const float u = float(i) / segmentSamples;
+            const Color shown{{start.xy.x + (end.xy.x - start.xy.x) * u, start.xy.y + (end.xy.y - start.xy.y) * u},
+                start.bri + (end.bri - start.bri) * u};
+            const Color planned = path.at((startStep + (endStep - startStep) * u) / steps);
+            error = std::max(error, labDistance(toOklab(shown), toOklab(planned)));
+        }
+        return error;
+    }
+} // namespace
+
+TransitionEngine::TransitionEngine(float maxError, std::chrono::milliseconds minInterval) : maxError(maxError)
+{
+    const auto interval = std::max(
+        minInterval, std::chrono::duration_cast<std::chrono::milliseconds>(HueCommandAPI::minDelay));
+    // Round up to whole transition time units
+    this->minInterval = ((interval + transitionUnit - std::chrono::milliseconds(1)) / transitionUnit) * transitionUnit;
+}
+
+float TransitionEngine::getMaxError() const
+{
+    return maxError;
+}
+
+std::chrono::milliseconds TransitionEngine::getMinInterval() const
+{
+    return minInterval;
+}
+
+std::vector<TransitionKeyframe> TransitionEngine::plan(
+    TransitionColor from, TransitionColor to, std::chrono::milliseconds duration, ColorType colorType) const
+{
+    const int steps = static_cast<int>((duration + transitionUnit / 2) / transitionUnit);
+    const Path path(from, to, colorType);
+    const TransitionColor target{ColorConversion::clampToGamut(to.xy, colorType), to.bri};
+    if (steps <= 0)
+    {
+        return {{std::chrono::milliseconds(0), target, 0}};
+    }
+    const int minSteps = static_cast<int>(minInterval / transitionUnit);
+
+    std::vector<TransitionKeyframe> keyframes;
+    // Color the light shows at the start of the current segment
+    Color shown = path.at(0.0f);
+    int current = 0;
+    while (current < steps)
+    {
+        // Extend the segment as long as the fade of the bridge stays close to the path
+        int end = std::min(current + minSteps, steps);
+        while (end < steps)
+        {
+            const Color next = toColor(quantize(path.at(float(end + 1) / steps)));
+            if (segmentError(path, shown, next, current, end + 1, steps) > maxError)
+            {
+                break;
+            }
+            ++end;
+        }
+        const TransitionColor color = end == steps ? target : quantize(path.at(float(end) / steps));
+        keyframes.push_back({current * transitionUnit, color, static_cast<uint16_t>(end - current)});
+        shown = toColor(color);
+        current = end;
+    }
+    return keyframes;
+}
+
+Result<void> TransitionEngine::run(HueLight& light, TransitionColor to, std::chrono::milliseconds duration) const
+{
+    const ColorType colorType = light.getColorType();
+    if (!ColorConversion::getGamut(colorType))
+    {
+        // Keyframes are sent as xy, which the light would reject after it was turned on
+        return HueError(CURRENT_FILE_INFO, "Light does not support xy colors");
+    }
+    const LightState state = light.getState();
+    const std::vector<TransitionKeyframe> keyframes = plan(getColor(state, colorType), to, duration, colorType);
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < keyframes.size(); ++i)
+    {
+        const TransitionKeyframe& keyframe = keyframes[i];
+        std::this_thread::sleep_until(start + keyframe.time);
+        StateRequest request;
+        request.setTransition(keyframe.transition);
+        if (i == 0 && !state.on)
+        {
+            request.setOn(true);
+        }
+        request.setXY(keyframe.color.xy.x, keyframe.color.xy.y);
+        if (i + 1 == keyframes.size() && to.bri == 0)
+        {
+            // Fade out completely
+            request.setOn(false);
+        }
+        else
+        {
+            request.setBrightness(std::max(keyframe.color.bri, uint8_t(1)));
+        }
+        Result<utils::ReplyValidation> result = light.trySetState(request);
+        if (!result.ok())
+        {
+            return result.getError();
+        }
+    }
+    return Result<void>();
+}
+
+TransitionColor TransitionEngine::interpolate(TransitionColor from, TransitionColor to, float t, ColorType colorType)
+{
+    return quantize(Path(from, to, colorType).at(t));
+}
+
+float TransitionEngine::distance(TransitionColor a, TransitionColor b)
+{
+    return labDistance(toOklab(toColor(a)), toOklab(toColor(b)));
+}
+
+TransitionColor TransitionEngine::getColor(const LightState& state, ColorType colorType)
+{
+    TransitionColor color{{0.0f, 0.0f}, state.on ? state.bri : uint8_t(0)};
+    switch (state.colormode)
+    {
+    case ColorMode::XY:
+        color.xy = state.xy;
+        break;
+    case ColorMode::CT:
+        color.xy = ColorConversion::colorTemperatureToXY(state.ct);
+        break;
+    case ColorMode::HS:
+        color.xy = ColorConversion::hueSaturationToXY(state.hue, state.sat, colorType);
+        break;
+    default:
+        color.xy = ColorConversion::rgbToXY(255, 255, 255);
+        break;
+    }
+    return color;
+}
@@ -22,61 +22,173 @@
 
 #include "include/Utils.h"
 
-#include <iostream>
+#include <cmath>
+#include <cstring>
 
 namespace utils
 {
-    bool validateReplyForLight(const nlohmann::json& request, const nlohmann::json& reply, int lightId)
+    namespace
     {
-        bool success = false;
-        std::string path = "/lights/" + std::to_string(lightId) + "/state/";
-        for (auto it = reply.begin(); it != reply.end(); ++it)
+        // Returns the position of the attribute name in "/lights/<lightId>/state/<attribute>",
+        // or std::string::npos if the path belongs to something else
+        template <typename String>
+        std::size_t findStateAttribute(const String& path, int lightId)
         {
-            success = it.value().count("success");
-            if (success)
+            const char lightsPrefix[] = "/lights/";
+            const char statePrefix[] = "/state/";
+            const std::size_t lightsLength = sizeof(lightsPrefix) - 1;
+            const std::size_t stateLength = sizeof(statePrefix) - 1;
+            if (path.compare(0, lightsLength, lightsPrefix) != 0)
             {
-                // Traverse through first object
-                nlohmann::json successObject = it.value()["success"];
-                for (auto successIt = successObject.begin(); successIt != successObject.end(); ++successIt)
+                return std::string::npos;
+            }
+            std::size_t pos = lightsLength;
+            long id = 0;
+            while (pos < path.size() && path[pos] >= '0' && path[pos] <= '9')
+            {
+                id = id * 10 + (path[pos] - '0');
+                ++pos;
+            }
+            if (pos == lightsLength || id != lightId || path.compare(pos, stateLength, statePrefix) != 0)
+            {
+                return std::string::npos;
+            }
+            return pos + stateLength;
+        }
+
+        // Returns the position of the attribute name in "<prefix>/<attribute>",
+        // or std::string::npos if the path belongs to something else
+        template <typename String>
+        std::size_t findAttribute(const String& path, const std::string& prefix)
+        {
+            // Paths in the reply always start with a slash
+            const std::size_t start = !prefix.empty() && prefix.front() != '/' ? 1 : 0;
+            const std::size_t end = start + prefix.size();
+            if (path.size() <= end || (start == 1 && path.front() != '/')
+                || path.compare(start, prefix.size(), prefix.c_str()) != 0 || path[end] != '/')
+            {
+                return std::string::npos;
+            }
+            return end + 1;
+        }
+
+        // Returns the field of the attribute starting at pos, or 0 if it is not known
+        template <typename String>
+        uint16_t getField(const String& path, std::size_t pos)
+        {
+            static const struct
+            {
+                const char* name;
+                StateRequest::Field field;
+            } fields[] = {{"on", StateRequest::ON}, {"bri", StateRequest::BRI}, {"hue", StateRequest::HUE},
+                {"sat", StateRequest::SAT}, {"xy", StateRequest::XY}, {"ct", StateRequest::CT},
+                {"alert", StateRequest::ALERT}, {"effect", StateRequest::EFFECT},
+                {"transitiontime", StateRequest::TRANSITION}};
+            for (const auto& entry : fields)
+            {
+                if (path.compare(pos, std::string::npos, entry.name) == 0)
                 {
-                    const std::string successPath = successIt.key();
-                    if (successPath.find(path) == 0)
+                    return entry.field;
+                }
+            }
+            return 0;
+        }
+
+        template <typename Json>
+        bool isUnsignedEqual(const Json& value, unsigned int expected)
+        {
+            return value.is_number_integer() && value.template get<int64_t>() == static_cast<int64_t>(expected);
+        }
+
+        template <typename Json>
+        bool isStringEqual(const Json& value, const char* expected)
+        {
+            return value.is_string()
+                && std::strcmp(value.template get_ref<const typename Json::string_t&>().c_str(), expected) == 0;
+        }
+
+        template <typename Json>
+        bool isCoordinateEqual(const Json& value, float expected)
+        {
+            return value.is_number() && std::abs(value.template get<float>() - expected) <= 1E-4f;
+        }
+
+        template <typename Json>
+        bool isValueEqual(const StateRequest& request, uint16_t field, const Json& value)
+        {
+            const LightState& state = request.getState();
+            switch (field)
+            {
+            case StateRequest::ON:
+                return value.is_boolean() && value.template get<bool>() == state.on;
+            case StateRequest::BRI:
+                return isUnsignedEqual(value, state.bri);
+            case StateRequest::HUE:
+                return isUnsignedEqual(value, state.hue);
+            case StateRequest::SAT:
+                return isUnsignedEqual(value, state.sat);
+            case StateRequest::CT:
+                return isUnsignedEqual(value, state.ct);
+            case StateRequest::TRANSITION:
+                return isUnsignedEqual(value, request.getTransition());
+            case StateRequest::ALERT:
+                return isStringEqual(value, alertToString(state.alert));
+            case StateRequest::EFFECT:
+                return isStringEqual(value, effectToString(state.effect));
+            case StateRequest::XY:
+                return value.is_array() && value.size() == 2 && isCoordinateEqual(value[0], state.xy.x)
+                    && isCoordinateEqual(value[1], state.xy.y);
+            default:
+                return false;
+            }
+        }
+
+        // Compares all success entries of reply with request.
+        // findAttribute returns the position of the attribute name in a path or std::string::npos.
+        template <typename Json, typename Finder>
+        ReplyValidation compareReply(const StateRequest& request, const Json& reply, Finder findAttribute)
+        {
+            ReplyValidation result;
+            if (!reply.is_array() || reply.empty())
+            {
+                result.unexpected = true;
+                return result;
+            }
+            for (const Json& entry : reply)
+            {
+                auto successIt = entry.is_object() ? entry.find("success") : entry.end();
+                if (successIt == entry.end() || !successIt->is_object())
+                {
+                    result.unexpected = true;
+                    continue;
+                }
+                for (auto it = successIt->begin(); it != successIt->end(); ++it)
+                {
+                    const auto& path = it.key();
+                    const std::size_t pos = findAttribute(path);
+                    const uint16_t field = pos == std::string::npos ? 0 : getField(path, pos);
+                    if (field == 0 || !request.has(static_cast<StateRequest::Field>(field)))
                     {
-                        const std::string valueKey = successPath.substr(path.size());
-                        auto requestIt = request.find(valueKey);
-                        success = requestIt != request.end();
-                        if (success)
-                        {
-                            if (valueKey == "xy")
-                            {
-                                success
-                                    = std::abs(requestIt.value()[0].get<float>() - successIt.value()[0].get<float>())
-                                        <= 1E-4f
-                                    && std::abs(requestIt.value()[1].get<float>() - successIt.value()[1].get<float>())
-                                        <= 1E-4f;
-                            }
-                            else
-                            {
-                                success = requestIt.value() == successIt.value();
-                            }
-                            if (!success)
-                            {
-                                std::cout << "Value " << requestIt.value() << " does not match reply "
-                                          << successIt.value() << std::endl;
-                            }
-                        }
+                        result.unexpected = true;
                     }
-                    else
+                    else if (!isValueEqual(request, field, it.value()))
                     {
-                        success = false;
+                        result.mismatched |= field;
                     }
                 }
             }
-            if (!success) // Fail fast
-            {
-                break;
-            }
+            return result;
         }
-        return success;
+    } // namespace
+
+    ReplyValidation validateReplyForLight(const StateRequest& request, const nlohmann::json& reply, int lightId)
+    {
+        return compareReply(
+            request, reply, [lightId](const std::string& path) { return findStateAttribute(path, lightId); });
+    }
+
+    ReplyValidation validateReply(const StateRequest& request, const ArenaJson& reply, const std::string& path)
+    {
+        return compareReply(request, reply, [&path](const ArenaString& key) { return findAttribute(key, path); });
     }
-} // namespace utils
\ No newline at end of file
+} // namespace utils
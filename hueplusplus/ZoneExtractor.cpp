@@ -0,0 +1,301 @@
+/**
+    \file ZoneExtractor.cpp
+    Copyright Notice\n
+    Copyright (C) 2017  Jan Rogall		- developer\n
+    Copyright (C) 2017  Moritz Wirger	- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "include/ZoneExtractor.h"
+
+#include <algorithm>
+
+#include "include/HueExceptionMacro.h"
+#include "include/SimdSupport.h"
+
+namespace
+{
+    // Pixels are 3 bytes, so three registers hold a whole number of pixels.
+    // The masks select the bytes of one channel in each of the three registers.
+    template <std::size_t Bytes>
+    struct ChannelMasks
+    {
+        uint8_t mask[3][3][Bytes];
+    };
+
+    template <std::size_t Bytes>
+    constexpr ChannelMasks<Bytes> createChannelMasks()
+    {
+        ChannelMasks<Bytes> result{};
+        for (std::size_t reg = 0; reg < 3; ++reg)
+        {
+            for (std::size_t channel = 0; channel < 3; ++channel)
+            {
+                for (std::size_t i = 0; i < Bytes; ++i)
+                {
+                    result.mask[reg][channel][i] = (reg * Bytes + i) % 3 == channel ? 0xFF : 0;
+                }
+            }
+        }
+        return result;
+    }
+
+    void sumScalar(const uint8_t* pixels, std::size_t count, uint64_t* sums)
+    {
+        uint64_t red = 0;
+        uint64_t green = 0;
+        uint64_t blue = 0;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            red += pixels[3 * i];
+            green += pixels[3 * i + 1];
+            blue += pixels[3 * i + 2];
+        }
+        sums[0] += red;
+        sums[1] += green;
+        sums[2] += blue;
+    }
+
+#ifdef HUEPLUSPLUS_SSE2
+    constexpr ChannelMasks<16> masksSSE2 = createChannelMasks<16>();
+
+    // Sums 16 pixels at a time, the sum of absolute differences to 0 adds up 8 bytes at once
+    std::size_t sumSSE2(const uint8_t* pixels, std::size_t count, uint64_t* sums)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        __m128i masks[3][3];
+        for (int reg = 0; reg < 3; ++reg)
+        {
+            for (int channel = 0; channel < 3; ++channel)
+            {
+                masks[reg][channel]
+                    = _mm_loadu_si128(reinterpret_cast<const __m128i*>(masksSSE2.mask[reg][channel]));
+            }
+        }
+        __m128i accumulators[3] = {zero, zero, zero};
+        std::size_t i = 0;
+        for (; i + 16 <= count; i += 16)
+        {
+            for (int reg = 0; reg < 3; ++reg)
+            {
+                const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels + 3 * i + 16 * reg));
+                for (int channel = 0; channel < 3; ++channel)
+                {
+                    accumulators[channel] = _mm_add_epi64(
+                        accumulators[channel], _mm_sad_epu8(_mm_and_si128(bytes, masks[reg][channel]), zero));
+                }
+            }
+        }
+        for (int channel = 0; channel < 3; ++channel)
+        {
+            uint64_t lanes[2];
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), accumulators[channel]);
+            sums[channel] += lanes[0] + lanes[1];
+        }
+        return i;
+    }
+#endif
+
+#ifdef HUEPLUSPLUS_AVX2
+    constexpr ChannelMasks<32> masksAVX2 = createChannelMasks<32>();
+
+    // Sums 32 pixels at a time
+    __attribute__((target("avx2"))) std::size_t sumAVX2(const uint8_t* pixels, std::size_t count, uint64_t* sums)
+    {
+        const __m256i zero = _mm256_setzero_si256();
+        __m256i masks[3][3];
+        for (int reg = 0; reg < 3; ++reg)
+        {
+            for (int channel = 0; channel < 3; ++channel)
+            {
+                masks[reg][channel]
+                    = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(masksAVX2.mask[reg][channel]));
+            }
+        }
+        __m256i accumulators[3] = {zero, zero, zero};
+        std::size_t i = 0;
+        for (; i + 32 <= count; i += 32)
+        {
+            for (int reg = 0; reg < 3; ++reg)
+            {
+                const __m256i bytes
+                    = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pixels + 3 * i + 32 * reg));
+                for (int channel = 0; channel < 3; ++channel)
+                {
+                    accumulators[channel] = _mm256_add_epi64(accumulators[channel],
+                        _mm256_sad_epu8(_mm256_and_si256(bytes, masks[reg][channel]), zero));
+                }
+            }
+        }
+        for (int channel = 0; channel < 3; ++channel)
+        {
+            uint64_t lanes[4];
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), accumulators[channel]);
+            sums[channel] += lanes[0] + lanes[1] + lanes[2] + lanes[3];
+        }
+        return i;
+    }
+#endif
+
+    // Adds the color components of a row of pixels to sums
+    void sumRow(const uint8_t* pixels, std::size_t count, uint64_t* sums, ColorConversion::Simd simd)
+    {
+        std::size_t done = 0;
+        switch (simd)
+        {
+#ifdef HUEPLUSPLUS_AVX2
+        case ColorConversion::Simd::AVX2:
+            done = sumAVX2(pixels, count, sums);
+            break;
+#endif
+#ifdef HUEPLUSPLUS_SSE2
+        case ColorConversion::Simd::SSE2:
+            done = sumSSE2(pixels, count, sums);
+            break;
+#endif
+        default:
+            break;
+        }
+        // Remaining pixels that do not fill whole registers
+        sumScalar(pixels + 3 * done, count - done, sums);
+    }
+
+    // Zones whose largest average component is at most this are black, the hue of darker colors is only noise
+    constexpr uint8_t blackLevel = 3;
+} // namespace
+
+ZoneExtractor::ZoneExtractor(unsigned int frameWidth, unsigned int frameHeight, std::vector<FrameZone> zones)
+    : frameWidth(frameWidth),
+      frameHeight(frameHeight),
+      zones(std::move(zones)),
+      red(this->zones.size()),
+      green(this->zones.size()),
+      blue(this->zones.size()),
+      x(this->zones.size()),
+      y(this->zones.size()),
+      brightness(this->zones.size(), 1)
+{
+    for (const FrameZone& zone : this->zones)
+    {
+        if (zone.width == 0 || zone.height == 0)
+        {
+            throw HueException(CURRENT_FILE_INFO, "Zone is empty");
+        }
+        if (zone.left > frameWidth || zone.width > frameWidth - zone.left || zone.top > frameHeight
+            || zone.height > frameHeight - zone.top)
+        {
+            throw HueException(CURRENT_FILE_INFO, "Zone is not inside of the frame");
+        }
+    }
+}
+
+unsigned int ZoneExtractor::getFrameWidth() const
+{
+    return frameWidth;
+}
+
+unsigned int ZoneExtractor::getFrameHeight() const
+{
+    return frameHeight;
+}
+
+const std::vector<FrameZone>& ZoneExtractor::getZones() const
+{
+    return zones;
+}
+
+void ZoneExtractor::process(const uint8_t* frame, std::size_t stride)
+{
+    process(frame, stride, utils::getProcessorSimd());
+}
+
+void ZoneExtractor::process(const uint8_t* frame, std::size_t stride, ColorConversion::Simd simd)
+{
+    // The sums only use integers, so they are vectorized in fixed point builds too.
+    // rgbToXY falls back by itself when its floating point kernels are not available.
+    simd = std::min(simd, utils::getProcessorSimd());
+    for (std::size_t i = 0; i < zones.size(); ++i)
+    {
+        const FrameZone& zone = zones[i];
+        uint64_t sums[3] = {0, 0, 0};
+        for (unsigned int row = 0; row < zone.height; ++row)
+        {
+            sumRow(frame + (zone.top + row) * stride + 3 * std::size_t(zone.left), zone.width, sums, simd);
+        }
+        const uint64_t count = uint64_t(zone.width) * zone.height;
+        red[i] = static_cast<uint8_t>((sums[0] + count / 2) / count);
+        green[i] = static_cast<uint8_t>((sums[1] + count / 2) / count);
+        blue[i] = static_cast<uint8_t>((sums[2] + count / 2) / count);
+        const unsigned int maxComponent = std::max({red[i], green[i], blue[i]});
+        brightness[i] = static_cast<uint8_t>(std::max((maxComponent * 254 + 127) / 255, 1u));
+    }
+    ColorConversion::rgbToXY(red.data(), green.data(), blue.data(), zones.size(), x.data(), y.data(), nullptr, simd);
+}
+
+RGB ZoneExtractor::getColor(std::size_t zone) const
+{
+    return {red[zone], green[zone], blue[zone]};
+}
+
+XY ZoneExtractor::getXY(std::size_t zone) const
+{
+    return {x[zone], y[zone]};
+}
+
+uint8_t ZoneExtractor::getBrightness(std::size_t zone) const
+{
+    return brightness[zone];
+}
+
+Result<void> ZoneExtractor::send(Hue& bridge, uint16_t transition) const
+{
+    Result<void> result;
+    for (std::size_t i = 0; i < zones.size(); ++i)
+    {
+        HueLight& light = bridge.getLight(zones[i].lightId);
+        // The cached state includes what earlier sends were accepted with, so on only changes when it has to
+        const bool on = light.getState().on;
+        StateRequest request;
+        if (std::max({red[i], green[i], blue[i]}) <= blackLevel)
+        {
+            // Black has no xy coordinates, the gamut would move {0, 0} to saturated blue
+            if (!on)
+            {
+                continue;
+            }
+            request.setOn(false);
+        }
+        else
+        {
+            // Clamped like the bridge does, so deadband filters compare with the color the light reports
+            const XY xy = ColorConversion::clampToGamut({x[i], y[i]}, light.getColorType());
+            if (!on)
+            {
+                request.setOn(true);
+            }
+            request.setXY(xy.x, xy.y);
+            request.setBrightness(brightness[i]);
+        }
+        request.setTransition(transition);
+        Result<utils::ReplyValidation> reply = light.trySetState(request);
+        if (!reply.ok() && result.ok())
+        {
+            result = reply.getError();
+        }
+    }
+    return result;
+}
@@ -0,0 +1,77 @@
+/**
+    \file bench_BridgeSnapshot.cpp
+    Copyright Notice\n
+    Copyright (C) 2017  Jan Rogall		- developer\n
+    Copyright (C) 2017  Moritz Wirger	- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include <cstdio>
+#include <sstream>
+#include <string>
+
+#include "benchmark.h"
+
+#include "BridgeSnapshot.h"
+
+namespace
+{
+    void measureEncoding(const BridgeSnapshot& snapshot, SnapshotEncoding encoding, const char* name)
+    {
+        const int iterations = 100;
+        const std::vector<uint8_t> data = snapshot.encode(encoding);
+        std::printf("%s: %zu bytes\n", name, data.size());
+        benchmark::measure("  encode", iterations, [&]() { benchmark::doNotOptimize(snapshot.encode(encoding)); });
+        benchmark::measure("  decode", iterations, [&]() {
+            BridgeSnapshot result = BridgeSnapshot::decode(data, encoding);
+            benchmark::doNotOptimize(result);
+        });
+    }
+} // namespace
+
+int main()
+{
+    const nlohmann::json bridgeState = benchmark::createBridgeState(200);
+    BridgeSnapshot snapshot;
+    snapshot.ip = "192.168.2.116";
+    snapshot.username = "ThisIsAnUsernameForTheHueBridge";
+    for (auto it = bridgeState["lights"].begin(); it != bridgeState["lights"].end(); ++it)
+    {
+        snapshot.lights.push_back(BridgeSnapshot::Light{
+            std::stoi(it.key()), it.value()["modelid"].get<std::string>(), ColorType::GAMUT_C, it.value()});
+    }
+    std::printf("Snapshot with 200 lights\n");
+    measureEncoding(snapshot, SnapshotEncoding::JSON, "JSON text");
+    measureEncoding(snapshot, SnapshotEncoding::CBOR, "CBOR");
+    measureEncoding(snapshot, SnapshotEncoding::MSGPACK, "MessagePack");
+
+    std::stringstream stream;
+    snapshot.write(stream);
+    const std::string data = stream.str();
+    std::printf("BridgeSnapshot::write: %zu bytes\n", data.size());
+    benchmark::measure("  write", 100, [&]() {
+        std::ostringstream out;
+        snapshot.write(out);
+        benchmark::doNotOptimize(out);
+    });
+    benchmark::measure("  read", 100, [&]() {
+        std::istringstream in(data);
+        BridgeSnapshot result = BridgeSnapshot::read(in);
+        benchmark::doNotOptimize(result);
+    });
+    return 0;
+}
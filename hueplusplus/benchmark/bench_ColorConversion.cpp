@@ -0,0 +1,185 @@
+/**
+    \file bench_ColorConversion.cpp
+    Copyright Notice\n
+    Copyright (C) 2017  Jan Rogall		- developer\n
+    Copyright (C) 2017  Moritz Wirger	- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "benchmark.h"
+
+#include "ColorConversion.h"
+
+int main()
+{
+    // Roughly the pixel count of a downscaled video frame
+    const std::size_t count = 4096;
+    std::vector<uint8_t> r(count);
+    std::vector<uint8_t> g(count);
+    std::vector<uint8_t> b(count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        r[i] = static_cast<uint8_t>(i * 7);
+        g[i] = static_cast<uint8_t>(i * 13 + 5);
+        b[i] = static_cast<uint8_t>(i * 31 + 11);
+    }
+    std::vector<float> x(count);
+    std::vector<float> y(count);
+    std::vector<float> brightness(count);
+
+    const int iterations = 2000;
+    std::printf("Converting %zu colors\n", count);
+    benchmark::measure("pow per color", iterations, [&]() {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            float c[3] = {float(r[i]) / 255, float(g[i]) / 255, float(b[i]) / 255};
+            for (float& v : c)
+            {
+                v = (v > 0.04045f) ? std::pow((v + 0.055f) / (1.0f + 0.055f), 2.4f) : (v / 12.92f);
+            }
+            const float X = c[0] * 0.664511f + c[1] * 0.154324f + c[2] * 0.162028f;
+            const float Y = c[0] * 0.283881f + c[1] * 0.668433f + c[2] * 0.047685f;
+            const float Z = c[0] * 0.000088f + c[1] * 0.072310f + c[2] * 0.986039f;
+            x[i] = X / (X + Y + Z);
+            y[i] = Y / (X + Y + Z);
+            brightness[i] = Y;
+        }
+        benchmark::doNotOptimize(x[count - 1]);
+    });
+    benchmark::measure("rgbToXY per color", iterations, [&]() {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const XY xy = ColorConversion::rgbToXY(r[i], g[i], b[i], &brightness[i]);
+            x[i] = xy.x;
+            y[i] = xy.y;
+        }
+        benchmark::doNotOptimize(x[count - 1]);
+    });
+    // Integer path used on embedded platforms, it only pays off where float division is slow
+    benchmark::measure("rgbToXYFixed per color", iterations, [&]() {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const XY xy = ColorConversion::rgbToXYFixed(r[i], g[i], b[i], &brightness[i]);
+            x[i] = xy.x;
+            y[i] = xy.y;
+        }
+        benchmark::doNotOptimize(x[count - 1]);
+    });
+
+    const ColorConversion::Simd supported = ColorConversion::getSupportedSimd();
+    const struct
+    {
+        const char* name;
+        ColorConversion::Simd simd;
+    } kernels[] = {{"batch scalar", ColorConversion::Simd::NONE}, {"batch SSE2", ColorConversion::Simd::SSE2},
+        {"batch AVX2", ColorConversion::Simd::AVX2}};
+    for (const auto& kernel : kernels)
+    {
+        if (kernel.simd > supported)
+        {
+            std::printf("%-40s %15s\n", kernel.name, "not supported");
+            continue;
+        }
+        benchmark::measure(kernel.name, iterations, [&]() {
+            ColorConversion::rgbToXY(
+                r.data(), g.data(), b.data(), count, x.data(), y.data(), brightness.data(), kernel.simd);
+            benchmark::doNotOptimize(x[count - 1]);
+        });
+    }
+
+    // Most converted colors are outside of gamut A
+    const ColorConversion::Gamut& gamut = *ColorConversion::getGamut(ColorType::GAMUT_A);
+    std::printf("\nClamping %zu colors to gamut A\n", count);
+    std::vector<float> clampedX(count);
+    std::vector<float> clampedY(count);
+    benchmark::measure("clampToGamut per color", iterations, [&]() {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const XY xy = ColorConversion::clampToGamut({x[i], y[i]}, gamut);
+            clampedX[i] = xy.x;
+            clampedY[i] = xy.y;
+        }
+        benchmark::doNotOptimize(clampedX[count - 1]);
+    });
+    benchmark::measure("clampToGamutFixed per color", iterations, [&]() {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const XY xy = ColorConversion::clampToGamutFixed({x[i], y[i]}, ColorType::GAMUT_A);
+            clampedX[i] = xy.x;
+            clampedY[i] = xy.y;
+        }
+        benchmark::doNotOptimize(clampedX[count - 1]);
+    });
+    for (const auto& kernel : kernels)
+    {
+        if (kernel.simd > supported)
+        {
+            continue;
+        }
+        benchmark::measure(kernel.name, iterations, [&]() {
+            clampedX = x;
+            clampedY = y;
+            ColorConversion::clampToGamut(clampedX.data(), clampedY.data(), count, gamut, kernel.simd);
+            benchmark::doNotOptimize(clampedX[count - 1]);
+        });
+    }
+
+    // Dashboard refresh with lights in all color modes
+    std::vector<LightState> states(count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        LightState& state = states[i];
+        state.on = true;
+        state.bri = static_cast<uint8_t>(i % 254 + 1);
+        state.colormode = static_cast<ColorMode>(i % 3 + 1);
+        state.hue = static_cast<uint16_t>(i * 97);
+        state.sat = static_cast<uint8_t>(i % 255);
+        state.xy = {x[i], y[i]};
+        state.ct = static_cast<uint16_t>(153 + i % 347);
+    }
+    std::vector<RGB> rgb(count);
+    std::printf("\nConverting %zu light states to RGB\n", count);
+    benchmark::measure("stateToRGB", iterations, [&]() {
+        ColorConversion::stateToRGB(states.data(), count, rgb.data());
+        benchmark::doNotOptimize(rgb[count - 1]);
+    });
+
+    // Normalizing hue and saturation commands to xy and back
+    std::printf("\nConverting %zu colors between hue/saturation and xy for gamut C\n", count);
+    benchmark::measure("hueSaturationToXY per color", iterations, [&]() {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const XY xy = ColorConversion::hueSaturationToXY(states[i].hue, states[i].sat, ColorType::GAMUT_C);
+            clampedX[i] = xy.x;
+            clampedY[i] = xy.y;
+        }
+        benchmark::doNotOptimize(clampedX[count - 1]);
+    });
+    std::vector<HueSaturation> hueSaturation(count);
+    benchmark::measure("xyToHueSaturation per color", iterations, [&]() {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            hueSaturation[i] = ColorConversion::xyToHueSaturation({x[i], y[i]}, ColorType::GAMUT_C);
+        }
+        benchmark::doNotOptimize(hueSaturation[count - 1]);
+    });
+    return 0;
+}
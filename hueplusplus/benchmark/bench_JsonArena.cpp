@@ -0,0 +1,144 @@
+/**
+    \file bench_JsonArena.cpp
+    Copyright Notice\n
+    Copyright (C) 2018  Jan Rogall		- developer\n
+    Copyright (C) 2018  Moritz Wirger	- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+#include "benchmark.h"
+
+#include "BaseHttpHandler.h"
+#include "HueCommandAPI.h"
+#include "HueExceptionMacro.h"
+#include "JsonArena.h"
+#include "Utils.h"
+#include "json/json.hpp"
+
+namespace
+{
+    std::atomic<std::size_t> allocationCount{0};
+
+    const char* const reply = "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\n\r\n"
+                              "[{\"success\":{\"/lights/1/state/transitiontime\":10}},"
+                              "{\"success\":{\"/lights/1/state/on\":true}},"
+                              "{\"success\":{\"/lights/1/state/xy\":[0.3127,0.329]}}]";
+
+    // Answers every request with the same reply, without network access
+    class ReplayHttpHandler : public BaseHttpHandler
+    {
+    public:
+        std::string send(const std::string& /*msg*/, const std::string& /*adr*/, int /*port*/) const override
+        {
+            return reply;
+        }
+        std::vector<std::string> sendMulticast(const std::string& /*msg*/, const std::string& /*adr*/,
+            int /*port*/, int /*timeout*/) const override
+        {
+            return {};
+        }
+    };
+
+    // Allocations of one call to f
+    template <typename F>
+    std::size_t countAllocations(F f)
+    {
+        // First call may allocate thread local buffers
+        f();
+        const std::size_t before = allocationCount;
+        f();
+        return allocationCount - before;
+    }
+} // namespace
+
+void* operator new(std::size_t size)
+{
+    ++allocationCount;
+    void* p = std::malloc(size ? size : 1);
+    if (!p)
+    {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+int main()
+{
+    HueCommandAPI commands("127.0.0.1", 80, "user", std::make_shared<ReplayHttpHandler>());
+    StateRequest request;
+    request.setTransition(10);
+    request.setOn(true);
+    request.setXY(0.3127f, 0.329f);
+    const nlohmann::json jsonRequest = request.toJson();
+
+    // HueCommandAPI waits minDelay between requests, so only the allocations are measured for the whole cycle
+    const std::size_t jsonCycle = countAllocations([&]() {
+        nlohmann::json response = commands.PUTRequest("/lights/1/state", jsonRequest, CURRENT_FILE_INFO);
+        benchmark::doNotOptimize(utils::validateReplyForLight(request, response, 1));
+    });
+    const std::size_t arenaCycle = countAllocations([&]() {
+        benchmark::doNotOptimize(commands.PUTRequest("/lights/1/state", request, CURRENT_FILE_INFO));
+    });
+    std::printf("Heap allocations per state request\n");
+    std::printf("%-40s %12zu\n", "nlohmann::json request and reply", jsonCycle);
+    std::printf("%-40s %12zu\n", "StateRequest, ArenaJson reply", arenaCycle);
+
+    // Parsing and validating the reply alone
+    const std::string body = std::string(reply).substr(std::string(reply).find("\r\n\r\n") + 4);
+    JsonArena arena;
+    const std::size_t jsonParse = countAllocations([&]() {
+        nlohmann::json response = nlohmann::json::parse(body);
+        benchmark::doNotOptimize(utils::validateReplyForLight(request, response, 1));
+    });
+    const std::size_t arenaParse = countAllocations([&]() {
+        JsonArena::Scope scope(arena);
+        ArenaJson response = ArenaJson::parse(body);
+        benchmark::doNotOptimize(utils::validateReply(request, response, "/lights/1/state"));
+    });
+    std::printf("\nHeap allocations to parse and validate the reply\n");
+    std::printf("%-40s %12zu\n", "nlohmann::json", jsonParse);
+    std::printf("%-40s %12zu\n", "ArenaJson", arenaParse);
+
+    const int iterations = 100000;
+    std::printf("\n");
+    benchmark::measure("nlohmann::json parse + validate", iterations, [&]() {
+        nlohmann::json response = nlohmann::json::parse(body);
+        benchmark::doNotOptimize(utils::validateReplyForLight(request, response, 1));
+    });
+    benchmark::measure("ArenaJson parse + validate", iterations, [&]() {
+        JsonArena::Scope scope(arena);
+        ArenaJson response = ArenaJson::parse(body);
+        benchmark::doNotOptimize(utils::validateReply(request, response, "/lights/1/state"));
+    });
+    return 0;
+}
@@ -0,0 +1,135 @@
+/**
+    \file bench_LightFields.cpp
+    Copyright Notice\n
+    Copyright (C) 2017  Jan Rogall		- developer\n
+    Copyright (C) 2017  Moritz Wirger	- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "benchmark.h"
+
+#include "LightFields.h"
+#include "LightState.h"
+#include "LightStateParser.h"
+#include "json/json.hpp"
+
+namespace
+{
+    std::atomic<std::size_t> liveBytes{0};
+
+    // Every allocation is prefixed with its size, so freed memory can be subtracted
+    constexpr std::size_t headerSize = alignof(std::max_align_t);
+} // namespace
+
+void* operator new(std::size_t size)
+{
+    void* p = std::malloc(size + headerSize);
+    if (!p)
+    {
+        throw std::bad_alloc();
+    }
+    *static_cast<std::size_t*>(p) = size;
+    liveBytes += size;
+    return static_cast<char*>(p) + headerSize;
+}
+
+void operator delete(void* p) noexcept
+{
+    if (p)
+    {
+        void* block = static_cast<char*>(p) - headerSize;
+        liveBytes -= *static_cast<std::size_t*>(block);
+        std::free(block);
+    }
+}
+
+void operator delete(void* p, std::size_t /*size*/) noexcept
+{
+    operator delete(p);
+}
+
+int main()
+{
+    const int lightCount = 200;
+    const nlohmann::json lights = benchmark::createBridgeState(lightCount)["lights"];
+    std::vector<std::string> replies;
+    for (const auto& light : lights)
+    {
+        replies.push_back(light.dump());
+    }
+
+    std::printf("Refresh of %d lights\n", lightCount);
+    const double dom = benchmark::measure("json::parse + LightState::fromJson", 100, [&]() {
+        for (const std::string& reply : replies)
+        {
+            nlohmann::json json = nlohmann::json::parse(reply);
+            LightState state = LightState::fromJson(json["state"]);
+            benchmark::doNotOptimize(state);
+            benchmark::doNotOptimize(json);
+        }
+    });
+    const double text = benchmark::measure("LightStateParser + LightFields", 100, [&]() {
+        for (const std::string& reply : replies)
+        {
+            LightInfo light = LightStateParser::parseLight(reply);
+            LightFields fields(reply, light);
+            benchmark::doNotOptimize(light.state);
+            benchmark::doNotOptimize(fields);
+        }
+    });
+    std::printf("Speedup: %.2fx\n", dom / text);
+    benchmark::measure("  + read swversion", 100, [&]() {
+        for (const std::string& reply : replies)
+        {
+            LightInfo light = LightStateParser::parseLight(reply);
+            LightFields fields(reply, light);
+            std::string version = fields.getString(LightField::SWVERSION);
+            benchmark::doNotOptimize(version);
+        }
+    });
+
+    std::vector<nlohmann::json> storedJson;
+    storedJson.reserve(lightCount);
+    std::size_t before = liveBytes;
+    for (const std::string& reply : replies)
+    {
+        storedJson.push_back(nlohmann::json::parse(reply));
+    }
+    std::printf("%-40s %12zu bytes\n", "Retained per light as json", (liveBytes - before) / lightCount);
+
+    std::vector<LightFields> stored;
+    stored.reserve(lightCount);
+    before = liveBytes;
+    for (const std::string& reply : replies)
+    {
+        stored.emplace_back(reply);
+    }
+    std::printf("%-40s %12zu bytes\n", "Retained per light as LightFields", (liveBytes - before) / lightCount);
+    for (const LightFields& fields : stored)
+    {
+        fields.getString(LightField::SWVERSION);
+    }
+    std::printf("%-40s %12zu bytes\n", "  after reading swversion", (liveBytes - before) / lightCount);
+    return 0;
+}
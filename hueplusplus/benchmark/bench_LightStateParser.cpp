@@ -0,0 +1,54 @@
+/**
+    \file bench_LightStateParser.cpp
+    Copyright Notice\n
+    Copyright (C) 2017  Jan Rogall		- developer\n
+    Copyright (C) 2017  Moritz Wirger	- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include <cstdio>
+#include <string>
+
+#include "benchmark.h"
+
+#include "LightState.h"
+#include "LightStateParser.h"
+#include "json/json.hpp"
+
+int main()
+{
+    const std::string body = benchmark::createBridgeState(200).dump();
+    std::printf("Bridge state with 200 lights: %zu bytes\n", body.size());
+    const int iterations = 200;
+
+    const double dom = benchmark::measure("json::parse + LightState::fromJson", iterations, [&]() {
+        nlohmann::json state = nlohmann::json::parse(body);
+        int count = 0;
+        for (const auto& light : state["lights"])
+        {
+            LightState decoded = LightState::fromJson(light["state"]);
+            count += decoded.bri;
+        }
+        benchmark::doNotOptimize(count);
+    });
+    const double sax = benchmark::measure("LightStateParser::parseBridgeState", iterations, [&]() {
+        std::vector<LightInfo> lights = LightStateParser::parseBridgeState(body);
+        benchmark::doNotOptimize(lights);
+    });
+    std::printf("Speedup: %.2fx\n", dom / sax);
+    return 0;
+}
@@ -0,0 +1,73 @@
+/**
+    \file bench_StateRequest.cpp
+    Copyright Notice\n
+    Copyright (C) 2018  Jan Rogall		- developer\n
+    Copyright (C) 2018  Moritz Wirger	- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include <cstdio>
+#include <string>
+
+#include "benchmark.h"
+
+#include "StateRequest.h"
+#include "json/json.hpp"
+
+int main()
+{
+    const int iterations = 1000000;
+    std::string buffer;
+
+    std::printf("{\"on\":true,\"bri\":200}\n");
+    const double jsonOnBri = benchmark::measure("json + dump", iterations, [&]() {
+        nlohmann::json request = nlohmann::json::object();
+        request["on"] = true;
+        request["bri"] = 200;
+        std::string body = request.dump();
+        benchmark::doNotOptimize(body);
+    });
+    const double fastOnBri = benchmark::measure("StateRequest::serialize", iterations, [&]() {
+        StateRequest request;
+        request.setOn(true);
+        request.setBrightness(200);
+        request.serialize(buffer);
+        benchmark::doNotOptimize(buffer);
+    });
+    std::printf("Speedup: %.2fx\n\n", jsonOnBri / fastOnBri);
+
+    std::printf("{\"on\":true,\"transitiontime\":10,\"xy\":[0.3127,0.329]}\n");
+    const double jsonXY = benchmark::measure("json + dump", iterations, [&]() {
+        nlohmann::json request = nlohmann::json::object();
+        request["transitiontime"] = 10;
+        request["on"] = true;
+        request["xy"][0] = 0.3127f;
+        request["xy"][1] = 0.329f;
+        std::string body = request.dump();
+        benchmark::doNotOptimize(body);
+    });
+    const double fastXY = benchmark::measure("StateRequest::serialize", iterations, [&]() {
+        StateRequest request;
+        request.setTransition(10);
+        request.setOn(true);
+        request.setXY(0.3127f, 0.329f);
+        request.serialize(buffer);
+        benchmark::doNotOptimize(buffer);
+    });
+    std::printf("Speedup: %.2fx\n", jsonXY / fastXY);
+    return 0;
+}
@@ -0,0 +1,116 @@
+/**
+    \file bench_WritePath.cpp
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+    Copyright (C) 2020  Moritz Wirger	- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "benchmark.h"
+
+#include "BaseHttpHandler.h"
+#include "Hue.h"
+#include "NumberFormat.h"
+#include "json/json.hpp"
+
+namespace
+{
+    // Answers GET with a bridge state and PUT with a successful alert, without network access
+    class ReplayHttpHandler : public BaseHttpHandler
+    {
+    public:
+        ReplayHttpHandler()
+            : bridgeState("HTTP/1.1 200 OK\r\n\r\n" + benchmark::createBridgeState(1).dump()),
+              alertReply("HTTP/1.1 200 OK\r\n\r\n[{\"success\":{\"/lights/1/state/alert\":\"select\"}}]")
+        {}
+        std::string send(const std::string& msg, const std::string& /*adr*/, int /*port*/) const override
+        {
+            return msg.compare(0, 3, "GET") == 0 ? bridgeState : alertReply;
+        }
+        std::vector<std::string> sendMulticast(const std::string& /*msg*/, const std::string& /*adr*/,
+            int /*port*/, int /*timeout*/) const override
+        {
+            return {};
+        }
+
+    private:
+        std::string bridgeState;
+        std::string alertReply;
+    };
+} // namespace
+
+int main()
+{
+    Hue bridge("127.0.0.1", 80, "ThisIsAnUsernameForTheHueBridge", std::make_shared<ReplayHttpHandler>());
+    HueLight& light = bridge.getLight(1);
+
+    // HueCommandAPI waits minDelay between requests, the wait is excluded from the measurement
+    const int iterations = 20;
+    std::chrono::steady_clock::duration total{};
+    for (int i = 0; i < iterations; ++i)
+    {
+        std::this_thread::sleep_for(HueCommandAPI::minDelay + std::chrono::milliseconds(10));
+        auto start = std::chrono::steady_clock::now();
+        benchmark::doNotOptimize(light.alert());
+        total += std::chrono::steady_clock::now() - start;
+    }
+    std::printf("%-40s %12.0f ns\n", "HueLight::alert end to end",
+        std::chrono::duration<double, std::nano>(total).count() / iterations);
+
+    const int id = 17;
+    const std::string username = "ThisIsAnUsernameForTheHueBridge";
+    const std::string apiPrefix = "/api/" + username;
+    const std::string lightPath = "/lights/" + std::to_string(id);
+    std::printf("\nRequest path\n");
+    benchmark::measure("concatenated with std::to_string", 1000000, [&]() {
+        std::string path = "/api/" + username + "/lights/" + std::to_string(id) + "/state";
+        benchmark::doNotOptimize(path);
+    });
+    benchmark::measure("precomputed prefixes", 1000000, [&]() {
+        std::string path;
+        path.reserve(apiPrefix.size() + lightPath.size() + 6);
+        path.append(apiPrefix);
+        path.append(lightPath);
+        path.append("/state");
+        benchmark::doNotOptimize(path);
+    });
+
+    std::printf("\nFormatting xy\n");
+    const float x = 0.3127f;
+    const float y = 0.329f;
+    benchmark::measure("nlohmann::json dump", 1000000, [&]() {
+        std::string out = nlohmann::json{x, y}.dump();
+        benchmark::doNotOptimize(out);
+    });
+    std::string out;
+    benchmark::measure("utils::appendFloat", 1000000, [&]() {
+        out.clear();
+        out.push_back('[');
+        utils::appendFloat(out, x);
+        out.push_back(',');
+        utils::appendFloat(out, y);
+        out.push_back(']');
+        benchmark::doNotOptimize(out);
+    });
+    return 0;
+}
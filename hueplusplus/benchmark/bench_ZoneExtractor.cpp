@@ -0,0 +1,78 @@
+/**
+    \file bench_ZoneExtractor.cpp
+    Copyright Notice\n
+    Copyright (C) 2017  Jan Rogall		- developer\n
+    Copyright (C) 2017  Moritz Wirger	- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include <cstdio>
+#include <vector>
+
+#include "benchmark.h"
+
+#include "ZoneExtractor.h"
+
+int main()
+{
+    // Full HD frame with ambilight zones along the edges, 8 on top and bottom and 4 on each side
+    const unsigned int width = 1920;
+    const unsigned int height = 1080;
+    const unsigned int depth = 160;
+    std::vector<uint8_t> frame(3 * width * height);
+    for (std::size_t i = 0; i < frame.size(); ++i)
+    {
+        frame[i] = static_cast<uint8_t>(i * 7 + i / 4096);
+    }
+    std::vector<FrameZone> zones;
+    int lightId = 1;
+    for (unsigned int i = 0; i < 8; ++i)
+    {
+        zones.push_back({lightId++, i * width / 8, 0, width / 8, depth});
+        zones.push_back({lightId++, i * width / 8, height - depth, width / 8, depth});
+    }
+    for (unsigned int i = 0; i < 4; ++i)
+    {
+        zones.push_back({lightId++, 0, depth + i * (height - 2 * depth) / 4, depth, (height - 2 * depth) / 4});
+        zones.push_back(
+            {lightId++, width - depth, depth + i * (height - 2 * depth) / 4, depth, (height - 2 * depth) / 4});
+    }
+    ZoneExtractor extractor(width, height, zones);
+
+    const int iterations = 200;
+    std::printf("Extracting %zu zones from a %ux%u frame\n", zones.size(), width, height);
+    const ColorConversion::Simd supported = ColorConversion::getSupportedSimd();
+    const struct
+    {
+        const char* name;
+        ColorConversion::Simd simd;
+    } kernels[] = {{"process scalar", ColorConversion::Simd::NONE}, {"process SSE2", ColorConversion::Simd::SSE2},
+        {"process AVX2", ColorConversion::Simd::AVX2}};
+    for (const auto& kernel : kernels)
+    {
+        if (kernel.simd > supported)
+        {
+            std::printf("%-40s %15s\n", kernel.name, "not supported");
+            continue;
+        }
+        benchmark::measure(kernel.name, iterations, [&]() {
+            extractor.process(frame.data(), 3 * width, kernel.simd);
+            benchmark::doNotOptimize(extractor.getXY(0));
+        });
+    }
+    return 0;
+}
@@ -0,0 +1,109 @@
+/**
+    \file benchmark.h
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+    Copyright (C) 2020  Moritz Wirger	- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#ifndef _BENCHMARK_H
+#define _BENCHMARK_H
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+#include "json/json.hpp"
+
+namespace benchmark
+{
+    //! \brief Prevents the compiler from optimizing away a computed value
+    template <typename T>
+    void doNotOptimize(const T& value)
+    {
+#if defined(__GNUC__)
+        // Empty asm that may read the value through memory
+        asm volatile("" : : "g"(&value) : "memory");
+#else
+        static const void* volatile sink;
+        sink = &value;
+        static_cast<void>(sink);
+#endif
+    }
+
+    //! \brief Runs \c f \c iterations times and prints the average time per iteration
+    //! \returns Average time per iteration in nanoseconds
+    template <typename F>
+    double measure(const char* name, int iterations, F f)
+    {
+        // Warm up caches and allocator
+        f();
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i)
+        {
+            f();
+        }
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        const double result = elapsed.count() / iterations;
+        std::printf("%-40s %12.0f ns\n", name, result);
+        return result;
+    }
+
+    //! \brief Builds a bridge state similar to GET /api/<username> of a bridge with \c lightCount lights
+    inline nlohmann::json createBridgeState(int lightCount)
+    {
+        nlohmann::json lights = nlohmann::json::object();
+        for (int i = 1; i <= lightCount; ++i)
+        {
+            nlohmann::json light{{"state",
+                                      {{"on", i % 2 == 0}, {"bri", i % 254 + 1}, {"hue", i * 300}, {"sat", i % 254},
+                                          {"effect", "none"}, {"xy", {0.3 + i * 0.0001, 0.4}}, {"ct", 153 + i},
+                                          {"alert", "none"}, {"colormode", "xy"}, {"mode", "homeautomation"},
+                                          {"reachable", true}}},
+                {"swupdate", {{"state", "noupdates"}, {"lastinstall", "2020-03-11T10:47:14"}}},
+                {"type", "Extended color light"}, {"name", "Hue color lamp " + std::to_string(i)},
+                {"modelid", "LCT015"}, {"manufacturername", "Signify Netherlands B.V."},
+                {"productname", "Hue color lamp"},
+                {"capabilities",
+                    {{"certified", true},
+                        {"control",
+                            {{"mindimlevel", 1000}, {"maxlumen", 806}, {"colorgamuttype", "C"},
+                                {"colorgamut", {{0.6915, 0.3083}, {0.17, 0.7}, {0.1532, 0.0475}}},
+                                {"ct", {{"min", 153}, {"max", 500}}}}},
+                        {"streaming", {{"renderer", true}, {"proxy", true}}}}},
+                {"config",
+                    {{"archetype", "sultanbulb"}, {"function", "mixed"}, {"direction", "omnidirectional"},
+                        {"startup", {{"mode", "safety"}, {"configured", true}}}}},
+                {"uniqueid", "00:17:88:01:04:00:00:" + std::to_string(i % 100) + "-0b"},
+                {"swversion", "1.50.2_r30933"}, {"swconfigid", "772B0E5E"}, {"productid", "Philips-LCT015-1-A19ECLv5"}};
+            lights[std::to_string(i)] = std::move(light);
+        }
+        nlohmann::json groups = nlohmann::json::object();
+        for (int i = 1; i <= lightCount / 10; ++i)
+        {
+            groups[std::to_string(i)] = {{"name", "Room " + std::to_string(i)}, {"type", "Room"},
+                {"lights", {std::to_string(i * 10 - 1), std::to_string(i * 10)}},
+                {"state", {{"all_on", false}, {"any_on", true}}},
+                {"action", {{"on", true}, {"bri", 254}, {"xy", {0.3, 0.4}}, {"colormode", "xy"}}}};
+        }
+        return {{"lights", std::move(lights)}, {"groups", std::move(groups)},
+            {"config", {{"name", "Philips hue"}, {"swversion", "1939070020"}, {"apiversion", "1.35.0"}}},
+            {"sensors", nlohmann::json::object()}, {"scenes", nlohmann::json::object()}};
+    }
+} // namespace benchmark
+
+#endif
@@ -49,6 +49,19 @@ public:
     //! \throws HueException when response contained no body
     std::string sendGetHTTPBody(const std::string& msg, const std::string& adr, int port = 80) const override;
 
+    //! \brief Send a message to a specified host and return the body of the response parsed as JSON.
+    //!
+    //! Used by all Json request functions. The default implementation parses the result of \ref sendGetHTTPBody,
+    //! handlers that can read the response in pieces should override it to parse while receiving.
+    //! \param msg The message that should sent to the specified address
+    //! \param adr Ip or hostname in dotted decimal notation like "192.168.2.1"
+    //! \param port Optional port the request is sent to, default is 80
+    //! \return Parsed body of the response of the host
+    //! \throws std::system_error when system or socket operations fail
+    //! \throws HueException when response contained no body
+    //! \throws nlohmann::json::parse_error when the body could not be parsed
+    virtual nlohmann::json sendGetHTTPJson(const std::string& msg, const std::string& adr, int port = 80) const;
+
     //! \brief Send a HTTP request with the given method to the specified host and return the body of the response.
     //!
     //! \param method HTTP method type e.g. GET, HEAD, POST, PUT, DELETE, ...
@@ -132,6 +145,19 @@ public:
     nlohmann::json GETJson(
         const std::string& uri, const nlohmann::json& body, const std::string& adr, int port = 80) const override;
 
+    //! \brief Send a HTTP GET request with an already serialized json body and return the unparsed body of the
+    //! response.
+    //!
+    //! \param uri Uniform Resource Identifier in the request
+    //! \param body Serialized json request body
+    //! \param adr Ip or hostname in dotted decimal notation like "192.168.2.1"
+    //! \param port Optional port the request is sent to, default is 80
+    //! \return Body of the response of the host
+    //! \throws std::system_error when system or socket operations fail
+    //! \throws HueException when response contained no body
+    std::string GETRaw(
+        const std::string& uri, const std::string& body, const std::string& adr, int port = 80) const override;
+
     //! \brief Send a HTTP POST request to the specified host and return the body of the response parsed as JSON.
     //!
     //! \param uri Uniform Resource Identifier in the request
@@ -158,6 +184,19 @@ public:
     nlohmann::json PUTJson(
         const std::string& uri, const nlohmann::json& body, const std::string& adr, int port = 80) const override;
 
+    //! \brief Send a HTTP PUT request with an already serialized json body and return the unparsed body of the
+    //! response.
+    //!
+    //! \param uri Uniform Resource Identifier in the request
+    //! \param body Serialized json request body, sent unchanged
+    //! \param adr Ip or hostname in dotted decimal notation like "192.168.2.1"
+    //! \param port Optional port the request is sent to, default is 80
+    //! \return Body of the response of the host
+    //! \throws std::system_error when system or socket operations fail
+    //! \throws HueException when response contained no body
+    std::string PUTRaw(
+        const std::string& uri, const std::string& body, const std::string& adr, int port = 80) const override;
+
     //! \brief Send a HTTP DELETE request to the specified host and return the body of the response parsed as JSON.
     //!
     //! \param uri Uniform Resource Identifier in the request
@@ -170,6 +209,17 @@ public:
     //! \throws nlohmann::json::parse_error when the body could not be parsed
     nlohmann::json DELETEJson(
         const std::string& uri, const nlohmann::json& body, const std::string& adr, int port = 80) const override;
+
+protected:
+    //! \brief Builds a HTTP request message that can be passed to \ref send
+    //!
+    //! \param method HTTP method type e.g. GET, HEAD, POST, PUT, DELETE, ...
+    //! \param uri Uniform Resource Identifier in the request
+    //! \param contentType MIME type of the body data e.g. "text/html", "application/json", ...
+    //! \param body Request body, may be empty
+    //! \return Complete request including headers and body
+    static std::string buildHTTPRequest(
+        const std::string& method, const std::string& uri, const std::string& contentType, const std::string& body);
 };
 
 #endif
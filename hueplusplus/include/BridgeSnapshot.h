@@ -0,0 +1,112 @@
+/**
+    \file BridgeSnapshot.h
+    Copyright Notice\n
+    Copyright (C) 2017  Jan Rogall		- developer\n
+    Copyright (C) 2017  Moritz Wirger	- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#ifndef _BRIDGE_SNAPSHOT_H
+#define _BRIDGE_SNAPSHOT_H
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "HueLight.h"
+
+#include "json/json.hpp"
+
+//! \brief Encoding of the json representation of a \ref BridgeSnapshot
+enum class SnapshotEncoding
+{
+    JSON, //!< Compact json text
+    CBOR, //!< Concise Binary Object Representation (RFC 7049)
+    MSGPACK //!< MessagePack
+};
+
+//! \brief Persistable copy of everything needed to control a bridge without contacting it first
+//!
+//! Contains the credentials of the bridge and the id, model id, \ref ColorType and last known state of every light.
+//! The snapshot is written in a versioned binary format, snapshots of an unknown version are rejected.
+//! It can also be converted to json, which can be encoded as CBOR or MessagePack to exchange it with other processes.
+//! Create a snapshot with \ref Hue::createSnapshot and restore it with \ref Hue::restoreSnapshot.
+struct BridgeSnapshot
+{
+    //! \brief Stored information about a single light
+    struct Light
+    {
+        int id; //!< Id of the light
+        std::string modelId; //!< Model id used to classify the light
+        ColorType colorType; //!< Classification of the light
+        nlohmann::json state; //!< Last known reply of GET /lights/<id>
+    };
+
+    //! \brief Version of the binary format that is written by \ref write
+    //!
+    //! Version 1 stored the light states as json text, version 2 stores them as CBOR.
+    static constexpr uint32_t version = 2;
+
+    std::string ip; //!< IP address of the bridge
+    int port = 80; //!< Port of the bridge
+    std::string username; //!< Username that is used to access the bridge
+    std::vector<Light> lights; //!< All lights known when the snapshot was created
+
+    //! \brief Writes the snapshot in binary format
+    //!
+    //! \param stream Stream to write to, should be opened in binary mode
+    //! \throws HueException when the stream could not be written
+    void write(std::ostream& stream) const;
+
+    //! \brief Reads a snapshot in binary format
+    //!
+    //! \param stream Stream to read from, should be opened in binary mode
+    //! \returns The snapshot that was read
+    //! \throws HueException when the stream does not contain a snapshot, has an unknown version or is truncated
+    //! \throws nlohmann::json::parse_error when a stored light state could not be parsed
+    static BridgeSnapshot read(std::istream& stream);
+
+    //! \brief Converts the snapshot to json
+    //!
+    //! \returns Object with "version", "ip", "port", "username" and "lights".
+    //! Each light is an object with "id", "modelid", "colortype" and "state".
+    nlohmann::json toJson() const;
+
+    //! \brief Converts json created by \ref toJson back to a snapshot
+    //!
+    //! \throws HueException when json has a different version or is not a valid snapshot
+    static BridgeSnapshot fromJson(const nlohmann::json& json);
+
+    //! \brief Encodes the json representation of the snapshot
+    //!
+    //! \param encoding Encoding of the result
+    //! \returns Encoded result of \ref toJson
+    std::vector<uint8_t> encode(SnapshotEncoding encoding) const;
+
+    //! \brief Decodes a snapshot created by \ref encode
+    //!
+    //! \param data Encoded snapshot
+    //! \param encoding Encoding that was used for \ref encode
+    //! \returns The decoded snapshot
+    //! \throws HueException when the decoded json has a different version or is not a valid snapshot
+    //! \throws nlohmann::json::parse_error when data could not be decoded
+    static BridgeSnapshot decode(const std::vector<uint8_t>& data, SnapshotEncoding encoding);
+};
+
+#endif
@@ -0,0 +1,224 @@
+/**
+    \file ColorConversion.h
+    Copyright Notice\n
+    Copyright (C) 2017  Jan Rogall		- developer\n
+    Copyright (C) 2017  Moritz Wirger	- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#ifndef _COLOR_CONVERSION_H
+#define _COLOR_CONVERSION_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "HueLight.h"
+#include "Units.h"
+
+//! \brief Converts colors between RGB and the CIE xy space of the lights
+class ColorConversion
+{
+public:
+    //! \brief Instruction set used by the batch conversions
+    enum class Simd
+    {
+        NONE, //!< Plain C++, used on all other platforms
+        SSE2, //!< 4 colors at a time
+        AVX2 //!< 8 colors at a time
+    };
+
+    //! \brief Triangle of xy colors a light can show
+    struct Gamut
+    {
+        XY red;
+        XY green;
+        XY blue;
+    };
+
+    //! \brief Returns the best instruction set supported by the current processor
+    static Simd getSupportedSimd();
+
+    //! \brief Removes the sRGB gamma correction of a color component
+    //!
+    //! Uses a lookup table generated at compile time.
+    //! \param value sRGB color component
+    //! \returns Linear color component from 0 to 1
+    static float srgbToLinear(uint8_t value);
+
+    //! \brief Applies the sRGB gamma correction to a color component
+    //!
+    //! Inverse of \ref srgbToLinear, which means linearToSrgb(srgbToLinear(c)) returns c for all 256 components.
+    //! \param value Linear color component from 0 to 1, other values are clamped
+    //! \returns Closest sRGB color component
+    static uint8_t linearToSrgb(float value);
+
+    //! \brief Converts xy coordinates and brightness to sRGB
+    //!
+    //! The color is scaled so that the largest component is at full intensity for brightness 254,
+    //! lower brightness scales the linear components.
+    //! Colors outside of the RGB gamut are clipped.
+    //! \param xy CIE xy color coordinates
+    //! \param brightness Brightness from 0 to 254
+    //! \returns sRGB color, black if y is 0
+    static RGB xyToRGB(XY xy, uint8_t brightness);
+
+    //! \brief Converts hue, saturation and brightness to sRGB
+    //! \param hue Hue from 0 to 65535
+    //! \param saturation Saturation from 0 to 254
+    //! \param brightness Brightness from 0 to 254, applied like in \ref xyToRGB
+    static RGB hueSaturationToRGB(uint16_t hue, uint8_t saturation, uint8_t brightness);
+
+    //! \brief Converts hue and saturation to the xy coordinates a light shows
+    //!
+    //! Uses the same conversion as \ref hueSaturationToRGB followed by \ref rgbToXY,
+    //! so colors set in both color modes can be compared. The result is moved into the gamut of the light.
+    //! \param hue Hue from 0 to 65535
+    //! \param saturation Saturation from 0 to 254
+    //! \param colorType Color type of the light, types without a known gamut are not clamped
+    static XY hueSaturationToXY(uint16_t hue, uint8_t saturation, ColorType colorType);
+
+    //! \brief Converts xy coordinates to hue and saturation
+    //!
+    //! Inverse of \ref hueSaturationToXY within the rounding of the 8 bit RGB components.
+    //! The coordinates are moved into the gamut of the light first, colors outside of the RGB gamut are clipped.
+    //! \param xy CIE xy color coordinates
+    //! \param colorType Color type of the light, types without a known gamut are not clamped
+    //! \returns Hue from 0 to 65535 and saturation from 0 to 254, both 0 if y is 0
+    static HueSaturation xyToHueSaturation(XY xy, ColorType colorType);
+
+    //! \brief Returns the xy coordinates of a color temperature on the planckian locus
+    //!
+    //! Uses a table generated at compile time.
+    //! \param mired Color temperature in mired, clamped to 40 (25000 K) to 600 (1667 K)
+    static XY colorTemperatureToXY(unsigned int mired);
+
+    //! \brief Returns the color temperature closest to xy coordinates
+    //!
+    //! Inverse of \ref colorTemperatureToXY, colors off the planckian locus return the closest point on it.
+    //! \returns Color temperature in mired from 40 to 600
+    static unsigned int xyToColorTemperature(XY xy);
+
+    //! \brief Converts a color temperature and brightness to sRGB
+    //! \param mired Color temperature in mired
+    //! \param brightness Brightness from 0 to 254, applied like in \ref xyToRGB
+    static RGB colorTemperatureToRGB(unsigned int mired, uint8_t brightness);
+
+    //! \brief Converts the color a light shows to sRGB
+    //!
+    //! Uses the color mode of the state to pick the conversion. Lights without color mode are white.
+    //! \returns sRGB color, black if the light is off
+    static RGB stateToRGB(const LightState& state);
+
+    //! \brief Converts many xy coordinates and brightness values to sRGB
+    //! \see xyToRGB(XY, uint8_t)
+    static void xyToRGB(const float* x, const float* y, const uint8_t* brightness, std::size_t count, uint8_t* r,
+        uint8_t* g, uint8_t* b);
+
+    //! \brief Converts many hue, saturation and brightness values to sRGB
+    //! \see hueSaturationToRGB(uint16_t, uint8_t, uint8_t)
+    static void hueSaturationToRGB(const uint16_t* hue, const uint8_t* saturation, const uint8_t* brightness,
+        std::size_t count, uint8_t* r, uint8_t* g, uint8_t* b);
+
+    //! \brief Converts many color temperatures and brightness values to sRGB
+    //! \see colorTemperatureToRGB(unsigned int, uint8_t)
+    static void colorTemperatureToRGB(
+        const uint16_t* mired, const uint8_t* brightness, std::size_t count, uint8_t* r, uint8_t* g, uint8_t* b);
+
+    //! \brief Converts the colors of many light states to sRGB
+    //! \see stateToRGB(const LightState&)
+    static void stateToRGB(const LightState* states, std::size_t count, RGB* rgb);
+
+    //! \brief Converts a single sRGB color to xy
+    //!
+    //! Applies the sRGB gamma correction and the wide gamut conversion matrix used by
+    //! \ref SimpleColorHueStrategy::setColorRGB.
+    //! \param r, g, b sRGB color components
+    //! \param brightness Optional output for the relative luminance Y from 0 to 1
+    //! \returns xy coordinates, {0, 0} for black
+    static XY rgbToXY(uint8_t r, uint8_t g, uint8_t b, float* brightness = nullptr);
+
+    //! \brief Converts a single sRGB color to xy with integer arithmetic
+    //!
+    //! Used by all RGB conversions when the library is compiled with HUEPLUSPLUS_FIXED_POINT,
+    //! which is the default for ESP_PLATFORM where floating point division is slow.
+    //! Results differ from \ref rgbToXY by less than 0.002, most of it for very dark colors.
+    //! \see rgbToXY(uint8_t, uint8_t, uint8_t, float*)
+    static XY rgbToXYFixed(uint8_t r, uint8_t g, uint8_t b, float* brightness = nullptr);
+
+    //! \brief Converts many sRGB colors to xy
+    //!
+    //! Input and output are separate arrays for each component, so the colors can be converted
+    //! with SIMD instructions. Results are the same as \ref rgbToXY within floating point rounding.
+    //! \param r, g, b Arrays with the sRGB color components, \c count entries each
+    //! \param count Number of colors
+    //! \param x, y Arrays receiving the xy coordinates, \c count entries each. Black is converted to {0, 0}.
+    //! \param brightness Optional array receiving the relative luminance Y from 0 to 1, may be nullptr
+    static void rgbToXY(const uint8_t* r, const uint8_t* g, const uint8_t* b, std::size_t count, float* x,
+        float* y, float* brightness);
+
+    //! \brief Converts many sRGB colors to xy using a specific instruction set
+    //!
+    //! Falls back to the best supported instruction set if \c simd is not supported.
+    //! \see rgbToXY(const uint8_t*, const uint8_t*, const uint8_t*, std::size_t, float*, float*, float*)
+    static void rgbToXY(const uint8_t* r, const uint8_t* g, const uint8_t* b, std::size_t count, float* x,
+        float* y, float* brightness, Simd simd);
+
+    //! \brief Returns the gamut of a \ref ColorType
+    //! \returns Pointer to the static gamut A, B or C, nullptr if colorType has no known gamut
+    static const Gamut* getGamut(ColorType colorType);
+
+    //! \brief Checks whether a color is inside or on the edge of a gamut
+    static bool isInGamut(XY xy, const Gamut& gamut);
+
+    //! \brief Moves a color into a gamut
+    //!
+    //! Colors outside of the gamut are replaced by the closest point on its edge, like the bridge does.
+    //! \returns xy if it is inside of the gamut, otherwise the closest color inside
+    static XY clampToGamut(XY xy, const Gamut& gamut);
+
+    //! \brief Moves a color into the gamut of a \ref ColorType
+    //! \returns xy unchanged if colorType has no known gamut,
+    //! otherwise \ref clampToGamut(XY, const Gamut&)
+    static XY clampToGamut(XY xy, ColorType colorType);
+
+    //! \brief Moves a color into a gamut with integer arithmetic
+    //!
+    //! Used by all gamut clamping when the library is compiled with HUEPLUSPLUS_FIXED_POINT.
+    //! Coordinates are rounded to multiples of 1/16384 and limited to [0, 1].
+    //! \see clampToGamut(XY, const Gamut&)
+    static XY clampToGamutFixed(XY xy, const Gamut& gamut);
+
+    //! \brief Moves a color into the gamut of a \ref ColorType with integer arithmetic
+    //! \see clampToGamut(XY, ColorType)
+    static XY clampToGamutFixed(XY xy, ColorType colorType);
+
+    //! \brief Moves many colors into a gamut
+    //!
+    //! Results are the same as \ref clampToGamut(XY, const Gamut&) within floating point rounding.
+    //! \param x, y Arrays with \c count xy coordinates, which are clamped in place
+    //! \param count Number of colors
+    //! \param gamut Gamut to clamp to
+    static void clampToGamut(float* x, float* y, std::size_t count, const Gamut& gamut);
+
+    //! \brief Moves many colors into a gamut using a specific instruction set
+    //!
+    //! Falls back to the best supported instruction set if \c simd is not supported.
+    //! \see clampToGamut(float*, float*, std::size_t, const Gamut&)
+    static void clampToGamut(float* x, float* y, std::size_t count, const Gamut& gamut, Simd simd);
+};
+
+#endif
@@ -0,0 +1,84 @@
+/**
+    \file DeadbandFilter.h
+    Copyright Notice\n
+    Copyright (C) 2017  Jan Rogall		- developer\n
+    Copyright (C) 2017  Moritz Wirger	- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#ifndef _DEADBAND_FILTER_H
+#define _DEADBAND_FILTER_H
+
+#include <atomic>
+#include <cstdint>
+
+#include "LightState.h"
+#include "StateRequest.h"
+
+//! \brief Removes changes from state requests that are too small to be seen
+//!
+//! Noisy inputs like sensors, audio or video change the color by tiny amounts all the time.
+//! Sending each of those changes wastes the rate limit of the bridge. The filter compares the
+//! requested color and brightness with the current state of the light in the perceptual Oklab
+//! color space and removes changes below the threshold. Color temperature changes are compared in mired.
+//!
+//! \par Thread safety
+//! A filter can be shared by multiple lights and threads, the counters are atomic.
+class DeadbandFilter
+{
+public:
+    //! \brief Creates a filter
+    //! \param maxDistance Largest Oklab distance of a color or brightness change that is removed.
+    //! 0.02 is about the smallest visible difference.
+    //! \param maxMired Largest color temperature change in mired that is removed
+    explicit DeadbandFilter(float maxDistance = 0.02f, unsigned int maxMired = 5);
+
+    //! \brief Returns the largest Oklab distance that is removed
+    float getMaxDistance() const;
+    //! \brief Returns the largest color temperature change in mired that is removed
+    unsigned int getMaxMired() const;
+
+    //! \brief Removes invisible changes from a request
+    //!
+    //! Only changes of a light that is on are removed, requests that turn the light off or change effects are kept.
+    //! Complete hue and saturation or xy colors are compared with the color the light shows in either of both modes,
+    //! other requests that switch the color mode are kept.
+    //! \param request Request that is changed in place
+    //! \param state Current state of the light
+    //! \returns false if nothing visible is left to send, then the request should be dropped
+    bool apply(StateRequest& request, const LightState& state);
+
+    //! \brief Returns the number of requests that were passed on
+    uint64_t getPassedRequests() const;
+    //! \brief Returns the number of requests that were dropped completely
+    uint64_t getSuppressedRequests() const;
+    //! \brief Returns the number of attributes that were removed from requests
+    //!
+    //! Also counts the attributes of dropped requests.
+    uint64_t getSuppressedFields() const;
+    //! \brief Sets all counters to 0
+    void resetCounters();
+
+private:
+    float maxDistance;
+    unsigned int maxMired;
+    std::atomic<uint64_t> passedRequests{0};
+    std::atomic<uint64_t> suppressedRequests{0};
+    std::atomic<uint64_t> suppressedFields{0};
+};
+
+#endif
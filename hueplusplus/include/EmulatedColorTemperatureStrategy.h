@@ -0,0 +1,61 @@
+/**
+    \file EmulatedColorTemperatureStrategy.h
+    Copyright Notice\n
+    Copyright (C) 2017  Jan Rogall		- developer\n
+    Copyright (C) 2017  Moritz Wirger	- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#ifndef _EMULATED_COLOR_TEMPERATURE_STRATEGY_H
+#define _EMULATED_COLOR_TEMPERATURE_STRATEGY_H
+
+#include "ExtendedColorTemperatureStrategy.h"
+#include "HueLight.h"
+
+//! \brief Class emulating color temperatures on lights that only support xy colors
+//!
+//! Color temperatures are sent as the xy coordinates of the planckian locus, which are looked up in a table
+//! generated at compile time. Used for lights with \ref ColorType::GAMUT_A, so color temperatures
+//! can be set on all color lights.
+class EmulatedColorTemperatureStrategy : public ExtendedColorTemperatureStrategy
+{
+public:
+    //! \brief Function for changing a lights color temperature in mired with a
+    //! specified transition.
+    //!
+    //! The color temperature in mired ranges from 153 to 500 whereas 153 is cold and 500 is warm.
+    //! The light is set to the xy color of the temperature with \ref HueLight::setColorXY.
+    //! \param mired The color temperature in mired
+    //! \param transition The time it takes to fade to the new color in multiples of
+    //! 100ms, 4 = 400ms and should be seen as the default
+    //! \param light A reference of the light
+    bool setColorTemperature(unsigned int mired, uint8_t transition, HueLight& light) const override;
+    //! \brief Function that returns the current color temperature of the light
+    //!
+    //! Updates the lights state by calling refreshState()
+    //! \param light A reference of the light
+    //! \return Color temperature in mired from 153 to 500 that is closest to the color of the light
+    unsigned int getColorTemperature(HueLight& light) const override;
+    //! \brief Function that returns the current color temperature of the light
+    //!
+    //! \note This does not update the lights state
+    //! \param light A const reference of the light
+    //! \return Color temperature in mired from 153 to 500 that is closest to the color of the light
+    unsigned int getColorTemperature(const HueLight& light) const override;
+};
+
+#endif
@@ -29,12 +29,16 @@
 #include <utility>
 #include <vector>
 
+#include "BridgeSnapshot.h"
 #include "BrightnessStrategy.h"
 #include "ColorHueStrategy.h"
 #include "ColorTemperatureStrategy.h"
 #include "HueCommandAPI.h"
 #include "HueLight.h"
 #include "IHttpHandler.h"
+#include "LightStateParser.h"
+#include "SharedMutex.h"
+#include "StateDiff.h"
 
 #include "json/json.hpp"
 
@@ -108,6 +112,13 @@ private:
 };
 
 //! Hue class
+//!
+//! \par Thread safety
+//! Lights can be created, listed and controlled from multiple threads at the same time. The bridge state and the
+//! light registry are guarded by a reader-writer lock that is never held while waiting for the bridge, every
+//! \ref HueLight additionally guards its own state. Returned light references stay valid until the light is removed.
+//! The configuration functions \ref requestUsername, \ref setIP, \ref setPort, \ref setHttpHandler and
+//! \ref restoreSnapshot must not be called while other threads use the bridge or its lights.
 class Hue
 {
     friend class HueFinder;
@@ -123,6 +134,21 @@ public:
     Hue(const std::string& ip, const int port, const std::string& username,
         std::shared_ptr<const IHttpHandler> handler);
 
+    //! \brief Copy constructor that holds the shared lock of \c other, so it can be used by other threads
+    //!
+    //! The lights are copied under their own locks.
+    Hue(const Hue& other);
+
+    //! \brief Move constructor, \c other must not be used by other threads
+    Hue(Hue&& other) = default;
+
+    //! \brief Copy assignment that copies \c other under its shared lock and then replaces this bridge under its lock
+    //! \attention All references to previously returned lights become invalid.
+    Hue& operator=(const Hue& other);
+
+    //! \brief Move assignment, neither bridge may be used by other threads
+    Hue& operator=(Hue&& other) = default;
+
     //! \brief Function to get the ip address of the hue bridge
     //!
     //! \return string containing ip
@@ -164,6 +190,9 @@ public:
 
     //! \brief Function that returns a \ref HueLight of specified id
     //!
+    //! The light is created from the last bulk refresh of the bridge state and cached, so no request is needed
+    //! when the light was already created or listed. The bridge is only contacted when the id is unknown.
+    //! Use the non-const getters of \ref HueLight to read a fresh state.
     //! \param id Integer that specifies the ID of a Hue light
     //! \return \ref HueLight that can be controlled
     //! \throws std::system_error when system or socket operations fail
@@ -191,6 +220,7 @@ public:
     //! \brief Function that returns all lights that are associated with this
     //! bridge
     //!
+    //! Needs a single request to the bridge, all lights are created or updated from its reply.
     //! \return A vector containing references to every HueLight
     //! \throws std::system_error when system or socket operations fail
     //! \throws HueException when response contains no body
@@ -247,8 +277,78 @@ public:
         commands = HueCommandAPI(ip, port, username, http_handler);
     }
 
+    //! \brief Function that returns the change detection of the bridge state.
+    //!
+    //! Every time the bridge state is refreshed (for example by \ref getAllLights or \ref lightExists), the new
+    //! state is compared to the previous one. Subscribers of the returned \ref StateDiff are notified about every
+    //! changed attribute of lights, groups and sensors, including changes made by other apps or switches.
+    //! The complete bridge state is only kept for the comparison while there are subscribers, so the first refresh
+    //! after subscribing does not report any changes.
+    //! \return Reference to the \ref StateDiff of this bridge
+    StateDiff& getStateDiff() { return stateDiff; }
+
+    //! \brief Function that creates a snapshot of the credentials and all lights created so far.
+    //!
+    //! \note This will not update the local state of the bridge. Call \ref getAllLights first to include all lights.
+    //! \return A \ref BridgeSnapshot that can be written to disk and restored later with \ref restoreSnapshot
+    BridgeSnapshot createSnapshot() const;
+
+    //! \brief Function that restores credentials and lights from a snapshot without contacting the bridge.
+    //!
+    //! Replaces ip, port, username and all lights. The lights are usable immediately with their last known state,
+    //! the const getters do not need a request to the bridge. Call \ref reconcile afterwards to update them.
+    //! \attention All references to previously returned lights become invalid.
+    //! \param snapshot Snapshot that was created by \ref createSnapshot
+    void restoreSnapshot(const BridgeSnapshot& snapshot);
+
+    //! \brief Function that updates all lights from a single request of the bridge state.
+    //!
+    //! Intended to be called after \ref restoreSnapshot. Lights that no longer exist on the bridge are removed,
+    //! lights that changed their model are classified again. New lights are only created by \ref getLight.
+    //! Blocks until the request is done and all lights are updated. Other threads may use the lights meanwhile,
+    //! the new color type and strategies of a light are set at once under its lock.
+    //! References to removed lights become invalid.
+    //! \throws std::system_error when system or socket operations fail
+    //! \throws HueException when response contained no body or a light was replaced by a model of unknown type,
+    //! like \ref getLight. Then no light is changed.
+    //! \throws HueAPIResponseException when response contains an error
+    //! \throws nlohmann::json::parse_error when response could not be parsed
+    void reconcile();
+
 private:
-    //! \brief Function that refreshes the local \ref state of the Hue bridge
+    //! \brief Copy constructor that is called while \c otherLock holds the shared lock of \c other
+    Hue(const Hue& other, const std::shared_lock<SharedMutex>& otherLock);
+
+    //! \brief Function that creates a light from its state and adds it to \ref lights
+    //!
+    //! \param id Id of the light
+    //! \param lightState Light in the bridge state, parsed by \ref LightStateParser
+    //! \return Reference to the cached light
+    //! \throws HueException when the type of the light is unknown
+    HueLight& createLight(int id, LightInfo lightState);
+
+    //! \brief Function that classifies a light by its model id
+    //!
+    //! \param modelId Model id of the light like "LCT001"
+    //! \return The \ref ColorType of the model or ColorType::UNDEFINED if it is unknown
+    static ColorType getColorTypeOfModel(const std::string& modelId);
+
+    //! \brief Function that classifies a light by its model id and rejects unknown models
+    //!
+    //! \param modelId Model id of the light like "LCT001"
+    //! \return The \ref ColorType of the model
+    //! \throws HueException when the model is unknown
+    static ColorType getKnownColorTypeOfModel(const std::string& modelId);
+
+    //! \brief Function that sets the color type and the matching strategies of a light
+    //!
+    //! Holds the exclusive lock of the light, so it can be used while other threads use the light.
+    void setLightType(HueLight& light, ColorType colorType) const;
+
+    //! \brief Function that refreshes the local \ref lightStates of the Hue bridge
+    //!
+    //! The reply is parsed by \ref LightStateParser. It is only parsed into a json tree for \ref stateDiff
+    //! while it has subscribers.
     //! \throws std::system_error when system or socket operations fail
     //! \throws HueException when response contained no body
     //! \throws HueAPIResponseException when response contains an error
@@ -260,8 +360,10 @@ private:
                     //!< like "192.168.2.1"
     std::string username; //!< Username that is ussed to access the hue bridge
     int port;
-    nlohmann::json state; //!< The state of the hue bridge as it is returned from it
+    std::map<int, LightInfo> lightStates; //!< Lights in the last state of the bridge, with their json text
+    nlohmann::json diffState; //!< Last state of the bridge for \ref stateDiff, null without subscribers
     std::map<uint8_t, HueLight> lights; //!< Maps ids to HueLights that are controlled by this bridge
+    mutable SharedMutex stateMutex; //!< Guards \ref lightStates, \ref diffState and \ref lights
 
     std::shared_ptr<BrightnessStrategy> simpleBrightnessStrategy; //!< Strategy that is used for controlling the
                                                                   //!< brightness of lights
@@ -274,9 +376,13 @@ private:
     std::shared_ptr<ColorTemperatureStrategy> extendedColorTemperatureStrategy; //!< Strategy that is used for
                                                                                 //!< controlling the color temperature
                                                                                 //!< of lights
+    std::shared_ptr<ColorTemperatureStrategy> emulatedColorTemperatureStrategy; //!< Strategy that is used for
+                                                                                //!< emulating the color temperature
+                                                                                //!< of lights with only xy colors
     std::shared_ptr<const IHttpHandler> http_handler; //!< A IHttpHandler that is used to communicate with the
                                                       //!< bridge
     HueCommandAPI commands; //!< A HueCommandAPI that is used to communicate with the bridge
+    StateDiff stateDiff; //!< Notifies subscribers about changes between refreshes of \ref diffState
 };
 
 #endif
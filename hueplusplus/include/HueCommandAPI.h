@@ -29,6 +29,9 @@
 
 #include "HueException.h"
 #include "IHttpHandler.h"
+#include "Result.h"
+#include "StateRequest.h"
+#include "Utils.h"
 
 //! Handles communication to the bridge via IHttpHandler and enforces a timeout
 //! between each request
@@ -70,6 +73,44 @@ public:
     nlohmann::json PUTRequest(const std::string& path, const nlohmann::json& request) const;
     nlohmann::json PUTRequest(const std::string& path, const nlohmann::json& request, FileInfo fileInfo) const;
 
+    //! \brief Sends a HTTP PUT request to the bridge without throwing on failures
+    //!
+    //! Like \ref PUTRequest, but error responses of the bridge (like an unreachable light),
+    //! failed socket operations and invalid responses are returned as \ref HueError.
+    //! \param path API request path (appended after /api/{username})
+    //! \param request Request to the api, may be empty
+    //! \param fileInfo FileInfo from calling function for error details.
+    //! \returns The response or the error
+    Result<nlohmann::json> tryPUTRequest(
+        const std::string& path, const nlohmann::json& request, FileInfo fileInfo) const;
+
+    //! \brief Sends a HTTP PUT request with a state body to the bridge and validates the response
+    //!
+    //! The request is serialized directly into a buffer that is reused by all requests of the calling thread.
+    //! The response is only needed for validation, so it is parsed into a \ref JsonArena of the calling thread
+    //! that is reset afterwards.
+    //! This function will block until at least \ref minDelay has passed to any previous request
+    //! \param path API request path (appended after /api/{username}), like "/lights/1/state"
+    //! \param request State request, like for /lights/<id>/state
+    //! \param fileInfo FileInfo from calling function for exception details.
+    //! \returns Result of comparing the response with the request
+    //! \throws std::system_error when system or socket operations fail
+    //! \throws HueException when response contains no body
+    //! \throws HueAPIResponseException when response contains an error
+    //! \throws nlohmann::json::parse_error when response could not be parsed
+    utils::ReplyValidation PUTRequest(const std::string& path, const StateRequest& request, FileInfo fileInfo) const;
+
+    //! \brief Sends a HTTP PUT request with a state body to the bridge without throwing on failures
+    //!
+    //! Like \ref PUTRequest, but error responses of the bridge (like an unreachable light),
+    //! failed socket operations and invalid responses are returned as \ref HueError.
+    //! \param path API request path (appended after /api/{username}), like "/lights/1/state"
+    //! \param request State request, like for /lights/<id>/state
+    //! \param fileInfo FileInfo from calling function for error details.
+    //! \returns Result of comparing the response with the request or the error
+    Result<utils::ReplyValidation> tryPUTRequest(
+        const std::string& path, const StateRequest& request, FileInfo fileInfo) const;
+
     //! \brief Sends a HTTP GET request to the bridge and returns the response
     //!
     //! This function will block until at least \ref minDelay has passed to any previous request
@@ -82,6 +123,36 @@ public:
     nlohmann::json GETRequest(const std::string& path, const nlohmann::json& request) const;
     nlohmann::json GETRequest(const std::string& path, const nlohmann::json& request, FileInfo fileInfo) const;
 
+    //! \brief Sends a HTTP GET request to the bridge without throwing on failures
+    //!
+    //! Like \ref GETRequest, but error responses of the bridge, failed socket operations
+    //! and invalid responses are returned as \ref HueError.
+    //! \param path API request path (appended after /api/{username})
+    //! \param request Request to the api, may be empty
+    //! \param fileInfo FileInfo from calling function for error details.
+    //! \returns The response or the error
+    Result<nlohmann::json> tryGETRequest(
+        const std::string& path, const nlohmann::json& request, FileInfo fileInfo) const;
+
+    //! \brief Sends a HTTP GET request with an empty request to the bridge and returns the unparsed response
+    //!
+    //! Lets the caller decode the response without building a json tree, like with \ref LightStateParser.
+    //! Error responses of the bridge are not detected, the parser of the caller has to check them.
+    //! This function will block until at least \ref minDelay has passed to any previous request
+    //! \param path API request path (appended after /api/{username})
+    //! \returns The return value of the underlying \ref IHttpHandler::GETRaw call
+    //! \throws std::system_error when system or socket operations fail
+    //! \throws HueException when response contains no body
+    std::string GETRaw(const std::string& path) const;
+
+    //! \brief Sends a HTTP GET request with an empty request to the bridge without throwing on failures
+    //!
+    //! Like \ref GETRaw, but failed socket operations and responses without body are returned as \ref HueError.
+    //! \param path API request path (appended after /api/{username})
+    //! \param fileInfo FileInfo from calling function for error details.
+    //! \returns The response or the error
+    Result<std::string> tryGETRaw(const std::string& path, FileInfo fileInfo) const;
+
     //! \brief Sends a HTTP DELETE request to the bridge and returns the response
     //!
     //! This function will block until at least \ref minDelay has passed to any previous request
@@ -94,6 +165,17 @@ public:
     nlohmann::json DELETERequest(const std::string& path, const nlohmann::json& request) const;
     nlohmann::json DELETERequest(const std::string& path, const nlohmann::json& request, FileInfo fileInfo) const;
 
+    //! \brief Sends a HTTP DELETE request to the bridge without throwing on failures
+    //!
+    //! Like \ref DELETERequest, but error responses of the bridge, failed socket operations
+    //! and invalid responses are returned as \ref HueError.
+    //! \param path API request path (appended after /api/{username})
+    //! \param request Request to the api, may be empty
+    //! \param fileInfo FileInfo from calling function for error details.
+    //! \returns The response or the error
+    Result<nlohmann::json> tryDELETERequest(
+        const std::string& path, const nlohmann::json& request, FileInfo fileInfo) const;
+
 private:
     struct TimeoutData
     {
@@ -104,7 +186,7 @@ private:
     //! \brief Throws an exception if response contains an error, passes though value
     //! \throws HueAPIResponseException when response contains an error
     //! \returns \ref response if there is no error
-    nlohmann::json HandleError(FileInfo fileInfo, const nlohmann::json& response) const;
+    nlohmann::json HandleError(FileInfo fileInfo, nlohmann::json response) const;
 
     //! \brief Combines path with api prefix and username
     //! \returns "/api/<username>/<path>"
@@ -115,7 +197,7 @@ public:
 private:
     std::string ip;
     int port;
-    std::string username;
+    std::string apiPrefix;
     std::shared_ptr<const IHttpHandler> httpHandler;
     std::shared_ptr<TimeoutData> timeout;
 };
@@ -29,14 +29,21 @@
 #include "json/json.hpp"
 
 //! \brief Contains information about error location, use CURRENT_FILE_INFO to create
+//!
+//! Only keeps pointers to the string literals, so creating and copying it does not allocate.
+//! The strings are combined by \ref ToString when an error is reported.
 struct FileInfo
 {
-    //! \brief Current file name from __FILE__. Empty if unknown
-    std::string filename;
+    //! \brief Current file name from __FILE__. nullptr if unknown
+    //!
+    //! Must have static storage duration like __FILE__.
+    const char* filename = nullptr;
     //! \brief Current line number from __LINE__. -1 if unknown
     int line = -1;
-    //! \brief Current function from __func__. Empty if unknown
-    std::string func;
+    //! \brief Current function from __func__. nullptr if unknown
+    //!
+    //! Must have static storage duration like __func__.
+    const char* func = nullptr;
 
     //! \brief String representation of func, file and line.
     //! \returns "<func> in <filename>:<line>" or "Unknown file" if unknown.
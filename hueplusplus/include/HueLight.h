@@ -24,11 +24,18 @@
 #define _HUE_LIGHT_H
 
 #include <memory>
+#include <shared_mutex>
 
 #include "BrightnessStrategy.h"
 #include "ColorHueStrategy.h"
 #include "ColorTemperatureStrategy.h"
+#include "DeadbandFilter.h"
 #include "HueCommandAPI.h"
+#include "LightFields.h"
+#include "LightState.h"
+#include "Result.h"
+#include "SharedMutex.h"
+#include "StateRequest.h"
 
 #include "json/json.hpp"
 
@@ -91,6 +98,14 @@ enum ColorType
 //!
 //! Class for Hue Light fixtures
 //!
+//! \par Thread safety
+//! A light can be used from multiple threads at the same time. The state is guarded by a reader-writer lock
+//! per light, so const getters of different threads do not block each other and are never blocked by requests
+//! to the bridge. Concurrent setters are not ordered, the last request received by the bridge wins.
+//! The color type, strategies and deadband filter are guarded by the same lock, because \ref Hue::reconcile and
+//! \ref setDeadbandFilter can change them while the light is used. Commands copy the strategy or filter they need
+//! and do not hold the lock while they run.
+//!
 class HueLight
 {
     friend class Hue;
@@ -99,11 +114,24 @@ class HueLight
     friend class ExtendedColorHueStrategy;
     friend class SimpleColorTemperatureStrategy;
     friend class ExtendedColorTemperatureStrategy;
+    friend class EmulatedColorTemperatureStrategy;
 
 public:
     //! \brief std dtor
     ~HueLight() = default;
 
+    //! \brief Copy constructor that holds the shared lock of \c other, so it can be used by other threads
+    HueLight(const HueLight& other);
+
+    //! \brief Move constructor, \c other must not be used by other threads
+    HueLight(HueLight&& other) = default;
+
+    //! \brief Copy assignment that copies \c other under its shared lock and then replaces this light under its lock
+    HueLight& operator=(const HueLight& other);
+
+    //! \brief Move assignment, neither light may be used by other threads
+    HueLight& operator=(HueLight&& other) = default;
+
     //! \brief Function that turns the light on.
     //!
     //! \param transition Optional parameter to set the transition from current state to new, standard is 4 = 400ms
@@ -217,6 +245,27 @@ public:
     //! \throws nlohmann::json::parse_error when response could not be parsed
     virtual bool setName(const std::string& name);
 
+    //! \brief Const function that returns the typed state of the light.
+    //!
+    //! \note This will not refresh the light state
+    //! \return Copy of the state decoded by the last refresh
+    virtual LightState getState() const;
+
+    //! \brief Const function that returns the raw state of the light.
+    //!
+    //! The reply is stored as text, so it is parsed on every call.
+    //! \note This will not refresh the light state
+    //! \return Copy of the complete json reply of the bridge from the last refresh
+    virtual nlohmann::json getRawState() const;
+
+    //! \brief Const function that returns a single member of the raw state.
+    //!
+    //! Parses the stored reply like \ref getRawState, the typed getters like \ref getState are cheaper.
+    //! \note This will not refresh the light state
+    //! \param field Member of the reply of GET /lights/<id>
+    //! \return Copy of the member or null if the bridge did not send it
+    virtual nlohmann::json getField(LightField field) const;
+
     //! \brief Const function that returns the color type of the light.
     //!
     //! \return ColorType containig the color type of the light
@@ -226,31 +275,31 @@ public:
     //!
     //! \return Bool that is true when the light has specified abilities and false
     //! when not
-    virtual bool hasBrightnessControl() const { return brightnessStrategy != nullptr; };
+    virtual bool hasBrightnessControl() const { return loadBrightnessStrategy() != nullptr; };
 
     //! \brief Const function to check whether this light has color temperature
     //! control
     //!
     //! \return Bool that is true when the light has specified abilities and false
     //! when not
-    virtual bool hasTemperatureControl() const { return colorTemperatureStrategy != nullptr; };
+    virtual bool hasTemperatureControl() const { return loadColorTemperatureStrategy() != nullptr; };
 
     //! \brief Connst function to check whether this light has full color control
     //!
     //! \return Bool that is true when the light has specified abilities and false
     //! when not
-    virtual bool hasColorControl() const { return colorHueStrategy != nullptr; };
+    virtual bool hasColorControl() const { return loadColorHueStrategy() != nullptr; };
 
     //! \brief Const function that converts Kelvin to Mired.
     //!
     //! \param kelvin Unsigned integer value in Kelvin
-    //! \return Unsigned integer value in Mired
+    //! \return Unsigned integer value in Mired rounded down, 0 if kelvin is 0
     unsigned int KelvinToMired(unsigned int kelvin) const;
 
     //! \brief Const function that converts Mired to Kelvin.
     //!
     //! \param mired Unsigned integer value in Mired
-    //! \return Unsigned integer value in Kelvin
+    //! \return Unsigned integer value in Kelvin rounded down, 0 if mired is 0
     unsigned int MiredToKelvin(unsigned int mired) const;
 
     //! \brief Function that sets the brightness of this light.
@@ -267,9 +316,10 @@ public:
     //! \throws nlohmann::json::parse_error when response could not be parsed
     virtual bool setBrightness(unsigned int bri, uint8_t transition = 4)
     {
-        if (brightnessStrategy)
+        const auto strategy = loadBrightnessStrategy();
+        if (strategy)
         {
-            return brightnessStrategy->setBrightness(bri, transition, *this);
+            return strategy->setBrightness(bri, transition, *this);
         }
         return false;
     };
@@ -282,9 +332,10 @@ public:
     //! Unsigned int that is 0 when function failed
     virtual unsigned int getBrightness() const
     {
-        if (brightnessStrategy)
+        const auto strategy = loadBrightnessStrategy();
+        if (strategy)
         {
-            return brightnessStrategy->getBrightness(*this);
+            return strategy->getBrightness(*this);
         }
         return 0;
     };
@@ -301,9 +352,10 @@ public:
     //! \throws nlohmann::json::parse_error when response could not be parsed
     virtual unsigned int getBrightness()
     {
-        if (brightnessStrategy)
+        const auto strategy = loadBrightnessStrategy();
+        if (strategy)
         {
-            return brightnessStrategy->getBrightness(*this);
+            return strategy->getBrightness(*this);
         }
         return 0;
     };
@@ -322,9 +374,10 @@ public:
     //! \throws nlohmann::json::parse_error when response could not be parsed
     virtual bool setColorTemperature(unsigned int mired, uint8_t transition = 4)
     {
-        if (colorTemperatureStrategy)
+        const auto strategy = loadColorTemperatureStrategy();
+        if (strategy)
         {
-            return colorTemperatureStrategy->setColorTemperature(mired, transition, *this);
+            return strategy->setColorTemperature(mired, transition, *this);
         }
         return false;
     };
@@ -340,9 +393,10 @@ public:
     //! \return Unsigned int representing the color temperature in mired or 0 when failed
     virtual unsigned int getColorTemperature() const
     {
-        if (colorTemperatureStrategy)
+        const auto strategy = loadColorTemperatureStrategy();
+        if (strategy)
         {
-            return colorTemperatureStrategy->getColorTemperature(*this);
+            return strategy->getColorTemperature(*this);
         }
         return 0;
     };
@@ -361,9 +415,10 @@ public:
     //! \throws nlohmann::json::parse_error when response could not be parsed
     virtual unsigned int getColorTemperature()
     {
-        if (colorTemperatureStrategy)
+        const auto strategy = loadColorTemperatureStrategy();
+        if (strategy)
         {
-            return colorTemperatureStrategy->getColorTemperature(*this);
+            return strategy->getColorTemperature(*this);
         }
         return 0;
     };
@@ -382,9 +437,10 @@ public:
     //! \throws nlohmann::json::parse_error when response could not be parsed
     virtual bool setColorHue(uint16_t hue, uint8_t transition = 4)
     {
-        if (colorHueStrategy)
+        const auto strategy = loadColorHueStrategy();
+        if (strategy)
         {
-            return colorHueStrategy->setColorHue(hue, transition, *this);
+            return strategy->setColorHue(hue, transition, *this);
         }
         return false;
     };
@@ -403,9 +459,10 @@ public:
     //! \throws nlohmann::json::parse_error when response could not be parsed
     virtual bool setColorSaturation(uint8_t sat, uint8_t transition = 4)
     {
-        if (colorHueStrategy)
+        const auto strategy = loadColorHueStrategy();
+        if (strategy)
         {
-            return colorHueStrategy->setColorSaturation(sat, transition, *this);
+            return strategy->setColorSaturation(sat, transition, *this);
         }
         return false;
     };
@@ -425,9 +482,10 @@ public:
     //! \throws nlohmann::json::parse_error when response could not be parsed
     virtual bool setColorHueSaturation(uint16_t hue, uint8_t sat, uint8_t transition = 4)
     {
-        if (colorHueStrategy)
+        const auto strategy = loadColorHueStrategy();
+        if (strategy)
         {
-            return colorHueStrategy->setColorHueSaturation(hue, sat, transition, *this);
+            return strategy->setColorHueSaturation(hue, sat, transition, *this);
         }
         return false;
     };
@@ -445,9 +503,10 @@ public:
     //! \throws nlohmann::json::parse_error when response could not be parsed
     virtual std::pair<uint16_t, uint8_t> getColorHueSaturation() const
     {
-        if (colorHueStrategy)
+        const auto strategy = loadColorHueStrategy();
+        if (strategy)
         {
-            return colorHueStrategy->getColorHueSaturation(*this);
+            return strategy->getColorHueSaturation(*this);
         }
         return {};
     };
@@ -465,9 +524,10 @@ public:
     //! \throws nlohmann::json::parse_error when response could not be parsed
     virtual std::pair<uint16_t, uint8_t> getColorHueSaturation()
     {
-        if (colorHueStrategy)
+        const auto strategy = loadColorHueStrategy();
+        if (strategy)
         {
-            return colorHueStrategy->getColorHueSaturation(*this);
+            return strategy->getColorHueSaturation(*this);
         }
         return {};
     };
@@ -486,9 +546,10 @@ public:
     //! \throws nlohmann::json::parse_error when response could not be parsed
     virtual bool setColorXY(float x, float y, uint8_t transition = 4)
     {
-        if (colorHueStrategy)
+        const auto strategy = loadColorHueStrategy();
+        if (strategy)
         {
-            return colorHueStrategy->setColorXY(x, y, transition, *this);
+            return strategy->setColorXY(x, y, transition, *this);
         }
         return false;
     };
@@ -502,9 +563,10 @@ public:
     //! empty one when failed
     virtual std::pair<float, float> getColorXY() const
     {
-        if (colorHueStrategy)
+        const auto strategy = loadColorHueStrategy();
+        if (strategy)
         {
-            return colorHueStrategy->getColorXY(*this);
+            return strategy->getColorXY(*this);
         }
         return {};
     };
@@ -521,9 +583,10 @@ public:
     //! \throws nlohmann::json::parse_error when response could not be parsed
     virtual std::pair<float, float> getColorXY()
     {
-        if (colorHueStrategy)
+        const auto strategy = loadColorHueStrategy();
+        if (strategy)
         {
-            return colorHueStrategy->getColorXY(*this);
+            return strategy->getColorXY(*this);
         }
         return {};
     };
@@ -545,13 +608,32 @@ public:
     //! \throws nlohmann::json::parse_error when response could not be parsed
     virtual bool setColorRGB(uint8_t r, uint8_t g, uint8_t b, uint8_t transition = 4)
     {
-        if (colorHueStrategy)
+        const auto strategy = loadColorHueStrategy();
+        if (strategy)
         {
-            return colorHueStrategy->setColorRGB(r, g, b, transition, *this);
+            return strategy->setColorRGB(r, g, b, transition, *this);
         }
         return false;
     };
 
+    //! \brief Function that returns the current color of the light as RGB
+    //!
+    //! \note The color is converted from the current color mode of the light and
+    //! does not need a \ref ColorHueStrategy. This function does not update the lights state.
+    //! \return RGB color, black when the light is off
+    virtual RGB getColorRGB() const;
+
+    //! \brief Function that returns the current color of the light as RGB
+    //!
+    //! \note The color is converted from the current color mode of the light and
+    //! does not need a \ref ColorHueStrategy. Updates the lights state by calling refreshState()
+    //! \return RGB color, black when the light is off
+    //! \throws std::system_error when system or socket operations fail
+    //! \throws HueException when response contained no body
+    //! \throws HueAPIResponseException when response contains an error
+    //! \throws nlohmann::json::parse_error when response could not be parsed
+    virtual RGB getColorRGB();
+
     //! \brief Function that lets the light perform one breath cycle.
     //!
     //! Can be used for locating a light.
@@ -562,6 +644,35 @@ public:
     //! \throws nlohmann::json::parse_error when response could not be parsed
     virtual bool alert();
 
+    //! \brief Function that sends a state request without throwing on expected failures.
+    //!
+    //! Error responses of the bridge (like an unreachable light or too many requests), failed socket
+    //! operations and invalid responses are returned instead of thrown, so it can be used in loops
+    //! that control many lights. The state of the light is not refreshed, but the attributes the bridge
+    //! accepted are set in the cached state.
+    //! \param request The state that should be changed
+    //! \return Result of comparing the reply with the request or the error
+    virtual Result<utils::ReplyValidation> trySetState(const StateRequest& request);
+
+    //! \brief Sets a filter that removes invisible changes from state requests
+    //!
+    //! The filter is applied to every state request of the light before it is sent.
+    //! Requests without visible changes are not sent and count as successful.
+    //! Can be called while other threads send requests, the filter is replaced under the exclusive lock.
+    //! Requests copy the filter under the shared lock and keep using the old filter until they are sent.
+    //! \param filter Filter to use, can be shared by many lights. nullptr disables filtering.
+    void setDeadbandFilter(std::shared_ptr<DeadbandFilter> filter);
+
+    //! \brief Returns the filter for state requests or nullptr if there is none
+    //!
+    //! The filter is copied under the shared lock.
+    std::shared_ptr<DeadbandFilter> getDeadbandFilter() const;
+
+    //! \brief Function that refreshes the state of the light without throwing on expected failures.
+    //!
+    //! \return Empty result or the error, the state is not changed on errors
+    virtual Result<void> tryRefreshState();
+
     //! \brief Function that lets the light perform one breath cycle in specified
     //! color temperature.
     //!
@@ -575,9 +686,10 @@ public:
     //! \throws nlohmann::json::parse_error when response could not be parsed
     virtual bool alertTemperature(unsigned int mired)
     {
-        if (colorTemperatureStrategy)
+        const auto strategy = loadColorTemperatureStrategy();
+        if (strategy)
         {
-            return colorTemperatureStrategy->alertTemperature(mired, *this);
+            return strategy->alertTemperature(mired, *this);
         }
         return false;
     };
@@ -596,9 +708,10 @@ public:
     //! \throws nlohmann::json::parse_error when response could not be parsed
     virtual bool alertHueSaturation(uint16_t hue, uint8_t sat)
     {
-        if (colorHueStrategy)
+        const auto strategy = loadColorHueStrategy();
+        if (strategy)
         {
-            return colorHueStrategy->alertHueSaturation(hue, sat, *this);
+            return strategy->alertHueSaturation(hue, sat, *this);
         }
         return false;
     };
@@ -618,9 +731,10 @@ public:
     //! \throws nlohmann::json::parse_error when response could not be parsed
     virtual bool alertXY(float x, float y)
     {
-        if (colorHueStrategy)
+        const auto strategy = loadColorHueStrategy();
+        if (strategy)
         {
-            return colorHueStrategy->alertXY(x, y, *this);
+            return strategy->alertXY(x, y, *this);
         }
         return false;
     };
@@ -641,9 +755,10 @@ public:
     //! \throws nlohmann::json::parse_error when response could not be parsed
     virtual bool alertRGB(uint8_t r, uint8_t g, uint8_t b)
     {
-        if (colorHueStrategy)
+        const auto strategy = loadColorHueStrategy();
+        if (strategy)
         {
-            return colorHueStrategy->alertRGB(r, g, b, *this);
+            return strategy->alertRGB(r, g, b, *this);
         }
         return false;
     };
@@ -665,9 +780,10 @@ public:
     //! \throws nlohmann::json::parse_error when response could not be parsed
     virtual bool setColorLoop(bool on)
     {
-        if (colorHueStrategy)
+        const auto strategy = loadColorHueStrategy();
+        if (strategy)
         {
-            return colorHueStrategy->setColorLoop(on, *this);
+            return strategy->setColorLoop(on, *this);
         }
         return false;
     };
@@ -697,6 +813,20 @@ protected:
         std::shared_ptr<const ColorTemperatureStrategy> colorTempStrategy,
         std::shared_ptr<const ColorHueStrategy> colorHueStrategy);
 
+    //! \brief Protected ctor that is used by \ref Hue class to create a light from a known state without contacting
+    //! the bridge.
+    //!
+    //! \param id Integer that specifies the id of this light
+    //! \param commands HueCommandAPI for communication with the bridge
+    //! \param initialState Last known reply of GET /lights/<id> parsed by \ref LightStateParser, with its text in
+    //! LightInfo::text. Used instead of refreshing the state.
+    //!
+    //! leaves strategies unset
+    HueLight(int id, const HueCommandAPI& commands, LightInfo initialState);
+
+    //! \brief Protected copy constructor that is called while \c otherLock holds the shared lock of \c other
+    HueLight(const HueLight& other, const std::shared_lock<SharedMutex>& otherLock);
+
     //! \brief Protected function that sets the brightness strategy.
     //!
     //! The strategy defines how specific commands that deal with brightness
@@ -704,6 +834,7 @@ protected:
     //! BrightnessStrategy
     virtual void setBrightnessStrategy(std::shared_ptr<const BrightnessStrategy> strat)
     {
+        std::lock_guard<SharedMutex> lock(stateMutex);
         brightnessStrategy = std::move(strat);
     };
 
@@ -714,6 +845,7 @@ protected:
     //! ColorTemperatureStrategy
     virtual void setColorTemperatureStrategy(std::shared_ptr<const ColorTemperatureStrategy> strat)
     {
+        std::lock_guard<SharedMutex> lock(stateMutex);
         colorTemperatureStrategy = std::move(strat);
     };
 
@@ -723,9 +855,24 @@ protected:
     //! are executed \param strat a strategy of type \ref ColorHueStrategy
     virtual void setColorHueStrategy(std::shared_ptr<const ColorHueStrategy> strat)
     {
+        std::lock_guard<SharedMutex> lock(stateMutex);
         colorHueStrategy = std::move(strat);
     };
 
+    //! \brief Returns the brightness strategy, copied under the shared lock
+    //!
+    //! The copy keeps the strategy alive while it is used without holding the lock,
+    //! even if \ref Hue::reconcile replaces it in the meantime.
+    std::shared_ptr<const BrightnessStrategy> loadBrightnessStrategy() const;
+
+    //! \brief Returns the color temperature strategy, copied under the shared lock
+    //! \see loadBrightnessStrategy
+    std::shared_ptr<const ColorTemperatureStrategy> loadColorTemperatureStrategy() const;
+
+    //! \brief Returns the color strategy, copied under the shared lock
+    //! \see loadBrightnessStrategy
+    std::shared_ptr<const ColorHueStrategy> loadColorHueStrategy() const;
+
     //! \brief Protected function that sets the HueCommandAPI.
     //!
     //! The HueCommandAPI is used for bridge communication
@@ -765,6 +912,26 @@ protected:
     //! \throws nlohmann::json::parse_error when response could not be parsed
     virtual nlohmann::json SendPutRequest(const nlohmann::json& request, const std::string& subPath, FileInfo fileInfo);
 
+    //! \brief Utility function to send a state request to the light.
+    //!
+    //! The request is serialized without building a json tree and the reply is only kept for validation.
+    //! The attributes the bridge accepted are set in \ref state, so the \ref DeadbandFilter compares the next
+    //! request with them instead of the state of the last refresh.
+    //! \param request The state that should be changed
+    //! \param fileInfo FileInfo from calling function for exception details.
+    //! \return Result of comparing the reply with the request
+    //! \throws std::system_error when system or socket operations fail
+    //! \throws HueException when response contained no body
+    //! \throws HueAPIResponseException when response contains an error
+    //! \throws nlohmann::json::parse_error when response could not be parsed
+    virtual utils::ReplyValidation SendStateRequest(const StateRequest& request, FileInfo fileInfo);
+
+    //! \brief Sets the attributes of a sent request in \ref state, except those the bridge did not accept
+    //!
+    //! \param request The request that was sent
+    //! \param result Result of comparing the reply with \c request, nothing is set when it was unexpected
+    void applyAccepted(const StateRequest& request, const utils::ReplyValidation& result);
+
     //! \brief Virtual function that refreshes the \ref state of the light.
     //! \throws std::system_error when system or socket operations fail
     //! \throws HueException when response contained no body
@@ -772,9 +939,29 @@ protected:
     //! \throws nlohmann::json::parse_error when response could not be parsed
     virtual void refreshState();
 
+    //! \brief Replaces the \ref state of the light without contacting the bridge.
+    //!
+    //! \param lightState Text of the reply of GET /lights/<id> or of the member of the light in the bridge state
+    //! \return false when \c lightState has no "state" member, then the state is not changed
+    //! \throws HueAPIResponseException when \c lightState contains an error
+    //! \throws nlohmann::json::parse_error when \c lightState could not be parsed
+    bool applyState(std::string lightState);
+
+    //! \brief Replaces the \ref state of the light with a reply that was already parsed.
+    //!
+    //! \param lightState Text of the reply of GET /lights/<id> or of the member of the light in the bridge state
+    //! \param light \c lightState parsed by \ref LightStateParser, its hot members are moved out
+    //! \return false when \c lightState has no "state" member, then the state is not changed
+    bool applyState(std::string lightState, LightInfo& light);
+
 protected:
     int id; //!< holds the id of the light
-    nlohmann::json state; //!< holds the current state of the light updated by \ref refreshState
+    std::string path; //!< holds the api path "/lights/<id>" of the light
+    std::string statePath; //!< holds the api path "/lights/<id>/state" of the light
+    LightState state; //!< holds the current typed state of the light updated by \ref refreshState
+    LightFields fields; //!< holds the text of the last reply, cold members are decoded on access
+    //! guards \ref state, \ref fields, \ref colorType, the strategies and \ref deadbandFilter
+    mutable SharedMutex stateMutex;
     ColorType colorType; //!< holds the \ref ColorType of the light
 
     std::shared_ptr<const BrightnessStrategy>
@@ -784,6 +971,8 @@ protected:
     std::shared_ptr<const ColorHueStrategy>
         colorHueStrategy; //!< holds a reference to the strategy that handles all color commands
     HueCommandAPI commands; //!< A IHttpHandler that is used to communicate with the bridge
+    //! removes invisible changes from state requests, guarded by \ref stateMutex
+    std::shared_ptr<DeadbandFilter> deadbandFilter;
 };
 
 #endif
@@ -153,6 +153,26 @@ public:
     virtual nlohmann::json GETJson(
         const std::string& uri, const nlohmann::json& body, const std::string& adr, int port = 80) const = 0;
 
+    //! \brief Send a HTTP GET request with an already serialized json body and return the unparsed body of the
+    //! response.
+    //!
+    //! This lets the caller choose how the response is parsed.
+    //! The default implementation parses \c body, calls \ref GETJson and serializes the result again.
+    //! Handlers that send the body as text should override it to pass both bodies through unchanged.
+    //! \param uri Uniform Resource Identifier in the request
+    //! \param body Serialized json request body
+    //! \param adr Ip or hostname in dotted decimal notation like "192.168.2.1"
+    //! \param port Optional port the request is sent to, default is 80
+    //! \return Body of the response of the host
+    //! \throws std::system_error when system or socket operations fail
+    //! \throws HueException when response contained no body
+    //! \throws nlohmann::json::parse_error when \c body could not be parsed by the default implementation
+    virtual std::string GETRaw(
+        const std::string& uri, const std::string& body, const std::string& adr, int port = 80) const
+    {
+        return GETJson(uri, nlohmann::json::parse(body), adr, port).dump();
+    }
+
     //! \brief Send a HTTP POST request to the specified host and return the body of the response parsed as JSON.
     //!
     //! \param uri Uniform Resource Identifier in the request
@@ -179,6 +199,26 @@ public:
     virtual nlohmann::json PUTJson(
         const std::string& uri, const nlohmann::json& body, const std::string& adr, int port = 80) const = 0;
 
+    //! \brief Send a HTTP PUT request with an already serialized json body and return the unparsed body of the
+    //! response.
+    //!
+    //! This lets the caller choose how the response is parsed.
+    //! The default implementation parses \c body, calls \ref PUTJson and serializes the result again.
+    //! Handlers that send the body as text should override it to pass both bodies through unchanged.
+    //! \param uri Uniform Resource Identifier in the request
+    //! \param body Serialized json request body
+    //! \param adr Ip or hostname in dotted decimal notation like "192.168.2.1"
+    //! \param port Optional port the request is sent to, default is 80
+    //! \return Body of the response of the host
+    //! \throws std::system_error when system or socket operations fail
+    //! \throws HueException when response contained no body
+    //! \throws nlohmann::json::parse_error when \c body could not be parsed by the default implementation
+    virtual std::string PUTRaw(
+        const std::string& uri, const std::string& body, const std::string& adr, int port = 80) const
+    {
+        return PUTJson(uri, nlohmann::json::parse(body), adr, port).dump();
+    }
+
     //! \brief Send a HTTP DELETE request to the specified host and return the body of the response parsed as JSON.
     //!
     //! \param uri Uniform Resource Identifier in the request
@@ -0,0 +1,165 @@
+/**
+    \file JsonArena.h
+    Copyright Notice\n
+    Copyright (C) 2018  Jan Rogall		- developer\n
+    Copyright (C) 2018  Moritz Wirger	- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#ifndef _JSON_ARENA_H
+#define _JSON_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "json/json.hpp"
+
+//! \brief Monotonic memory arena for short lived json trees
+//!
+//! Memory is taken from large blocks and only released all at once by \ref reset.
+//! \ref ArenaAllocator uses the arena of the \ref Scope that was active on the current thread when it was created.
+class JsonArena
+{
+public:
+    //! \brief Installs an arena for all \ref ArenaAllocator allocations of the current thread
+    //!
+    //! The previously installed arena is restored when the scope ends.
+    //! Scopes of the same arena can be nested, the arena is reset when the outermost of them ends.
+    //! All trees using the arena must be destroyed before that.
+    class Scope
+    {
+    public:
+        explicit Scope(JsonArena& arena);
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        JsonArena& arena;
+        JsonArena* previous;
+    };
+
+    //! \brief Creates an arena
+    //! \param blockSize Size of the blocks that are allocated from the heap
+    explicit JsonArena(std::size_t blockSize = 4096);
+    ~JsonArena();
+    JsonArena(const JsonArena&) = delete;
+    JsonArena& operator=(const JsonArena&) = delete;
+
+    //! \brief Allocates memory from the arena
+    //! \throws std::bad_alloc when no new block can be allocated
+    void* allocate(std::size_t size, std::size_t alignment);
+
+    //! \brief Checks whether \c p points into a block of the arena
+    bool owns(const void* p) const;
+
+    //! \brief Releases all allocations
+    //!
+    //! The first block is kept for the next use, all other blocks are freed.
+    void reset();
+
+    //! \brief Number of allocations since the last \ref reset
+    std::size_t getAllocationCount() const { return allocationCount; }
+    //! \brief Number of blocks that are currently allocated from the heap
+    std::size_t getBlockCount() const;
+
+    //! \brief Arena of the active \ref Scope on the current thread, nullptr if there is none
+    static JsonArena* current();
+
+private:
+    struct Block
+    {
+        Block* next;
+        std::size_t size;
+    };
+
+    //! \brief Allocates a new block that can hold at least \c size bytes
+    void addBlock(std::size_t size);
+
+private:
+    std::size_t blockSize;
+    Block* blocks = nullptr; //!< Newest block first
+    std::size_t offset = 0; //!< Used bytes of the newest block
+    std::size_t allocationCount = 0;
+    std::size_t scopeCount = 0; //!< Number of active scopes using this arena
+};
+
+//! \brief Allocator that uses the \ref JsonArena of the active \ref JsonArena::Scope, or the heap if there is none
+//!
+//! The arena is taken when the allocator is created and kept by all of its copies.
+//! Deallocating arena memory does nothing, it is released when the arena is reset.
+//! nlohmann::basic_json creates new allocators to destroy values, so a tree must be destroyed
+//! under the same scope it was created in, or without any scope if it was created without one.
+template <typename T>
+class ArenaAllocator
+{
+public:
+    using value_type = T;
+
+    ArenaAllocator() noexcept : arena(JsonArena::current()) {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena(other.getArena())
+    {}
+
+    T* allocate(std::size_t n)
+    {
+        if (arena)
+        {
+            return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T)));
+        }
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+    void deallocate(T* p, std::size_t /*n*/) noexcept
+    {
+        if (!arena)
+        {
+            ::operator delete(p);
+        }
+    }
+
+    //! \brief Arena the memory is taken from, nullptr for the heap
+    JsonArena* getArena() const noexcept { return arena; }
+
+private:
+    JsonArena* arena;
+};
+
+template <typename T, typename U>
+bool operator==(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs) noexcept
+{
+    return lhs.getArena() == rhs.getArena();
+}
+template <typename T, typename U>
+bool operator!=(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs) noexcept
+{
+    return !(lhs == rhs);
+}
+
+//! \brief String type of \ref ArenaJson
+using ArenaString = std::basic_string<char, std::char_traits<char>, ArenaAllocator<char>>;
+
+//! \brief Json type whose values, containers and strings are allocated with \ref ArenaAllocator
+//!
+//! Used for transient request and response trees that are discarded right after they were processed.
+using ArenaJson = nlohmann::basic_json<std::map, std::vector, ArenaString, bool, std::int64_t, std::uint64_t, double,
+    ArenaAllocator>;
+
+#endif
@@ -0,0 +1,130 @@
+/**
+    \file LightFields.h
+    Copyright Notice\n
+    Copyright (C) 2017  Jan Rogall		- developer\n
+    Copyright (C) 2017  Moritz Wirger	- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#ifndef _LIGHT_FIELDS_H
+#define _LIGHT_FIELDS_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+#include "LightStateParser.h"
+
+#include "json/json.hpp"
+
+//! \brief Members of a light reply
+enum class LightField : uint8_t
+{
+    TYPE, //!< "type"
+    NAME, //!< "name"
+    MODELID, //!< "modelid"
+    UNIQUEID, //!< "uniqueid"
+    MANUFACTURERNAME, //!< "manufacturername"
+    PRODUCTNAME, //!< "productname"
+    LUMINAIREUNIQUEID, //!< "luminaireuniqueid"
+    SWVERSION, //!< "swversion"
+    STATE, //!< "state"
+    STATE_ON, //!< "state/on"
+    STATE_BRI, //!< "state/bri"
+    STATE_HUE, //!< "state/hue"
+    STATE_SAT, //!< "state/sat"
+    STATE_XY, //!< "state/xy"
+    STATE_CT, //!< "state/ct"
+    STATE_COLORMODE, //!< "state/colormode"
+    STATE_EFFECT, //!< "state/effect"
+    STATE_ALERT, //!< "state/alert"
+    STATE_REACHABLE //!< "state/reachable"
+};
+
+//! \brief Reply of GET /lights/<id>, kept as the received text
+//!
+//! The hot string members (type, name and modelid) are copied out of the parsed \ref LightInfo when the reply
+//! is set, the typed state is kept by \ref HueLight. The other string members are cold: they are decoded
+//! from the text on the first access to one of them. Members without typed storage, like "config" or
+//! "capabilities", are only available as json, which is parsed from the text on every access.
+//! Decoding on access is thread safe, but setting a new reply is not.
+class LightFields
+{
+public:
+    //! \brief Number of string fields, they are the first values of \ref LightField
+    static constexpr std::size_t stringCount = static_cast<std::size_t>(LightField::SWVERSION) + 1;
+
+    //! \brief Creates an empty reply where all fields are missing
+    LightFields();
+    //! \brief Parses the hot fields of a reply and keeps the text
+    //! \param reply Text of the reply
+    //! \throws nlohmann::json::parse_error when the reply is not valid json
+    //! \throws HueAPIResponseException when the reply contains an error
+    explicit LightFields(std::string reply);
+    //! \brief Keeps the text of a reply that was already parsed
+    //! \param reply Text of the reply
+    //! \param light Parsed reply, the hot strings are moved out of it
+    LightFields(std::string reply, LightInfo& light);
+    //! \brief Copies the reply, the copy decodes cold fields again when they are accessed
+    LightFields(const LightFields& other);
+    LightFields(LightFields&& other) noexcept;
+    LightFields& operator=(const LightFields& other);
+    LightFields& operator=(LightFields&& other) noexcept;
+
+    //! \brief Returns whether \c field is decoded when the reply is set
+    static bool isHot(LightField field);
+
+    //! \brief Returns a string member of the reply
+    //!
+    //! Decodes the cold strings if \c field is cold.
+    //! \returns The value or an empty string if it is missing, not a string or \c field is no string field
+    std::string getString(LightField field) const;
+
+    //! \brief Returns a member of the reply
+    //!
+    //! Parses the text, so the typed accessors should be preferred.
+    //! \returns The member or null if it is missing
+    nlohmann::json get(LightField field) const;
+
+    //! \brief Parses the complete reply
+    //! \returns The reply or null if it is empty
+    nlohmann::json getJson() const;
+
+    //! \brief Returns the text of the reply
+    const std::string& getText() const { return text; }
+
+    //! \brief Returns whether the cold strings were already decoded
+    bool isDecoded() const { return decoded; }
+
+    //! \brief Swaps the replies and fields of both objects
+    void swap(LightFields& other) noexcept;
+
+private:
+    //! \brief Decodes the cold strings from \ref text, if not done yet
+    void decode() const;
+
+private:
+    std::string text; //!< Reply as it was received
+
+    mutable std::atomic<bool> decoded;
+    mutable std::mutex decodeMutex; //!< Guards decoding of the cold entries of \ref strings
+    mutable std::array<std::string, stringCount> strings; //!< Values of the string fields
+};
+
+#endif
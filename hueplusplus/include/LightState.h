@@ -0,0 +1,113 @@
+/**
+    \file LightState.h
+    Copyright Notice\n
+    Copyright (C) 2017  Jan Rogall		- developer\n
+    Copyright (C) 2017  Moritz Wirger	- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#ifndef _LIGHT_STATE_H
+#define _LIGHT_STATE_H
+
+#include <cstdint>
+#include <string>
+
+#include "Units.h"
+
+#include "json/json.hpp"
+
+//! \brief Color mode a light is currently in
+enum class ColorMode : uint8_t
+{
+    NONE, //!< Light has no color mode or it is unknown
+    HS, //!< Hue and saturation ("hs")
+    XY, //!< CIE xy coordinates ("xy")
+    CT //!< Color temperature ("ct")
+};
+
+//! \brief Dynamic effect of a light
+enum class Effect : uint8_t
+{
+    NONE, //!< No effect ("none")
+    COLORLOOP //!< Light cycles through all hues ("colorloop")
+};
+
+//! \brief Alert effect of a light
+enum class Alert : uint8_t
+{
+    NONE, //!< No alert ("none")
+    SELECT, //!< One breathe cycle ("select")
+    LSELECT //!< Breathe cycles for 15 seconds ("lselect")
+};
+
+//! \brief Typed state of a light, decoded once from the "state" member of the bridge response
+//!
+//! Values that are missing in the response are left at their defaults, \ref has tells them apart
+//! from values that were received.
+struct LightState
+{
+    //! \brief Members of the "state" response
+    enum Member : uint16_t
+    {
+        ON = 1 << 0, //!< "on"
+        REACHABLE = 1 << 1, //!< "reachable"
+        BRI = 1 << 2, //!< "bri"
+        HUE = 1 << 3, //!< "hue"
+        SAT = 1 << 4, //!< "sat"
+        XY = 1 << 5, //!< "xy"
+        CT = 1 << 6, //!< "ct"
+        COLORMODE = 1 << 7, //!< "colormode"
+        EFFECT = 1 << 8, //!< "effect"
+        ALERT = 1 << 9 //!< "alert"
+    };
+
+    ::XY xy = {0.0f, 0.0f}; //!< CIE xy color coordinates
+    uint16_t hue = 0; //!< Hue from 0 to 65535
+    uint16_t ct = 0; //!< Color temperature in mired
+    uint8_t bri = 0; //!< Brightness from 1 to 254
+    uint8_t sat = 0; //!< Saturation from 0 to 254
+    bool on = false; //!< Whether the light is on
+    bool reachable = false; //!< Whether the light can be reached by the bridge
+    ColorMode colormode = ColorMode::NONE; //!< Current color mode
+    Effect effect = Effect::NONE; //!< Current dynamic effect
+    Alert alert = Alert::NONE; //!< Current alert effect
+    uint16_t members = 0; //!< Members that were present in the response
+
+    //! \brief Checks whether a member was present in the response
+    bool has(Member member) const { return (members & member) != 0; }
+
+    //! \brief Decodes the typed state
+    //!
+    //! \param state The "state" member of a light, as returned by GET /lights/<id>
+    //! \returns The decoded state. Missing or invalid members are default initialized,
+    //! numbers are converted with utils::convertNumber.
+    static LightState fromJson(const nlohmann::json& state);
+};
+
+//! \brief Converts the API name of a color mode ("hs", "xy" or "ct")
+//! \returns The matching ColorMode or ColorMode::NONE if it is unknown
+ColorMode parseColorMode(const std::string& mode);
+
+//! \brief Converts the API name of an effect ("none" or "colorloop")
+//! \returns The matching Effect or Effect::NONE if it is unknown
+Effect parseEffect(const std::string& effect);
+
+//! \brief Converts the API name of an alert ("none", "select" or "lselect")
+//! \returns The matching Alert or Alert::NONE if it is unknown
+Alert parseAlert(const std::string& alert);
+
+#endif
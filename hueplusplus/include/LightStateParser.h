@@ -0,0 +1,101 @@
+/**
+    \file LightStateParser.h
+    Copyright Notice\n
+    Copyright (C) 2017  Jan Rogall		- developer\n
+    Copyright (C) 2017  Moritz Wirger	- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#ifndef _LIGHT_STATE_PARSER_H
+#define _LIGHT_STATE_PARSER_H
+
+#include <string>
+#include <vector>
+
+#include "LightState.h"
+
+//! \brief Attributes of a light that are read by \ref HueLight, decoded without building a json tree
+struct LightInfo
+{
+    int id = 0; //!< Id of the light, 0 when a single light was parsed
+    std::string name; //!< "name"
+    std::string type; //!< "type"
+    std::string modelId; //!< "modelid"
+    std::string uniqueId; //!< "uniqueid"
+    std::string manufacturerName; //!< "manufacturername"
+    std::string productName; //!< "productname"
+    std::string luminaireUniqueId; //!< "luminaireuniqueid"
+    std::string swVersion; //!< "swversion"
+    LightState state; //!< Decoded "state" member
+    bool hasState = false; //!< Whether the light has a "state" object
+    std::string text; //!< Json text of the light, only set by \ref LightStateParser::parseLights and
+                      //!< \ref LightStateParser::parseBridgeState
+};
+
+//! \brief Extracts light attributes from bridge responses using the SAX interface of nlohmann::json
+//!
+//! Only the attributes in \ref LightInfo are kept, all other values are skipped while parsing.
+//! This avoids allocating the complete tree for large responses. The results are the same as
+//! decoding the parsed tree with \ref LightState::fromJson.
+class LightStateParser
+{
+public:
+    //! \brief Parses the reply of GET /lights/<id>
+    //!
+    //! \param body Response body
+    //! \returns The light, with id 0
+    //! \throws nlohmann::json::parse_error when the body is not valid json
+    //! \throws nlohmann::json::out_of_range when a number is too large for a double
+    //! \throws HueAPIResponseException when the response contains an error
+    static LightInfo parseLight(const std::string& body);
+
+    //! \brief Parses the reply of GET /lights
+    //!
+    //! \param body Response body
+    //! \returns All lights in the order of the response
+    //! \throws nlohmann::json::parse_error when the body is not valid json
+    //! \throws nlohmann::json::out_of_range when a number is too large for a double
+    //! \throws HueAPIResponseException when the response contains an error
+    static std::vector<LightInfo> parseLights(const std::string& body);
+
+    //! \brief Parses the lights of the complete bridge state, as returned by GET /api/<username>
+    //!
+    //! \param body Response body
+    //! \returns All lights in the order of the response
+    //! \throws nlohmann::json::parse_error when the body is not valid json
+    //! \throws nlohmann::json::out_of_range when a number is too large for a double
+    //! \throws HueAPIResponseException when the response contains an error
+    static std::vector<LightInfo> parseBridgeState(const std::string& body);
+
+    //! \brief Parses the lights of the complete bridge state, as returned by GET /api/<username>
+    //!
+    //! \param body Response body
+    //! \param hasLights Set to whether the root object has a "lights" object
+    //! \returns All lights in the order of the response
+    //! \throws nlohmann::json::parse_error when the body is not valid json
+    //! \throws nlohmann::json::out_of_range when a number is too large for a double
+    //! \throws HueAPIResponseException when the response contains an error
+    static std::vector<LightInfo> parseBridgeState(const std::string& body, bool& hasLights);
+
+private:
+    //! \brief Parses \c body, the members of the lights are at \c lightDepth
+    //!
+    //! \param hasLights Set to whether the object containing the lights was found
+    static std::vector<LightInfo> parse(const std::string& body, int lightDepth, bool& hasLights);
+};
+
+#endif
@@ -44,6 +44,28 @@ public:
     //! String containing the response of the host
     virtual std::string send(const std::string& msg, const std::string& adr, int port = 80) const;
 
+    //! \brief Function that sends a given message to the specified host and
+    //! parses the body of the response while it is received.
+    //!
+    //! The response is never held in memory as a whole, so parsing overlaps the transfer.
+    //! \param msg String that contains the message that is sent to the specified address
+    //! \param adr String that contains an ip or hostname in dotted decimal notation like "192.168.2.1"
+    //! \param port Optional integer that specifies the port to which the request is sent to. Default is 80
+    //! \return Parsed body of the response of the host
+    //! \throws std::system_error when system or socket operations fail
+    //! \throws HueException when response contained no body
+    //! \throws nlohmann::json::parse_error when the body could not be parsed
+    nlohmann::json sendGetHTTPJson(const std::string& msg, const std::string& adr, int port = 80) const override;
+
+    //! \brief Reads a HTTP response from a connected socket and parses its body incrementally.
+    //!
+    //! \param socketFD Socket the request was already sent to
+    //! \return Parsed body of the response
+    //! \throws std::system_error when reading from the socket fails
+    //! \throws HueException when response contained no body
+    //! \throws nlohmann::json::parse_error when the body could not be parsed
+    static nlohmann::json receiveJson(int socketFD);
+
     //! \brief Function that sends a multicast request with the specified message.
     //!
     //! \param msg String that contains the request that is sent to the specified
@@ -0,0 +1,47 @@
+/**
+    \file NumberFormat.h
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+    Copyright (C) 2020  Moritz Wirger	- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#ifndef _NUMBER_FORMAT_H
+#define _NUMBER_FORMAT_H
+
+#include <string>
+
+namespace utils
+{
+    //! \brief Appends the decimal representation of an unsigned integer
+    //!
+    //! Does not depend on the locale and does not allocate besides growing \c out.
+    void appendUnsigned(std::string& out, unsigned long long value);
+
+    //! \brief Appends the decimal representation of an integer
+    //!
+    //! Does not depend on the locale and does not allocate besides growing \c out.
+    void appendInt(std::string& out, long long value);
+
+    //! \brief Appends the shortest representation that parses back to the same value
+    //!
+    //! The output is identical to the number in nlohmann::json::dump and does not depend on the locale.
+    //! \returns Appends "null" if \c value is not finite, like nlohmann::json::dump
+    void appendFloat(std::string& out, double value);
+} // namespace utils
+
+#endif
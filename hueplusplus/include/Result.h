@@ -0,0 +1,191 @@
+/**
+    \file Result.h
+    Copyright Notice\n
+    Copyright (C) 2018  Jan Rogall		- developer\n
+    Copyright (C) 2018  Moritz Wirger	- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#ifndef _RESULT_H
+#define _RESULT_H
+
+#include <cstdint>
+#include <exception>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include "HueException.h"
+
+#include "json/json.hpp"
+
+//! \brief Expected failure of a request, reported without throwing
+//!
+//! Only stores the parts of the error, the message is combined by \ref toString when it is needed.
+class HueError
+{
+public:
+    //! \brief Kind of failure
+    enum class Type : uint8_t
+    {
+        NONE, //!< No error
+        API_RESPONSE, //!< Bridge answered with an "error" object, like for an unreachable light
+        TRANSPORT, //!< System or socket operation failed
+        INVALID_RESPONSE //!< Response had no body or could not be parsed
+    };
+
+    //! \brief Creates an empty error of type NONE
+    HueError() = default;
+
+    //! \brief Creates an error of type API_RESPONSE
+    //! \param fileInfo Location of the cause
+    //! \param code Hue API error type, like 201 when a parameter is not modifiable
+    //! \param address URI the API call referred to
+    //! \param description Error description of the bridge
+    HueError(FileInfo fileInfo, int code, std::string address, std::string description);
+
+    //! \brief Creates an error of type TRANSPORT
+    //! \param fileInfo Location of the cause
+    //! \param error Error code of the failed system operation
+    //! \param description Description of the failure, like the what() of the std::system_error
+    //! \param cause Caught exception that is rethrown by \ref raise. When it is null,
+    //! \ref raise throws a std::system_error with \c error and \c description.
+    HueError(
+        FileInfo fileInfo, std::error_code error, std::string description, std::exception_ptr cause = nullptr);
+
+    //! \brief Creates an error of type INVALID_RESPONSE
+    //! \param fileInfo Location of the cause
+    //! \param description Description of the failure
+    HueError(FileInfo fileInfo, std::string description);
+
+    //! \brief Creates an error from the "error" member of an API response
+    //! \param fileInfo Location of the cause
+    //! \param response Object with a member "error" containing "type", "address" and "description".
+    //! Missing members are defaulted to -1 or "".
+    static HueError fromResponse(FileInfo fileInfo, const nlohmann::json& response);
+
+    //! \brief Kind of failure
+    Type getType() const { return type; }
+    //! \brief Hue API error type, or the value of the system error code for TRANSPORT errors
+    int getCode() const { return code; }
+    //! \brief Error code of the system operation, only set for TRANSPORT errors
+    const std::error_code& getSystemError() const { return systemError; }
+    //! \brief Address the API call tried to access, only set for API_RESPONSE errors
+    const std::string& getAddress() const { return address; }
+    //! \brief Error description
+    const std::string& getDescription() const { return description; }
+    //! \brief Location of the cause
+    const FileInfo& getFile() const { return fileInfo; }
+
+    //! \brief Combines all parts of the error to a message
+    //! \returns "<func> in <file>:<line> <code> <address> <description>"
+    std::string toString() const;
+
+    //! \brief Throws the exception the throwing functions would have thrown
+    //! \throws HueAPIResponseException for API_RESPONSE errors
+    //! \throws std::system_error for TRANSPORT errors, the original exception when it was stored
+    //! \throws HueException for INVALID_RESPONSE errors and errors without a type
+    [[noreturn]] void raise() const;
+
+private:
+    Type type = Type::NONE;
+    int code = 0;
+    std::error_code systemError;
+    std::string address;
+    std::string description;
+    FileInfo fileInfo;
+    std::exception_ptr cause;
+};
+
+//! \brief Value of a request that may have failed with a \ref HueError instead
+//! \tparam T Type of the value, must be default constructible
+template <typename T>
+class Result
+{
+public:
+    //! \brief Creates a successful result
+    Result(T value) : value(std::move(value)) {}
+    //! \brief Creates a failed result
+    Result(HueError error) : error(std::move(error)) {}
+
+    //! \brief Returns whether the request succeeded
+    bool ok() const { return error.getType() == HueError::Type::NONE; }
+    //! \brief Returns whether the request succeeded
+    explicit operator bool() const { return ok(); }
+
+    //! \brief Returns the value of a successful result
+    //! \throws The exception from \ref HueError::raise when the request failed
+    const T& get() const
+    {
+        if (!ok())
+        {
+            error.raise();
+        }
+        return value;
+    }
+    //! \brief Returns the value of a successful result
+    //! \throws The exception from \ref HueError::raise when the request failed
+    T& get()
+    {
+        if (!ok())
+        {
+            error.raise();
+        }
+        return value;
+    }
+
+    //! \brief Returns the error of a failed result, or an error of type NONE
+    const HueError& getError() const { return error; }
+
+private:
+    T value{};
+    HueError error;
+};
+
+//! \brief Result of a request without a value
+template <>
+class Result<void>
+{
+public:
+    //! \brief Creates a successful result
+    Result() = default;
+    //! \brief Creates a failed result
+    Result(HueError error) : error(std::move(error)) {}
+
+    //! \brief Returns whether the request succeeded
+    bool ok() const { return error.getType() == HueError::Type::NONE; }
+    //! \brief Returns whether the request succeeded
+    explicit operator bool() const { return ok(); }
+
+    //! \brief Throws when the request failed
+    //! \throws The exception from \ref HueError::raise when the request failed
+    void get() const
+    {
+        if (!ok())
+        {
+            error.raise();
+        }
+    }
+
+    //! \brief Returns the error of a failed result, or an error of type NONE
+    const HueError& getError() const { return error; }
+
+private:
+    HueError error;
+};
+
+#endif
@@ -0,0 +1,54 @@
+/**
+    \file SharedMutex.h
+    Copyright Notice\n
+    Copyright (C) 2017  Jan Rogall		- developer\n
+    Copyright (C) 2017  Moritz Wirger	- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#ifndef _SHARED_MUTEX_H
+#define _SHARED_MUTEX_H
+
+#include <mutex>
+#include <shared_mutex>
+
+//! \brief Reader-writer mutex that can be a member of copyable classes
+//!
+//! Copies do not share the lock with the original, every object owns a separate mutex.
+//! Satisfies the SharedMutex requirements, so it can be used with std::shared_lock and std::lock_guard.
+class SharedMutex
+{
+public:
+    SharedMutex() = default;
+    //! \brief Creates a new unlocked mutex, \c other is not touched
+    SharedMutex(const SharedMutex& /*other*/) {}
+    //! \brief Does nothing, the mutex of this object stays the same
+    SharedMutex& operator=(const SharedMutex& /*other*/) { return *this; }
+
+    void lock() { mutex.lock(); }
+    bool try_lock() { return mutex.try_lock(); }
+    void unlock() { mutex.unlock(); }
+
+    void lock_shared() { mutex.lock_shared(); }
+    bool try_lock_shared() { return mutex.try_lock_shared(); }
+    void unlock_shared() { mutex.unlock_shared(); }
+
+private:
+    std::shared_timed_mutex mutex;
+};
+
+#endif
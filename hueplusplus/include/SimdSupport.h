@@ -0,0 +1,63 @@
+/**
+    \file SimdSupport.h
+    Copyright Notice\n
+    Copyright (C) 2017  Jan Rogall		- developer\n
+    Copyright (C) 2017  Moritz Wirger	- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#ifndef _SIMD_SUPPORT_H
+#define _SIMD_SUPPORT_H
+
+// Only included by the sources of the library that contain SIMD kernels.
+// Defines HUEPLUSPLUS_SSE2 and HUEPLUSPLUS_AVX2 when the compiler can generate the instructions.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HUEPLUSPLUS_SSE2
+#include <emmintrin.h>
+#endif
+#if defined(HUEPLUSPLUS_SSE2) && (defined(__GNUC__) || defined(__clang__))
+// AVX2 functions are compiled with a target attribute and only called when the processor supports them
+#define HUEPLUSPLUS_AVX2
+#include <immintrin.h>
+#endif
+
+#include "ColorConversion.h"
+
+namespace utils
+{
+    //! \brief Returns the best instruction set supported by the compiler and the current processor
+    //!
+    //! Unlike \ref ColorConversion::getSupportedSimd it does not depend on HUEPLUSPLUS_FIXED_POINT,
+    //! so it is used for kernels that only use integers.
+    inline ColorConversion::Simd getProcessorSimd()
+    {
+#if defined(HUEPLUSPLUS_AVX2)
+        static const bool avx2 = __builtin_cpu_supports("avx2");
+        if (avx2)
+        {
+            return ColorConversion::Simd::AVX2;
+        }
+#endif
+#if defined(HUEPLUSPLUS_SSE2)
+        return ColorConversion::Simd::SSE2;
+#else
+        return ColorConversion::Simd::NONE;
+#endif
+    }
+} // namespace utils
+
+#endif
@@ -23,6 +23,8 @@
 #ifndef _SIMPLE_COLOR_HUE_STRATEGY_H
 #define _SIMPLE_COLOR_HUE_STRATEGY_H
 
+#include <functional>
+
 #include "ColorHueStrategy.h"
 #include "HueLight.h"
 
@@ -147,6 +149,16 @@ public:
     //! \param light A const reference of the light
     //! \return Pair containing the x as first value and y as second value
     std::pair<float, float> getColorXY(const HueLight& light) const override;
+
+protected:
+    //! \brief Shows an alert in the color set by setColor and restores the previous color
+    //!
+    //! The previous color is always restored as xy, so hue and saturation only pass through one path.
+    //! \param light A reference of the light
+    //! \param restoreTemperature Whether a color temperature can be restored, otherwise only colors are
+    //! \param setColor Sets the alert color, returns false on failure
+    //! \return false when the light was not in a restorable mode or a request failed
+    static bool alertColor(HueLight& light, bool restoreTemperature, const std::function<bool()>& setColor);
 };
 
 #endif
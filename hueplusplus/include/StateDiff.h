@@ -0,0 +1,160 @@
+/**
+    \file StateDiff.h
+    Copyright Notice\n
+    Copyright (C) 2017  Jan Rogall		- developer\n
+    Copyright (C) 2017  Moritz Wirger	- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#ifndef _STATE_DIFF_H
+#define _STATE_DIFF_H
+
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "SharedMutex.h"
+
+#include "json/json.hpp"
+
+//! \brief Type of bridge resource a \ref StateChange refers to
+enum class ResourceType
+{
+    LIGHT, //!< Member of "lights"
+    GROUP, //!< Member of "groups"
+    SENSOR //!< Member of "sensors"
+};
+
+//! \brief Single change between two bridge state snapshots
+struct StateChange
+{
+    //! \brief Type of the changed resource
+    ResourceType resource;
+    //! \brief Id of the changed resource
+    int id;
+    //! \brief Path of the attribute relative to the resource, like "state/on".
+    //!
+    //! Empty when the whole resource was added or removed.
+    std::string attribute;
+    //! \brief Value before the change, null if the attribute was added
+    nlohmann::json oldValue;
+    //! \brief Value after the change, null if the attribute was removed
+    nlohmann::json newValue;
+};
+
+//! \brief Compares successive bridge states and notifies subscribers about changes
+//!
+//! Only "lights", "groups" and "sensors" are compared. Objects are compared member by member,
+//! so only the leaf values that actually changed are reported. Arrays (like "xy") are reported as a whole.
+//! Subscribing and notifying is thread safe, subscribers are called without holding a lock
+//! and may subscribe or unsubscribe themselves.
+//!
+//! Notifications are not serialized. \ref Hue compares the states under its lock, but notifies after releasing it,
+//! so subscribers can use the bridge. When several threads refresh the bridge at the same time, their changes can
+//! arrive interleaved or in a different order than the states were received. Every change carries its old and new
+//! value, refresh from a single thread when the order matters.
+class StateDiff
+{
+public:
+    //! \brief Function that is called for every change
+    using Subscriber = std::function<void(const StateChange&)>;
+
+    StateDiff() = default;
+    //! \brief Copies the subscribers of \c other under its shared lock
+    StateDiff(const StateDiff& other);
+    //! \brief Move constructor, \c other must not be used by other threads
+    StateDiff(StateDiff&& other) = default;
+    //! \brief Copies the subscribers of \c other under its shared lock and then replaces them under the lock
+    StateDiff& operator=(const StateDiff& other);
+    //! \brief Move assignment, neither object may be used by other threads
+    StateDiff& operator=(StateDiff&& other) = default;
+
+    //! \brief Registers a subscriber for changes of all resource types
+    //!
+    //! \param subscriber Function that is called for every change
+    //! \returns Handle that can be passed to \ref unsubscribe
+    int subscribe(Subscriber subscriber);
+
+    //! \brief Registers a subscriber for changes of one resource type
+    //!
+    //! \param resource Type of resource the subscriber is interested in
+    //! \param subscriber Function that is called for every change of \c resource
+    //! \returns Handle that can be passed to \ref unsubscribe
+    int subscribe(ResourceType resource, Subscriber subscriber);
+
+    //! \brief Removes a subscriber
+    //!
+    //! \param handle Handle returned by \ref subscribe
+    void unsubscribe(int handle);
+
+    //! \brief Tells whether any subscriber is registered
+    //!
+    //! Lets the owner skip building the states for \ref compare when nobody would be notified.
+    bool hasSubscribers() const;
+
+    //! \brief Compares two bridge states and notifies all subscribers
+    //!
+    //! \param previous Old bridge state as returned by GET /api/<username>
+    //! \param current New bridge state as returned by GET /api/<username>
+    //! \returns All changes that were found, in the order they were dispatched
+    std::vector<StateChange> update(const nlohmann::json& previous, const nlohmann::json& current);
+
+    //! \brief Notifies all subscribers about changes that were already computed
+    //!
+    //! \param changes Changes as returned by \ref compare
+    void notify(const std::vector<StateChange>& changes) const;
+
+    //! \brief Compares two bridge states without notifying subscribers
+    //!
+    //! \param previous Old bridge state as returned by GET /api/<username>
+    //! \param current New bridge state as returned by GET /api/<username>
+    //! \returns All changes of lights, groups and sensors
+    static std::vector<StateChange> compare(const nlohmann::json& previous, const nlohmann::json& current);
+
+    //! \brief Compares two states of a single resource
+    //!
+    //! \param resource Type of the resource
+    //! \param id Id of the resource
+    //! \param previous Old state of the resource, null if it was added
+    //! \param current New state of the resource, null if it was removed
+    //! \param changes Vector the changes are appended to
+    static void compareResource(ResourceType resource, int id, const nlohmann::json& previous,
+        const nlohmann::json& current, std::vector<StateChange>& changes);
+
+private:
+    //! \brief Compares one collection like "lights" of two bridge states
+    static void compareCollection(ResourceType resource, const nlohmann::json& previous, const nlohmann::json& current,
+        std::vector<StateChange>& changes);
+
+    //! \brief Recursively compares two objects and appends changed leaves
+    static void compareObject(ResourceType resource, int id, std::string& path, const nlohmann::json& previous,
+        const nlohmann::json& current, std::vector<StateChange>& changes);
+
+private:
+    struct Subscription
+    {
+        bool filtered; //!< True if only changes of \ref resource should be reported
+        ResourceType resource;
+        Subscriber subscriber;
+    };
+    std::map<int, Subscription> subscribers; //!< Maps handles to subscriptions
+    int nextHandle = 0; //!< Handle for the next subscription
+    mutable SharedMutex mutex; //!< Guards \ref subscribers and \ref nextHandle
+};
+
+#endif
@@ -0,0 +1,116 @@
+/**
+    \file StateRequest.h
+    Copyright Notice\n
+    Copyright (C) 2018  Jan Rogall		- developer\n
+    Copyright (C) 2018  Moritz Wirger	- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#ifndef _STATE_REQUEST_H
+#define _STATE_REQUEST_H
+
+#include <cstdint>
+#include <string>
+
+#include "LightState.h"
+
+#include "json/json.hpp"
+
+//! \brief Body of a PUT request to /lights/<id>/state or /groups/<id>/action
+//!
+//! Only the common state attributes are supported, so the body can be serialized
+//! directly into a string without building a json tree. Attributes that are not set are omitted.
+class StateRequest
+{
+public:
+    //! \brief Attributes that can be set in a request
+    enum Field : uint16_t
+    {
+        ON = 1 << 0, //!< "on"
+        BRI = 1 << 1, //!< "bri"
+        HUE = 1 << 2, //!< "hue"
+        SAT = 1 << 3, //!< "sat"
+        XY = 1 << 4, //!< "xy"
+        CT = 1 << 5, //!< "ct"
+        ALERT = 1 << 6, //!< "alert"
+        EFFECT = 1 << 7, //!< "effect"
+        TRANSITION = 1 << 8 //!< "transitiontime"
+    };
+
+    //! \brief Sets whether the light is turned on or off
+    void setOn(bool value);
+    //! \brief Sets the brightness from 1 to 254
+    void setBrightness(uint8_t value);
+    //! \brief Sets the hue from 0 to 65535
+    void setHue(uint16_t value);
+    //! \brief Sets the saturation from 0 to 254
+    void setSaturation(uint8_t value);
+    //! \brief Sets the CIE xy color coordinates
+    void setXY(float x, float y);
+    //! \brief Sets the color temperature in mired
+    void setColorTemperature(uint16_t value);
+    //! \brief Sets the alert effect
+    void setAlert(Alert value);
+    //! \brief Sets the dynamic effect
+    void setEffect(Effect value);
+    //! \brief Sets the transition time in multiples of 100ms
+    void setTransition(uint16_t value);
+
+    //! \brief Removes an attribute from the request
+    void remove(Field field) { fields &= ~field; }
+
+    //! \brief Checks whether an attribute was set
+    bool has(Field field) const { return (fields & field) != 0; }
+    //! \brief Checks whether no attribute was set
+    bool empty() const { return fields == 0; }
+
+    //! \brief The state values of the request
+    //!
+    //! Only the attributes for which \ref has returns true are valid.
+    const LightState& getState() const { return state; }
+    //! \brief Transition time in multiples of 100ms, only valid if \ref has(TRANSITION)
+    uint16_t getTransition() const { return transition; }
+
+    //! \brief Writes the request as compact json
+    //!
+    //! The output does not depend on the locale and is identical to <code>toJson().dump()</code>.
+    //! \param out String the request is written to, its previous contents are replaced.
+    //! The capacity is kept, so a buffer can be reused for many requests without allocating.
+    void serialize(std::string& out) const;
+
+    //! \brief Converts the request into a json object
+    nlohmann::json toJson() const;
+
+    //! \brief Sets the attributes of the request in a state, like the bridge does when it accepts the request
+    //!
+    //! Colors also set the color mode. Alerts are not set, because the bridge ends them by itself.
+    //! \param target State that is changed in place, the set attributes are marked as present
+    void applyTo(LightState& target) const;
+
+private:
+    LightState state;
+    uint16_t transition = 0;
+    uint16_t fields = 0;
+};
+
+//! \brief Converts an alert to its API name ("none", "select" or "lselect")
+const char* alertToString(Alert alert);
+
+//! \brief Converts an effect to its API name ("none" or "colorloop")
+const char* effectToString(Effect effect);
+
+#endif
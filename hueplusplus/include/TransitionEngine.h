@@ -0,0 +1,112 @@
+/**
+    \file TransitionEngine.h
+    Copyright Notice\n
+    Copyright (C) 2017  Jan Rogall		- developer\n
+    Copyright (C) 2017  Moritz Wirger	- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#ifndef _TRANSITION_ENGINE_H
+#define _TRANSITION_ENGINE_H
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "HueLight.h"
+#include "Result.h"
+#include "Units.h"
+
+//! \brief Color and brightness of a light at one point of a transition
+struct TransitionColor
+{
+    XY xy; //!< CIE xy color coordinates
+    uint8_t bri; //!< Brightness from 0 to 254
+};
+
+//! \brief One state request of a planned transition
+struct TransitionKeyframe
+{
+    std::chrono::milliseconds time; //!< Time after the start of the transition when the request is sent
+    TransitionColor color; //!< Color the light fades to
+    uint16_t transition; //!< Transition time of the request in multiples of 100 ms
+};
+
+//! \brief Runs color transitions on the client
+//!
+//! The bridge fades linearly in xy and brightness, which takes ugly paths between distant colors.
+//! The engine interpolates in the perceptual Oklab color space instead, clamped to the gamut of the light.
+//! The path is split into the fewest keyframes for which the fade of the bridge stays close enough to the path.
+//! Each keyframe is one state request, so the requests also respect the rate limit of the bridge.
+class TransitionEngine
+{
+public:
+    //! \brief Creates a transition engine
+    //! \param maxError Largest allowed Oklab distance between the planned path and the fade of the bridge.
+    //! 0.02 is about the smallest visible difference.
+    //! \param minInterval Minimum time between two requests, rounded up to a multiple of 100 ms.
+    //! Requests are never sent faster than \ref HueCommandAPI::minDelay.
+    explicit TransitionEngine(
+        float maxError = 0.02f, std::chrono::milliseconds minInterval = std::chrono::milliseconds(100));
+
+    //! \brief Returns the largest allowed Oklab distance
+    float getMaxError() const;
+
+    //! \brief Returns the minimum time between two requests
+    std::chrono::milliseconds getMinInterval() const;
+
+    //! \brief Plans the keyframes of a transition
+    //! \param from Color the light currently shows
+    //! \param to Color at the end of the transition
+    //! \param duration Length of the transition, rounded to a multiple of 100 ms
+    //! \param colorType Color type of the light, colors are clamped to its gamut
+    //! \returns Keyframes ordered by time. The last one ends at \c to after \c duration.
+    std::vector<TransitionKeyframe> plan(
+        TransitionColor from, TransitionColor to, std::chrono::milliseconds duration, ColorType colorType) const;
+
+    //! \brief Runs a transition on a light
+    //!
+    //! Starts from the cached state of the light and blocks until the last keyframe is sent.
+    //! The light is turned on with the first keyframe if necessary.
+    //! Only lights with a color gamut are supported, because keyframes are sent as xy colors.
+    //! \param light Light to change, should have a refreshed state
+    //! \param to Color at the end of the transition
+    //! \param duration Length of the transition
+    //! \returns Empty result, an error without sending anything if the \ref ColorType of the light
+    //! has no gamut, or the error of the first request that failed
+    Result<void> run(HueLight& light, TransitionColor to, std::chrono::milliseconds duration) const;
+
+    //! \brief Interpolates between two colors in Oklab
+    //! \param from, to Colors at the start and end
+    //! \param t Position on the path from 0 to 1
+    //! \param colorType Color type of the light, the result is clamped to its gamut
+    static TransitionColor interpolate(TransitionColor from, TransitionColor to, float t, ColorType colorType);
+
+    //! \brief Returns the perceptual distance of two colors in Oklab
+    static float distance(TransitionColor a, TransitionColor b);
+
+    //! \brief Returns the color a light state shows, independent of its color mode
+    //! \param state State of the light
+    //! \param colorType Color type of the light, hue and saturation are converted in its gamut
+    static TransitionColor getColor(const LightState& state, ColorType colorType);
+
+private:
+    float maxError;
+    std::chrono::milliseconds minInterval;
+};
+
+#endif
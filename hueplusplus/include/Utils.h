@@ -23,6 +23,12 @@
 #ifndef _UTILS_H
 #define _UTILS_H
 
+#include <cstdint>
+#include <limits>
+
+#include "JsonArena.h"
+#include "StateRequest.h"
+
 #include "json/json.hpp"
 
 namespace utils
@@ -59,13 +65,74 @@ namespace utils
         }
     } // namespace detail
 
+    //! \brief Result of \ref validateReplyForLight
+    struct ReplyValidation
+    {
+        //! \brief \ref StateRequest::Field bits of the attributes that were confirmed with a different value
+        uint16_t mismatched = 0;
+        //! \brief True if the reply contained an entry that is not a success for a requested attribute of the light
+        bool unexpected = false;
+
+        //! \brief Checks whether the request was executed correctly
+        bool isSuccess() const { return mismatched == 0 && !unexpected; }
+        //! \brief Checks whether the attribute was confirmed with a different value
+        bool isMismatched(StateRequest::Field field) const { return (mismatched & field) != 0; }
+    };
+
     //! \brief Function for validating that a request was executed correctly
     //!
+    //! The reply is compared with the typed request in place, without copying any part of it.
+    //! Colors are compared with a tolerance of 1E-4, because the bridge rounds the coordinates.
     //! \param request The request that was sent initially
     //! \param reply The reply that was received
     //! \param lightId The identifier of the light
-    //! \return True if request was executed correctly
-    bool validateReplyForLight(const nlohmann::json& request, const nlohmann::json& reply, int lightId);
+    //! \return Which attributes did not match the request
+    ReplyValidation validateReplyForLight(const StateRequest& request, const nlohmann::json& reply, int lightId);
+
+    //! \brief Function for validating that a state request was executed correctly
+    //!
+    //! Same as \ref validateReplyForLight, but for a transient reply of any resource.
+    //! \param request The request that was sent initially
+    //! \param reply The reply that was received
+    //! \param path Path the request was sent to, like "/lights/1/state" or "/groups/1/action"
+    //! \return Which attributes did not match the request
+    ReplyValidation validateReply(const StateRequest& request, const ArenaJson& reply, const std::string& path);
+
+    //! \brief Converts an integer json number to an attribute like "bri" or "ct"
+    //!
+    //! Converts like nlohmann::json::get<T>, so values outside of the range of \c T wrap around.
+    template <typename T>
+    T convertNumber(std::int64_t value)
+    {
+        return static_cast<T>(value);
+    }
+
+    //! \brief Converts an unsigned json number to an attribute like "bri" or "ct"
+    //!
+    //! Converts like nlohmann::json::get<T>, so values outside of the range of \c T wrap around.
+    template <typename T>
+    T convertNumber(std::uint64_t value)
+    {
+        return static_cast<T>(value);
+    }
+
+    //! \brief Converts a floating point json number to an attribute like "bri" or "ct"
+    //!
+    //! Fractions are truncated like nlohmann::json::get<T>. Values outside of the range of \c T are clamped,
+    //! because a plain cast of them is undefined behavior.
+    template <typename T>
+    T convertNumber(double value)
+    {
+        if (!(value > 0.0))
+        {
+            return 0;
+        }
+        if (value >= static_cast<double>(std::numeric_limits<T>::max()))
+        {
+            return std::numeric_limits<T>::max();
+        }
+        return static_cast<T>(value);
+    }
 
     //! \brief Returns the object/array member or null if it does not exist
     //!
@@ -0,0 +1,119 @@
+/**
+    \file ZoneExtractor.h
+    Copyright Notice\n
+    Copyright (C) 2017  Jan Rogall		- developer\n
+    Copyright (C) 2017  Moritz Wirger	- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#ifndef _ZONE_EXTRACTOR_H
+#define _ZONE_EXTRACTOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "ColorConversion.h"
+#include "Hue.h"
+#include "Result.h"
+#include "Units.h"
+
+//! \brief Rectangle of a video frame that is shown by a light
+struct FrameZone
+{
+    int lightId; //!< Id of the light that shows the average color of the zone
+    unsigned int left; //!< First column in pixels
+    unsigned int top; //!< First row in pixels
+    unsigned int width; //!< Number of columns
+    unsigned int height; //!< Number of rows
+};
+
+//! \brief Reduces video frames to the average colors of zones for ambilight style effects
+//!
+//! Frames are packed 8 bit RGB, 3 bytes per pixel. The zones are summed with SIMD instructions
+//! and converted to xy with \ref ColorConversion. All buffers are allocated in the constructor,
+//! so processing a stream of frames does not allocate memory.
+class ZoneExtractor
+{
+public:
+    //! \brief Creates an extractor for frames of a fixed size
+    //! \param frameWidth, frameHeight Size of the frames in pixels
+    //! \param zones Rectangles mapped to lights, may overlap
+    //! \throws HueException when a zone is empty or not completely inside of the frame
+    ZoneExtractor(unsigned int frameWidth, unsigned int frameHeight, std::vector<FrameZone> zones);
+
+    //! \brief Returns the width of the frames in pixels
+    unsigned int getFrameWidth() const;
+
+    //! \brief Returns the height of the frames in pixels
+    unsigned int getFrameHeight() const;
+
+    //! \brief Returns the zones in the order of their colors
+    const std::vector<FrameZone>& getZones() const;
+
+    //! \brief Computes the colors of all zones from a frame
+    //! \param frame Packed RGB pixels of the frame, starting at the top left
+    //! \param stride Distance between the start of two rows in bytes, at least 3 * frame width
+    void process(const uint8_t* frame, std::size_t stride);
+
+    //! \brief Computes the colors of all zones using a specific instruction set
+    //!
+    //! Falls back to the best supported instruction set if \c simd is not supported.
+    //! \see process(const uint8_t*, std::size_t)
+    void process(const uint8_t* frame, std::size_t stride, ColorConversion::Simd simd);
+
+    //! \brief Returns the average sRGB color of a zone in the last processed frame
+    //! \param zone Index of the zone
+    RGB getColor(std::size_t zone) const;
+
+    //! \brief Returns the xy coordinates of the average color of a zone
+    //! \param zone Index of the zone
+    XY getXY(std::size_t zone) const;
+
+    //! \brief Returns the brightness of a zone from 1 to 254
+    //!
+    //! The brightness follows the largest component of the average color, because the lights
+    //! show saturated colors at full brightness. Black zones use the lowest brightness.
+    //! \param zone Index of the zone
+    uint8_t getBrightness(std::size_t zone) const;
+
+    //! \brief Sends the colors of the last processed frame to the lights
+    //!
+    //! Each zone is one state request with xy and brightness, lights that are off are turned on.
+    //! Lights of black or almost black zones, with no component above 3, are turned off instead.
+    //! The requests are sent with \ref HueLight::trySetState, so the deadband filters of the lights apply
+    //! and the bridge rate limit is respected. Failed requests do not stop the other zones.
+    //! \param bridge Bridge of the lights
+    //! \param transition Transition time in multiples of 100 ms
+    //! \returns Empty result or the error of the first request that failed
+    //! \throws HueException when a light id is not valid
+    Result<void> send(Hue& bridge, uint16_t transition = 1) const;
+
+private:
+    unsigned int frameWidth;
+    unsigned int frameHeight;
+    std::vector<FrameZone> zones;
+    // Results of the last frame, one entry per zone
+    std::vector<uint8_t> red;
+    std::vector<uint8_t> green;
+    std::vector<uint8_t> blue;
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<uint8_t> brightness;
+};
+
+#endif
@@ -23,6 +23,7 @@
 #ifndef _MOCK_HUE_LIGHT_H
 #define _MOCK_HUE_LIGHT_H
 
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -39,7 +40,14 @@ public:
     MockHueLight(std::shared_ptr<const IHttpHandler> handler)
         : HueLight(1, HueCommandAPI(getBridgeIp(), getBridgePort(), getBridgeUsername(), handler)) {};
 
-    nlohmann::json& getState() { return state; };
+    LightState getState() const override { return state; };
+
+    //! Members changed by the tests count as received from the bridge
+    LightState& getMutableState()
+    {
+        state.members = static_cast<uint16_t>(~0u);
+        return state;
+    };
 
     MOCK_METHOD1(On, bool(uint8_t transition));
 
@@ -109,6 +117,10 @@ public:
 
     MOCK_METHOD4(setColorRGB, bool(uint8_t r, uint8_t g, uint8_t b, uint8_t transition));
 
+    MOCK_CONST_METHOD0(getColorRGB, RGB());
+
+    MOCK_METHOD0(getColorRGB, RGB());
+
     MOCK_METHOD0(alert, bool());
 
     MOCK_METHOD1(alertTemperature, bool(unsigned int mired));
@@ -128,7 +140,17 @@ public:
     MOCK_METHOD3(
         SendPutRequest, nlohmann::json(const nlohmann::json& request, const std::string& subPath, FileInfo fileInfo));
 
+    MOCK_METHOD2(SendStateRequest, utils::ReplyValidation(const StateRequest& request, FileInfo fileInfo));
+
     MOCK_METHOD0(refreshState, void());
+
+    MOCK_METHOD1(trySetState, Result<utils::ReplyValidation>(const StateRequest& request));
 };
 
+//! \brief Action for SendStateRequest, validates the request against a prepared reply of light 1
+inline std::function<utils::ReplyValidation(const StateRequest&, FileInfo)> ValidateAgainst(nlohmann::json reply)
+{
+    return [reply](const StateRequest& request, FileInfo) { return utils::validateReplyForLight(request, reply, 1); };
+}
+
 #endif
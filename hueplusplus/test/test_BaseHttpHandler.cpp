@@ -209,6 +209,52 @@ TEST(BaseHttpHandler, PUTJson)
     EXPECT_EQ(expected, handler.PUTJson("UrI", testval, "192.168.2.1", 90));
 }
 
+TEST(BaseHttpHandler, GETRaw)
+{
+    using namespace ::testing;
+    MockBaseHttpHandler handler;
+
+    const std::string body = "{}";
+    std::string expected_call = "GET UrI HTTP/1.0\r\nContent-Type: application/json\r\nContent-Length: ";
+    expected_call.append(std::to_string(body.size()));
+    expected_call.append("\r\n\r\n");
+    expected_call.append(body);
+    expected_call.append("\r\n\r\n");
+
+    EXPECT_CALL(handler, send(expected_call, "192.168.2.1", 90))
+        .Times(AtLeast(2))
+        .WillOnce(Return(""))
+        .WillRepeatedly(Return("\r\n\r\n{\"test\" : \"whatever\"}"));
+
+    EXPECT_THROW(handler.GETRaw("UrI", body, "192.168.2.1", 90), HueException);
+    // Response is not parsed
+    EXPECT_EQ("{\"test\" : \"whatever\"}", handler.GETRaw("UrI", body, "192.168.2.1", 90));
+}
+
+TEST(BaseHttpHandler, PUTRaw)
+{
+    using namespace ::testing;
+    MockBaseHttpHandler handler;
+
+    const std::string body = "{\"on\":true}";
+    std::string expected_call = "PUT UrI HTTP/1.0\r\nContent-Type: application/json\r\nContent-Length: ";
+    expected_call.append(std::to_string(body.size()));
+    expected_call.append("\r\n\r\n");
+    expected_call.append(body);
+    expected_call.append("\r\n\r\n");
+
+    EXPECT_CALL(handler, send(expected_call, "192.168.2.1", 90))
+        .Times(AtLeast(2))
+        .WillOnce(Return(""))
+        .WillOnce(Return("\r\n\r\n"))
+        .WillRepeatedly(Return("\r\n\r\n{\"test\" : \"whatever\"}"));
+
+    EXPECT_THROW(handler.PUTRaw("UrI", body, "192.168.2.1", 90), HueException);
+    // Response is not parsed
+    EXPECT_EQ("", handler.PUTRaw("UrI", body, "192.168.2.1", 90));
+    EXPECT_EQ("{\"test\" : \"whatever\"}", handler.PUTRaw("UrI", body, "192.168.2.1", 90));
+}
+
 TEST(BaseHttpHandler, DELETEJson)
 {
     using namespace ::testing;
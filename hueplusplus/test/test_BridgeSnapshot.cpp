@@ -0,0 +1,275 @@
+/**
+    \file test_BridgeSnapshot.cpp
+    Copyright Notice\n
+    Copyright (C) 2017  Jan Rogall		- developer\n
+    Copyright (C) 2017  Moritz Wirger	- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "testhelper.h"
+
+#include "../include/BridgeSnapshot.h"
+#include "../include/Hue.h"
+#include "../include/json/json.hpp"
+#include "mocks/mock_HttpHandler.h"
+
+namespace
+{
+    nlohmann::json getLightState(const std::string& name, const std::string& modelId, bool on)
+    {
+        return nlohmann::json{
+            {"state", {{"on", on}, {"bri", 254}, {"ct", 366}, {"colormode", "ct"}, {"reachable", true}}},
+            {"type", "Color temperature light"}, {"name", name}, {"modelid", modelId}};
+    }
+} // namespace
+
+TEST(BridgeSnapshot, writeRead)
+{
+    BridgeSnapshot snapshot;
+    snapshot.ip = getBridgeIp();
+    snapshot.port = getBridgePort();
+    snapshot.username = getBridgeUsername();
+    snapshot.lights.push_back(
+        BridgeSnapshot::Light{1, "LTW001", ColorType::TEMPERATURE, getLightState("a", "LTW001", true)});
+    snapshot.lights.push_back(
+        BridgeSnapshot::Light{12, "LCT001", ColorType::GAMUT_B, getLightState("b", "LCT001", false)});
+
+    std::stringstream stream;
+    snapshot.write(stream);
+    BridgeSnapshot result = BridgeSnapshot::read(stream);
+    EXPECT_EQ(getBridgeIp(), result.ip);
+    EXPECT_EQ(getBridgePort(), result.port);
+    EXPECT_EQ(getBridgeUsername(), result.username);
+    ASSERT_EQ(2, result.lights.size());
+    EXPECT_EQ(1, result.lights[0].id);
+    EXPECT_EQ("LTW001", result.lights[0].modelId);
+    EXPECT_EQ(ColorType::TEMPERATURE, result.lights[0].colorType);
+    EXPECT_EQ(snapshot.lights[0].state, result.lights[0].state);
+    EXPECT_EQ(12, result.lights[1].id);
+    EXPECT_EQ(ColorType::GAMUT_B, result.lights[1].colorType);
+    EXPECT_EQ(snapshot.lights[1].state, result.lights[1].state);
+}
+
+TEST(BridgeSnapshot, readInvalid)
+{
+    BridgeSnapshot snapshot;
+    snapshot.lights.push_back(
+        BridgeSnapshot::Light{1, "LTW001", ColorType::TEMPERATURE, getLightState("a", "LTW001", true)});
+    std::stringstream stream;
+    snapshot.write(stream);
+    const std::string data = stream.str();
+    {
+        std::istringstream empty("");
+        EXPECT_THROW(BridgeSnapshot::read(empty), HueException);
+    }
+    {
+        std::string wrongMagic = data;
+        wrongMagic[0] = 'X';
+        std::istringstream in(wrongMagic);
+        EXPECT_THROW(BridgeSnapshot::read(in), HueException);
+    }
+    {
+        std::string wrongVersion = data;
+        wrongVersion[4] = static_cast<char>(BridgeSnapshot::version + 1);
+        std::istringstream in(wrongVersion);
+        EXPECT_THROW(BridgeSnapshot::read(in), HueException);
+    }
+    {
+        std::istringstream in(data.substr(0, data.size() - 3));
+        EXPECT_THROW(BridgeSnapshot::read(in), HueException);
+    }
+}
+
+TEST(BridgeSnapshot, readVersion1)
+{
+    const nlohmann::json state = getLightState("a", "LTW001", true);
+    std::string data = "HUES";
+    auto appendU32 = [&](uint32_t value) {
+        for (int i = 0; i < 4; ++i)
+        {
+            data.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+        }
+    };
+    auto appendString = [&](const std::string& value) {
+        appendU32(static_cast<uint32_t>(value.size()));
+        data.append(value);
+    };
+    appendU32(1);
+    appendString(getBridgeIp());
+    appendU32(getBridgePort());
+    appendString(getBridgeUsername());
+    appendU32(1);
+    appendU32(3);
+    appendString("LTW001");
+    appendU32(static_cast<uint32_t>(ColorType::TEMPERATURE));
+    appendString(state.dump());
+
+    std::istringstream in(data);
+    BridgeSnapshot result = BridgeSnapshot::read(in);
+    EXPECT_EQ(getBridgeIp(), result.ip);
+    EXPECT_EQ(getBridgeUsername(), result.username);
+    ASSERT_EQ(1, result.lights.size());
+    EXPECT_EQ(3, result.lights[0].id);
+    EXPECT_EQ(ColorType::TEMPERATURE, result.lights[0].colorType);
+    EXPECT_EQ(state, result.lights[0].state);
+}
+
+TEST(BridgeSnapshot, encodeDecode)
+{
+    BridgeSnapshot snapshot;
+    snapshot.ip = getBridgeIp();
+    snapshot.port = getBridgePort();
+    snapshot.username = getBridgeUsername();
+    snapshot.lights.push_back(
+        BridgeSnapshot::Light{1, "LTW001", ColorType::TEMPERATURE, getLightState("a", "LTW001", true)});
+    snapshot.lights.push_back(
+        BridgeSnapshot::Light{12, "LCT001", ColorType::GAMUT_B, getLightState("b", "LCT001", false)});
+    snapshot.lights[1].state["state"]["xy"] = {0.3127, 0.329};
+
+    const nlohmann::json json = snapshot.toJson();
+    EXPECT_EQ(BridgeSnapshot::version, json["version"]);
+    EXPECT_EQ(getBridgeIp(), json["ip"]);
+    EXPECT_EQ(12, json["lights"][1]["id"]);
+    EXPECT_EQ("LCT001", json["lights"][1]["modelid"]);
+    EXPECT_EQ(snapshot.lights[1].state, json["lights"][1]["state"]);
+
+    for (SnapshotEncoding encoding : {SnapshotEncoding::JSON, SnapshotEncoding::CBOR, SnapshotEncoding::MSGPACK})
+    {
+        const std::vector<uint8_t> data = snapshot.encode(encoding);
+        BridgeSnapshot result = BridgeSnapshot::decode(data, encoding);
+        EXPECT_EQ(json, result.toJson());
+        EXPECT_EQ(getBridgePort(), result.port);
+        ASSERT_EQ(2, result.lights.size());
+        EXPECT_EQ(ColorType::GAMUT_B, result.lights[1].colorType);
+        EXPECT_EQ(snapshot.lights[1].state, result.lights[1].state);
+    }
+    const std::vector<uint8_t> text = snapshot.encode(SnapshotEncoding::JSON);
+    EXPECT_EQ(json.dump(), std::string(text.begin(), text.end()));
+    EXPECT_LT(snapshot.encode(SnapshotEncoding::CBOR).size(), text.size());
+    EXPECT_LT(snapshot.encode(SnapshotEncoding::MSGPACK).size(), text.size());
+}
+
+TEST(BridgeSnapshot, decodeInvalid)
+{
+    BridgeSnapshot snapshot;
+    snapshot.lights.push_back(
+        BridgeSnapshot::Light{1, "LTW001", ColorType::TEMPERATURE, getLightState("a", "LTW001", true)});
+    const nlohmann::json json = snapshot.toJson();
+    EXPECT_NO_THROW(BridgeSnapshot::fromJson(json));
+    EXPECT_THROW(BridgeSnapshot::fromJson(nullptr), HueException);
+    {
+        nlohmann::json wrongVersion = json;
+        wrongVersion["version"] = BridgeSnapshot::version + 1;
+        EXPECT_THROW(BridgeSnapshot::fromJson(wrongVersion), HueException);
+    }
+    {
+        nlohmann::json missing = json;
+        missing.erase("username");
+        EXPECT_THROW(BridgeSnapshot::fromJson(missing), HueException);
+    }
+    {
+        nlohmann::json wrongType = json;
+        wrongType["lights"][0]["id"] = "1";
+        EXPECT_THROW(BridgeSnapshot::fromJson(wrongType), HueException);
+    }
+    {
+        nlohmann::json wrongColorType = json;
+        wrongColorType["lights"][0]["colortype"] = 100;
+        EXPECT_THROW(BridgeSnapshot::fromJson(wrongColorType), HueException);
+    }
+    std::vector<uint8_t> data = snapshot.encode(SnapshotEncoding::CBOR);
+    data.resize(data.size() / 2);
+    EXPECT_THROW(BridgeSnapshot::decode(data, SnapshotEncoding::CBOR), nlohmann::json::parse_error);
+}
+
+TEST(BridgeSnapshot, HueRestore)
+{
+    using namespace ::testing;
+    std::shared_ptr<MockHttpHandler> handler = std::make_shared<MockHttpHandler>();
+    nlohmann::json bridgeState{{"lights", {{"1", getLightState("Lamp 1", "LTW001", true)}}}};
+    EXPECT_CALL(
+        *handler, GETJson("/api/" + getBridgeUsername(), nlohmann::json::object(), getBridgeIp(), getBridgePort()))
+        .Times(1)
+        .WillOnce(Return(bridgeState));
+    EXPECT_CALL(*handler,
+        GETJson("/api/" + getBridgeUsername() + "/lights/1", nlohmann::json::object(), getBridgeIp(), getBridgePort()))
+        .Times(0);
+
+    std::stringstream stream;
+    {
+        Hue test_bridge(getBridgeIp(), getBridgePort(), getBridgeUsername(), handler);
+        test_bridge.getLight(1);
+        test_bridge.createSnapshot().write(stream);
+    }
+    Mock::VerifyAndClearExpectations(handler.get());
+
+    // Restoring does not contact the bridge
+    EXPECT_CALL(*handler, GETJson(_, _, _, _)).Times(0);
+    Hue restored("", 0, "", handler);
+    restored.restoreSnapshot(BridgeSnapshot::read(stream));
+    EXPECT_EQ(getBridgeIp(), restored.getBridgeIP());
+    EXPECT_EQ(getBridgePort(), restored.getBridgePort());
+    EXPECT_EQ(getBridgeUsername(), restored.getUsername());
+    const Hue& constBridge = restored;
+    EXPECT_TRUE(constBridge.lightExists(1));
+    BridgeSnapshot current = restored.createSnapshot();
+    ASSERT_EQ(1, current.lights.size());
+    EXPECT_EQ(ColorType::TEMPERATURE, current.lights[0].colorType);
+    EXPECT_EQ(bridgeState["lights"]["1"], current.lights[0].state);
+    Mock::VerifyAndClearExpectations(handler.get());
+
+    // Reconcile updates state with a single request and removes lights that no longer exist
+    EXPECT_CALL(
+        *handler, GETJson("/api/" + getBridgeUsername(), nlohmann::json::object(), getBridgeIp(), getBridgePort()))
+        .Times(1)
+        .WillOnce(Return(nlohmann::json{{"lights", {{"1", getLightState("Lamp 1", "LCT001", false)}}}}));
+    EXPECT_CALL(*handler, GETJson("/api/" + getBridgeUsername() + "/lights/1", _, _, _)).Times(0);
+    restored.reconcile();
+    current = restored.createSnapshot();
+    ASSERT_EQ(1, current.lights.size());
+    EXPECT_EQ("LCT001", current.lights[0].modelId);
+    EXPECT_EQ(ColorType::GAMUT_B, current.lights[0].colorType);
+    EXPECT_FALSE(current.lights[0].state["state"]["on"].get<bool>());
+    Mock::VerifyAndClearExpectations(handler.get());
+
+    // Unknown models are rejected like by getLight and the light is kept
+    EXPECT_CALL(
+        *handler, GETJson("/api/" + getBridgeUsername(), nlohmann::json::object(), getBridgeIp(), getBridgePort()))
+        .Times(1)
+        .WillOnce(Return(nlohmann::json{{"lights", {{"1", getLightState("Lamp 1", "UNKNOWN", true)}}}}));
+    EXPECT_THROW(restored.reconcile(), HueException);
+    current = restored.createSnapshot();
+    ASSERT_EQ(1, current.lights.size());
+    EXPECT_EQ("LCT001", current.lights[0].modelId);
+    EXPECT_EQ(ColorType::GAMUT_B, current.lights[0].colorType);
+    EXPECT_FALSE(current.lights[0].state["state"]["on"].get<bool>());
+    Mock::VerifyAndClearExpectations(handler.get());
+
+    EXPECT_CALL(
+        *handler, GETJson("/api/" + getBridgeUsername(), nlohmann::json::object(), getBridgeIp(), getBridgePort()))
+        .Times(1)
+        .WillOnce(Return(nlohmann::json{{"lights", nlohmann::json::object()}}));
+    restored.reconcile();
+    EXPECT_TRUE(restored.createSnapshot().lights.empty());
+}
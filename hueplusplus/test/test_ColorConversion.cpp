@@ -0,0 +1,561 @@
+/**
+    \file test_ColorConversion.cpp
+    Copyright Notice\n
+    Copyright (C) 2017  Jan Rogall		- developer\n
+    Copyright (C) 2017  Moritz Wirger	- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../include/ColorConversion.h"
+
+namespace
+{
+    // Conversion as previously done in SimpleColorHueStrategy::setColorRGB
+    XY referenceRgbToXY(uint8_t r, uint8_t g, uint8_t b, float& brightness)
+    {
+        const float red = float(r) / 255;
+        const float green = float(g) / 255;
+        const float blue = float(b) / 255;
+        const float redCorrected = (red > 0.04045f) ? pow((red + 0.055f) / (1.0f + 0.055f), 2.4f) : (red / 12.92f);
+        const float greenCorrected
+            = (green > 0.04045f) ? pow((green + 0.055f) / (1.0f + 0.055f), 2.4f) : (green / 12.92f);
+        const float blueCorrected
+            = (blue > 0.04045f) ? pow((blue + 0.055f) / (1.0f + 0.055f), 2.4f) : (blue / 12.92f);
+        const float X = redCorrected * 0.664511f + greenCorrected * 0.154324f + blueCorrected * 0.162028f;
+        const float Y = redCorrected * 0.283881f + greenCorrected * 0.668433f + blueCorrected * 0.047685f;
+        const float Z = redCorrected * 0.000088f + greenCorrected * 0.072310f + blueCorrected * 0.986039f;
+        brightness = Y;
+        return {X / (X + Y + Z), Y / (X + Y + Z)};
+    }
+
+#ifdef HUEPLUSPLUS_FIXED_POINT
+    // All conversions use the integer path, its accuracy is checked by the tests of the Fixed functions
+    XY expectedRgbToXY(uint8_t r, uint8_t g, uint8_t b, float& brightness)
+    {
+        return ColorConversion::rgbToXYFixed(r, g, b, &brightness);
+    }
+
+    // Clamped colors are rounded to 1/16384 toward the inside of the gamut
+    void expectClamped(XY expected, XY actual)
+    {
+        EXPECT_NEAR(expected.x, actual.x, 2e-4f);
+        EXPECT_NEAR(expected.y, actual.y, 2e-4f);
+    }
+
+    constexpr float clampTolerance = 2e-4f;
+    constexpr int componentTolerance = 1;
+#else
+    XY expectedRgbToXY(uint8_t r, uint8_t g, uint8_t b, float& brightness)
+    {
+        return referenceRgbToXY(r, g, b, brightness);
+    }
+
+    void expectClamped(XY expected, XY actual)
+    {
+        EXPECT_FLOAT_EQ(expected.x, actual.x);
+        EXPECT_FLOAT_EQ(expected.y, actual.y);
+    }
+
+    constexpr float clampTolerance = 1e-5f;
+    constexpr int componentTolerance = 0;
+#endif
+} // namespace
+
+TEST(ColorConversion, srgbToLinear)
+{
+    EXPECT_EQ(0.0f, ColorConversion::srgbToLinear(0));
+    EXPECT_FLOAT_EQ(1.0f, ColorConversion::srgbToLinear(255));
+    for (int i = 0; i < 256; ++i)
+    {
+        const float value = float(i) / 255;
+        const float expected
+            = (value > 0.04045f) ? std::pow((value + 0.055f) / (1.0f + 0.055f), 2.4f) : (value / 12.92f);
+        EXPECT_FLOAT_EQ(expected, ColorConversion::srgbToLinear(i)) << i;
+    }
+}
+
+TEST(ColorConversion, linearToSrgb)
+{
+    for (int i = 0; i < 256; ++i)
+    {
+        EXPECT_EQ(i, ColorConversion::linearToSrgb(ColorConversion::srgbToLinear(i)));
+    }
+    EXPECT_EQ(0, ColorConversion::linearToSrgb(-0.5f));
+    EXPECT_EQ(255, ColorConversion::linearToSrgb(1.5f));
+    // Rounds in sRGB space, not in linear space
+    EXPECT_EQ(188, ColorConversion::linearToSrgb(0.5f));
+    EXPECT_EQ(13, ColorConversion::linearToSrgb(0.004f));
+}
+
+TEST(ColorConversion, rgbToXY)
+{
+    float brightness = 0;
+    XY xy = ColorConversion::rgbToXY(0, 0, 0, &brightness);
+    EXPECT_EQ(0.0f, xy.x);
+    EXPECT_EQ(0.0f, xy.y);
+    EXPECT_EQ(0.0f, brightness);
+
+    xy = ColorConversion::rgbToXY(255, 255, 255, &brightness);
+    EXPECT_NEAR(0.3227f, xy.x, 0.0001f);
+    EXPECT_NEAR(0.329f, xy.y, 0.0001f);
+    EXPECT_NEAR(1.0f, brightness, 0.0001f);
+
+    for (int r = 0; r < 256; r += 15)
+    {
+        for (int g = 0; g < 256; g += 15)
+        {
+            for (int b = 1; b < 256; b += 15)
+            {
+                float expectedBrightness = 0;
+                const XY expected = expectedRgbToXY(r, g, b, expectedBrightness);
+                xy = ColorConversion::rgbToXY(r, g, b, &brightness);
+                EXPECT_FLOAT_EQ(expected.x, xy.x);
+                EXPECT_FLOAT_EQ(expected.y, xy.y);
+                EXPECT_FLOAT_EQ(expectedBrightness, brightness);
+            }
+        }
+    }
+}
+
+TEST(ColorConversion, rgbToXYBatch)
+{
+    // Odd count so every kernel also converts a remainder
+    std::vector<uint8_t> r;
+    std::vector<uint8_t> g;
+    std::vector<uint8_t> b;
+    for (int i = 0; i < 1003; ++i)
+    {
+        r.push_back(static_cast<uint8_t>(i * 7));
+        g.push_back(static_cast<uint8_t>(i * 13 + 5));
+        b.push_back(static_cast<uint8_t>(i * 31 + 11));
+    }
+    r[17] = g[17] = b[17] = 0;
+    const std::size_t count = r.size();
+
+    const ColorConversion::Simd levels[]
+        = {ColorConversion::Simd::NONE, ColorConversion::Simd::SSE2, ColorConversion::Simd::AVX2};
+    for (ColorConversion::Simd simd : levels)
+    {
+        std::vector<float> x(count, -1.0f);
+        std::vector<float> y(count, -1.0f);
+        std::vector<float> brightness(count, -1.0f);
+        ColorConversion::rgbToXY(r.data(), g.data(), b.data(), count, x.data(), y.data(), brightness.data(), simd);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            float expectedBrightness = 0;
+            XY expected{0.0f, 0.0f};
+            if (r[i] || g[i] || b[i])
+            {
+                expected = expectedRgbToXY(r[i], g[i], b[i], expectedBrightness);
+            }
+            EXPECT_NEAR(expected.x, x[i], 1e-5f) << "simd " << static_cast<int>(simd) << " index " << i;
+            EXPECT_NEAR(expected.y, y[i], 1e-5f) << "simd " << static_cast<int>(simd) << " index " << i;
+            EXPECT_NEAR(expectedBrightness, brightness[i], 1e-5f)
+                << "simd " << static_cast<int>(simd) << " index " << i;
+        }
+        // Brightness is optional
+        ColorConversion::rgbToXY(r.data(), g.data(), b.data(), count, x.data(), y.data(), nullptr, simd);
+    }
+    // Empty input
+    ColorConversion::rgbToXY(nullptr, nullptr, nullptr, 0, nullptr, nullptr, nullptr);
+}
+
+TEST(ColorConversion, getGamut)
+{
+    EXPECT_EQ(nullptr, ColorConversion::getGamut(ColorType::UNDEFINED));
+    EXPECT_EQ(nullptr, ColorConversion::getGamut(ColorType::NONE));
+    EXPECT_EQ(nullptr, ColorConversion::getGamut(ColorType::TEMPERATURE));
+    const ColorConversion::Gamut* gamutA = ColorConversion::getGamut(ColorType::GAMUT_A);
+    ASSERT_NE(nullptr, gamutA);
+    EXPECT_EQ(gamutA, ColorConversion::getGamut(ColorType::GAMUT_A_TEMPERATURE));
+    EXPECT_FLOAT_EQ(0.704f, gamutA->red.x);
+    const ColorConversion::Gamut* gamutB = ColorConversion::getGamut(ColorType::GAMUT_B);
+    ASSERT_NE(nullptr, gamutB);
+    EXPECT_EQ(gamutB, ColorConversion::getGamut(ColorType::GAMUT_B_TEMPERATURE));
+    EXPECT_FLOAT_EQ(0.409f, gamutB->green.x);
+    const ColorConversion::Gamut* gamutC = ColorConversion::getGamut(ColorType::GAMUT_C);
+    ASSERT_NE(nullptr, gamutC);
+    EXPECT_EQ(gamutC, ColorConversion::getGamut(ColorType::GAMUT_C_TEMPERATURE));
+    EXPECT_FLOAT_EQ(0.1532f, gamutC->blue.x);
+}
+
+TEST(ColorConversion, clampToGamut)
+{
+    const ColorConversion::Gamut& gamut = *ColorConversion::getGamut(ColorType::GAMUT_B);
+    // Vertices in both orders
+    const ColorConversion::Gamut reversed{gamut.blue, gamut.green, gamut.red};
+    for (const ColorConversion::Gamut& g : {gamut, reversed})
+    {
+        EXPECT_TRUE(ColorConversion::isInGamut({0.4f, 0.3f}, g));
+        EXPECT_TRUE(ColorConversion::isInGamut(g.red, g));
+        EXPECT_FALSE(ColorConversion::isInGamut({0.1f, 0.1f}, g));
+        EXPECT_FALSE(ColorConversion::isInGamut({0.7f, 0.7f}, g));
+
+        // Inside stays the same
+        XY xy = ColorConversion::clampToGamut({0.4f, 0.3f}, g);
+        EXPECT_EQ(0.4f, xy.x);
+        EXPECT_EQ(0.3f, xy.y);
+        // Closest point on an edge
+        xy = ColorConversion::clampToGamut({0.1f, 0.1f}, g);
+        EXPECT_NEAR(0.17751f, xy.x, clampTolerance);
+        EXPECT_NEAR(0.06076f, xy.y, clampTolerance);
+        // Closest point is a vertex
+        xy = ColorConversion::clampToGamut({0.8f, 0.3f}, g);
+        expectClamped(gamut.red, xy);
+    }
+
+    XY xy = ColorConversion::clampToGamut({0.1f, 0.1f}, ColorType::GAMUT_B);
+    EXPECT_NEAR(0.17751f, xy.x, clampTolerance);
+    xy = ColorConversion::clampToGamut({0.1f, 0.1f}, ColorType::NONE);
+    EXPECT_EQ(0.1f, xy.x);
+    EXPECT_EQ(0.1f, xy.y);
+}
+
+TEST(ColorConversion, clampToGamutBatch)
+{
+    std::vector<float> x;
+    std::vector<float> y;
+    for (int i = 0; i < 43; ++i)
+    {
+        for (int j = 0; j < 41; ++j)
+        {
+            x.push_back(i / 42.0f);
+            y.push_back(j / 40.0f);
+        }
+    }
+    const ColorConversion::Simd levels[]
+        = {ColorConversion::Simd::NONE, ColorConversion::Simd::SSE2, ColorConversion::Simd::AVX2};
+    for (ColorType type : {ColorType::GAMUT_A, ColorType::GAMUT_B, ColorType::GAMUT_C})
+    {
+        const ColorConversion::Gamut& gamut = *ColorConversion::getGamut(type);
+        for (ColorConversion::Simd simd : levels)
+        {
+            std::vector<float> clampedX = x;
+            std::vector<float> clampedY = y;
+            ColorConversion::clampToGamut(clampedX.data(), clampedY.data(), x.size(), gamut, simd);
+            for (std::size_t i = 0; i < x.size(); ++i)
+            {
+                const XY expected = ColorConversion::clampToGamut({x[i], y[i]}, gamut);
+                EXPECT_NEAR(expected.x, clampedX[i], 1e-6f) << "simd " << static_cast<int>(simd) << " index " << i;
+                EXPECT_NEAR(expected.y, clampedY[i], 1e-6f) << "simd " << static_cast<int>(simd) << " index " << i;
+            }
+        }
+    }
+}
+
+TEST(ColorConversion, rgbToXYFixed)
+{
+    float brightness = -1.0f;
+    XY xy = ColorConversion::rgbToXYFixed(0, 0, 0, &brightness);
+    EXPECT_EQ(0.0f, xy.x);
+    EXPECT_EQ(0.0f, xy.y);
+    EXPECT_EQ(0.0f, brightness);
+
+    // Black is checked above, the reference divides by 0
+    for (int r = 0; r < 256; r += 5)
+    {
+        for (int g = 0; g < 256; g += 5)
+        {
+            for (int b = (r == 0 && g == 0) ? 5 : 0; b < 256; b += 5)
+            {
+                float expectedBrightness;
+                const XY expected = referenceRgbToXY(r, g, b, expectedBrightness);
+                xy = ColorConversion::rgbToXYFixed(r, g, b, &brightness);
+                ASSERT_NEAR(expected.x, xy.x, 0.002f) << r << " " << g << " " << b;
+                ASSERT_NEAR(expected.y, xy.y, 0.002f) << r << " " << g << " " << b;
+                ASSERT_NEAR(expectedBrightness, brightness, 1e-4f) << r << " " << g << " " << b;
+                // Error is much smaller for colors that are not almost black
+                if (std::max({r, g, b}) >= 50)
+                {
+                    ASSERT_NEAR(expected.x, xy.x, 5e-4f) << r << " " << g << " " << b;
+                    ASSERT_NEAR(expected.y, xy.y, 5e-4f) << r << " " << g << " " << b;
+                }
+            }
+        }
+    }
+}
+
+TEST(ColorConversion, clampToGamutFixed)
+{
+    for (ColorType type : {ColorType::GAMUT_A, ColorType::GAMUT_B, ColorType::GAMUT_C})
+    {
+        const ColorConversion::Gamut& gamut = *ColorConversion::getGamut(type);
+        for (int i = 0; i <= 100; ++i)
+        {
+            for (int j = 0; j <= 100; ++j)
+            {
+                const XY xy{i / 100.0f, j / 100.0f};
+                const XY expected = ColorConversion::clampToGamut(xy, gamut);
+                const XY fixedType = ColorConversion::clampToGamutFixed(xy, type);
+                const XY fixedGamut = ColorConversion::clampToGamutFixed(xy, gamut);
+                ASSERT_NEAR(expected.x, fixedType.x, 2e-4f) << xy.x << " " << xy.y;
+                ASSERT_NEAR(expected.y, fixedType.y, 2e-4f) << xy.x << " " << xy.y;
+                // Rounding never leaves the gamut
+                ASSERT_TRUE(ColorConversion::isInGamut(fixedType, gamut)) << xy.x << " " << xy.y;
+                EXPECT_EQ(fixedType.x, fixedGamut.x);
+                EXPECT_EQ(fixedType.y, fixedGamut.y);
+            }
+        }
+    }
+    // Inside stays exactly the same
+    XY xy = ColorConversion::clampToGamutFixed({0.4f, 0.3f}, ColorType::GAMUT_B);
+    EXPECT_EQ(0.4f, xy.x);
+    EXPECT_EQ(0.3f, xy.y);
+    xy = ColorConversion::clampToGamutFixed({0.1f, 0.1f}, ColorType::NONE);
+    EXPECT_EQ(0.1f, xy.x);
+    EXPECT_EQ(0.1f, xy.y);
+    // Coordinates outside of [0, 1] do not overflow
+    xy = ColorConversion::clampToGamutFixed({-5.0f, 7.0f}, ColorType::GAMUT_C);
+    EXPECT_NEAR(0.17f, xy.x, 2e-4f);
+    EXPECT_NEAR(0.7f, xy.y, 2e-4f);
+}
+
+TEST(ColorConversion, xyToRGB)
+{
+    // Colors with one full component survive the round trip
+    for (int a = 0; a < 256; a += 17)
+    {
+        for (int b = 0; b < 256; b += 17)
+        {
+            const uint8_t colors[3][3] = {{255, uint8_t(a), uint8_t(b)}, {uint8_t(a), 255, uint8_t(b)},
+                {uint8_t(a), uint8_t(b), 255}};
+            for (const auto& color : colors)
+            {
+                const XY xy = ColorConversion::rgbToXY(color[0], color[1], color[2]);
+                const RGB rgb = ColorConversion::xyToRGB(xy, 254);
+                EXPECT_NEAR(color[0], rgb.r, 1) << a << " " << b;
+                EXPECT_NEAR(color[1], rgb.g, 1) << a << " " << b;
+                EXPECT_NEAR(color[2], rgb.b, 1) << a << " " << b;
+            }
+        }
+    }
+    // Brightness scales the linear components
+    const XY white = ColorConversion::rgbToXY(255, 255, 255);
+    RGB rgb = ColorConversion::xyToRGB(white, 127);
+    EXPECT_NEAR(188, rgb.r, componentTolerance);
+    EXPECT_NEAR(188, rgb.g, componentTolerance);
+    EXPECT_NEAR(188, rgb.b, componentTolerance);
+    rgb = ColorConversion::xyToRGB(white, 0);
+    EXPECT_EQ(0, rgb.r);
+    // Invalid coordinates
+    rgb = ColorConversion::xyToRGB({0.3f, 0.0f}, 254);
+    EXPECT_EQ(0, rgb.r);
+    EXPECT_EQ(0, rgb.g);
+    EXPECT_EQ(0, rgb.b);
+}
+
+TEST(ColorConversion, hueSaturationToRGB)
+{
+    RGB rgb = ColorConversion::hueSaturationToRGB(0, 254, 254);
+    EXPECT_EQ(255, rgb.r);
+    EXPECT_EQ(0, rgb.g);
+    EXPECT_EQ(0, rgb.b);
+    rgb = ColorConversion::hueSaturationToRGB(21845, 254, 254);
+    EXPECT_EQ(0, rgb.r);
+    EXPECT_EQ(255, rgb.g);
+    EXPECT_EQ(0, rgb.b);
+    rgb = ColorConversion::hueSaturationToRGB(43690, 254, 254);
+    EXPECT_EQ(0, rgb.r);
+    EXPECT_EQ(0, rgb.g);
+    EXPECT_EQ(255, rgb.b);
+    rgb = ColorConversion::hueSaturationToRGB(65535, 254, 254);
+    EXPECT_EQ(255, rgb.r);
+    EXPECT_EQ(0, rgb.g);
+    EXPECT_EQ(0, rgb.b);
+    // Half way between red and yellow
+    rgb = ColorConversion::hueSaturationToRGB(5461, 254, 254);
+    EXPECT_EQ(255, rgb.r);
+    EXPECT_NEAR(128, rgb.g, 1);
+    EXPECT_EQ(0, rgb.b);
+    rgb = ColorConversion::hueSaturationToRGB(12345, 0, 127);
+    EXPECT_EQ(188, rgb.r);
+    EXPECT_EQ(188, rgb.g);
+    EXPECT_EQ(188, rgb.b);
+}
+
+TEST(ColorConversion, hueSaturationToXY)
+{
+    // Same as the conversion through RGB without a gamut
+    for (uint16_t hue : {0, 5461, 12345, 21845, 43690, 60000})
+    {
+        for (uint8_t sat : {0, 100, 254})
+        {
+            const RGB rgb = ColorConversion::hueSaturationToRGB(hue, sat, 254);
+            const XY expected = ColorConversion::rgbToXY(rgb.r, rgb.g, rgb.b);
+            const XY xy = ColorConversion::hueSaturationToXY(hue, sat, ColorType::NONE);
+            EXPECT_FLOAT_EQ(expected.x, xy.x);
+            EXPECT_FLOAT_EQ(expected.y, xy.y);
+        }
+    }
+    // Pure green is outside of gamut A
+    const XY green = ColorConversion::hueSaturationToXY(21845, 254, ColorType::NONE);
+    const ColorConversion::Gamut& gamutA = *ColorConversion::getGamut(ColorType::GAMUT_A);
+    EXPECT_FALSE(ColorConversion::isInGamut(green, gamutA));
+    const XY clamped = ColorConversion::hueSaturationToXY(21845, 254, ColorType::GAMUT_A);
+    const XY expected = ColorConversion::clampToGamut(green, gamutA);
+    EXPECT_FLOAT_EQ(expected.x, clamped.x);
+    EXPECT_FLOAT_EQ(expected.y, clamped.y);
+}
+
+TEST(ColorConversion, xyToHueSaturation)
+{
+    // Round trip within the rounding of the RGB components
+    for (int hue = 0; hue < 65536; hue += 997)
+    {
+        for (int sat = 20; sat <= 254; sat += 13)
+        {
+            const XY xy = ColorConversion::hueSaturationToXY(hue, sat, ColorType::NONE);
+            const HueSaturation hs = ColorConversion::xyToHueSaturation(xy, ColorType::NONE);
+            const int hueError = std::abs(hs.hue - hue);
+            EXPECT_LE(std::min(hueError, 65536 - hueError), 65536 / 6 / sat + 1) << hue << ' ' << sat;
+            EXPECT_NEAR(sat, hs.saturation, 1) << hue << ' ' << sat;
+        }
+    }
+    HueSaturation hs = ColorConversion::xyToHueSaturation(ColorConversion::rgbToXY(255, 0, 0), ColorType::NONE);
+    EXPECT_EQ(0, hs.hue);
+    EXPECT_EQ(254, hs.saturation);
+    hs = ColorConversion::xyToHueSaturation(ColorConversion::rgbToXY(0, 0, 255), ColorType::NONE);
+    EXPECT_EQ(43691, hs.hue);
+    EXPECT_EQ(254, hs.saturation);
+    hs = ColorConversion::xyToHueSaturation(ColorConversion::rgbToXY(255, 255, 255), ColorType::NONE);
+    EXPECT_EQ(0, hs.hue);
+    EXPECT_EQ(0, hs.saturation);
+    hs = ColorConversion::xyToHueSaturation({0.3f, 0.0f}, ColorType::NONE);
+    EXPECT_EQ(0, hs.hue);
+    EXPECT_EQ(0, hs.saturation);
+
+    // Colors outside of the gamut are clamped first
+    const XY outside{0.1f, 0.8f};
+    const ColorConversion::Gamut& gamutB = *ColorConversion::getGamut(ColorType::GAMUT_B);
+    const HueSaturation clamped = ColorConversion::xyToHueSaturation(outside, ColorType::GAMUT_B);
+    const HueSaturation expected
+        = ColorConversion::xyToHueSaturation(ColorConversion::clampToGamut(outside, gamutB), ColorType::NONE);
+    EXPECT_EQ(expected.hue, clamped.hue);
+    EXPECT_EQ(expected.saturation, clamped.saturation);
+}
+
+TEST(ColorConversion, colorTemperatureToRGB)
+{
+    // 6500 K is close to the sRGB white point
+    XY xy = ColorConversion::colorTemperatureToXY(154);
+    EXPECT_NEAR(0.3135f, xy.x, 0.001f);
+    EXPECT_NEAR(0.3236f, xy.y, 0.001f);
+    // 2000 K
+    xy = ColorConversion::colorTemperatureToXY(500);
+    EXPECT_NEAR(0.5267f, xy.x, 0.001f);
+    EXPECT_NEAR(0.4133f, xy.y, 0.001f);
+    // Clamped to the valid range
+    xy = ColorConversion::colorTemperatureToXY(0);
+    const XY coldest = ColorConversion::colorTemperatureToXY(40);
+    EXPECT_EQ(coldest.x, xy.x);
+    EXPECT_EQ(coldest.y, xy.y);
+
+    const RGB warm = ColorConversion::colorTemperatureToRGB(500, 254);
+    EXPECT_EQ(255, warm.r);
+    EXPECT_LT(warm.b, warm.g);
+    EXPECT_LT(warm.g, warm.r);
+    const RGB cold = ColorConversion::colorTemperatureToRGB(153, 254);
+    EXPECT_GT(cold.r, 230);
+    EXPECT_GT(cold.g, 230);
+    EXPECT_EQ(255, cold.b);
+}
+
+TEST(ColorConversion, xyToColorTemperature)
+{
+    for (unsigned int mired = 40; mired <= 600; ++mired)
+    {
+        EXPECT_EQ(mired, ColorConversion::xyToColorTemperature(ColorConversion::colorTemperatureToXY(mired)));
+    }
+    // Colors off the locus return the closest point
+    const XY warm = ColorConversion::colorTemperatureToXY(370);
+    EXPECT_NEAR(370, ColorConversion::xyToColorTemperature({warm.x, warm.y + 0.01f}), 5);
+    EXPECT_EQ(600u, ColorConversion::xyToColorTemperature({0.7f, 0.3f}));
+    EXPECT_EQ(40u, ColorConversion::xyToColorTemperature({0.1f, 0.1f}));
+}
+
+TEST(ColorConversion, stateToRGB)
+{
+    std::vector<LightState> states(5);
+    for (LightState& state : states)
+    {
+        state.on = true;
+        state.bri = 254;
+    }
+    states[0].on = false;
+    states[1].colormode = ColorMode::NONE;
+    states[2].colormode = ColorMode::HS;
+    states[2].sat = 254;
+    states[3].colormode = ColorMode::XY;
+    states[3].xy = ColorConversion::rgbToXY(0, 0, 255);
+    states[4].colormode = ColorMode::CT;
+    states[4].ct = 366;
+
+    std::vector<RGB> rgb(states.size());
+    ColorConversion::stateToRGB(states.data(), states.size(), rgb.data());
+    EXPECT_EQ(0, rgb[0].r + rgb[0].g + rgb[0].b);
+    EXPECT_EQ(255 * 3, rgb[1].r + rgb[1].g + rgb[1].b);
+    EXPECT_EQ(255, rgb[2].r);
+    EXPECT_EQ(0, rgb[2].g);
+    EXPECT_EQ(255, rgb[3].b);
+    EXPECT_GE(1, rgb[3].r);
+    const RGB ct = ColorConversion::colorTemperatureToRGB(366, 254);
+    EXPECT_EQ(ct.r, rgb[4].r);
+    EXPECT_EQ(ct.g, rgb[4].g);
+    EXPECT_EQ(ct.b, rgb[4].b);
+
+    // Batch conversions give the same results
+    const float x[] = {0.2f, 0.4f, 0.6f};
+    const float y[] = {0.2f, 0.4f, 0.3f};
+    const uint8_t brightness[] = {254, 100, 1};
+    const uint16_t hue[] = {0, 30000, 50000};
+    const uint8_t sat[] = {0, 100, 254};
+    const uint16_t mired[] = {153, 300, 500};
+    uint8_t r[3];
+    uint8_t g[3];
+    uint8_t b[3];
+    ColorConversion::xyToRGB(x, y, brightness, 3, r, g, b);
+    for (int i = 0; i < 3; ++i)
+    {
+        const RGB expected = ColorConversion::xyToRGB({x[i], y[i]}, brightness[i]);
+        EXPECT_EQ(expected.r, r[i]);
+        EXPECT_EQ(expected.g, g[i]);
+        EXPECT_EQ(expected.b, b[i]);
+    }
+    ColorConversion::hueSaturationToRGB(hue, sat, brightness, 3, r, g, b);
+    for (int i = 0; i < 3; ++i)
+    {
+        const RGB expected = ColorConversion::hueSaturationToRGB(hue[i], sat[i], brightness[i]);
+        EXPECT_EQ(expected.r, r[i]);
+        EXPECT_EQ(expected.g, g[i]);
+        EXPECT_EQ(expected.b, b[i]);
+    }
+    ColorConversion::colorTemperatureToRGB(mired, brightness, 3, r, g, b);
+    for (int i = 0; i < 3; ++i)
+    {
+        const RGB expected = ColorConversion::colorTemperatureToRGB(mired[i], brightness[i]);
+        EXPECT_EQ(expected.r, r[i]);
+        EXPECT_EQ(expected.g, g[i]);
+        EXPECT_EQ(expected.b, b[i]);
+    }
+}
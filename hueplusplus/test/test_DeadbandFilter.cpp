@@ -0,0 +1,227 @@
+/**
+    \file test_DeadbandFilter.cpp
+    Copyright Notice\n
+    Copyright (C) 2017  Jan Rogall		- developer\n
+    Copyright (C) 2017  Moritz Wirger	- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include <gtest/gtest.h>
+
+#include "../include/ColorConversion.h"
+#include "../include/DeadbandFilter.h"
+
+namespace
+{
+    LightState createState(ColorMode mode)
+    {
+        LightState state;
+        state.on = true;
+        state.bri = 200;
+        state.colormode = mode;
+        state.xy = {0.4f, 0.4f};
+        state.hue = 10000;
+        state.sat = 200;
+        state.ct = 300;
+        return state;
+    }
+} // namespace
+
+TEST(DeadbandFilter, Constructor)
+{
+    DeadbandFilter filter;
+    EXPECT_FLOAT_EQ(0.02f, filter.getMaxDistance());
+    EXPECT_EQ(5u, filter.getMaxMired());
+    EXPECT_EQ(0u, filter.getPassedRequests());
+    EXPECT_EQ(0u, filter.getSuppressedRequests());
+    EXPECT_EQ(0u, filter.getSuppressedFields());
+
+    DeadbandFilter custom(0.05f, 10);
+    EXPECT_FLOAT_EQ(0.05f, custom.getMaxDistance());
+    EXPECT_EQ(10u, custom.getMaxMired());
+}
+
+TEST(DeadbandFilter, xy)
+{
+    DeadbandFilter filter;
+    const LightState state = createState(ColorMode::XY);
+
+    // Tiny change is dropped, including the transition
+    StateRequest request;
+    request.setTransition(2);
+    request.setXY(0.4005f, 0.3998f);
+    EXPECT_FALSE(filter.apply(request, state));
+    EXPECT_EQ(1u, filter.getSuppressedRequests());
+    EXPECT_EQ(1u, filter.getSuppressedFields());
+
+    // Visible change is kept
+    request = StateRequest();
+    request.setXY(0.3f, 0.3f);
+    EXPECT_TRUE(filter.apply(request, state));
+    EXPECT_TRUE(request.has(StateRequest::XY));
+    EXPECT_EQ(1u, filter.getPassedRequests());
+
+    // Color and brightness together
+    request = StateRequest();
+    request.setXY(0.4005f, 0.4f);
+    request.setBrightness(201);
+    EXPECT_FALSE(filter.apply(request, state));
+    request = StateRequest();
+    request.setXY(0.4005f, 0.4f);
+    request.setBrightness(100);
+    EXPECT_TRUE(filter.apply(request, state));
+    EXPECT_TRUE(request.has(StateRequest::XY));
+    EXPECT_TRUE(request.has(StateRequest::BRI));
+    EXPECT_EQ(2u, filter.getSuppressedRequests());
+    EXPECT_EQ(3u, filter.getSuppressedFields());
+
+    // Requests with an effect are not filtered at all, so even the invisible xy change is kept
+    request = StateRequest();
+    request.setXY(0.4005f, 0.4f);
+    request.setEffect(Effect::COLORLOOP);
+    EXPECT_TRUE(filter.apply(request, state));
+    EXPECT_TRUE(request.has(StateRequest::XY));
+
+    filter.resetCounters();
+    EXPECT_EQ(0u, filter.getPassedRequests());
+    EXPECT_EQ(0u, filter.getSuppressedRequests());
+    EXPECT_EQ(0u, filter.getSuppressedFields());
+}
+
+TEST(DeadbandFilter, brightness)
+{
+    DeadbandFilter filter;
+    LightState state = createState(ColorMode::NONE);
+    StateRequest request;
+    request.setBrightness(202);
+    EXPECT_FALSE(filter.apply(request, state));
+    // The same step is visible for a dark light
+    state.bri = 5;
+    request = StateRequest();
+    request.setBrightness(7);
+    EXPECT_TRUE(filter.apply(request, state));
+    EXPECT_TRUE(request.has(StateRequest::BRI));
+
+    // Changes are never removed while the light is off or turned off
+    state.on = false;
+    request = StateRequest();
+    request.setBrightness(5);
+    EXPECT_TRUE(filter.apply(request, state));
+    EXPECT_TRUE(request.has(StateRequest::BRI));
+    state.on = true;
+    request = StateRequest();
+    request.setOn(false);
+    request.setBrightness(5);
+    EXPECT_TRUE(filter.apply(request, state));
+    EXPECT_TRUE(request.has(StateRequest::BRI));
+
+    // Turning on a light that is on is not visible
+    request = StateRequest();
+    request.setOn(true);
+    request.setBrightness(5);
+    EXPECT_FALSE(filter.apply(request, state));
+}
+
+TEST(DeadbandFilter, hueSaturation)
+{
+    DeadbandFilter filter;
+    const LightState state = createState(ColorMode::HS);
+    StateRequest request;
+    request.setHue(10050);
+    request.setSaturation(199);
+    EXPECT_FALSE(filter.apply(request, state));
+    EXPECT_EQ(2u, filter.getSuppressedFields());
+
+    request = StateRequest();
+    request.setHue(30000);
+    EXPECT_TRUE(filter.apply(request, state));
+    EXPECT_TRUE(request.has(StateRequest::HUE));
+
+    // Switching to a visibly different color in xy mode is sent
+    request = StateRequest();
+    request.setXY(0.4f, 0.4f);
+    EXPECT_TRUE(filter.apply(request, state));
+    EXPECT_TRUE(request.has(StateRequest::XY));
+}
+
+TEST(DeadbandFilter, colorModeSwitch)
+{
+    DeadbandFilter filter;
+    LightState state = createState(ColorMode::HS);
+    const XY shown = ColorConversion::hueSaturationToXY(state.hue, state.sat, ColorType::NONE);
+
+    // The same color in xy mode is not visible
+    StateRequest request;
+    request.setXY(shown.x + 0.001f, shown.y);
+    EXPECT_FALSE(filter.apply(request, state));
+    EXPECT_EQ(1u, filter.getSuppressedFields());
+
+    // Complete hue and saturation are compared with a light in xy mode
+    state = createState(ColorMode::XY);
+    state.xy = shown;
+    request = StateRequest();
+    request.setHue(10000);
+    request.setSaturation(200);
+    EXPECT_FALSE(filter.apply(request, state));
+    request = StateRequest();
+    request.setHue(10000);
+    request.setSaturation(100);
+    EXPECT_TRUE(filter.apply(request, state));
+    EXPECT_TRUE(request.has(StateRequest::HUE));
+    EXPECT_TRUE(request.has(StateRequest::SAT));
+
+    // Only the hue depends on the previous saturation, so it is always sent
+    request = StateRequest();
+    request.setHue(10000);
+    EXPECT_TRUE(filter.apply(request, state));
+    EXPECT_TRUE(request.has(StateRequest::HUE));
+
+    // Switching to color temperature is always sent
+    request = StateRequest();
+    request.setColorTemperature(ColorConversion::xyToColorTemperature(shown));
+    EXPECT_TRUE(filter.apply(request, state));
+    EXPECT_TRUE(request.has(StateRequest::CT));
+}
+
+TEST(DeadbandFilter, colorTemperature)
+{
+    DeadbandFilter filter(0.02f, 5);
+    const LightState state = createState(ColorMode::CT);
+    StateRequest request;
+    request.setColorTemperature(295);
+    EXPECT_FALSE(filter.apply(request, state));
+
+    request = StateRequest();
+    request.setColorTemperature(306);
+    EXPECT_TRUE(filter.apply(request, state));
+    EXPECT_TRUE(request.has(StateRequest::CT));
+
+    // Brightness is kept when the color temperature changes
+    request = StateRequest();
+    request.setColorTemperature(320);
+    request.setBrightness(201);
+    EXPECT_TRUE(filter.apply(request, state));
+    EXPECT_TRUE(request.has(StateRequest::BRI));
+
+    // Only the color temperature is removed
+    request = StateRequest();
+    request.setColorTemperature(302);
+    request.setBrightness(100);
+    EXPECT_TRUE(filter.apply(request, state));
+    EXPECT_FALSE(request.has(StateRequest::CT));
+    EXPECT_TRUE(request.has(StateRequest::BRI));
+}
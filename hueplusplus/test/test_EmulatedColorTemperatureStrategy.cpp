@@ -0,0 +1,84 @@
+/**
+    \file test_EmulatedColorTemperatureStrategy.cpp
+    Copyright Notice\n
+    Copyright (C) 2017  Jan Rogall		- developer\n
+    Copyright (C) 2017  Moritz Wirger	- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include <memory>
+#include <string>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "testhelper.h"
+
+#include "../include/ColorConversion.h"
+#include "../include/EmulatedColorTemperatureStrategy.h"
+#include "../include/json/json.hpp"
+#include "mocks/mock_HttpHandler.h"
+#include "mocks/mock_HueLight.h"
+
+TEST(EmulatedColorTemperatureStrategy, setColorTemperature)
+{
+    using namespace ::testing;
+    std::shared_ptr<MockHttpHandler> handler(std::make_shared<MockHttpHandler>());
+    MockHueLight test_light(handler);
+
+    const XY warm = ColorConversion::colorTemperatureToXY(370);
+    EXPECT_CALL(test_light, setColorXY(FloatEq(warm.x), FloatEq(warm.y), 6)).Times(1).WillOnce(Return(true));
+    EXPECT_EQ(true, EmulatedColorTemperatureStrategy().setColorTemperature(370, 6, test_light));
+
+    // Clamped like on color temperature lights
+    const XY warmest = ColorConversion::colorTemperatureToXY(500);
+    EXPECT_CALL(test_light, setColorXY(FloatEq(warmest.x), FloatEq(warmest.y), 4)).Times(1).WillOnce(Return(false));
+    EXPECT_EQ(false, EmulatedColorTemperatureStrategy().setColorTemperature(600, 4, test_light));
+    const XY coldest = ColorConversion::colorTemperatureToXY(153);
+    EXPECT_CALL(test_light, setColorXY(FloatEq(coldest.x), FloatEq(coldest.y), 4)).Times(1).WillOnce(Return(true));
+    EXPECT_EQ(true, EmulatedColorTemperatureStrategy().setColorTemperature(0, 4, test_light));
+}
+
+TEST(EmulatedColorTemperatureStrategy, getColorTemperature)
+{
+    using namespace ::testing;
+    std::shared_ptr<MockHttpHandler> handler(std::make_shared<MockHttpHandler>());
+    MockHueLight test_light(handler);
+    EXPECT_CALL(test_light, refreshState()).Times(AtLeast(1)).WillRepeatedly(Return());
+
+    test_light.getMutableState().colormode = ColorMode::XY;
+    test_light.getMutableState().xy = ColorConversion::colorTemperatureToXY(370);
+    EXPECT_EQ(370, EmulatedColorTemperatureStrategy().getColorTemperature(test_light));
+    const HueLight& const_light = test_light;
+    EXPECT_EQ(370, EmulatedColorTemperatureStrategy().getColorTemperature(const_light));
+
+    // Saturated colors are limited to the range of color temperature lights
+    test_light.getMutableState().xy = {0.7f, 0.3f};
+    EXPECT_EQ(500, EmulatedColorTemperatureStrategy().getColorTemperature(test_light));
+    test_light.getMutableState().xy = {0.15f, 0.1f};
+    EXPECT_EQ(153, EmulatedColorTemperatureStrategy().getColorTemperature(test_light));
+
+    // Orange hue is warm white
+    test_light.getMutableState().colormode = ColorMode::HS;
+    test_light.getMutableState().hue = 5000;
+    test_light.getMutableState().sat = 150;
+    EXPECT_GT(EmulatedColorTemperatureStrategy().getColorTemperature(test_light), 400);
+
+    test_light.getMutableState().colormode = ColorMode::CT;
+    test_light.getMutableState().ct = 250;
+    EXPECT_EQ(250, EmulatedColorTemperatureStrategy().getColorTemperature(test_light));
+}
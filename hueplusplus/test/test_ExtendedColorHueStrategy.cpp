@@ -28,6 +28,7 @@
 
 #include "testhelper.h"
 
+#include "../include/ColorConversion.h"
 #include "../include/ExtendedColorHueStrategy.h"
 #include "../include/json/json.hpp"
 #include "mocks/mock_HttpHandler.h"
@@ -44,37 +45,43 @@ TEST(ExtendedColorHueStrategy, alertHueSaturation)
     MockHueLight test_light(handler);
     EXPECT_CALL(test_light, refreshState()).Times(AtLeast(1)).WillRepeatedly(Return());
 
-    test_light.getState()["state"]["colormode"] = "invalid";
-    test_light.getState()["state"]["on"] = false;
+    test_light.getMutableState().colormode = ColorMode::NONE;
+    test_light.getMutableState().on = false;
     EXPECT_EQ(false, ExtendedColorHueStrategy().alertHueSaturation(30000, 128, test_light));
 
     EXPECT_CALL(test_light, setColorHueSaturation(_, _, 1))
         .Times(AtLeast(2))
         .WillOnce(Return(false))
         .WillRepeatedly(Return(true));
-    test_light.getState()["state"]["colormode"] = "hs";
-    test_light.getState()["state"]["on"] = true;
-    test_light.getState()["state"]["sat"] = 100;
-    test_light.getState()["state"]["hue"] = 200;
+    test_light.getMutableState().colormode = ColorMode::HS;
+    test_light.getMutableState().on = true;
+    test_light.getMutableState().sat = 100;
+    test_light.getMutableState().hue = 200;
+    // Colors in hue and saturation are restored as xy
+    EXPECT_CALL(test_light, getColorType()).WillRepeatedly(Return(ColorType::GAMUT_C));
+    const XY restored = ColorConversion::hueSaturationToXY(200, 100, ColorType::GAMUT_C);
     EXPECT_EQ(false, ExtendedColorHueStrategy().alertHueSaturation(200, 100, test_light));
 
     EXPECT_CALL(test_light, alert()).Times(AtLeast(2)).WillOnce(Return(false)).WillRepeatedly(Return(true));
     EXPECT_EQ(false, ExtendedColorHueStrategy().alertHueSaturation(200, 100, test_light));
 
+    EXPECT_CALL(test_light, setColorXY(FloatEq(restored.x), FloatEq(restored.y), 1))
+        .Times(AtLeast(1))
+        .WillRepeatedly(Return(true));
     EXPECT_EQ(true, ExtendedColorHueStrategy().alertHueSaturation(200, 100, test_light));
 
     EXPECT_CALL(test_light, OffNoRefresh(_)).Times(AtLeast(1)).WillRepeatedly(Return(true));
-    test_light.getState()["state"]["on"] = false;
+    test_light.getMutableState().on = false;
     EXPECT_EQ(true, ExtendedColorHueStrategy().alertHueSaturation(200, 100, test_light));
 
     EXPECT_CALL(test_light, setColorHueSaturation(_, _, 1))
         .Times(AtLeast(2))
         .WillOnce(Return(false))
         .WillRepeatedly(Return(true));
-    test_light.getState()["state"]["colormode"] = "xy";
-    test_light.getState()["state"]["on"] = true;
-    test_light.getState()["state"]["xy"][0] = 0.1;
-    test_light.getState()["state"]["xy"][1] = 0.1;
+    test_light.getMutableState().colormode = ColorMode::XY;
+    test_light.getMutableState().on = true;
+    test_light.getMutableState().xy.x = 0.1f;
+    test_light.getMutableState().xy.y = 0.1f;
     EXPECT_EQ(false, ExtendedColorHueStrategy().alertHueSaturation(200, 100, test_light));
 
     EXPECT_CALL(test_light, alert()).Times(AtLeast(2)).WillOnce(Return(false)).WillRepeatedly(Return(true));
@@ -84,16 +91,16 @@ TEST(ExtendedColorHueStrategy, alertHueSaturation)
     EXPECT_EQ(true, ExtendedColorHueStrategy().alertHueSaturation(200, 100, test_light));
 
     EXPECT_CALL(test_light, OffNoRefresh(_)).Times(AtLeast(1)).WillRepeatedly(Return(true));
-    test_light.getState()["state"]["on"] = false;
+    test_light.getMutableState().on = false;
     EXPECT_EQ(true, ExtendedColorHueStrategy().alertHueSaturation(200, 100, test_light));
 
     EXPECT_CALL(test_light, setColorHueSaturation(_, _, 1))
         .Times(AtLeast(2))
         .WillOnce(Return(false))
         .WillRepeatedly(Return(true));
-    test_light.getState()["state"]["colormode"] = "ct";
-    test_light.getState()["state"]["on"] = true;
-    test_light.getState()["state"]["ct"] = 200;
+    test_light.getMutableState().colormode = ColorMode::CT;
+    test_light.getMutableState().on = true;
+    test_light.getMutableState().ct = 200;
     EXPECT_EQ(false, ExtendedColorHueStrategy().alertHueSaturation(200, 100, test_light));
 
     EXPECT_CALL(test_light, alert()).Times(AtLeast(2)).WillOnce(Return(false)).WillRepeatedly(Return(true));
@@ -103,7 +110,7 @@ TEST(ExtendedColorHueStrategy, alertHueSaturation)
     EXPECT_EQ(true, ExtendedColorHueStrategy().alertHueSaturation(200, 100, test_light));
 
     EXPECT_CALL(test_light, OffNoRefresh(_)).Times(AtLeast(1)).WillRepeatedly(Return(true));
-    test_light.getState()["state"]["on"] = false;
+    test_light.getMutableState().on = false;
     EXPECT_EQ(true, ExtendedColorHueStrategy().alertHueSaturation(200, 100, test_light));
 }
 
@@ -118,32 +125,37 @@ TEST(ExtendedColorHueStrategy, alertXY)
     MockHueLight test_light(handler);
     EXPECT_CALL(test_light, refreshState()).Times(AtLeast(1)).WillRepeatedly(Return());
 
-    test_light.getState()["state"]["colormode"] = "invalid";
-    test_light.getState()["state"]["on"] = false;
+    test_light.getMutableState().colormode = ColorMode::NONE;
+    test_light.getMutableState().on = false;
     EXPECT_EQ(false, ExtendedColorHueStrategy().alertXY(0.1f, 0.1f, test_light));
 
     EXPECT_CALL(test_light, setColorXY(_, _, 1)).Times(AtLeast(2)).WillOnce(Return(false)).WillRepeatedly(Return(true));
-    test_light.getState()["state"]["colormode"] = "hs";
-    test_light.getState()["state"]["on"] = true;
-    test_light.getState()["state"]["xy"][0] = 0.1;
-    test_light.getState()["state"]["xy"][1] = 0.1;
-    test_light.getState()["state"]["sat"] = 100;
-    test_light.getState()["state"]["hue"] = 200;
+    test_light.getMutableState().colormode = ColorMode::HS;
+    test_light.getMutableState().on = true;
+    test_light.getMutableState().xy.x = 0.1f;
+    test_light.getMutableState().xy.y = 0.1f;
+    test_light.getMutableState().sat = 100;
+    test_light.getMutableState().hue = 200;
+    // Colors in hue and saturation are restored as xy
+    EXPECT_CALL(test_light, getColorType()).WillRepeatedly(Return(ColorType::GAMUT_C));
+    const XY restored = ColorConversion::hueSaturationToXY(200, 100, ColorType::GAMUT_C);
     EXPECT_EQ(false, ExtendedColorHueStrategy().alertXY(0.1f, 0.1f, test_light));
 
     EXPECT_CALL(test_light, alert()).Times(AtLeast(2)).WillOnce(Return(false)).WillRepeatedly(Return(true));
     EXPECT_EQ(false, ExtendedColorHueStrategy().alertXY(0.1f, 0.1f, test_light));
 
-    EXPECT_CALL(test_light, setColorHueSaturation(_, _, 1)).Times(AtLeast(2)).WillRepeatedly(Return(true));
+    EXPECT_CALL(test_light, setColorXY(FloatEq(restored.x), FloatEq(restored.y), 1))
+        .Times(AtLeast(1))
+        .WillRepeatedly(Return(true));
     EXPECT_EQ(true, ExtendedColorHueStrategy().alertXY(0.1f, 0.1f, test_light));
 
     EXPECT_CALL(test_light, OffNoRefresh(_)).Times(AtLeast(1)).WillRepeatedly(Return(true));
-    test_light.getState()["state"]["on"] = false;
+    test_light.getMutableState().on = false;
     EXPECT_EQ(true, ExtendedColorHueStrategy().alertXY(0.1f, 0.1f, test_light));
 
     EXPECT_CALL(test_light, setColorXY(_, _, 1)).Times(AtLeast(2)).WillOnce(Return(false)).WillRepeatedly(Return(true));
-    test_light.getState()["state"]["colormode"] = "xy";
-    test_light.getState()["state"]["on"] = true;
+    test_light.getMutableState().colormode = ColorMode::XY;
+    test_light.getMutableState().on = true;
     EXPECT_EQ(false, ExtendedColorHueStrategy().alertXY(0.1f, 0.1f, test_light));
 
     EXPECT_CALL(test_light, alert()).Times(AtLeast(2)).WillOnce(Return(false)).WillRepeatedly(Return(true));
@@ -152,13 +164,13 @@ TEST(ExtendedColorHueStrategy, alertXY)
     EXPECT_EQ(true, ExtendedColorHueStrategy().alertXY(0.1f, 0.1f, test_light));
 
     EXPECT_CALL(test_light, OffNoRefresh(_)).Times(AtLeast(1)).WillRepeatedly(Return(true));
-    test_light.getState()["state"]["on"] = false;
+    test_light.getMutableState().on = false;
     EXPECT_EQ(true, ExtendedColorHueStrategy().alertXY(0.1f, 0.1f, test_light));
 
     EXPECT_CALL(test_light, setColorXY(_, _, 1)).Times(AtLeast(2)).WillOnce(Return(false)).WillRepeatedly(Return(true));
-    test_light.getState()["state"]["colormode"] = "ct";
-    test_light.getState()["state"]["on"] = true;
-    test_light.getState()["state"]["ct"] = 200;
+    test_light.getMutableState().colormode = ColorMode::CT;
+    test_light.getMutableState().on = true;
+    test_light.getMutableState().ct = 200;
     EXPECT_EQ(false, ExtendedColorHueStrategy().alertXY(0.1f, 0.1f, test_light));
 
     EXPECT_CALL(test_light, alert()).Times(AtLeast(2)).WillOnce(Return(false)).WillRepeatedly(Return(true));
@@ -168,7 +180,7 @@ TEST(ExtendedColorHueStrategy, alertXY)
     EXPECT_EQ(true, ExtendedColorHueStrategy().alertXY(0.1f, 0.1f, test_light));
 
     EXPECT_CALL(test_light, OffNoRefresh(_)).Times(AtLeast(1)).WillRepeatedly(Return(true));
-    test_light.getState()["state"]["on"] = false;
+    test_light.getMutableState().on = false;
     EXPECT_EQ(true, ExtendedColorHueStrategy().alertXY(0.1f, 0.1f, test_light));
 }
 
@@ -183,38 +195,43 @@ TEST(ExtendedColorHueStrategy, alertRGB)
     MockHueLight test_light(handler);
     EXPECT_CALL(test_light, refreshState()).Times(AtLeast(1)).WillRepeatedly(Return());
 
-    test_light.getState()["state"]["colormode"] = "invalid";
-    test_light.getState()["state"]["on"] = false;
+    test_light.getMutableState().colormode = ColorMode::NONE;
+    test_light.getMutableState().on = false;
     EXPECT_EQ(false, ExtendedColorHueStrategy().alertRGB(128, 128, 128, test_light));
 
     EXPECT_CALL(test_light, setColorRGB(_, _, _, 1))
         .Times(AtLeast(2))
         .WillOnce(Return(false))
         .WillRepeatedly(Return(true));
-    test_light.getState()["state"]["colormode"] = "hs";
-    test_light.getState()["state"]["on"] = true;
-    test_light.getState()["state"]["sat"] = 100;
-    test_light.getState()["state"]["hue"] = 200;
+    test_light.getMutableState().colormode = ColorMode::HS;
+    test_light.getMutableState().on = true;
+    test_light.getMutableState().sat = 100;
+    test_light.getMutableState().hue = 200;
+    // Colors in hue and saturation are restored as xy
+    EXPECT_CALL(test_light, getColorType()).WillRepeatedly(Return(ColorType::GAMUT_C));
+    const XY restored = ColorConversion::hueSaturationToXY(200, 100, ColorType::GAMUT_C);
     EXPECT_EQ(false, ExtendedColorHueStrategy().alertRGB(128, 128, 128, test_light));
 
     EXPECT_CALL(test_light, alert()).Times(AtLeast(2)).WillOnce(Return(false)).WillRepeatedly(Return(true));
     EXPECT_EQ(false, ExtendedColorHueStrategy().alertRGB(128, 128, 128, test_light));
 
-    EXPECT_CALL(test_light, setColorHueSaturation(_, _, 1)).Times(AtLeast(2)).WillRepeatedly(Return(true));
+    EXPECT_CALL(test_light, setColorXY(FloatEq(restored.x), FloatEq(restored.y), 1))
+        .Times(AtLeast(1))
+        .WillRepeatedly(Return(true));
     EXPECT_EQ(true, ExtendedColorHueStrategy().alertRGB(128, 128, 128, test_light));
 
     EXPECT_CALL(test_light, OffNoRefresh(_)).Times(AtLeast(1)).WillRepeatedly(Return(true));
-    test_light.getState()["state"]["on"] = false;
+    test_light.getMutableState().on = false;
     EXPECT_EQ(true, ExtendedColorHueStrategy().alertRGB(128, 128, 128, test_light));
 
     EXPECT_CALL(test_light, setColorRGB(_, _, _, 1))
         .Times(AtLeast(2))
         .WillOnce(Return(false))
         .WillRepeatedly(Return(true));
-    test_light.getState()["state"]["colormode"] = "xy";
-    test_light.getState()["state"]["on"] = true;
-    test_light.getState()["state"]["xy"][0] = 0.1;
-    test_light.getState()["state"]["xy"][1] = 0.1;
+    test_light.getMutableState().colormode = ColorMode::XY;
+    test_light.getMutableState().on = true;
+    test_light.getMutableState().xy.x = 0.1f;
+    test_light.getMutableState().xy.y = 0.1f;
     EXPECT_EQ(false, ExtendedColorHueStrategy().alertRGB(128, 128, 128, test_light));
 
     EXPECT_CALL(test_light, alert()).Times(AtLeast(2)).WillOnce(Return(false)).WillRepeatedly(Return(true));
@@ -224,16 +241,16 @@ TEST(ExtendedColorHueStrategy, alertRGB)
     EXPECT_EQ(true, ExtendedColorHueStrategy().alertRGB(128, 128, 128, test_light));
 
     EXPECT_CALL(test_light, OffNoRefresh(_)).Times(AtLeast(1)).WillRepeatedly(Return(true));
-    test_light.getState()["state"]["on"] = false;
+    test_light.getMutableState().on = false;
     EXPECT_EQ(true, ExtendedColorHueStrategy().alertRGB(128, 128, 128, test_light));
 
     EXPECT_CALL(test_light, setColorRGB(_, _, _, 1))
         .Times(AtLeast(2))
         .WillOnce(Return(false))
         .WillRepeatedly(Return(true));
-    test_light.getState()["state"]["colormode"] = "ct";
-    test_light.getState()["state"]["on"] = true;
-    test_light.getState()["state"]["ct"] = 200;
+    test_light.getMutableState().colormode = ColorMode::CT;
+    test_light.getMutableState().on = true;
+    test_light.getMutableState().ct = 200;
     EXPECT_EQ(false, ExtendedColorHueStrategy().alertRGB(128, 128, 128, test_light));
 
     EXPECT_CALL(test_light, alert()).Times(AtLeast(2)).WillOnce(Return(false)).WillRepeatedly(Return(true));
@@ -243,6 +260,6 @@ TEST(ExtendedColorHueStrategy, alertRGB)
     EXPECT_EQ(true, ExtendedColorHueStrategy().alertRGB(128, 128, 128, test_light));
 
     EXPECT_CALL(test_light, OffNoRefresh(_)).Times(AtLeast(1)).WillRepeatedly(Return(true));
-    test_light.getState()["state"]["on"] = false;
+    test_light.getMutableState().on = false;
     EXPECT_EQ(true, ExtendedColorHueStrategy().alertRGB(128, 128, 128, test_light));
 }
@@ -54,22 +54,22 @@ TEST(ExtendedColorTemperatureStrategy, setColorTemperature)
     prep_ret[2] = nlohmann::json::object();
     prep_ret[2]["success"] = nlohmann::json::object();
     prep_ret[2]["success"]["/lights/1/state/ct"] = 155;
-    EXPECT_CALL(test_light, SendPutRequest(_, "/state", _)).Times(1).WillOnce(Return(prep_ret));
+    EXPECT_CALL(test_light, SendStateRequest(_, _)).Times(1).WillOnce(Invoke(ValidateAgainst(prep_ret)));
 
-    test_light.getState()["state"]["colormode"] = "ct";
-    test_light.getState()["state"]["on"] = true;
-    test_light.getState()["state"]["ct"] = 200;
+    test_light.getMutableState().colormode = ColorMode::CT;
+    test_light.getMutableState().on = true;
+    test_light.getMutableState().ct = 200;
     EXPECT_EQ(true, ExtendedColorTemperatureStrategy().setColorTemperature(200, 4, test_light));
 
-    test_light.getState()["state"]["on"] = false;
+    test_light.getMutableState().on = false;
     EXPECT_EQ(true, ExtendedColorTemperatureStrategy().setColorTemperature(155, 6, test_light));
 
     prep_ret[2]["success"]["/lights/1/state/ct"] = 153;
-    EXPECT_CALL(test_light, SendPutRequest(_, "/state", _)).Times(1).WillOnce(Return(prep_ret));
+    EXPECT_CALL(test_light, SendStateRequest(_, _)).Times(1).WillOnce(Invoke(ValidateAgainst(prep_ret)));
     EXPECT_EQ(true, ExtendedColorTemperatureStrategy().setColorTemperature(0, 6, test_light));
 
     prep_ret[2]["success"]["/lights/1/state/ct"] = 500;
-    EXPECT_CALL(test_light, SendPutRequest(_, "/state", _)).Times(1).WillOnce(Return(prep_ret));
+    EXPECT_CALL(test_light, SendStateRequest(_, _)).Times(1).WillOnce(Invoke(ValidateAgainst(prep_ret)));
     EXPECT_EQ(true, ExtendedColorTemperatureStrategy().setColorTemperature(600, 6, test_light));
 }
 
@@ -84,19 +84,19 @@ TEST(ExtendedColorTemperatureStrategy, alertTemperature)
     MockHueLight test_light(handler);
     EXPECT_CALL(test_light, refreshState()).Times(AtLeast(1)).WillRepeatedly(Return());
 
-    test_light.getState()["state"]["colormode"] = "invalid";
-    test_light.getState()["state"]["on"] = false;
+    test_light.getMutableState().colormode = ColorMode::NONE;
+    test_light.getMutableState().on = false;
     EXPECT_EQ(false, ExtendedColorTemperatureStrategy().alertTemperature(400, test_light));
 
     EXPECT_CALL(test_light, setColorTemperature(_, _))
         .Times(AtLeast(2))
         .WillOnce(Return(false))
         .WillRepeatedly(Return(true));
-    test_light.getState()["state"]["colormode"] = "hs";
-    test_light.getState()["state"]["on"] = true;
-    test_light.getState()["state"]["ct"] = 200;
-    test_light.getState()["state"]["sat"] = 100;
-    test_light.getState()["state"]["hue"] = 200;
+    test_light.getMutableState().colormode = ColorMode::HS;
+    test_light.getMutableState().on = true;
+    test_light.getMutableState().ct = 200;
+    test_light.getMutableState().sat = 100;
+    test_light.getMutableState().hue = 200;
     EXPECT_EQ(false, ExtendedColorTemperatureStrategy().alertTemperature(400, test_light));
 
     EXPECT_CALL(test_light, alert()).Times(AtLeast(2)).WillOnce(Return(false)).WillRepeatedly(Return(true));
@@ -106,17 +106,17 @@ TEST(ExtendedColorTemperatureStrategy, alertTemperature)
     EXPECT_EQ(true, ExtendedColorTemperatureStrategy().alertTemperature(400, test_light));
 
     EXPECT_CALL(test_light, OffNoRefresh(_)).Times(AtLeast(1)).WillRepeatedly(Return(true));
-    test_light.getState()["state"]["on"] = false;
+    test_light.getMutableState().on = false;
     EXPECT_EQ(true, ExtendedColorTemperatureStrategy().alertTemperature(400, test_light));
 
     EXPECT_CALL(test_light, setColorTemperature(_, _))
         .Times(AtLeast(2))
         .WillOnce(Return(false))
         .WillRepeatedly(Return(true));
-    test_light.getState()["state"]["colormode"] = "xy";
-    test_light.getState()["state"]["on"] = true;
-    test_light.getState()["state"]["xy"][0] = 0.1;
-    test_light.getState()["state"]["xy"][1] = 0.1;
+    test_light.getMutableState().colormode = ColorMode::XY;
+    test_light.getMutableState().on = true;
+    test_light.getMutableState().xy.x = 0.1f;
+    test_light.getMutableState().xy.y = 0.1f;
     EXPECT_EQ(false, ExtendedColorTemperatureStrategy().alertTemperature(400, test_light));
 
     EXPECT_CALL(test_light, alert()).Times(AtLeast(2)).WillOnce(Return(false)).WillRepeatedly(Return(true));
@@ -125,17 +125,17 @@ TEST(ExtendedColorTemperatureStrategy, alertTemperature)
     EXPECT_CALL(test_light, setColorXY(_, _, 1)).Times(AtLeast(2)).WillRepeatedly(Return(true));
     EXPECT_EQ(true, ExtendedColorTemperatureStrategy().alertTemperature(400, test_light));
 
-    test_light.getState()["state"]["on"] = false;
+    test_light.getMutableState().on = false;
     EXPECT_EQ(true, ExtendedColorTemperatureStrategy().alertTemperature(400, test_light));
 
     EXPECT_CALL(test_light, setColorTemperature(_, _))
         .Times(AtLeast(2))
         .WillOnce(Return(false))
         .WillRepeatedly(Return(true));
-    test_light.getState()["state"]["colormode"] = "ct";
-    test_light.getState()["state"]["on"] = true;
-    test_light.getState()["state"]["on"] = true;
-    test_light.getState()["state"]["ct"] = 200;
+    test_light.getMutableState().colormode = ColorMode::CT;
+    test_light.getMutableState().on = true;
+    test_light.getMutableState().on = true;
+    test_light.getMutableState().ct = 200;
     EXPECT_EQ(false, ExtendedColorTemperatureStrategy().alertTemperature(400, test_light));
 
     EXPECT_CALL(test_light, alert()).Times(AtLeast(2)).WillOnce(Return(false)).WillRepeatedly(Return(true));
@@ -143,6 +143,6 @@ TEST(ExtendedColorTemperatureStrategy, alertTemperature)
 
     EXPECT_EQ(true, ExtendedColorTemperatureStrategy().alertTemperature(400, test_light));
 
-    test_light.getState()["state"]["on"] = false;
+    test_light.getMutableState().on = false;
     EXPECT_EQ(true, ExtendedColorTemperatureStrategy().alertTemperature(400, test_light));
 }
@@ -24,12 +24,15 @@
 #include <iostream>
 #include <memory>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
 #include "testhelper.h"
 
+#include "../include/DeadbandFilter.h"
 #include "../include/Hue.h"
 #include "../include/json/json.hpp"
 #include "mocks/mock_HttpHandler.h"
@@ -391,10 +394,10 @@ TEST(Hue, removeLight)
 
     Hue test_bridge(getBridgeIp(), getBridgePort(), getBridgeUsername(), handler);
 
+    // Light is created from the bridge state
     EXPECT_CALL(*handler,
         GETJson("/api/" + getBridgeUsername() + "/lights/1", nlohmann::json::object(), getBridgeIp(), getBridgePort()))
-        .Times(1)
-        .WillRepeatedly(Return(hue_bridge_state["lights"]["1"]));
+        .Times(0);
 
     nlohmann::json return_answer;
     return_answer = nlohmann::json::array();
@@ -430,18 +433,22 @@ TEST(Hue, getAllLights)
 
     EXPECT_CALL(
         *handler, GETJson("/api/" + getBridgeUsername(), nlohmann::json::object(), getBridgeIp(), getBridgePort()))
-        .Times(2)
+        .Times(1)
         .WillRepeatedly(Return(hue_bridge_state));
 
+    // Only refreshed by the non-const getName
     EXPECT_CALL(*handler,
         GETJson("/api/" + getBridgeUsername() + "/lights/1", nlohmann::json::object(), getBridgeIp(), getBridgePort()))
-        .Times(2)
+        .Times(1)
         .WillRepeatedly(Return(hue_bridge_state["lights"]["1"]));
 
     Hue test_bridge(getBridgeIp(), getBridgePort(), getBridgeUsername(), handler);
 
     std::vector<std::reference_wrapper<HueLight>> test_lights = test_bridge.getAllLights();
     ASSERT_EQ(1, test_lights.size());
+    const HueLight& const_test_light = test_bridge.getLight(1);
+    EXPECT_EQ(&test_lights[0].get(), &const_test_light);
+    EXPECT_EQ(const_test_light.getName(), "Hue ambiance lamp 1");
     EXPECT_EQ(test_lights[0].get().getName(), "Hue ambiance lamp 1");
     EXPECT_EQ(test_lights[0].get().getColorType(), ColorType::TEMPERATURE);
 }
@@ -464,8 +471,7 @@ TEST(Hue, lightExists)
         .WillRepeatedly(Return(hue_bridge_state));
     EXPECT_CALL(*handler,
         GETJson("/api/" + getBridgeUsername() + "/lights/1", nlohmann::json::object(), getBridgeIp(), getBridgePort()))
-        .Times(AtLeast(1))
-        .WillRepeatedly(Return(hue_bridge_state["lights"]["1"]));
+        .Times(0);
 
     Hue test_bridge(getBridgeIp(), getBridgePort(), getBridgeUsername(), handler);
 
@@ -501,8 +507,7 @@ TEST(Hue, getPictureOfLight)
         .WillRepeatedly(Return(hue_bridge_state));
     EXPECT_CALL(*handler,
         GETJson("/api/" + getBridgeUsername() + "/lights/1", nlohmann::json::object(), getBridgeIp(), getBridgePort()))
-        .Times(AtLeast(1))
-        .WillRepeatedly(Return(hue_bridge_state["lights"]["1"]));
+        .Times(0);
 
     Hue test_bridge(getBridgeIp(), getBridgePort(), getBridgeUsername(), handler);
 
@@ -521,3 +526,121 @@ TEST(Hue, refreshState)
     std::vector<std::reference_wrapper<HueLight>> test_lights = test_bridge.getAllLights();
     EXPECT_EQ(test_lights.size(), 0);
 }
+
+TEST(Hue, concurrentAccess)
+{
+    using namespace ::testing;
+    std::shared_ptr<MockHttpHandler> handler = std::make_shared<MockHttpHandler>();
+    nlohmann::json light_state{{"state",
+                                   {{"on", true}, {"bri", 254}, {"hue", 100}, {"sat", 200}, {"xy", {0.3, 0.3}},
+                                       {"ct", 300}, {"colormode", "ct"}, {"reachable", true}}},
+        {"type", "Extended color light"}, {"name", "Hue lamp"}, {"modelid", "LCT001"}, {"swversion", "1.0"}};
+    nlohmann::json hue_bridge_state{{"lights", {{"1", light_state}, {"2", light_state}, {"3", light_state}}}};
+    std::atomic<int> refreshes{0};
+    EXPECT_CALL(
+        *handler, GETJson("/api/" + getBridgeUsername(), nlohmann::json::object(), getBridgeIp(), getBridgePort()))
+        .WillRepeatedly(InvokeWithoutArgs([&]() {
+            // Changes on every refresh, so subscribers are notified
+            nlohmann::json result = hue_bridge_state;
+            const bool even = (++refreshes % 2) == 0;
+            result["groups"]["1"]["action"]["on"] = even;
+            // Light 1 alternates between a color and a dimmable model, so reconcile replaces its strategies
+            result["lights"]["1"]["modelid"] = even ? "LCT001" : "LWB004";
+            return result;
+        }));
+    for (int id = 1; id <= 3; ++id)
+    {
+        EXPECT_CALL(*handler,
+            GETJson("/api/" + getBridgeUsername() + "/lights/" + std::to_string(id), nlohmann::json::object(),
+                getBridgeIp(), getBridgePort()))
+            .WillRepeatedly(Return(light_state));
+    }
+    EXPECT_CALL(*handler, PUTJson(_, _, getBridgeIp(), getBridgePort()))
+        .WillRepeatedly(Return(nlohmann::json::array()));
+
+    Hue test_bridge(getBridgeIp(), getBridgePort(), getBridgeUsername(), handler);
+    const Hue& const_bridge = test_bridge;
+    // Subscribers may use the bridge while being notified
+    std::atomic<int> notifications{0};
+    test_bridge.getStateDiff().subscribe([&](const StateChange& change) {
+        const_bridge.lightExists(change.id);
+        ++notifications;
+    });
+
+    std::atomic<bool> done{false};
+    std::atomic<int> reads{0};
+    std::vector<std::thread> threads;
+    std::vector<std::thread> getters;
+    for (int i = 0; i < 2; ++i)
+    {
+        // Setters
+        threads.emplace_back([&, i]() {
+            for (int j = 0; j < 2; ++j)
+            {
+                HueLight& light = test_bridge.getLight(1 + (i + j) % 3);
+                light.setBrightness(100 + j);
+                light.setColorTemperature(200 + j);
+            }
+        });
+        // Getters
+        getters.emplace_back([&]() {
+            std::vector<std::reference_wrapper<HueLight>> lights = test_bridge.getAllLights();
+            while (!done)
+            {
+                for (const HueLight& light : lights)
+                {
+                    EXPECT_EQ("Hue lamp", light.getName());
+                    EXPECT_EQ(254u, light.getBrightness());
+                    EXPECT_TRUE(light.getState().on);
+                    EXPECT_TRUE(const_bridge.lightExists(light.getId()));
+                    EXPECT_EQ("e27_waca", const_bridge.getPictureOfLight(light.getId()));
+                    ++reads;
+                }
+            }
+        });
+    }
+    // Listing
+    threads.emplace_back([&]() {
+        for (int j = 0; j < 2; ++j)
+        {
+            EXPECT_EQ(3, test_bridge.getAllLights().size());
+        }
+    });
+    // Reconcile in the background, like after restoring a snapshot
+    threads.emplace_back([&]() {
+        for (int j = 0; j < 4; ++j)
+        {
+            test_bridge.reconcile();
+        }
+    });
+    // Copies are made while the bridge and its lights are used
+    threads.emplace_back([&]() {
+        for (int j = 0; j < 4; ++j)
+        {
+            const HueLight light = test_bridge.getLight(1 + j % 3);
+            EXPECT_EQ("Hue lamp", light.getName());
+            const Hue copy = test_bridge;
+            EXPECT_TRUE(copy.lightExists(light.getId()));
+        }
+    });
+    // Filters are replaced while the setters send requests
+    threads.emplace_back([&]() {
+        for (int j = 0; j < 4; ++j)
+        {
+            test_bridge.getLight(1 + j % 3).setDeadbandFilter(j % 2 ? nullptr : std::make_shared<DeadbandFilter>());
+        }
+    });
+    // Join the other threads first, then stop the getters
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    done = true;
+    for (std::thread& thread : getters)
+    {
+        thread.join();
+    }
+    EXPECT_LT(0, reads);
+    EXPECT_LT(0, notifications);
+    EXPECT_EQ(3, test_bridge.getAllLights().size());
+}
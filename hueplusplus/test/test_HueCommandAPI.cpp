@@ -26,6 +26,7 @@
 #include "testhelper.h"
 
 #include "../include/Hue.h"
+#include "../include/HueExceptionMacro.h"
 #include "../include/json/json.hpp"
 #include "mocks/mock_HttpHandler.h"
 
@@ -99,6 +100,59 @@ TEST(HueCommandAPI, PUTRequest)
     }
 }
 
+TEST(HueCommandAPI, PUTRequestState)
+{
+    using namespace ::testing;
+    std::shared_ptr<MockHttpHandler> httpHandler = std::make_shared<MockHttpHandler>();
+
+    HueCommandAPI api(getBridgeIp(), getBridgePort(), getBridgeUsername(), httpHandler);
+    StateRequest request;
+    request.setOn(true);
+    request.setBrightness(200);
+    const nlohmann::json expected{{"on", true}, {"bri", 200}};
+    nlohmann::json result = nlohmann::json::array();
+    result[0]["success"]["/lights/1/state/on"] = true;
+    result[1]["success"]["/lights/1/state/bri"] = 200;
+
+    // Default implementation of PUTRaw calls PUTJson
+    {
+        const std::string path = "/lights/1/state";
+        EXPECT_CALL(*httpHandler, PUTJson("/api/" + getBridgeUsername() + path, expected, getBridgeIp(), 80))
+            .WillOnce(Return(result));
+        utils::ReplyValidation validation = api.PUTRequest(path, request, CURRENT_FILE_INFO);
+        EXPECT_TRUE(validation.isSuccess());
+        Mock::VerifyAndClearExpectations(httpHandler.get());
+    }
+    // mismatched reply, path without slash
+    {
+        const std::string path = "lights/1/state";
+        result[1]["success"]["/lights/1/state/bri"] = 100;
+        EXPECT_CALL(*httpHandler, PUTJson("/api/" + getBridgeUsername() + "/" + path, expected, getBridgeIp(), 80))
+            .WillOnce(Return(result));
+        utils::ReplyValidation validation = api.PUTRequest(path, request, CURRENT_FILE_INFO);
+        EXPECT_FALSE(validation.unexpected);
+        EXPECT_EQ(StateRequest::BRI, validation.mismatched);
+        Mock::VerifyAndClearExpectations(httpHandler.get());
+    }
+    // reply for other resource
+    {
+        const std::string path = "/groups/1/action";
+        EXPECT_CALL(*httpHandler, PUTJson("/api/" + getBridgeUsername() + path, expected, getBridgeIp(), 80))
+            .WillOnce(Return(result));
+        EXPECT_TRUE(api.PUTRequest(path, request, CURRENT_FILE_INFO).unexpected);
+        Mock::VerifyAndClearExpectations(httpHandler.get());
+    }
+    // api returns error
+    {
+        const std::string path = "/lights/1/state";
+        const nlohmann::json errorResponse{{"error", {{"type", 10}, {"address", path}, {"description", "Stuff"}}}};
+        EXPECT_CALL(*httpHandler, PUTJson("/api/" + getBridgeUsername() + path, expected, getBridgeIp(), 80))
+            .WillOnce(Return(errorResponse));
+        EXPECT_THROW(api.PUTRequest(path, request, CURRENT_FILE_INFO), HueAPIResponseException);
+        Mock::VerifyAndClearExpectations(httpHandler.get());
+    }
+}
+
 TEST(HueCommandAPI, GETRequest)
 {
     using namespace ::testing;
@@ -169,6 +223,47 @@ TEST(HueCommandAPI, GETRequest)
     }
 }
 
+TEST(HueCommandAPI, GETRaw)
+{
+    using namespace ::testing;
+    std::shared_ptr<MockHttpHandler> httpHandler = std::make_shared<MockHttpHandler>();
+
+    HueCommandAPI api(getBridgeIp(), getBridgePort(), getBridgeUsername(), httpHandler);
+    const nlohmann::json result{{"name", "Lamp"}};
+    const std::string path = "/lights/1";
+
+    // Default implementation of GETRaw calls GETJson with an empty request
+    {
+        EXPECT_CALL(*httpHandler,
+            GETJson("/api/" + getBridgeUsername() + path, nlohmann::json::object(), getBridgeIp(), 80))
+            .WillOnce(Return(result));
+        EXPECT_EQ(result.dump(), api.GETRaw(path));
+        Mock::VerifyAndClearExpectations(httpHandler.get());
+    }
+    // Error responses are returned unchanged
+    {
+        const nlohmann::json errorResponse{{"error", {{"type", 3}, {"address", path}, {"description", "Stuff"}}}};
+        EXPECT_CALL(*httpHandler, GETJson("/api/" + getBridgeUsername() + path, _, getBridgeIp(), 80))
+            .WillOnce(Return(errorResponse));
+        EXPECT_EQ(errorResponse.dump(), api.GETRaw(path));
+        Mock::VerifyAndClearExpectations(httpHandler.get());
+    }
+    // socket error
+    {
+        EXPECT_CALL(*httpHandler, GETJson("/api/" + getBridgeUsername() + path, _, getBridgeIp(), 80))
+            .WillOnce(Throw(std::system_error(std::make_error_code(std::errc::host_unreachable))));
+        EXPECT_THROW(api.GETRaw(path), std::system_error);
+        Mock::VerifyAndClearExpectations(httpHandler.get());
+
+        EXPECT_CALL(*httpHandler, GETJson("/api/" + getBridgeUsername() + path, _, getBridgeIp(), 80))
+            .WillOnce(Throw(std::system_error(std::make_error_code(std::errc::host_unreachable))));
+        Result<std::string> response = api.tryGETRaw(path, CURRENT_FILE_INFO);
+        ASSERT_FALSE(response.ok());
+        EXPECT_EQ(HueError::Type::TRANSPORT, response.getError().getType());
+        Mock::VerifyAndClearExpectations(httpHandler.get());
+    }
+}
+
 TEST(HueCommandAPI, DELETERequest)
 {
     using namespace ::testing;
@@ -238,3 +333,75 @@ TEST(HueCommandAPI, DELETERequest)
         Mock::VerifyAndClearExpectations(httpHandler.get());
     }
 }
+
+TEST(HueCommandAPI, tryRequests)
+{
+    using namespace ::testing;
+    std::shared_ptr<MockHttpHandler> httpHandler = std::make_shared<MockHttpHandler>();
+
+    HueCommandAPI api(getBridgeIp(), getBridgePort(), getBridgeUsername(), httpHandler);
+    StateRequest request;
+    request.setOn(true);
+    const nlohmann::json expected{{"on", true}};
+    const std::string path = "/lights/1/state";
+    // success
+    {
+        nlohmann::json result = nlohmann::json::array();
+        result[0]["success"]["/lights/1/state/on"] = true;
+        EXPECT_CALL(*httpHandler, PUTJson("/api/" + getBridgeUsername() + path, expected, getBridgeIp(), 80))
+            .WillOnce(Return(result));
+        Result<utils::ReplyValidation> validation = api.tryPUTRequest(path, request, CURRENT_FILE_INFO);
+        ASSERT_TRUE(validation.ok());
+        EXPECT_TRUE(validation.get().isSuccess());
+        Mock::VerifyAndClearExpectations(httpHandler.get());
+    }
+    // light is unreachable, reported without throwing
+    {
+        const nlohmann::json errorResponse = {
+            {{"error", {{"type", 201}, {"address", path + "/on"}, {"description", "device is off"}}}}};
+        EXPECT_CALL(*httpHandler, PUTJson("/api/" + getBridgeUsername() + path, expected, getBridgeIp(), 80))
+            .WillOnce(Return(errorResponse));
+        Result<utils::ReplyValidation> validation = api.tryPUTRequest(path, request, CURRENT_FILE_INFO);
+        ASSERT_FALSE(validation.ok());
+        const HueError& error = validation.getError();
+        EXPECT_EQ(HueError::Type::API_RESPONSE, error.getType());
+        EXPECT_EQ(201, error.getCode());
+        EXPECT_EQ(path + "/on", error.getAddress());
+        EXPECT_EQ("device is off", error.getDescription());
+        EXPECT_THROW(validation.get(), HueAPIResponseException);
+        Mock::VerifyAndClearExpectations(httpHandler.get());
+    }
+    // socket error
+    {
+        EXPECT_CALL(*httpHandler, GETJson("/api/" + getBridgeUsername() + "/lights/1", _, getBridgeIp(), 80))
+            .WillOnce(Throw(std::system_error(std::make_error_code(std::errc::host_unreachable))));
+        Result<nlohmann::json> result = api.tryGETRequest("/lights/1", nlohmann::json::object(), CURRENT_FILE_INFO);
+        ASSERT_FALSE(result.ok());
+        EXPECT_EQ(HueError::Type::TRANSPORT, result.getError().getType());
+        EXPECT_EQ(std::make_error_code(std::errc::host_unreachable), result.getError().getSystemError());
+        EXPECT_THROW(result.get(), std::system_error);
+        Mock::VerifyAndClearExpectations(httpHandler.get());
+    }
+    // missing body
+    {
+        EXPECT_CALL(*httpHandler, DELETEJson("/api/" + getBridgeUsername() + "/lights/1", _, getBridgeIp(), 80))
+            .WillOnce(Throw(HueException(CURRENT_FILE_INFO, "Failed to find body in response")));
+        Result<nlohmann::json> result
+            = api.tryDELETERequest("/lights/1", nlohmann::json::object(), CURRENT_FILE_INFO);
+        ASSERT_FALSE(result.ok());
+        EXPECT_EQ(HueError::Type::INVALID_RESPONSE, result.getError().getType());
+        EXPECT_THROW(result.get(), HueException);
+        Mock::VerifyAndClearExpectations(httpHandler.get());
+    }
+    // json request
+    {
+        const nlohmann::json result = {{{"success", {{"/lights/1/name", "Lamp"}}}}};
+        EXPECT_CALL(*httpHandler, PUTJson("/api/" + getBridgeUsername() + "/lights/1", _, getBridgeIp(), 80))
+            .WillOnce(Return(result));
+        Result<nlohmann::json> response
+            = api.tryPUTRequest("/lights/1", nlohmann::json{{"name", "Lamp"}}, CURRENT_FILE_INFO);
+        ASSERT_TRUE(response.ok());
+        EXPECT_EQ(result, response.get());
+        Mock::VerifyAndClearExpectations(httpHandler.get());
+    }
+}
@@ -25,6 +25,7 @@
 
 #include "testhelper.h"
 
+#include "../include/ColorConversion.h"
 #include "../include/Hue.h"
 #include "../include/HueLight.h"
 #include "../include/json/json.hpp"
@@ -110,15 +111,15 @@ protected:
             .WillRepeatedly(Return(hue_bridge_state));
         EXPECT_CALL(
             *handler, GETJson("/api/" + getBridgeUsername() + "/lights/1", nlohmann::json::object(), getBridgeIp(), 80))
-            .Times(AtLeast(1))
+            .Times(AnyNumber())
             .WillRepeatedly(Return(hue_bridge_state["lights"]["1"]));
         EXPECT_CALL(
             *handler, GETJson("/api/" + getBridgeUsername() + "/lights/2", nlohmann::json::object(), getBridgeIp(), 80))
-            .Times(AtLeast(1))
+            .Times(AnyNumber())
             .WillRepeatedly(Return(hue_bridge_state["lights"]["2"]));
         EXPECT_CALL(
             *handler, GETJson("/api/" + getBridgeUsername() + "/lights/3", nlohmann::json::object(), getBridgeIp(), 80))
-            .Times(AtLeast(1))
+            .Times(AnyNumber())
             .WillRepeatedly(Return(hue_bridge_state["lights"]["3"]));
     }
     ~HueLightTest() {};
@@ -356,6 +357,16 @@ TEST_F(HueLightTest, getSwVersion)
     EXPECT_EQ("5.50.1.19085", test_light_3.getSwVersion());
 }
 
+TEST_F(HueLightTest, getField)
+{
+    const HueLight ctest_light_1 = test_bridge.getLight(1);
+    EXPECT_EQ("Dimmable light", ctest_light_1.getField(LightField::TYPE));
+    EXPECT_EQ(true, ctest_light_1.getField(LightField::STATE_ON));
+    EXPECT_TRUE(ctest_light_1.getField(LightField::STATE_XY).is_null());
+    // Missing fields are not inserted into the raw state
+    EXPECT_EQ(0, ctest_light_1.getRawState()["state"].count("xy"));
+}
+
 TEST_F(HueLightTest, setName)
 {
     using namespace ::testing;
@@ -422,6 +433,7 @@ TEST_F(HueLightTest, KelvinToMired)
     EXPECT_EQ(250, test_light_1.KelvinToMired(4000));
     EXPECT_EQ(200, test_light_2.KelvinToMired(5000));
     EXPECT_EQ(166, test_light_3.KelvinToMired(6000));
+    EXPECT_EQ(0, test_light_3.KelvinToMired(0));
 }
 
 TEST_F(HueLightTest, MiredToKelvin)
@@ -440,6 +452,7 @@ TEST_F(HueLightTest, MiredToKelvin)
     EXPECT_EQ(5000, test_light_2.MiredToKelvin(200));
     EXPECT_EQ(6024, test_light_3.MiredToKelvin(166)); // 6000 kelvin should be 166 mired, but keep in
                                                       // mind flops are not exact
+    EXPECT_EQ(0, test_light_3.MiredToKelvin(0));
 }
 
 TEST_F(HueLightTest, hasBrightnessControl)
@@ -469,10 +482,11 @@ TEST_F(HueLightTest, hasTemperatureControl)
     HueLight test_light_3 = test_bridge.getLight(3);
 
     EXPECT_EQ(false, ctest_light_1.hasTemperatureControl());
-    EXPECT_EQ(false, ctest_light_2.hasTemperatureControl());
+    // Color temperature is emulated on gamut A
+    EXPECT_EQ(true, ctest_light_2.hasTemperatureControl());
     EXPECT_EQ(true, ctest_light_3.hasTemperatureControl());
     EXPECT_EQ(false, test_light_1.hasTemperatureControl());
-    EXPECT_EQ(false, test_light_2.hasTemperatureControl());
+    EXPECT_EQ(true, test_light_2.hasTemperatureControl());
     EXPECT_EQ(true, test_light_3.hasTemperatureControl());
 }
 
@@ -557,13 +571,20 @@ TEST_F(HueLightTest, setColorTemperature)
     EXPECT_CALL(*handler, PUTJson("/api/" + getBridgeUsername() + "/lights/3/state", _, getBridgeIp(), 80))
         .Times(1)
         .WillOnce(Return(prep_ret));
+    // Gamut A light is set to the xy color of the temperature
+    const XY xy = ColorConversion::colorTemperatureToXY(400);
+    nlohmann::json emulated_ret = {{{"success", {{"/lights/2/state/transitiontime", 2}}}},
+        {{"success", {{"/lights/2/state/on", true}}}}, {{"success", {{"/lights/2/state/xy", {xy.x, xy.y}}}}}};
+    EXPECT_CALL(*handler, PUTJson("/api/" + getBridgeUsername() + "/lights/2/state", _, getBridgeIp(), 80))
+        .Times(1)
+        .WillOnce(Return(emulated_ret));
 
     HueLight test_light_1 = test_bridge.getLight(1);
     HueLight test_light_2 = test_bridge.getLight(2);
     HueLight test_light_3 = test_bridge.getLight(3);
 
     EXPECT_EQ(false, test_light_1.setColorTemperature(153));
-    EXPECT_EQ(false, test_light_2.setColorTemperature(400, 2));
+    EXPECT_EQ(true, test_light_2.setColorTemperature(400, 2));
     EXPECT_EQ(true, test_light_3.setColorTemperature(100, 0));
 }
 
@@ -577,10 +598,10 @@ TEST_F(HueLightTest, getColorTemperature)
     HueLight test_light_3 = test_bridge.getLight(3);
 
     EXPECT_EQ(0, ctest_light_1.getColorTemperature());
-    EXPECT_EQ(0, ctest_light_2.getColorTemperature());
+    EXPECT_EQ(366, ctest_light_2.getColorTemperature());
     EXPECT_EQ(366, ctest_light_3.getColorTemperature());
     EXPECT_EQ(0, test_light_1.getColorTemperature());
-    EXPECT_EQ(0, test_light_2.getColorTemperature());
+    EXPECT_EQ(366, test_light_2.getColorTemperature());
     EXPECT_EQ(366, test_light_3.getColorTemperature());
 }
 
@@ -708,8 +729,9 @@ TEST_F(HueLightTest, setColorXY)
     prep_ret = nlohmann::json::array();
     prep_ret[2] = nlohmann::json::object();
     prep_ret[2]["success"] = nlohmann::json::object();
-    prep_ret[2]["success"]["/lights/3/state/xy"][0] = 0.4232;
-    prep_ret[2]["success"]["/lights/3/state/xy"][1] = 0.1231;
+    // Requested color is outside of gamut C, the closest color is sent instead
+    prep_ret[2]["success"]["/lights/3/state/xy"][0] = 0.4015;
+    prep_ret[2]["success"]["/lights/3/state/xy"][1] = 0.1678;
     prep_ret[1] = nlohmann::json::object();
     prep_ret[1]["success"] = nlohmann::json::object();
     prep_ret[1]["success"]["/lights/3/state/on"] = true;
@@ -746,6 +768,54 @@ TEST_F(HueLightTest, getColorXY)
     EXPECT_EQ(std::make_pair(static_cast<float>(0.102), static_cast<float>(0.102)), test_light_3.getColorXY());
 }
 
+TEST_F(HueLightTest, getColorRGB)
+{
+    const HueLight ctest_light_1 = test_bridge.getLight(1);
+    const HueLight ctest_light_3 = test_bridge.getLight(3);
+    HueLight test_light_1 = test_bridge.getLight(1);
+    HueLight test_light_3 = test_bridge.getLight(3);
+
+    // Light is in color temperature mode, 366 mired
+    const RGB expected = ColorConversion::colorTemperatureToRGB(366, 254);
+    RGB rgb = ctest_light_1.getColorRGB();
+    EXPECT_EQ(expected.r, rgb.r);
+    EXPECT_EQ(expected.g, rgb.g);
+    EXPECT_EQ(expected.b, rgb.b);
+    rgb = test_light_1.getColorRGB();
+    EXPECT_EQ(expected.r, rgb.r);
+    EXPECT_EQ(expected.g, rgb.g);
+    EXPECT_EQ(expected.b, rgb.b);
+    // Light is off
+    rgb = ctest_light_3.getColorRGB();
+    EXPECT_EQ(0, rgb.r);
+    EXPECT_EQ(0, rgb.g);
+    EXPECT_EQ(0, rgb.b);
+    rgb = test_light_3.getColorRGB();
+    EXPECT_EQ(0, rgb.r);
+}
+
+TEST_F(HueLightTest, getState)
+{
+    const HueLight ctest_light_1 = test_bridge.getLight(1);
+    const HueLight ctest_light_2 = test_bridge.getLight(2);
+    const HueLight ctest_light_3 = test_bridge.getLight(3);
+
+    EXPECT_TRUE(ctest_light_1.getState().on);
+    EXPECT_EQ(ColorMode::CT, ctest_light_3.getState().colormode);
+
+    LightState state = ctest_light_2.getState();
+    EXPECT_FALSE(state.on);
+    EXPECT_TRUE(state.reachable);
+    EXPECT_EQ(254, state.bri);
+    EXPECT_EQ(123, state.sat);
+    EXPECT_EQ(366, state.ct);
+    EXPECT_FLOAT_EQ(0.102f, state.xy.x);
+    EXPECT_FLOAT_EQ(0.102f, state.xy.y);
+    EXPECT_EQ(ColorMode::CT, state.colormode);
+    EXPECT_EQ(Alert::NONE, state.alert);
+    EXPECT_EQ(hue_bridge_state["lights"]["2"], ctest_light_2.getRawState());
+}
+
 TEST_F(HueLightTest, setColorRGB)
 {
     using namespace ::testing;
@@ -804,9 +874,85 @@ TEST_F(HueLightTest, alert)
     EXPECT_EQ(true, test_light_3.alert());
 }
 
+TEST_F(HueLightTest, trySetState)
+{
+    using namespace ::testing;
+    nlohmann::json unreachable = nlohmann::json::array();
+    unreachable[0]["error"]
+        = {{"type", 201}, {"address", "/lights/1/state/on"}, {"description", "parameter, on, is not modifiable"}};
+    nlohmann::json success = nlohmann::json::array();
+    success[0]["success"]["/lights/1/state/on"] = true;
+    EXPECT_CALL(*handler,
+        PUTJson("/api/" + getBridgeUsername() + "/lights/1/state", nlohmann::json{{"on", true}}, getBridgeIp(), 80))
+        .Times(2)
+        .WillOnce(Return(unreachable))
+        .WillOnce(Return(success));
+
+    HueLight test_light_1 = test_bridge.getLight(1);
+    StateRequest request;
+    request.setOn(true);
+    Result<utils::ReplyValidation> result = test_light_1.trySetState(request);
+    ASSERT_FALSE(result.ok());
+    EXPECT_EQ(201, result.getError().getCode());
+
+    result = test_light_1.trySetState(request);
+    ASSERT_TRUE(result.ok());
+    EXPECT_TRUE(result.get().isSuccess());
+}
+
+TEST_F(HueLightTest, deadbandFilter)
+{
+    using namespace ::testing;
+    nlohmann::json success = nlohmann::json::array();
+    success[0]["success"]["/lights/1/state/bri"] = 200;
+    // Only the visible change is sent
+    EXPECT_CALL(*handler,
+        PUTJson("/api/" + getBridgeUsername() + "/lights/1/state", nlohmann::json{{"bri", 200}}, getBridgeIp(), 80))
+        .Times(1)
+        .WillOnce(Return(success));
+
+    HueLight test_light_1 = test_bridge.getLight(1);
+    EXPECT_EQ(nullptr, test_light_1.getDeadbandFilter());
+    auto filter = std::make_shared<DeadbandFilter>();
+    test_light_1.setDeadbandFilter(filter);
+    EXPECT_EQ(filter, test_light_1.getDeadbandFilter());
+
+    EXPECT_TRUE(test_light_1.setBrightness(253));
+    EXPECT_TRUE(test_light_1.setBrightness(200));
+    // Compared with the accepted brightness, not with the one of the last refresh
+    EXPECT_EQ(200u, test_light_1.getState().bri);
+    StateRequest request;
+    request.setBrightness(201);
+    Result<utils::ReplyValidation> result = test_light_1.trySetState(request);
+    ASSERT_TRUE(result.ok());
+    EXPECT_TRUE(result.get().isSuccess());
+    EXPECT_EQ(2u, filter->getSuppressedRequests());
+    EXPECT_EQ(1u, filter->getPassedRequests());
+}
+
+TEST_F(HueLightTest, tryRefreshState)
+{
+    using namespace ::testing;
+    HueLight test_light_1 = test_bridge.getLight(1);
+    EXPECT_CALL(*handler, GETJson("/api/" + getBridgeUsername() + "/lights/1", _, getBridgeIp(), 80))
+        .Times(2)
+        .WillOnce(Throw(std::system_error(std::make_error_code(std::errc::host_unreachable))))
+        .WillOnce(Return(nlohmann::json{{"name", "Lamp"}}));
+
+    Result<void> result = test_light_1.tryRefreshState();
+    ASSERT_FALSE(result.ok());
+    EXPECT_EQ(HueError::Type::TRANSPORT, result.getError().getType());
+    result = test_light_1.tryRefreshState();
+    ASSERT_FALSE(result.ok());
+    EXPECT_EQ(HueError::Type::INVALID_RESPONSE, result.getError().getType());
+}
+
 TEST_F(HueLightTest, alertTemperature)
 {
     using namespace ::testing;
+    EXPECT_CALL(*handler, PUTJson("/api/" + getBridgeUsername() + "/lights/2/state", _, getBridgeIp(), 80))
+        .Times(1)
+        .WillOnce(Return(nlohmann::json::array()));
     EXPECT_CALL(*handler, PUTJson("/api/" + getBridgeUsername() + "/lights/3/state", _, getBridgeIp(), 80))
         .Times(1)
         .WillOnce(Return(nlohmann::json::array()));
@@ -896,9 +1042,12 @@ TEST_F(HueLightTest, refreshState)
 
     EXPECT_CALL(
         *handler, GETJson("/api/" + getBridgeUsername() + "/lights/1", nlohmann::json::object(), getBridgeIp(), 80))
-        .Times(2)
+        .Times(1)
         .WillRepeatedly(Return(nlohmann::json::object()));
 
+    // Cached lights are not refreshed by getLight
     const HueLight ctest_light_1 = test_bridge.getLight(1);
     HueLight test_light_1 = test_bridge.getLight(1);
+    // Invalid answer keeps the previous state
+    EXPECT_TRUE(test_light_1.isOn());
 }
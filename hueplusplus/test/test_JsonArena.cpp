@@ -0,0 +1,120 @@
+/**
+    \file test_JsonArena.cpp
+    Copyright Notice\n
+    Copyright (C) 2018  Jan Rogall		- developer\n
+    Copyright (C) 2018  Moritz Wirger	- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "../include/JsonArena.h"
+
+TEST(JsonArena, allocate)
+{
+    JsonArena arena(256);
+    EXPECT_EQ(0, arena.getBlockCount());
+    void* a = arena.allocate(10, 1);
+    void* b = arena.allocate(16, 8);
+    EXPECT_EQ(1, arena.getBlockCount());
+    EXPECT_EQ(2, arena.getAllocationCount());
+    EXPECT_TRUE(arena.owns(a));
+    EXPECT_TRUE(arena.owns(b));
+    EXPECT_EQ(0, reinterpret_cast<std::uintptr_t>(b) % 8);
+    int local = 0;
+    EXPECT_FALSE(arena.owns(&local));
+
+    // Larger than a block
+    void* c = arena.allocate(1000, 16);
+    EXPECT_EQ(0, reinterpret_cast<std::uintptr_t>(c) % 16);
+    EXPECT_EQ(2, arena.getBlockCount());
+    EXPECT_TRUE(arena.owns(c));
+
+    arena.reset();
+    EXPECT_EQ(1, arena.getBlockCount());
+    EXPECT_EQ(0, arena.getAllocationCount());
+    EXPECT_EQ(a, arena.allocate(10, 1));
+}
+
+TEST(JsonArena, ArenaJson)
+{
+    JsonArena arena;
+    EXPECT_EQ(nullptr, JsonArena::current());
+    {
+        JsonArena::Scope scope(arena);
+        EXPECT_EQ(&arena, JsonArena::current());
+        ArenaJson json = ArenaJson::parse(R"([{"success":{"/lights/1/state/effect":"colorloop"}}])");
+        EXPECT_GT(arena.getAllocationCount(), 0);
+        auto it = json[0].find("success");
+        ASSERT_NE(json[0].end(), it);
+        EXPECT_EQ("colorloop", it->value("/lights/1/state/effect", ""));
+        EXPECT_EQ(R"([{"success":{"/lights/1/state/effect":"colorloop"}}])", json.dump());
+    }
+    EXPECT_EQ(nullptr, JsonArena::current());
+    EXPECT_EQ(0, arena.getAllocationCount());
+
+    // Without scope the heap is used
+    ArenaJson json = {{"key", "a string that is too long for small string optimization"}};
+    EXPECT_EQ(0, arena.getAllocationCount());
+    json = nullptr;
+}
+
+TEST(JsonArena, ArenaAllocator)
+{
+    JsonArena arena;
+    JsonArena other;
+    JsonArena::Scope scope(arena);
+    ArenaAllocator<int> allocator;
+    EXPECT_EQ(&arena, allocator.getArena());
+    {
+        // The allocator keeps the arena it was created with
+        JsonArena::Scope otherScope(other);
+        int* p = allocator.allocate(4);
+        EXPECT_TRUE(arena.owns(p));
+        EXPECT_EQ(0, other.getAllocationCount());
+        EXPECT_NE(allocator, ArenaAllocator<char>());
+        EXPECT_EQ(allocator, ArenaAllocator<char>(allocator));
+
+        // Deallocation does not reuse the memory
+        allocator.deallocate(p, 4);
+        EXPECT_NE(p, allocator.allocate(4));
+        EXPECT_EQ(2, arena.getAllocationCount());
+    }
+}
+
+TEST(JsonArena, nestedScope)
+{
+    JsonArena outer;
+    JsonArena inner;
+    JsonArena::Scope outerScope(outer);
+    {
+        JsonArena::Scope innerScope(inner);
+        EXPECT_EQ(&inner, JsonArena::current());
+    }
+    EXPECT_EQ(&outer, JsonArena::current());
+
+    // Only the outermost scope of an arena resets it
+    outer.allocate(16, 8);
+    {
+        JsonArena::Scope sameScope(outer);
+        outer.allocate(16, 8);
+    }
+    EXPECT_EQ(&outer, JsonArena::current());
+    EXPECT_EQ(2, outer.getAllocationCount());
+}
@@ -0,0 +1,120 @@
+/**
+    \file test_LightFields.cpp
+    Copyright Notice\n
+    Copyright (C) 2017  Jan Rogall		- developer\n
+    Copyright (C) 2017  Moritz Wirger	- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include <gtest/gtest.h>
+
+#include "../include/LightFields.h"
+#include "../include/LightStateParser.h"
+#include "../include/json/json.hpp"
+
+namespace
+{
+    nlohmann::json getLightReply()
+    {
+        return {{"state", {{"on", true}, {"bri", 200}, {"xy", {0.3, 0.4}}, {"colormode", "xy"}}},
+            {"type", "Extended color light"}, {"name", "Lamp"}, {"modelid", "LCT015"}, {"swversion", 5}};
+    }
+} // namespace
+
+TEST(LightFields, get)
+{
+    const LightFields fields(getLightReply().dump());
+    EXPECT_EQ(true, fields.get(LightField::STATE_ON));
+    EXPECT_EQ((nlohmann::json{0.3, 0.4}), fields.get(LightField::STATE_XY));
+    EXPECT_EQ("Lamp", fields.getString(LightField::NAME));
+    EXPECT_EQ("LCT015", fields.getString(LightField::MODELID));
+    // Missing members are null
+    EXPECT_TRUE(fields.get(LightField::STATE_CT).is_null());
+    EXPECT_TRUE(fields.get(LightField::UNIQUEID).is_null());
+    EXPECT_EQ("", fields.getString(LightField::UNIQUEID));
+    EXPECT_EQ(getLightReply(), fields.getJson());
+    EXPECT_EQ(getLightReply().dump(), fields.getText());
+    // Wrong type
+    EXPECT_EQ("", fields.getString(LightField::SWVERSION));
+    // No string field
+    EXPECT_EQ("", fields.getString(LightField::STATE_BRI));
+
+    const LightFields empty;
+    EXPECT_TRUE(empty.get(LightField::STATE).is_null());
+    EXPECT_TRUE(empty.getJson().is_null());
+    EXPECT_EQ("", empty.getString(LightField::SWVERSION));
+    const LightFields noState(nlohmann::json{{"name", "Lamp"}}.dump());
+    EXPECT_TRUE(noState.get(LightField::STATE_ON).is_null());
+    EXPECT_EQ("Lamp", noState.getString(LightField::NAME));
+
+    EXPECT_THROW(LightFields("{"), nlohmann::json::parse_error);
+}
+
+TEST(LightFields, decodeCold)
+{
+    nlohmann::json reply = getLightReply();
+    reply["swversion"] = "1.50.2";
+    reply["productname"] = "Hue color lamp";
+    const LightFields fields(reply.dump());
+    // Hot fields do not decode the reply
+    EXPECT_EQ("Lamp", fields.getString(LightField::NAME));
+    EXPECT_EQ("Extended color light", fields.getString(LightField::TYPE));
+    EXPECT_FALSE(fields.isDecoded());
+
+    EXPECT_EQ("1.50.2", fields.getString(LightField::SWVERSION));
+    EXPECT_TRUE(fields.isDecoded());
+    EXPECT_EQ("Hue color lamp", fields.getString(LightField::PRODUCTNAME));
+    EXPECT_EQ("", fields.getString(LightField::LUMINAIREUNIQUEID));
+    EXPECT_EQ(reply["state"], fields.get(LightField::STATE));
+}
+
+TEST(LightFields, parsed)
+{
+    const std::string text = getLightReply().dump();
+    LightInfo light = LightStateParser::parseLight(text);
+    const LightFields fields(text, light);
+    EXPECT_EQ("Lamp", fields.getString(LightField::NAME));
+    // Hot strings are moved out of the parsed light
+    EXPECT_EQ("", light.name);
+    EXPECT_EQ(getLightReply(), fields.getJson());
+}
+
+TEST(LightFields, copyAndMove)
+{
+    nlohmann::json reply = getLightReply();
+    reply["swversion"] = "1.50.2";
+    LightFields original(reply.dump());
+    EXPECT_EQ("1.50.2", original.getString(LightField::SWVERSION));
+    LightFields copy(original);
+    EXPECT_FALSE(copy.isDecoded());
+    EXPECT_EQ("Lamp", copy.getString(LightField::NAME));
+    EXPECT_EQ("1.50.2", copy.getString(LightField::SWVERSION));
+    EXPECT_EQ(reply, copy.getJson());
+
+    LightFields moved(std::move(original));
+    EXPECT_TRUE(moved.isDecoded());
+    EXPECT_EQ("1.50.2", moved.getString(LightField::SWVERSION));
+    EXPECT_EQ("", original.getString(LightField::SWVERSION));
+
+    LightFields assigned;
+    assigned = copy;
+    EXPECT_EQ("1.50.2", assigned.getString(LightField::SWVERSION));
+    assigned = LightFields(nlohmann::json{{"name", "Other"}}.dump());
+    EXPECT_EQ("Other", assigned.getString(LightField::NAME));
+    EXPECT_TRUE(assigned.get(LightField::STATE_BRI).is_null());
+    EXPECT_EQ((nlohmann::json{{"name", "Other"}}), assigned.getJson());
+}
@@ -0,0 +1,90 @@
+/**
+    \file test_LightState.cpp
+    Copyright Notice\n
+    Copyright (C) 2017  Jan Rogall		- developer\n
+    Copyright (C) 2017  Moritz Wirger	- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include <gtest/gtest.h>
+
+#include "../include/LightState.h"
+#include "../include/json/json.hpp"
+
+TEST(LightState, fromJson)
+{
+    nlohmann::json json{{"on", true}, {"bri", 200}, {"hue", 40000}, {"sat", 150}, {"effect", "colorloop"},
+        {"xy", {0.3, 0.4}}, {"ct", 300}, {"alert", "lselect"}, {"colormode", "xy"}, {"mode", "homeautomation"},
+        {"reachable", true}};
+    LightState state = LightState::fromJson(json);
+    EXPECT_TRUE(state.on);
+    EXPECT_EQ(200, state.bri);
+    EXPECT_EQ(40000, state.hue);
+    EXPECT_EQ(150, state.sat);
+    EXPECT_EQ(Effect::COLORLOOP, state.effect);
+    EXPECT_FLOAT_EQ(0.3f, state.xy.x);
+    EXPECT_FLOAT_EQ(0.4f, state.xy.y);
+    EXPECT_EQ(300, state.ct);
+    EXPECT_EQ(Alert::LSELECT, state.alert);
+    EXPECT_EQ(ColorMode::XY, state.colormode);
+    EXPECT_TRUE(state.reachable);
+    for (LightState::Member member : {LightState::ON, LightState::REACHABLE, LightState::BRI, LightState::HUE,
+             LightState::SAT, LightState::XY, LightState::CT, LightState::COLORMODE, LightState::EFFECT,
+             LightState::ALERT})
+    {
+        EXPECT_TRUE(state.has(member));
+    }
+}
+
+TEST(LightState, fromJsonMissing)
+{
+    LightState state = LightState::fromJson(nlohmann::json::object());
+    EXPECT_FALSE(state.on);
+    EXPECT_EQ(0, state.bri);
+    EXPECT_EQ(ColorMode::NONE, state.colormode);
+    EXPECT_EQ(0, state.members);
+
+    state = LightState::fromJson(nullptr);
+    EXPECT_FALSE(state.reachable);
+    EXPECT_EQ(0, state.members);
+
+    // Wrong types are ignored instead of throwing
+    state = LightState::fromJson({{"on", "yes"}, {"bri", "full"}, {"xy", {0.1}}, {"colormode", 1}});
+    EXPECT_FALSE(state.on);
+    EXPECT_EQ(0, state.bri);
+    EXPECT_FLOAT_EQ(0.0f, state.xy.x);
+    EXPECT_EQ(ColorMode::NONE, state.colormode);
+    EXPECT_EQ(0, state.members);
+
+    state = LightState::fromJson({{"bri", 0}, {"on", false}});
+    EXPECT_TRUE(state.has(LightState::BRI));
+    EXPECT_TRUE(state.has(LightState::ON));
+    EXPECT_FALSE(state.has(LightState::SAT));
+}
+
+TEST(LightState, parse)
+{
+    EXPECT_EQ(ColorMode::HS, parseColorMode("hs"));
+    EXPECT_EQ(ColorMode::XY, parseColorMode("xy"));
+    EXPECT_EQ(ColorMode::CT, parseColorMode("ct"));
+    EXPECT_EQ(ColorMode::NONE, parseColorMode("invalid"));
+    EXPECT_EQ(Effect::NONE, parseEffect("none"));
+    EXPECT_EQ(Effect::COLORLOOP, parseEffect("colorloop"));
+    EXPECT_EQ(Alert::NONE, parseAlert("none"));
+    EXPECT_EQ(Alert::SELECT, parseAlert("select"));
+    EXPECT_EQ(Alert::LSELECT, parseAlert("lselect"));
+}
@@ -0,0 +1,196 @@
+/**
+    \file test_LightStateParser.cpp
+    Copyright Notice\n
+    Copyright (C) 2017  Jan Rogall		- developer\n
+    Copyright (C) 2017  Moritz Wirger	- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../include/HueException.h"
+#include "../include/LightStateParser.h"
+#include "../include/json/json.hpp"
+
+namespace
+{
+    nlohmann::json getLightJson(const std::string& name, int bri)
+    {
+        return nlohmann::json{{"state",
+                                  {{"on", true}, {"bri", bri}, {"hue", 40000}, {"sat", 150}, {"effect", "colorloop"},
+                                      {"xy", {0.3, 0.4}}, {"ct", 300}, {"alert", "lselect"}, {"colormode", "xy"},
+                                      {"mode", "homeautomation"}, {"reachable", true}}},
+            {"swupdate", {{"state", "noupdates"}, {"lastinstall", nullptr}}}, {"type", "Extended color light"},
+            {"name", name}, {"modelid", "LCT015"}, {"manufacturername", "Philips"}, {"productname", "Hue color lamp"},
+            {"capabilities",
+                {{"control",
+                    {{"colorgamuttype", "C"}, {"colorgamut", {{0.6915, 0.3083}, {0.17, 0.7}, {0.1532, 0.0475}}},
+                        {"ct", {{"min", 153}, {"max", 500}}}}}}},
+            {"config", {{"archetype", "sultanbulb"}, {"startup", {{"mode", "safety"}, {"on", false}}}}},
+            {"uniqueid", "00:17:88:01:00:00:00:00-0b"}, {"swversion", "1.46.13_r26312"}};
+    }
+
+    void expectEqual(const LightState& expected, const LightState& actual)
+    {
+        EXPECT_EQ(expected.on, actual.on);
+        EXPECT_EQ(expected.reachable, actual.reachable);
+        EXPECT_EQ(expected.bri, actual.bri);
+        EXPECT_EQ(expected.hue, actual.hue);
+        EXPECT_EQ(expected.sat, actual.sat);
+        EXPECT_EQ(expected.ct, actual.ct);
+        EXPECT_FLOAT_EQ(expected.xy.x, actual.xy.x);
+        EXPECT_FLOAT_EQ(expected.xy.y, actual.xy.y);
+        EXPECT_EQ(expected.colormode, actual.colormode);
+        EXPECT_EQ(expected.effect, actual.effect);
+        EXPECT_EQ(expected.alert, actual.alert);
+        EXPECT_EQ(expected.members, actual.members);
+    }
+} // namespace
+
+TEST(LightStateParser, parseLight)
+{
+    const nlohmann::json json = getLightJson("Lamp", 200);
+    LightInfo light = LightStateParser::parseLight(json.dump());
+    EXPECT_EQ(0, light.id);
+    EXPECT_EQ("Lamp", light.name);
+    EXPECT_EQ("Extended color light", light.type);
+    EXPECT_EQ("LCT015", light.modelId);
+    EXPECT_EQ("00:17:88:01:00:00:00:00-0b", light.uniqueId);
+    EXPECT_EQ("Philips", light.manufacturerName);
+    EXPECT_EQ("Hue color lamp", light.productName);
+    EXPECT_EQ("", light.luminaireUniqueId);
+    EXPECT_EQ("1.46.13_r26312", light.swVersion);
+    expectEqual(LightState::fromJson(json["state"]), light.state);
+    // Nested "ct" and "on" of capabilities and config are not confused with the state
+    EXPECT_EQ(300, light.state.ct);
+    EXPECT_TRUE(light.state.on);
+}
+
+TEST(LightStateParser, parseLightInvalid)
+{
+    nlohmann::json state{{"on", "yes"}, {"bri", "full"}, {"xy", {0.1}}, {"colormode", 1}, {"ct", {{"value", 1}}}};
+    LightInfo light = LightStateParser::parseLight(nlohmann::json{{"state", state}}.dump());
+    expectEqual(LightState::fromJson(state), light.state);
+
+    state = {{"xy", {0.1, "0.2"}}};
+    light = LightStateParser::parseLight(nlohmann::json{{"state", state}}.dump());
+    expectEqual(LightState::fromJson(state), light.state);
+
+    EXPECT_THROW(LightStateParser::parseLight("{\"state\": {"), nlohmann::json::parse_error);
+    EXPECT_THROW(LightStateParser::parseLight(""), nlohmann::json::parse_error);
+    // Overflow of a number is reported with its own type
+    EXPECT_THROW(LightStateParser::parseLight("{\"state\":{\"bri\":1e500}}"), nlohmann::json::out_of_range);
+}
+
+TEST(LightStateParser, parseLightOutOfRange)
+{
+    // Integers outside of the range of a member are converted like json::get, floating point values are clamped
+    nlohmann::json state{{"bri", 300}, {"hue", -1}, {"sat", 254.7}, {"ct", 1e10}};
+    LightInfo light = LightStateParser::parseLight(nlohmann::json{{"state", state}}.dump());
+    EXPECT_EQ(static_cast<uint8_t>(300), light.state.bri);
+    EXPECT_EQ(static_cast<uint16_t>(-1), light.state.hue);
+    EXPECT_EQ(254, light.state.sat);
+    EXPECT_EQ(65535, light.state.ct);
+    expectEqual(LightState::fromJson(state), light.state);
+
+    state = {{"bri", -1}, {"hue", 70000}, {"sat", -0.5}, {"ct", 18446744073709551615u}};
+    light = LightStateParser::parseLight(nlohmann::json{{"state", state}}.dump());
+    EXPECT_EQ(static_cast<uint8_t>(-1), light.state.bri);
+    EXPECT_EQ(static_cast<uint16_t>(70000), light.state.hue);
+    EXPECT_EQ(0, light.state.sat);
+    EXPECT_EQ(static_cast<uint16_t>(18446744073709551615u), light.state.ct);
+    expectEqual(LightState::fromJson(state), light.state);
+}
+
+TEST(LightStateParser, parseError)
+{
+    nlohmann::json error{{"type", 3}, {"address", "/lights/9"}, {"description", "resource, /lights/9, not available"}};
+    const std::string errorArray = nlohmann::json::array({{{"error", error}}}).dump();
+    try
+    {
+        LightStateParser::parseLight(errorArray);
+        FAIL() << "parseLight did not throw";
+    }
+    catch (const HueAPIResponseException& e)
+    {
+        EXPECT_EQ(3, e.GetErrorNumber());
+        EXPECT_EQ("/lights/9", e.GetAddress());
+        EXPECT_EQ("resource, /lights/9, not available", e.GetDescription());
+    }
+    EXPECT_THROW(LightStateParser::parseLight(nlohmann::json{{"error", error}}.dump()), HueAPIResponseException);
+    EXPECT_THROW(LightStateParser::parseLights(errorArray), HueAPIResponseException);
+    EXPECT_THROW(LightStateParser::parseBridgeState(errorArray), HueAPIResponseException);
+    // Only the first element of an array is checked, like HueCommandAPI does
+    EXPECT_NO_THROW(LightStateParser::parseLight(nlohmann::json::array({1, {{"error", error}}}).dump()));
+    // Other members named "error" are no error response
+    LightInfo light = LightStateParser::parseLight(
+        nlohmann::json{{"name", "Lamp"}, {"config", {{"error", error}}}, {"state", {{"on", true}}}}.dump());
+    EXPECT_EQ("Lamp", light.name);
+    EXPECT_TRUE(light.state.on);
+}
+
+TEST(LightStateParser, parseLights)
+{
+    nlohmann::json json{{"1", getLightJson("Lamp 1", 100)}, {"12", getLightJson("Lamp 12", 120)}};
+    std::vector<LightInfo> lights = LightStateParser::parseLights(json.dump());
+    ASSERT_EQ(2, lights.size());
+    EXPECT_EQ(1, lights[0].id);
+    EXPECT_EQ("Lamp 1", lights[0].name);
+    EXPECT_EQ(100, lights[0].state.bri);
+    EXPECT_EQ(12, lights[1].id);
+    EXPECT_EQ("Lamp 12", lights[1].name);
+    expectEqual(LightState::fromJson(json["12"]["state"]), lights[1].state);
+    EXPECT_EQ(json["1"].dump(), lights[0].text);
+    EXPECT_EQ(json["12"].dump(), lights[1].text);
+
+    // Whitespace and numbers at the end of an object do not move the text
+    nlohmann::json numbers{{"5", {{"name", "Lamp 5"}, {"state", {{"bri", 5}}}, {"capabilities", 1.5}}}};
+    lights = LightStateParser::parseLights(numbers.dump(4));
+    ASSERT_EQ(1, lights.size());
+    EXPECT_EQ(numbers["5"], nlohmann::json::parse(lights[0].text));
+    EXPECT_EQ('{', lights[0].text.front());
+    EXPECT_EQ('}', lights[0].text.back());
+
+    EXPECT_TRUE(LightStateParser::parseLights("{}").empty());
+}
+
+TEST(LightStateParser, parseBridgeState)
+{
+    nlohmann::json json{{"lights", {{"3", getLightJson("Lamp 3", 30)}, {"4", getLightJson("Lamp 4", 40)}}},
+        {"groups", {{"1", {{"name", "Room"}, {"state", {{"any_on", true}}}, {"action", {{"on", true}, {"bri", 1}}}}}}},
+        {"config", {{"name", "Bridge"}, {"whitelist", {{"abc", {{"name", "app"}}}}}}}};
+    std::vector<LightInfo> lights = LightStateParser::parseBridgeState(json.dump());
+    ASSERT_EQ(2, lights.size());
+    EXPECT_EQ(3, lights[0].id);
+    EXPECT_EQ("Lamp 3", lights[0].name);
+    EXPECT_EQ(30, lights[0].state.bri);
+    EXPECT_EQ(4, lights[1].id);
+    EXPECT_EQ(40, lights[1].state.bri);
+    EXPECT_EQ(json["lights"]["4"].dump(), lights[1].text);
+
+    bool hasLights = false;
+    EXPECT_EQ(2, LightStateParser::parseBridgeState(json.dump(), hasLights).size());
+    EXPECT_TRUE(hasLights);
+    EXPECT_TRUE(LightStateParser::parseBridgeState("{\"lights\": {}}", hasLights).empty());
+    EXPECT_TRUE(hasLights);
+    EXPECT_TRUE(LightStateParser::parseBridgeState("{\"config\": {\"name\": \"Bridge\"}}", hasLights).empty());
+    EXPECT_FALSE(hasLights);
+    EXPECT_TRUE(LightStateParser::parseBridgeState("{\"config\": {\"name\": \"Bridge\"}}").empty());
+}
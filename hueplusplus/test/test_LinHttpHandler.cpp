@@ -0,0 +1,99 @@
+/**
+    \file test_LinHttpHandler.cpp
+    Copyright Notice\n
+    Copyright (C) 2017  Jan Rogall		- developer\n
+    Copyright (C) 2017  Moritz Wirger	- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include <cerrno>
+#include <string>
+#include <system_error>
+#include <thread>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include "../include/HueException.h"
+#include "../include/LinHttpHandler.h"
+#include "../include/json/json.hpp"
+
+namespace
+{
+    // Writes the response to one end of a socket pair from another thread and parses it from the other end
+    nlohmann::json receive(const std::string& response)
+    {
+        int sockets[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) < 0)
+        {
+            throw std::system_error(errno, std::generic_category(), "socketpair");
+        }
+        std::thread writer([&]() {
+            std::size_t sent = 0;
+            while (sent < response.size())
+            {
+                ssize_t bytes = write(sockets[1], response.data() + sent, response.size() - sent);
+                if (bytes <= 0)
+                {
+                    break;
+                }
+                sent += bytes;
+            }
+            close(sockets[1]);
+        });
+        try
+        {
+            nlohmann::json result = LinHttpHandler::receiveJson(sockets[0]);
+            close(sockets[0]);
+            writer.join();
+            return result;
+        }
+        catch (...)
+        {
+            close(sockets[0]);
+            writer.join();
+            throw;
+        }
+    }
+} // namespace
+
+TEST(LinHttpHandler, receiveJson)
+{
+    nlohmann::json lights = nlohmann::json::object();
+    for (int i = 1; i <= 500; ++i)
+    {
+        lights[std::to_string(i)] = {{"state", {{"on", true}, {"bri", i % 255}, {"xy", {0.3, 0.4}}}},
+            {"name", "Hue color lamp " + std::to_string(i)}};
+    }
+    const nlohmann::json expected = {{"lights", lights}};
+    // Body is much larger than the receive buffer and the socket buffer
+    EXPECT_EQ(expected,
+        receive("HTTP/1.0 200 OK\r\nContent-Type: application/json\r\n\r\n" + expected.dump() + "\r\n"));
+    EXPECT_EQ(nlohmann::json::array(), receive("HTTP/1.0 200 OK\r\n\r\n[]"));
+    // Separator split by a partial match
+    EXPECT_EQ((nlohmann::json{{"a", 1}}), receive("HTTP/1.0 200 OK\r\n\r\r\n\r\n{\"a\":1}"));
+}
+
+TEST(LinHttpHandler, receiveJsonInvalid)
+{
+    EXPECT_THROW(receive(""), HueException);
+    EXPECT_THROW(receive("HTTP/1.0 200 OK\r\n{}"), HueException);
+    EXPECT_THROW(receive("HTTP/1.0 200 OK\r\n\r\n"), nlohmann::json::parse_error);
+    EXPECT_THROW(receive("HTTP/1.0 200 OK\r\n\r\n{\"a\":"), nlohmann::json::parse_error);
+}
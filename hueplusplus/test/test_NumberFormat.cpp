@@ -0,0 +1,78 @@
+/**
+    \file test_NumberFormat.cpp
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+    Copyright (C) 2020  Moritz Wirger	- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include <clocale>
+#include <limits>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "../include/NumberFormat.h"
+#include "../include/json/json.hpp"
+
+TEST(NumberFormat, appendInt)
+{
+    std::string out = "/lights/";
+    utils::appendInt(out, 12);
+    EXPECT_EQ("/lights/12", out);
+
+    const long long values[] = {0, 1, -1, 9, 10, 65535, -254, std::numeric_limits<long long>::max(),
+        std::numeric_limits<long long>::min()};
+    for (long long value : values)
+    {
+        out.clear();
+        utils::appendInt(out, value);
+        EXPECT_EQ(std::to_string(value), out);
+    }
+    out.clear();
+    utils::appendUnsigned(out, std::numeric_limits<unsigned long long>::max());
+    EXPECT_EQ(std::to_string(std::numeric_limits<unsigned long long>::max()), out);
+}
+
+TEST(NumberFormat, appendFloat)
+{
+    const double values[] = {0.0, 1.0, -1.0, 0.3127, 0.329, 0.1, 1e-7, 123456789.0, 0.6915f, 0.1532f};
+    for (double value : values)
+    {
+        std::string out;
+        utils::appendFloat(out, value);
+        EXPECT_EQ(nlohmann::json(value).dump(), out);
+        EXPECT_EQ(value, std::stod(out));
+    }
+    std::string out;
+    utils::appendFloat(out, std::numeric_limits<double>::infinity());
+    EXPECT_EQ("null", out);
+}
+
+TEST(NumberFormat, locale)
+{
+    // A locale with ',' as decimal separator must not change the output
+    const std::string previous = std::setlocale(LC_NUMERIC, nullptr);
+    if (std::setlocale(LC_NUMERIC, "de_DE.UTF-8") == nullptr)
+    {
+        return;
+    }
+    std::string out;
+    utils::appendFloat(out, 0.5);
+    std::setlocale(LC_NUMERIC, previous.c_str());
+    EXPECT_EQ("0.5", out);
+}
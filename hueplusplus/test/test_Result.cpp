@@ -0,0 +1,109 @@
+/**
+    \file test_Result.cpp
+    Copyright Notice\n
+    Copyright (C) 2018  Jan Rogall		- developer\n
+    Copyright (C) 2018  Moritz Wirger	- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include <exception>
+#include <string>
+#include <system_error>
+
+#include <gtest/gtest.h>
+
+#include "../include/HueExceptionMacro.h"
+#include "../include/Result.h"
+#include "../include/json/json.hpp"
+
+TEST(Result, HueError)
+{
+    const FileInfo fileInfo = CURRENT_FILE_INFO;
+    const HueError none;
+    EXPECT_EQ(HueError::Type::NONE, none.getType());
+
+    const HueError apiError = HueError::fromResponse(
+        fileInfo, {{"error", {{"type", 3}, {"address", "/lights/9"}, {"description", "not available"}}}});
+    EXPECT_EQ(HueError::Type::API_RESPONSE, apiError.getType());
+    EXPECT_EQ(3, apiError.getCode());
+    EXPECT_EQ(fileInfo.ToString() + " 3 /lights/9 not available", apiError.toString());
+    try
+    {
+        apiError.raise();
+        FAIL() << "raise did not throw";
+    }
+    catch (const HueAPIResponseException& e)
+    {
+        EXPECT_EQ(3, e.GetErrorNumber());
+        EXPECT_EQ("/lights/9", e.GetAddress());
+        EXPECT_EQ("not available", e.GetDescription());
+        EXPECT_EQ(fileInfo.line, e.GetFile().line);
+    }
+
+    // Missing members and wrong types are defaulted
+    const HueError incomplete = HueError::fromResponse(fileInfo, {{"error", {{"type", "3"}}}});
+    EXPECT_EQ(-1, incomplete.getCode());
+    EXPECT_EQ("", incomplete.getAddress());
+
+    const HueError transport(fileInfo, std::make_error_code(std::errc::timed_out), "timed out");
+    EXPECT_EQ(fileInfo.ToString() + " timed out", transport.toString());
+    EXPECT_THROW(transport.raise(), std::system_error);
+    // Rethrowing the stored exception keeps its message
+    const std::system_error original(std::make_error_code(std::errc::timed_out), "LinHttpHandler: recv");
+    for (const std::system_error& cause : {original, std::system_error(original.code())})
+    {
+        try
+        {
+            HueError(fileInfo, cause.code(), cause.what(), std::make_exception_ptr(cause)).raise();
+            FAIL() << "raise did not throw";
+        }
+        catch (const std::system_error& e)
+        {
+            EXPECT_EQ(cause.code(), e.code());
+            EXPECT_STREQ(cause.what(), e.what());
+        }
+    }
+    EXPECT_THROW(HueError(fileInfo, "no body").raise(), HueException);
+}
+
+TEST(Result, Result)
+{
+    Result<int> value(5);
+    EXPECT_TRUE(value.ok());
+    EXPECT_TRUE(static_cast<bool>(value));
+    EXPECT_EQ(5, value.get());
+    EXPECT_EQ(HueError::Type::NONE, value.getError().getType());
+
+    Result<int> error(HueError(CURRENT_FILE_INFO, "no body"));
+    EXPECT_FALSE(error.ok());
+    EXPECT_THROW(error.get(), HueException);
+
+    Result<void> empty;
+    EXPECT_TRUE(empty.ok());
+    EXPECT_NO_THROW(empty.get());
+    Result<void> failed(HueError(CURRENT_FILE_INFO, "no body"));
+    EXPECT_FALSE(failed);
+    EXPECT_THROW(failed.get(), HueException);
+}
+
+TEST(Result, FileInfo)
+{
+    FileInfo unknown;
+    EXPECT_EQ("Unknown file", unknown.ToString());
+    FileInfo current = CURRENT_FILE_INFO;
+    EXPECT_EQ(std::string("TestBody in ") + __FILE__ + ":" + std::to_string(current.line), current.ToString());
+}
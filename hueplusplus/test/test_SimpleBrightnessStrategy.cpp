@@ -56,22 +56,22 @@ TEST(SimpleBrightnessStrategy, setBrightness)
     prep_ret[2] = nlohmann::json::object();
     prep_ret[2]["success"] = nlohmann::json::object();
     prep_ret[2]["success"]["/lights/1/state/bri"] = 50;
-    EXPECT_CALL(test_light, SendPutRequest(_, "/state", _)).Times(1).WillOnce(Return(prep_ret));
+    EXPECT_CALL(test_light, SendStateRequest(_, _)).Times(1).WillOnce(Invoke(ValidateAgainst(prep_ret)));
 
-    test_light.getState()["state"]["on"] = true;
+    test_light.getMutableState().on = true;
     EXPECT_EQ(true, SimpleBrightnessStrategy().setBrightness(0, 4, test_light));
-    test_light.getState()["state"]["on"] = false;
+    test_light.getMutableState().on = false;
     EXPECT_EQ(true, SimpleBrightnessStrategy().setBrightness(0, 4, test_light));
 
-    test_light.getState()["state"]["bri"] = 0;
+    test_light.getMutableState().bri = 0;
     EXPECT_EQ(true, SimpleBrightnessStrategy().setBrightness(50, 6, test_light));
-    test_light.getState()["state"]["on"] = true;
-    test_light.getState()["state"]["bri"] = 50;
+    test_light.getMutableState().on = true;
+    test_light.getMutableState().bri = 50;
     EXPECT_EQ(true, SimpleBrightnessStrategy().setBrightness(50, 6, test_light));
 
     prep_ret[2]["success"]["/lights/1/state/bri"] = 254;
-    EXPECT_CALL(test_light, SendPutRequest(_, "/state", _)).Times(1).WillOnce(Return(prep_ret));
-    test_light.getState()["state"]["on"] = false;
+    EXPECT_CALL(test_light, SendStateRequest(_, _)).Times(1).WillOnce(Invoke(ValidateAgainst(prep_ret)));
+    test_light.getMutableState().on = false;
     EXPECT_EQ(true, SimpleBrightnessStrategy().setBrightness(255, 6, test_light));
 }
 
@@ -86,8 +86,8 @@ TEST(SimpleBrightnessStrategy, getBrightness)
     MockHueLight test_light(handler);
     EXPECT_CALL(test_light, refreshState()).Times(AtLeast(1)).WillRepeatedly(Return());
 
-    test_light.getState()["state"]["bri"] = 200;
+    test_light.getMutableState().bri = 200;
     EXPECT_EQ(200, SimpleBrightnessStrategy().getBrightness(test_light));
-    test_light.getState()["state"]["bri"] = 0;
+    test_light.getMutableState().bri = 0;
     EXPECT_EQ(0, SimpleBrightnessStrategy().getBrightness(static_cast<const HueLight>(test_light)));
 }
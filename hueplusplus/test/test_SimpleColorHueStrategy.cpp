@@ -29,6 +29,7 @@
 #include "testhelper.h"
 
 #include "../include/SimpleColorHueStrategy.h"
+#include "../include/ColorConversion.h"
 #include "../include/json/json.hpp"
 #include "mocks/mock_HttpHandler.h"
 #include "mocks/mock_HueLight.h"
@@ -54,14 +55,14 @@ TEST(SimpleColorHueStrategy, setColorHue)
     prep_ret[2] = nlohmann::json::object();
     prep_ret[2]["success"] = nlohmann::json::object();
     prep_ret[2]["success"]["/lights/1/state/hue"] = 30500;
-    EXPECT_CALL(test_light, SendPutRequest(_, "/state", _)).Times(1).WillOnce(Return(prep_ret));
+    EXPECT_CALL(test_light, SendStateRequest(_, _)).Times(1).WillOnce(Invoke(ValidateAgainst(prep_ret)));
 
-    test_light.getState()["state"]["on"] = true;
-    test_light.getState()["state"]["hue"] = 200;
-    test_light.getState()["state"]["colormode"] = "hs";
+    test_light.getMutableState().on = true;
+    test_light.getMutableState().hue = 200;
+    test_light.getMutableState().colormode = ColorMode::HS;
     EXPECT_EQ(true, SimpleColorHueStrategy().setColorHue(200, 4, test_light));
 
-    test_light.getState()["state"]["on"] = false;
+    test_light.getMutableState().on = false;
     EXPECT_EQ(true, SimpleColorHueStrategy().setColorHue(30500, 6, test_light));
 }
 
@@ -86,17 +87,39 @@ TEST(SimpleColorHueStrategy, setColorSaturation)
     prep_ret[2] = nlohmann::json::object();
     prep_ret[2]["success"] = nlohmann::json::object();
     prep_ret[2]["success"]["/lights/1/state/sat"] = 254;
-    EXPECT_CALL(test_light, SendPutRequest(_, "/state", _)).Times(1).WillOnce(Return(prep_ret));
+    EXPECT_CALL(test_light, SendStateRequest(_, _)).Times(1).WillOnce(Invoke(ValidateAgainst(prep_ret)));
 
-    test_light.getState()["state"]["on"] = true;
-    test_light.getState()["state"]["sat"] = 100;
-    test_light.getState()["state"]["colormode"] = "hs";
+    test_light.getMutableState().on = true;
+    test_light.getMutableState().sat = 100;
+    test_light.getMutableState().colormode = ColorMode::HS;
     EXPECT_EQ(true, SimpleColorHueStrategy().setColorSaturation(100, 4, test_light));
 
-    test_light.getState()["state"]["on"] = false;
+    test_light.getMutableState().on = false;
     EXPECT_EQ(true, SimpleColorHueStrategy().setColorSaturation(255, 6, test_light));
 }
 
+TEST(SimpleColorHueStrategy, setColorSaturationMissing)
+{
+    using namespace ::testing;
+    std::shared_ptr<MockHttpHandler> handler(std::make_shared<MockHttpHandler>());
+    EXPECT_CALL(
+        *handler, GETJson("/api/" + getBridgeUsername() + "/lights/1", nlohmann::json::object(), getBridgeIp(), 80))
+        .Times(AtLeast(1))
+        .WillRepeatedly(Return(nlohmann::json::object()));
+    MockHueLight test_light(handler);
+    EXPECT_CALL(test_light, refreshState()).Times(AtLeast(1)).WillRepeatedly(Return());
+    nlohmann::json prep_ret;
+    prep_ret = nlohmann::json::array();
+    prep_ret[0] = nlohmann::json::object();
+    prep_ret[0]["success"] = nlohmann::json::object();
+    prep_ret[0]["success"]["/lights/1/state/sat"] = 0;
+    EXPECT_CALL(test_light, SendStateRequest(_, _)).Times(1).WillOnce(Invoke(ValidateAgainst(prep_ret)));
+
+    // A member that is missing in the state is always sent, even if it matches the default
+    test_light.getMutableState() = LightState::fromJson({{"on", true}, {"colormode", "hs"}});
+    EXPECT_EQ(true, SimpleColorHueStrategy().setColorSaturation(0, 4, test_light));
+}
+
 TEST(SimpleColorHueStrategy, setColorHueSaturation)
 {
     using namespace ::testing;
@@ -121,15 +144,15 @@ TEST(SimpleColorHueStrategy, setColorHueSaturation)
     prep_ret[3] = nlohmann::json::object();
     prep_ret[3]["success"] = nlohmann::json::object();
     prep_ret[3]["success"]["/lights/1/state/sat"] = 254;
-    EXPECT_CALL(test_light, SendPutRequest(_, "/state", _)).Times(1).WillOnce(Return(prep_ret));
+    EXPECT_CALL(test_light, SendStateRequest(_, _)).Times(1).WillOnce(Invoke(ValidateAgainst(prep_ret)));
 
-    test_light.getState()["state"]["on"] = true;
-    test_light.getState()["state"]["sat"] = 100;
-    test_light.getState()["state"]["hue"] = 200;
-    test_light.getState()["state"]["colormode"] = "hs";
+    test_light.getMutableState().on = true;
+    test_light.getMutableState().sat = 100;
+    test_light.getMutableState().hue = 200;
+    test_light.getMutableState().colormode = ColorMode::HS;
     EXPECT_EQ(true, SimpleColorHueStrategy().setColorHueSaturation(200, 100, 4, test_light));
 
-    test_light.getState()["state"]["on"] = false;
+    test_light.getMutableState().on = false;
     EXPECT_EQ(true, SimpleColorHueStrategy().setColorHueSaturation(30500, 255, 6, test_light));
 }
 
@@ -155,18 +178,45 @@ TEST(SimpleColorHueStrategy, setColorXY)
     prep_ret[2]["success"] = nlohmann::json::object();
     prep_ret[2]["success"]["/lights/1/state/xy"][0] = 0.2355;
     prep_ret[2]["success"]["/lights/1/state/xy"][1] = 0.1234;
-    EXPECT_CALL(test_light, SendPutRequest(_, "/state", _)).Times(1).WillOnce(Return(prep_ret));
+    EXPECT_CALL(test_light, SendStateRequest(_, _)).Times(1).WillOnce(Invoke(ValidateAgainst(prep_ret)));
 
-    test_light.getState()["state"]["on"] = true;
-    test_light.getState()["state"]["xy"][0] = 0.1f;
-    test_light.getState()["state"]["xy"][1] = 0.1f;
-    test_light.getState()["state"]["colormode"] = "xy";
+    test_light.getMutableState().on = true;
+    test_light.getMutableState().xy.x = 0.1f;
+    test_light.getMutableState().xy.y = 0.1f;
+    test_light.getMutableState().colormode = ColorMode::XY;
     EXPECT_EQ(true, SimpleColorHueStrategy().setColorXY(0.1f, 0.1f, 4, test_light));
 
-    test_light.getState()["state"]["on"] = false;
+    test_light.getMutableState().on = false;
     EXPECT_EQ(true, SimpleColorHueStrategy().setColorXY(0.2355f, 0.1234f, 6, test_light));
 }
 
+TEST(SimpleColorHueStrategy, setColorXYGamut)
+{
+    using namespace ::testing;
+    std::shared_ptr<MockHttpHandler> handler(std::make_shared<MockHttpHandler>());
+    EXPECT_CALL(
+        *handler, GETJson("/api/" + getBridgeUsername() + "/lights/1", nlohmann::json::object(), getBridgeIp(), 80))
+        .Times(AtLeast(1))
+        .WillRepeatedly(Return(nlohmann::json::object()));
+    MockHueLight test_light(handler);
+    EXPECT_CALL(test_light, refreshState()).Times(AtLeast(1)).WillRepeatedly(Return());
+    EXPECT_CALL(test_light, getColorType()).WillRepeatedly(Return(ColorType::GAMUT_B));
+    // The bridge replies with the closest color in gamut B
+    nlohmann::json prep_ret = {{{"success", {{"/lights/1/state/xy", {0.1775, 0.0608}}}}}};
+    EXPECT_CALL(test_light, SendStateRequest(_, _)).Times(1).WillOnce(Invoke(ValidateAgainst(prep_ret)));
+
+    test_light.getMutableState().on = true;
+    test_light.getMutableState().xy.x = 0.3f;
+    test_light.getMutableState().xy.y = 0.3f;
+    test_light.getMutableState().colormode = ColorMode::XY;
+    EXPECT_EQ(true, SimpleColorHueStrategy().setColorXY(0.1f, 0.1f, 4, test_light));
+
+    // Light already has the clamped color, nothing is sent
+    test_light.getMutableState().xy.x = 0.1775f;
+    test_light.getMutableState().xy.y = 0.0608f;
+    EXPECT_EQ(true, SimpleColorHueStrategy().setColorXY(0.1f, 0.1f, 4, test_light));
+}
+
 TEST(SimpleColorHueStrategy, setColorRGB)
 {
     using namespace ::testing;
@@ -204,14 +254,14 @@ TEST(SimpleColorHueStrategy, setColorLoop)
     prep_ret[1] = nlohmann::json::object();
     prep_ret[1]["success"] = nlohmann::json::object();
     prep_ret[1]["success"]["/lights/1/state/effect"] = "colorloop";
-    EXPECT_CALL(test_light, SendPutRequest(_, "/state", _)).Times(1).WillOnce(Return(prep_ret));
+    EXPECT_CALL(test_light, SendStateRequest(_, _)).Times(1).WillOnce(Invoke(ValidateAgainst(prep_ret)));
 
-    test_light.getState()["state"]["on"] = true;
-    test_light.getState()["state"]["effect"] = "colorloop";
+    test_light.getMutableState().on = true;
+    test_light.getMutableState().effect = Effect::COLORLOOP;
     EXPECT_EQ(true, SimpleColorHueStrategy().setColorLoop(true, test_light));
 
-    test_light.getState()["state"]["on"] = false;
-    test_light.getState()["state"]["effect"] = "none";
+    test_light.getMutableState().on = false;
+    test_light.getMutableState().effect = Effect::NONE;
     EXPECT_EQ(true, SimpleColorHueStrategy().setColorLoop(true, test_light));
 }
 
@@ -226,37 +276,43 @@ TEST(SimpleColorHueStrategy, alertHueSaturation)
     MockHueLight test_light(handler);
     EXPECT_CALL(test_light, refreshState()).Times(AtLeast(1)).WillRepeatedly(Return());
 
-    test_light.getState()["state"]["colormode"] = "invalid";
-    test_light.getState()["state"]["on"] = false;
+    test_light.getMutableState().colormode = ColorMode::NONE;
+    test_light.getMutableState().on = false;
     EXPECT_EQ(false, SimpleColorHueStrategy().alertHueSaturation(30000, 128, test_light));
 
     EXPECT_CALL(test_light, setColorHueSaturation(_, _, 1))
         .Times(AtLeast(2))
         .WillOnce(Return(false))
         .WillRepeatedly(Return(true));
-    test_light.getState()["state"]["colormode"] = "hs";
-    test_light.getState()["state"]["on"] = true;
-    test_light.getState()["state"]["sat"] = 100;
-    test_light.getState()["state"]["hue"] = 200;
+    test_light.getMutableState().colormode = ColorMode::HS;
+    test_light.getMutableState().on = true;
+    test_light.getMutableState().sat = 100;
+    test_light.getMutableState().hue = 200;
+    // Colors in hue and saturation are restored as xy
+    EXPECT_CALL(test_light, getColorType()).WillRepeatedly(Return(ColorType::GAMUT_C));
+    const XY restored = ColorConversion::hueSaturationToXY(200, 100, ColorType::GAMUT_C);
     EXPECT_EQ(false, SimpleColorHueStrategy().alertHueSaturation(200, 100, test_light));
 
     EXPECT_CALL(test_light, alert()).Times(AtLeast(2)).WillOnce(Return(false)).WillRepeatedly(Return(true));
     EXPECT_EQ(false, SimpleColorHueStrategy().alertHueSaturation(200, 100, test_light));
 
+    EXPECT_CALL(test_light, setColorXY(FloatEq(restored.x), FloatEq(restored.y), 1))
+        .Times(AtLeast(1))
+        .WillRepeatedly(Return(true));
     EXPECT_EQ(true, SimpleColorHueStrategy().alertHueSaturation(200, 100, test_light));
 
     EXPECT_CALL(test_light, OffNoRefresh(_)).Times(AtLeast(1)).WillRepeatedly(Return(true));
-    test_light.getState()["state"]["on"] = false;
+    test_light.getMutableState().on = false;
     EXPECT_EQ(true, SimpleColorHueStrategy().alertHueSaturation(200, 100, test_light));
 
     EXPECT_CALL(test_light, setColorHueSaturation(_, _, 1))
         .Times(AtLeast(2))
         .WillOnce(Return(false))
         .WillRepeatedly(Return(true));
-    test_light.getState()["state"]["colormode"] = "xy";
-    test_light.getState()["state"]["on"] = true;
-    test_light.getState()["state"]["xy"][0] = 0.1;
-    test_light.getState()["state"]["xy"][1] = 0.1;
+    test_light.getMutableState().colormode = ColorMode::XY;
+    test_light.getMutableState().on = true;
+    test_light.getMutableState().xy.x = 0.1f;
+    test_light.getMutableState().xy.y = 0.1f;
     EXPECT_EQ(false, SimpleColorHueStrategy().alertHueSaturation(200, 100, test_light));
 
     EXPECT_CALL(test_light, alert()).Times(AtLeast(2)).WillOnce(Return(false)).WillRepeatedly(Return(true));
@@ -266,7 +322,7 @@ TEST(SimpleColorHueStrategy, alertHueSaturation)
     EXPECT_EQ(true, SimpleColorHueStrategy().alertHueSaturation(200, 100, test_light));
 
     EXPECT_CALL(test_light, OffNoRefresh(_)).Times(AtLeast(1)).WillRepeatedly(Return(true));
-    test_light.getState()["state"]["on"] = false;
+    test_light.getMutableState().on = false;
     EXPECT_EQ(true, SimpleColorHueStrategy().alertHueSaturation(200, 100, test_light));
 }
 
@@ -281,32 +337,37 @@ TEST(SimpleColorHueStrategy, alertXY)
     MockHueLight test_light(handler);
     EXPECT_CALL(test_light, refreshState()).Times(AtLeast(1)).WillRepeatedly(Return());
 
-    test_light.getState()["state"]["colormode"] = "invalid";
-    test_light.getState()["state"]["on"] = false;
+    test_light.getMutableState().colormode = ColorMode::NONE;
+    test_light.getMutableState().on = false;
     EXPECT_EQ(false, SimpleColorHueStrategy().alertXY(0.1f, 0.1f, test_light));
 
     EXPECT_CALL(test_light, setColorXY(_, _, 1)).Times(AtLeast(2)).WillOnce(Return(false)).WillRepeatedly(Return(true));
-    test_light.getState()["state"]["colormode"] = "hs";
-    test_light.getState()["state"]["on"] = true;
-    test_light.getState()["state"]["xy"][0] = 0.1;
-    test_light.getState()["state"]["xy"][1] = 0.1;
-    test_light.getState()["state"]["sat"] = 100;
-    test_light.getState()["state"]["hue"] = 200;
+    test_light.getMutableState().colormode = ColorMode::HS;
+    test_light.getMutableState().on = true;
+    test_light.getMutableState().xy.x = 0.1f;
+    test_light.getMutableState().xy.y = 0.1f;
+    test_light.getMutableState().sat = 100;
+    test_light.getMutableState().hue = 200;
+    // Colors in hue and saturation are restored as xy
+    EXPECT_CALL(test_light, getColorType()).WillRepeatedly(Return(ColorType::GAMUT_C));
+    const XY restored = ColorConversion::hueSaturationToXY(200, 100, ColorType::GAMUT_C);
     EXPECT_EQ(false, SimpleColorHueStrategy().alertXY(0.1f, 0.1f, test_light));
 
     EXPECT_CALL(test_light, alert()).Times(AtLeast(2)).WillOnce(Return(false)).WillRepeatedly(Return(true));
     EXPECT_EQ(false, SimpleColorHueStrategy().alertXY(0.1f, 0.1f, test_light));
 
-    EXPECT_CALL(test_light, setColorHueSaturation(_, _, 1)).Times(AtLeast(2)).WillRepeatedly(Return(true));
+    EXPECT_CALL(test_light, setColorXY(FloatEq(restored.x), FloatEq(restored.y), 1))
+        .Times(AtLeast(1))
+        .WillRepeatedly(Return(true));
     EXPECT_EQ(true, SimpleColorHueStrategy().alertXY(0.1f, 0.1f, test_light));
 
     EXPECT_CALL(test_light, OffNoRefresh(_)).Times(AtLeast(1)).WillRepeatedly(Return(true));
-    test_light.getState()["state"]["on"] = false;
+    test_light.getMutableState().on = false;
     EXPECT_EQ(true, SimpleColorHueStrategy().alertXY(0.1f, 0.1f, test_light));
 
     EXPECT_CALL(test_light, setColorXY(_, _, 1)).Times(AtLeast(2)).WillOnce(Return(false)).WillRepeatedly(Return(true));
-    test_light.getState()["state"]["colormode"] = "xy";
-    test_light.getState()["state"]["on"] = true;
+    test_light.getMutableState().colormode = ColorMode::XY;
+    test_light.getMutableState().on = true;
     EXPECT_EQ(false, SimpleColorHueStrategy().alertXY(0.1f, 0.1f, test_light));
 
     EXPECT_CALL(test_light, alert()).Times(AtLeast(2)).WillOnce(Return(false)).WillRepeatedly(Return(true));
@@ -315,7 +376,7 @@ TEST(SimpleColorHueStrategy, alertXY)
     EXPECT_EQ(true, SimpleColorHueStrategy().alertXY(0.1f, 0.1f, test_light));
 
     EXPECT_CALL(test_light, OffNoRefresh(_)).Times(AtLeast(1)).WillRepeatedly(Return(true));
-    test_light.getState()["state"]["on"] = false;
+    test_light.getMutableState().on = false;
     EXPECT_EQ(true, SimpleColorHueStrategy().alertXY(0.1f, 0.1f, test_light));
 }
 
@@ -330,38 +391,43 @@ TEST(SimpleColorHueStrategy, alertRGB)
     MockHueLight test_light(handler);
     EXPECT_CALL(test_light, refreshState()).Times(AtLeast(1)).WillRepeatedly(Return());
 
-    test_light.getState()["state"]["colormode"] = "invalid";
-    test_light.getState()["state"]["on"] = false;
+    test_light.getMutableState().colormode = ColorMode::NONE;
+    test_light.getMutableState().on = false;
     EXPECT_EQ(false, SimpleColorHueStrategy().alertRGB(128, 128, 128, test_light));
 
     EXPECT_CALL(test_light, setColorRGB(_, _, _, 1))
         .Times(AtLeast(2))
         .WillOnce(Return(false))
         .WillRepeatedly(Return(true));
-    test_light.getState()["state"]["colormode"] = "hs";
-    test_light.getState()["state"]["on"] = true;
-    test_light.getState()["state"]["sat"] = 100;
-    test_light.getState()["state"]["hue"] = 200;
+    test_light.getMutableState().colormode = ColorMode::HS;
+    test_light.getMutableState().on = true;
+    test_light.getMutableState().sat = 100;
+    test_light.getMutableState().hue = 200;
+    // Colors in hue and saturation are restored as xy
+    EXPECT_CALL(test_light, getColorType()).WillRepeatedly(Return(ColorType::GAMUT_C));
+    const XY restored = ColorConversion::hueSaturationToXY(200, 100, ColorType::GAMUT_C);
     EXPECT_EQ(false, SimpleColorHueStrategy().alertRGB(128, 128, 128, test_light));
 
     EXPECT_CALL(test_light, alert()).Times(AtLeast(2)).WillOnce(Return(false)).WillRepeatedly(Return(true));
     EXPECT_EQ(false, SimpleColorHueStrategy().alertRGB(128, 128, 128, test_light));
 
-    EXPECT_CALL(test_light, setColorHueSaturation(_, _, 1)).Times(AtLeast(2)).WillRepeatedly(Return(true));
+    EXPECT_CALL(test_light, setColorXY(FloatEq(restored.x), FloatEq(restored.y), 1))
+        .Times(AtLeast(1))
+        .WillRepeatedly(Return(true));
     EXPECT_EQ(true, SimpleColorHueStrategy().alertRGB(128, 128, 128, test_light));
 
     EXPECT_CALL(test_light, OffNoRefresh(_)).Times(AtLeast(1)).WillRepeatedly(Return(true));
-    test_light.getState()["state"]["on"] = false;
+    test_light.getMutableState().on = false;
     EXPECT_EQ(true, SimpleColorHueStrategy().alertRGB(128, 128, 128, test_light));
 
     EXPECT_CALL(test_light, setColorRGB(_, _, _, 1))
         .Times(AtLeast(2))
         .WillOnce(Return(false))
         .WillRepeatedly(Return(true));
-    test_light.getState()["state"]["colormode"] = "xy";
-    test_light.getState()["state"]["on"] = true;
-    test_light.getState()["state"]["xy"][0] = 0.1;
-    test_light.getState()["state"]["xy"][1] = 0.1;
+    test_light.getMutableState().colormode = ColorMode::XY;
+    test_light.getMutableState().on = true;
+    test_light.getMutableState().xy.x = 0.1f;
+    test_light.getMutableState().xy.y = 0.1f;
     EXPECT_EQ(false, SimpleColorHueStrategy().alertRGB(128, 128, 128, test_light));
 
     EXPECT_CALL(test_light, alert()).Times(AtLeast(2)).WillOnce(Return(false)).WillRepeatedly(Return(true));
@@ -371,7 +437,7 @@ TEST(SimpleColorHueStrategy, alertRGB)
     EXPECT_EQ(true, SimpleColorHueStrategy().alertRGB(128, 128, 128, test_light));
 
     EXPECT_CALL(test_light, OffNoRefresh(_)).Times(AtLeast(1)).WillRepeatedly(Return(true));
-    test_light.getState()["state"]["on"] = false;
+    test_light.getMutableState().on = false;
     EXPECT_EQ(true, SimpleColorHueStrategy().alertRGB(128, 128, 128, test_light));
 }
 
@@ -386,12 +452,12 @@ TEST(SimpleColorHueStrategy, getColorHueSaturation)
     MockHueLight test_light(handler);
     EXPECT_CALL(test_light, refreshState()).Times(AtLeast(1)).WillRepeatedly(Return());
 
-    test_light.getState()["state"]["hue"] = 5000;
-    test_light.getState()["state"]["sat"] = 128;
+    test_light.getMutableState().hue = 5000;
+    test_light.getMutableState().sat = 128;
     EXPECT_EQ(std::make_pair(static_cast<uint16_t>(5000), static_cast<uint8_t>(128)),
         SimpleColorHueStrategy().getColorHueSaturation(test_light));
-    test_light.getState()["state"]["hue"] = 50000;
-    test_light.getState()["state"]["sat"] = 158;
+    test_light.getMutableState().hue = 50000;
+    test_light.getMutableState().sat = 158;
     EXPECT_EQ(std::make_pair(static_cast<uint16_t>(50000), static_cast<uint8_t>(158)),
         SimpleColorHueStrategy().getColorHueSaturation(static_cast<const HueLight>(test_light)));
 }
@@ -407,12 +473,12 @@ TEST(SimpleColorHueStrategy, getColorXY)
     MockHueLight test_light(handler);
     EXPECT_CALL(test_light, refreshState()).Times(AtLeast(1)).WillRepeatedly(Return());
 
-    test_light.getState()["state"]["xy"][0] = 0.1234;
-    test_light.getState()["state"]["xy"][1] = 0.1234;
+    test_light.getMutableState().xy.x = 0.1234f;
+    test_light.getMutableState().xy.y = 0.1234f;
     EXPECT_EQ(std::make_pair(static_cast<float>(0.1234), static_cast<float>(0.1234)),
         SimpleColorHueStrategy().getColorXY(test_light));
-    test_light.getState()["state"]["xy"][0] = 0.12;
-    test_light.getState()["state"]["xy"][1] = 0.6458;
+    test_light.getMutableState().xy.x = 0.12f;
+    test_light.getMutableState().xy.y = 0.6458f;
     EXPECT_EQ(std::make_pair(static_cast<float>(0.12), static_cast<float>(0.6458)),
         SimpleColorHueStrategy().getColorXY(static_cast<const HueLight>(test_light)));
 }
@@ -55,21 +55,21 @@ TEST(SimpleColorTemperatureStrategy, setColorTemperature)
     prep_ret[2] = nlohmann::json::object();
     prep_ret[2]["success"] = nlohmann::json::object();
     prep_ret[2]["success"]["/lights/1/state/ct"] = 155;
-    EXPECT_CALL(test_light, SendPutRequest(_, "/state", _)).Times(1).WillOnce(Return(prep_ret));
+    EXPECT_CALL(test_light, SendStateRequest(_, _)).Times(1).WillOnce(Invoke(ValidateAgainst(prep_ret)));
 
-    test_light.getState()["state"]["on"] = true;
-    test_light.getState()["state"]["ct"] = 200;
+    test_light.getMutableState().on = true;
+    test_light.getMutableState().ct = 200;
     EXPECT_EQ(true, SimpleColorTemperatureStrategy().setColorTemperature(200, 4, test_light));
 
-    test_light.getState()["state"]["on"] = false;
+    test_light.getMutableState().on = false;
     EXPECT_EQ(true, SimpleColorTemperatureStrategy().setColorTemperature(155, 6, test_light));
 
     prep_ret[2]["success"]["/lights/1/state/ct"] = 153;
-    EXPECT_CALL(test_light, SendPutRequest(_, "/state", _)).Times(1).WillOnce(Return(prep_ret));
+    EXPECT_CALL(test_light, SendStateRequest(_, _)).Times(1).WillOnce(Invoke(ValidateAgainst(prep_ret)));
     EXPECT_EQ(true, SimpleColorTemperatureStrategy().setColorTemperature(0, 6, test_light));
 
     prep_ret[2]["success"]["/lights/1/state/ct"] = 500;
-    EXPECT_CALL(test_light, SendPutRequest(_, "/state", _)).Times(1).WillOnce(Return(prep_ret));
+    EXPECT_CALL(test_light, SendStateRequest(_, _)).Times(1).WillOnce(Invoke(ValidateAgainst(prep_ret)));
     EXPECT_EQ(true, SimpleColorTemperatureStrategy().setColorTemperature(600, 6, test_light));
 }
 
@@ -84,17 +84,17 @@ TEST(SimpleColorTemperatureStrategy, alertTemperature)
     MockHueLight test_light(handler);
     EXPECT_CALL(test_light, refreshState()).Times(AtLeast(1)).WillRepeatedly(Return());
 
-    test_light.getState()["state"]["colormode"] = "invalid";
-    test_light.getState()["state"]["on"] = false;
+    test_light.getMutableState().colormode = ColorMode::NONE;
+    test_light.getMutableState().on = false;
     EXPECT_EQ(false, SimpleColorTemperatureStrategy().alertTemperature(400, test_light));
 
     EXPECT_CALL(test_light, setColorTemperature(_, _))
         .Times(AtLeast(2))
         .WillOnce(Return(false))
         .WillRepeatedly(Return(true));
-    test_light.getState()["state"]["colormode"] = "ct";
-    test_light.getState()["state"]["on"] = true;
-    test_light.getState()["state"]["ct"] = 200;
+    test_light.getMutableState().colormode = ColorMode::CT;
+    test_light.getMutableState().on = true;
+    test_light.getMutableState().ct = 200;
     EXPECT_EQ(false, SimpleColorTemperatureStrategy().alertTemperature(400, test_light));
 
     EXPECT_CALL(test_light, alert()).Times(AtLeast(2)).WillOnce(Return(false)).WillRepeatedly(Return(true));
@@ -103,7 +103,7 @@ TEST(SimpleColorTemperatureStrategy, alertTemperature)
     EXPECT_EQ(true, SimpleColorTemperatureStrategy().alertTemperature(400, test_light));
 
     EXPECT_CALL(test_light, OffNoRefresh(_)).Times(AtLeast(1)).WillRepeatedly(Return(true));
-    test_light.getState()["state"]["on"] = false;
+    test_light.getMutableState().on = false;
     EXPECT_EQ(true, SimpleColorTemperatureStrategy().alertTemperature(400, test_light));
 }
 
@@ -118,8 +118,8 @@ TEST(SimpleColorTemperatureStrategy, getColorTemperature)
     MockHueLight test_light(handler);
     EXPECT_CALL(test_light, refreshState()).Times(AtLeast(1)).WillRepeatedly(Return());
 
-    test_light.getState()["state"]["ct"] = 200;
+    test_light.getMutableState().ct = 200;
     EXPECT_EQ(200, SimpleColorTemperatureStrategy().getColorTemperature(test_light));
-    test_light.getState()["state"]["ct"] = 500;
+    test_light.getMutableState().ct = 500;
     EXPECT_EQ(500, SimpleColorTemperatureStrategy().getColorTemperature(static_cast<const HueLight>(test_light)));
 }
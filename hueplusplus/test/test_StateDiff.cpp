@@ -0,0 +1,206 @@
+/**
+    \file test_StateDiff.cpp
+    Copyright Notice\n
+    Copyright (C) 2017  Jan Rogall		- developer\n
+    Copyright (C) 2017  Moritz Wirger	- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "testhelper.h"
+
+#include "../include/Hue.h"
+#include "../include/StateDiff.h"
+#include "../include/json/json.hpp"
+#include "mocks/mock_HttpHandler.h"
+
+namespace
+{
+    nlohmann::json getTestState()
+    {
+        return nlohmann::json{{"lights",
+                                  {{"1",
+                                      {{"state", {{"on", true}, {"bri", 254}, {"xy", {0.3, 0.3}}, {"reachable", true}}},
+                                          {"name", "Lamp 1"}, {"modelid", "LCT001"}}}}},
+            {"groups", {{"1", {{"name", "Room"}, {"action", {{"on", true}}}}}}},
+            {"sensors", {{"2", {{"state", {{"buttonevent", 1002}}}, {"config", {{"on", true}}}}}}},
+            {"config", {{"name", "Bridge"}}}};
+    }
+} // namespace
+
+TEST(StateDiff, compareEqual)
+{
+    const nlohmann::json state = getTestState();
+    EXPECT_TRUE(StateDiff::compare(state, state).empty());
+    EXPECT_TRUE(StateDiff::compare(nullptr, nullptr).empty());
+}
+
+TEST(StateDiff, compareAttributes)
+{
+    const nlohmann::json previous = getTestState();
+    nlohmann::json current = getTestState();
+    current["lights"]["1"]["state"]["on"] = false;
+    current["lights"]["1"]["state"]["xy"] = {0.4, 0.3};
+    current["lights"]["1"]["state"].erase("reachable");
+    current["lights"]["1"]["state"]["effect"] = "none";
+    current["sensors"]["2"]["state"]["buttonevent"] = 2002;
+    // Not a light, group or sensor
+    current["config"]["name"] = "Other";
+
+    std::vector<StateChange> changes = StateDiff::compare(previous, current);
+    ASSERT_EQ(5, changes.size());
+
+    EXPECT_EQ(ResourceType::LIGHT, changes[0].resource);
+    EXPECT_EQ(1, changes[0].id);
+    EXPECT_EQ("state/on", changes[0].attribute);
+    EXPECT_EQ(true, changes[0].oldValue);
+    EXPECT_EQ(false, changes[0].newValue);
+
+    EXPECT_EQ("state/reachable", changes[1].attribute);
+    EXPECT_EQ(true, changes[1].oldValue);
+    EXPECT_TRUE(changes[1].newValue.is_null());
+
+    EXPECT_EQ("state/xy", changes[2].attribute);
+    EXPECT_EQ((nlohmann::json{0.3, 0.3}), changes[2].oldValue);
+    EXPECT_EQ((nlohmann::json{0.4, 0.3}), changes[2].newValue);
+
+    EXPECT_EQ("state/effect", changes[3].attribute);
+    EXPECT_TRUE(changes[3].oldValue.is_null());
+    EXPECT_EQ("none", changes[3].newValue);
+
+    EXPECT_EQ(ResourceType::SENSOR, changes[4].resource);
+    EXPECT_EQ(2, changes[4].id);
+    EXPECT_EQ("state/buttonevent", changes[4].attribute);
+    EXPECT_EQ(1002, changes[4].oldValue);
+    EXPECT_EQ(2002, changes[4].newValue);
+}
+
+TEST(StateDiff, compareResources)
+{
+    const nlohmann::json previous = getTestState();
+    nlohmann::json current = getTestState();
+    current["groups"].erase("1");
+    current["groups"]["2"] = {{"name", "New room"}};
+
+    std::vector<StateChange> changes = StateDiff::compare(previous, current);
+    ASSERT_EQ(2, changes.size());
+
+    EXPECT_EQ(ResourceType::GROUP, changes[0].resource);
+    EXPECT_EQ(1, changes[0].id);
+    EXPECT_EQ("", changes[0].attribute);
+    EXPECT_EQ(previous["groups"]["1"], changes[0].oldValue);
+    EXPECT_TRUE(changes[0].newValue.is_null());
+
+    EXPECT_EQ(ResourceType::GROUP, changes[1].resource);
+    EXPECT_EQ(2, changes[1].id);
+    EXPECT_EQ("", changes[1].attribute);
+    EXPECT_TRUE(changes[1].oldValue.is_null());
+    EXPECT_EQ(current["groups"]["2"], changes[1].newValue);
+}
+
+TEST(StateDiff, subscribe)
+{
+    StateDiff diff;
+    std::vector<StateChange> all;
+    std::vector<StateChange> lights;
+    int allHandle = diff.subscribe([&](const StateChange& change) { all.push_back(change); });
+    diff.subscribe(ResourceType::LIGHT, [&](const StateChange& change) { lights.push_back(change); });
+
+    const nlohmann::json previous = getTestState();
+    nlohmann::json current = getTestState();
+    current["lights"]["1"]["state"]["bri"] = 100;
+    current["groups"]["1"]["action"]["on"] = false;
+
+    std::vector<StateChange> changes = diff.update(previous, current);
+    EXPECT_EQ(2, changes.size());
+    ASSERT_EQ(2, all.size());
+    ASSERT_EQ(1, lights.size());
+    EXPECT_EQ("state/bri", lights[0].attribute);
+    EXPECT_EQ(254, lights[0].oldValue);
+    EXPECT_EQ(100, lights[0].newValue);
+    EXPECT_EQ(ResourceType::GROUP, all[1].resource);
+    EXPECT_EQ("action/on", all[1].attribute);
+
+    diff.unsubscribe(allHandle);
+    diff.update(current, previous);
+    EXPECT_EQ(2, all.size());
+    EXPECT_EQ(2, lights.size());
+}
+
+TEST(StateDiff, HueRefresh)
+{
+    using namespace ::testing;
+    std::shared_ptr<MockHttpHandler> handler = std::make_shared<MockHttpHandler>();
+    nlohmann::json previous = getTestState();
+    nlohmann::json current = getTestState();
+    current["lights"]["1"]["state"]["on"] = false;
+    EXPECT_CALL(
+        *handler, GETJson("/api/" + getBridgeUsername(), nlohmann::json::object(), getBridgeIp(), getBridgePort()))
+        .Times(2)
+        .WillOnce(Return(previous))
+        .WillOnce(Return(current));
+
+    Hue test_bridge(getBridgeIp(), getBridgePort(), getBridgeUsername(), handler);
+    std::vector<StateChange> changes;
+    test_bridge.getStateDiff().subscribe([&](const StateChange& change) { changes.push_back(change); });
+
+    // First refresh has nothing to compare to
+    test_bridge.lightExists(1);
+    EXPECT_TRUE(changes.empty());
+
+    test_bridge.lightExists(1);
+    ASSERT_EQ(1, changes.size());
+    EXPECT_EQ(ResourceType::LIGHT, changes[0].resource);
+    EXPECT_EQ(1, changes[0].id);
+    EXPECT_EQ("state/on", changes[0].attribute);
+}
+
+TEST(StateDiff, HueRefreshWithoutSubscribers)
+{
+    using namespace ::testing;
+    std::shared_ptr<MockHttpHandler> handler = std::make_shared<MockHttpHandler>();
+    nlohmann::json first = getTestState();
+    nlohmann::json second = getTestState();
+    second["lights"]["1"]["state"]["on"] = false;
+    nlohmann::json third = second;
+    third["lights"]["1"]["state"]["bri"] = 1;
+    EXPECT_CALL(
+        *handler, GETJson("/api/" + getBridgeUsername(), nlohmann::json::object(), getBridgeIp(), getBridgePort()))
+        .Times(3)
+        .WillOnce(Return(first))
+        .WillOnce(Return(second))
+        .WillOnce(Return(third));
+
+    Hue test_bridge(getBridgeIp(), getBridgePort(), getBridgeUsername(), handler);
+    test_bridge.lightExists(1);
+
+    // The state is not kept without subscribers, so the change to second is not reported
+    std::vector<StateChange> changes;
+    test_bridge.getStateDiff().subscribe([&](const StateChange& change) { changes.push_back(change); });
+    test_bridge.lightExists(1);
+    EXPECT_TRUE(changes.empty());
+
+    test_bridge.lightExists(1);
+    ASSERT_EQ(1, changes.size());
+    EXPECT_EQ("state/bri", changes[0].attribute);
+}
@@ -0,0 +1,148 @@
+/**
+    \file test_StateRequest.cpp
+    Copyright Notice\n
+    Copyright (C) 2018  Jan Rogall		- developer\n
+    Copyright (C) 2018  Moritz Wirger	- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include <clocale>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "../include/StateRequest.h"
+#include "../include/json/json.hpp"
+
+TEST(StateRequest, empty)
+{
+    StateRequest request;
+    EXPECT_TRUE(request.empty());
+    EXPECT_FALSE(request.has(StateRequest::ON));
+    std::string out = "previous";
+    request.serialize(out);
+    EXPECT_EQ("{}", out);
+    EXPECT_EQ(nlohmann::json::object(), request.toJson());
+}
+
+TEST(StateRequest, serialize)
+{
+    StateRequest request;
+    request.setOn(true);
+    request.setBrightness(200);
+    EXPECT_FALSE(request.empty());
+    EXPECT_TRUE(request.has(StateRequest::ON));
+    EXPECT_TRUE(request.has(StateRequest::BRI));
+    EXPECT_FALSE(request.has(StateRequest::HUE));
+    std::string out;
+    request.serialize(out);
+    EXPECT_EQ("{\"bri\":200,\"on\":true}", out);
+
+    request.setHue(65534);
+    request.setSaturation(0);
+    request.setXY(0.3127f, 0.329f);
+    request.setColorTemperature(153);
+    request.setAlert(Alert::LSELECT);
+    request.setEffect(Effect::COLORLOOP);
+    request.setTransition(4000);
+    request.setOn(false);
+    request.serialize(out);
+    EXPECT_EQ(request.toJson().dump(), out);
+    EXPECT_EQ(request.toJson(), nlohmann::json::parse(out));
+    EXPECT_EQ((nlohmann::json{{"on", false}, {"bri", 200}, {"hue", 65534}, {"sat", 0}, {"xy", {0.3127f, 0.329f}},
+                  {"ct", 153}, {"alert", "lselect"}, {"effect", "colorloop"}, {"transitiontime", 4000}}),
+        nlohmann::json::parse(out));
+
+    request = StateRequest();
+    request.setEffect(Effect::NONE);
+    request.setAlert(Alert::NONE);
+    request.serialize(out);
+    EXPECT_EQ("{\"alert\":\"none\",\"effect\":\"none\"}", out);
+}
+
+TEST(StateRequest, serializeXY)
+{
+    const float values[] = {0.0f, 1.0f, 0.1f, 0.3333333f, 0.7f, 1E-5f, -0.25f};
+    std::string out;
+    for (float x : values)
+    {
+        StateRequest request;
+        request.setXY(x, 1.0f - x);
+        request.serialize(out);
+        EXPECT_EQ(request.toJson().dump(), out);
+        nlohmann::json parsed = nlohmann::json::parse(out);
+        EXPECT_EQ(x, parsed["xy"][0].get<float>());
+        EXPECT_EQ(1.0f - x, parsed["xy"][1].get<float>());
+    }
+}
+
+TEST(StateRequest, serializeLocale)
+{
+    // Decimal separator of the locale must not be used
+    const char* previous = std::setlocale(LC_NUMERIC, nullptr);
+    const std::string previousLocale = previous ? previous : "C";
+    if (!std::setlocale(LC_NUMERIC, "de_DE.UTF-8"))
+    {
+        std::setlocale(LC_NUMERIC, "C");
+    }
+    StateRequest request;
+    request.setXY(0.5f, 0.25f);
+    std::string out;
+    request.serialize(out);
+    std::setlocale(LC_NUMERIC, previousLocale.c_str());
+    EXPECT_EQ("{\"xy\":[0.5,0.25]}", out);
+}
+
+TEST(StateRequest, applyTo)
+{
+    LightState state;
+    state.on = false;
+    state.bri = 10;
+    state.ct = 300;
+    state.colormode = ColorMode::CT;
+    state.alert = Alert::NONE;
+    state.members = LightState::ON | LightState::BRI | LightState::CT | LightState::COLORMODE;
+
+    StateRequest request;
+    request.setOn(true);
+    request.setXY(0.25f, 0.5f);
+    request.setAlert(Alert::SELECT);
+    request.setTransition(0);
+    request.applyTo(state);
+    EXPECT_TRUE(state.on);
+    EXPECT_EQ(10, state.bri);
+    EXPECT_EQ(300, state.ct);
+    EXPECT_EQ(ColorMode::XY, state.colormode);
+    EXPECT_EQ(0.25f, state.xy.x);
+    EXPECT_EQ(0.5f, state.xy.y);
+    EXPECT_TRUE(state.has(LightState::XY));
+    EXPECT_FALSE(state.has(LightState::HUE));
+    // The bridge ends alerts by itself
+    EXPECT_EQ(Alert::NONE, state.alert);
+    EXPECT_FALSE(state.has(LightState::ALERT));
+
+    request = StateRequest();
+    request.setHue(100);
+    request.setSaturation(200);
+    request.setEffect(Effect::COLORLOOP);
+    request.applyTo(state);
+    EXPECT_EQ(ColorMode::HS, state.colormode);
+    EXPECT_EQ(100, state.hue);
+    EXPECT_EQ(200, state.sat);
+    EXPECT_EQ(Effect::COLORLOOP, state.effect);
+    EXPECT_TRUE(state.has(LightState::EFFECT));
+}
@@ -0,0 +1,252 @@
+/**
+    \file test_TransitionEngine.cpp
+    Copyright Notice\n
+    Copyright (C) 2017  Jan Rogall		- developer\n
+    Copyright (C) 2017  Moritz Wirger	- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include <memory>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "testhelper.h"
+
+#include "../include/ColorConversion.h"
+#include "../include/HueExceptionMacro.h"
+#include "../include/TransitionEngine.h"
+#include "mocks/mock_HttpHandler.h"
+#include "mocks/mock_HueLight.h"
+
+namespace
+{
+    // Largest distance between the fade of the bridge and the planned path
+    float getPlanError(const std::vector<TransitionKeyframe>& keyframes, TransitionColor from, TransitionColor to,
+        int steps, ColorType colorType)
+    {
+        float error = 0.0f;
+        TransitionColor shown = TransitionEngine::interpolate(from, to, 0.0f, colorType);
+        for (const TransitionKeyframe& keyframe : keyframes)
+        {
+            const int start = static_cast<int>(keyframe.time.count() / 100);
+            for (int i = 1; i < 10; ++i)
+            {
+                const float u = i / 10.0f;
+                const TransitionColor faded{{shown.xy.x + (keyframe.color.xy.x - shown.xy.x) * u,
+                                                shown.xy.y + (keyframe.color.xy.y - shown.xy.y) * u},
+                    static_cast<uint8_t>(shown.bri + (keyframe.color.bri - shown.bri) * u + 0.5f)};
+                const TransitionColor planned
+                    = TransitionEngine::interpolate(from, to, (start + keyframe.transition * u) / steps, colorType);
+                error = std::max(error, TransitionEngine::distance(faded, planned));
+            }
+            shown = keyframe.color;
+        }
+        return error;
+    }
+} // namespace
+
+TEST(TransitionEngine, Constructor)
+{
+    TransitionEngine engine;
+    EXPECT_FLOAT_EQ(0.02f, engine.getMaxError());
+    EXPECT_EQ(std::chrono::milliseconds(100), engine.getMinInterval());
+    // Never faster than the bridge allows
+    EXPECT_EQ(std::chrono::milliseconds(100), TransitionEngine(0.01f, std::chrono::milliseconds(0)).getMinInterval());
+    // Whole transition time units
+    EXPECT_EQ(std::chrono::milliseconds(200), TransitionEngine(0.01f, std::chrono::milliseconds(150)).getMinInterval());
+}
+
+TEST(TransitionEngine, interpolate)
+{
+    const TransitionColor red{{0.675f, 0.322f}, 254};
+    const TransitionColor blue{{0.167f, 0.04f}, 100};
+    TransitionColor color = TransitionEngine::interpolate(red, blue, 0.0f, ColorType::GAMUT_B);
+    EXPECT_NEAR(red.xy.x, color.xy.x, 1e-4f);
+    EXPECT_NEAR(red.xy.y, color.xy.y, 1e-4f);
+    EXPECT_EQ(red.bri, color.bri);
+    color = TransitionEngine::interpolate(red, blue, 1.0f, ColorType::GAMUT_B);
+    EXPECT_NEAR(blue.xy.x, color.xy.x, 1e-4f);
+    EXPECT_NEAR(blue.xy.y, color.xy.y, 1e-4f);
+    EXPECT_EQ(blue.bri, color.bri);
+    // Perceptual middle is between both colors and inside of the gamut
+    color = TransitionEngine::interpolate(red, blue, 0.5f, ColorType::GAMUT_B);
+    EXPECT_LT(blue.bri, color.bri);
+    EXPECT_GT(red.bri, color.bri);
+    EXPECT_TRUE(ColorConversion::isInGamut(color.xy, *ColorConversion::getGamut(ColorType::GAMUT_B)));
+    EXPECT_NEAR(TransitionEngine::distance(red, color), TransitionEngine::distance(color, blue), 0.01f);
+
+    // Fading in from black keeps the chromaticity
+    const TransitionColor black{{0.3f, 0.3f}, 0};
+    color = TransitionEngine::interpolate(black, red, 0.5f, ColorType::GAMUT_B);
+    EXPECT_NEAR(red.xy.x, color.xy.x, 1e-3f);
+    EXPECT_NEAR(red.xy.y, color.xy.y, 1e-3f);
+    EXPECT_LT(0, color.bri);
+    EXPECT_GT(254, color.bri);
+
+    // Colors are clamped to the gamut
+    color = TransitionEngine::interpolate({{0.1f, 0.1f}, 254}, {{0.1f, 0.1f}, 254}, 0.5f, ColorType::GAMUT_B);
+    EXPECT_TRUE(ColorConversion::isInGamut(color.xy, *ColorConversion::getGamut(ColorType::GAMUT_B)));
+}
+
+TEST(TransitionEngine, getColor)
+{
+    LightState state;
+    state.on = true;
+    state.bri = 200;
+    state.colormode = ColorMode::XY;
+    state.xy = {0.4f, 0.5f};
+    TransitionColor color = TransitionEngine::getColor(state, ColorType::NONE);
+    EXPECT_EQ(0.4f, color.xy.x);
+    EXPECT_EQ(0.5f, color.xy.y);
+    EXPECT_EQ(200, color.bri);
+
+    state.colormode = ColorMode::CT;
+    state.ct = 366;
+    color = TransitionEngine::getColor(state, ColorType::NONE);
+    EXPECT_EQ(ColorConversion::colorTemperatureToXY(366).x, color.xy.x);
+
+    state.colormode = ColorMode::HS;
+    state.hue = 0;
+    state.sat = 254;
+    color = TransitionEngine::getColor(state, ColorType::NONE);
+    EXPECT_EQ(ColorConversion::rgbToXY(255, 0, 0).x, color.xy.x);
+    // Hue and saturation are clamped to the gamut of the light
+    color = TransitionEngine::getColor(state, ColorType::GAMUT_A);
+    EXPECT_EQ(ColorConversion::clampToGamut(ColorConversion::rgbToXY(255, 0, 0), ColorType::GAMUT_A).x, color.xy.x);
+
+    // Light that is off fades in from black
+    state.on = false;
+    EXPECT_EQ(0, TransitionEngine::getColor(state, ColorType::NONE).bri);
+}
+
+TEST(TransitionEngine, plan)
+{
+    const TransitionEngine engine;
+    const TransitionColor red{{0.6915f, 0.3083f}, 254};
+    const TransitionColor blue{{0.1532f, 0.0475f}, 254};
+
+    // No duration
+    std::vector<TransitionKeyframe> keyframes
+        = engine.plan(red, blue, std::chrono::milliseconds(0), ColorType::GAMUT_C);
+    ASSERT_EQ(1u, keyframes.size());
+    EXPECT_EQ(0, keyframes[0].transition);
+    EXPECT_EQ(blue.xy.x, keyframes[0].color.xy.x);
+
+    // Same color needs one request
+    keyframes = engine.plan(red, red, std::chrono::milliseconds(5000), ColorType::GAMUT_C);
+    ASSERT_EQ(1u, keyframes.size());
+    EXPECT_EQ(50, keyframes[0].transition);
+
+    // Brightness change only, the bridge fades linearly but the path is perceptually uniform
+    // The check rounds the brightness, which adds some error
+    const float tolerance = engine.getMaxError() + 0.01f;
+    keyframes = engine.plan({red.xy, 20}, red, std::chrono::milliseconds(3000), ColorType::GAMUT_C);
+    EXPECT_GT(keyframes.size(), 1u);
+    EXPECT_LE(getPlanError(keyframes, {red.xy, 20}, red, 30, ColorType::GAMUT_C), tolerance);
+
+    keyframes = engine.plan(red, blue, std::chrono::milliseconds(2000), ColorType::GAMUT_C);
+    ASSERT_GT(keyframes.size(), 1u);
+    int total = 0;
+    for (std::size_t i = 0; i < keyframes.size(); ++i)
+    {
+        EXPECT_EQ(total * 100, keyframes[i].time.count());
+        EXPECT_GE(keyframes[i].transition, 1);
+        total += keyframes[i].transition;
+    }
+    EXPECT_EQ(20, total);
+    EXPECT_EQ(blue.xy.x, keyframes.back().color.xy.x);
+    EXPECT_EQ(blue.xy.y, keyframes.back().color.xy.y);
+    EXPECT_EQ(blue.bri, keyframes.back().color.bri);
+    EXPECT_LE(getPlanError(keyframes, red, blue, 20, ColorType::GAMUT_C), tolerance);
+
+    // Higher tolerance needs fewer requests
+    const std::vector<TransitionKeyframe> coarse
+        = TransitionEngine(0.1f).plan(red, blue, std::chrono::milliseconds(2000), ColorType::GAMUT_C);
+    EXPECT_LT(coarse.size(), keyframes.size());
+
+    // Rate budget is respected even if the error gets larger
+    const TransitionEngine slowEngine(0.001f, std::chrono::milliseconds(500));
+    const std::vector<TransitionKeyframe> slow
+        = slowEngine.plan(red, blue, std::chrono::milliseconds(2000), ColorType::GAMUT_C);
+    ASSERT_EQ(4u, slow.size());
+    for (std::size_t i = 1; i < slow.size(); ++i)
+    {
+        EXPECT_EQ(500, (slow[i].time - slow[i - 1].time).count());
+    }
+}
+
+TEST(TransitionEngine, run)
+{
+    using namespace ::testing;
+    std::shared_ptr<MockHttpHandler> handler(std::make_shared<MockHttpHandler>());
+    MockHueLight test_light(handler);
+    EXPECT_CALL(test_light, getColorType()).WillRepeatedly(Return(ColorType::GAMUT_C));
+    test_light.getMutableState().on = false;
+    test_light.getMutableState().bri = 254;
+    test_light.getMutableState().colormode = ColorMode::XY;
+    test_light.getMutableState().xy = {0.6915f, 0.3083f};
+
+    const TransitionEngine engine;
+    const TransitionColor blue{{0.1532f, 0.0475f}, 200};
+    const TransitionColor red = TransitionEngine::getColor(test_light.getState(), ColorType::GAMUT_C);
+    const std::vector<TransitionKeyframe> keyframes
+        = engine.plan(red, blue, std::chrono::milliseconds(300), ColorType::GAMUT_C);
+    std::vector<nlohmann::json> requests;
+    EXPECT_CALL(test_light, trySetState(_))
+        .Times(static_cast<int>(keyframes.size()))
+        .WillRepeatedly(Invoke([&](const StateRequest& request) {
+            requests.push_back(request.toJson());
+            return utils::ReplyValidation();
+        }));
+    Result<void> result = engine.run(test_light, blue, std::chrono::milliseconds(300));
+    EXPECT_TRUE(result.ok());
+    ASSERT_EQ(keyframes.size(), requests.size());
+    EXPECT_EQ(true, requests.front()["on"]);
+    EXPECT_EQ(200, requests.back()["bri"]);
+    EXPECT_NEAR(0.1532, requests.back()["xy"][0].get<double>(), 1e-4);
+    EXPECT_EQ(keyframes.back().transition, requests.back()["transitiontime"]);
+
+    // Fading out turns the light off and stops at the first error
+    test_light.getMutableState().on = true;
+    EXPECT_CALL(test_light, trySetState(_))
+        .WillOnce(Invoke([&](const StateRequest& request) {
+            requests.push_back(request.toJson());
+            return utils::ReplyValidation();
+        }))
+        .WillOnce(Return(HueError(CURRENT_FILE_INFO, "Failed")));
+    result = engine.run(test_light, {blue.xy, 0}, std::chrono::milliseconds(300));
+    EXPECT_FALSE(result.ok());
+
+    EXPECT_CALL(test_light, trySetState(_)).WillRepeatedly(Invoke([&](const StateRequest& request) {
+        requests.push_back(request.toJson());
+        return utils::ReplyValidation();
+    }));
+    result = engine.run(test_light, {blue.xy, 0}, std::chrono::milliseconds(0));
+    EXPECT_TRUE(result.ok());
+    EXPECT_EQ(false, requests.back()["on"]);
+    EXPECT_EQ(0u, requests.back().count("bri"));
+
+    // Lights without xy colors are rejected before anything is sent
+    for (ColorType colorType : {ColorType::UNDEFINED, ColorType::NONE, ColorType::TEMPERATURE})
+    {
+        EXPECT_CALL(test_light, getColorType()).WillRepeatedly(Return(colorType));
+        EXPECT_CALL(test_light, trySetState(_)).Times(0);
+        EXPECT_FALSE(engine.run(test_light, blue, std::chrono::milliseconds(300)).ok());
+    }
+}
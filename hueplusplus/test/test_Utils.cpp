@@ -0,0 +1,110 @@
+/**
+    \file test_Utils.cpp
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+    Copyright (C) 2020  Moritz Wirger	- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include <gtest/gtest.h>
+
+#include "../include/Utils.h"
+#include "../include/json/json.hpp"
+
+TEST(Utils, validateReplyForLight)
+{
+    StateRequest request;
+    request.setOn(true);
+    request.setBrightness(200);
+    request.setXY(0.3f, 0.4f);
+    request.setEffect(Effect::COLORLOOP);
+    request.setTransition(10);
+
+    nlohmann::json reply{{{"success", {{"/lights/3/state/on", true}}}}, {{"success", {{"/lights/3/state/bri", 200}}}},
+        {{"success", {{"/lights/3/state/xy", {0.30004, 0.4}}}}},
+        {{"success", {{"/lights/3/state/effect", "colorloop"}}}},
+        {{"success", {{"/lights/3/state/transitiontime", 10}}}}};
+    utils::ReplyValidation result = utils::validateReplyForLight(request, reply, 3);
+    EXPECT_TRUE(result.isSuccess());
+    EXPECT_EQ(0, result.mismatched);
+    EXPECT_FALSE(result.unexpected);
+
+    // Attributes that are not confirmed are not checked
+    reply.erase(4);
+    EXPECT_TRUE(utils::validateReplyForLight(request, reply, 3).isSuccess());
+
+    // Wrong light
+    result = utils::validateReplyForLight(request, reply, 33);
+    EXPECT_FALSE(result.isSuccess());
+    EXPECT_TRUE(result.unexpected);
+    EXPECT_EQ(0, result.mismatched);
+
+    // Empty reply
+    EXPECT_TRUE(utils::validateReplyForLight(request, nlohmann::json::array(), 3).unexpected);
+    EXPECT_TRUE(utils::validateReplyForLight(request, nlohmann::json::object(), 3).unexpected);
+}
+
+TEST(Utils, validateReplyForLightMismatch)
+{
+    StateRequest request;
+    request.setOn(true);
+    request.setBrightness(200);
+    request.setXY(0.3f, 0.4f);
+    request.setAlert(Alert::SELECT);
+
+    nlohmann::json reply{{{"success", {{"/lights/1/state/on", true}}}}, {{"success", {{"/lights/1/state/bri", 100}}}},
+        {{"success", {{"/lights/1/state/xy", {0.31, 0.4}}}}}, {{"success", {{"/lights/1/state/alert", "none"}}}}};
+    utils::ReplyValidation result = utils::validateReplyForLight(request, reply, 1);
+    EXPECT_FALSE(result.isSuccess());
+    EXPECT_FALSE(result.unexpected);
+    EXPECT_FALSE(result.isMismatched(StateRequest::ON));
+    EXPECT_TRUE(result.isMismatched(StateRequest::BRI));
+    EXPECT_TRUE(result.isMismatched(StateRequest::XY));
+    EXPECT_TRUE(result.isMismatched(StateRequest::ALERT));
+
+    // Wrong types
+    reply = {{{"success", {{"/lights/1/state/on", 1}}}}, {{"success", {{"/lights/1/state/xy", {0.3}}}}}};
+    result = utils::validateReplyForLight(request, reply, 1);
+    EXPECT_EQ(StateRequest::ON | StateRequest::XY, result.mismatched);
+}
+
+TEST(Utils, validateReplyForLightUnexpected)
+{
+    StateRequest request;
+    request.setOn(true);
+
+    // Attribute that was not requested
+    nlohmann::json reply{{{"success", {{"/lights/1/state/on", true}}}}, {{"success", {{"/lights/1/state/bri", 1}}}}};
+    EXPECT_TRUE(utils::validateReplyForLight(request, reply, 1).unexpected);
+
+    // Unknown attribute and other paths
+    reply = {{{"success", {{"/lights/1/state/hue_inc", 1}}}}};
+    EXPECT_TRUE(utils::validateReplyForLight(request, reply, 1).unexpected);
+    reply = {{{"success", {{"/lights/1/name", "name"}}}}};
+    EXPECT_TRUE(utils::validateReplyForLight(request, reply, 1).unexpected);
+    reply = {{{"success", {{"/lights//state/on", true}}}}};
+    EXPECT_TRUE(utils::validateReplyForLight(request, reply, 1).unexpected);
+    reply = {{{"success", {{"/lights/12/state/on", true}}}}};
+    EXPECT_TRUE(utils::validateReplyForLight(request, reply, 1).unexpected);
+
+    // Error entry
+    reply = {{{"success", {{"/lights/1/state/on", true}}}},
+        {{"error", {{"type", 201}, {"address", "/lights/1/state/bri"}, {"description", "Device is off"}}}}};
+    utils::ReplyValidation result = utils::validateReplyForLight(request, reply, 1);
+    EXPECT_TRUE(result.unexpected);
+    EXPECT_EQ(0, result.mismatched);
+}
@@ -0,0 +1,249 @@
+/**
+    \file test_ZoneExtractor.cpp
+    Copyright Notice\n
+    Copyright (C) 2017  Jan Rogall		- developer\n
+    Copyright (C) 2017  Moritz Wirger	- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "testhelper.h"
+
+#include "../include/HueException.h"
+#include "../include/ZoneExtractor.h"
+#include "mocks/mock_HttpHandler.h"
+
+namespace
+{
+    // Frame with random pixels and padding after each row
+    std::vector<uint8_t> createFrame(unsigned int height, std::size_t stride)
+    {
+        std::mt19937 random(42);
+        std::uniform_int_distribution<int> component(0, 255);
+        std::vector<uint8_t> frame(stride * height);
+        for (uint8_t& value : frame)
+        {
+            value = static_cast<uint8_t>(component(random));
+        }
+        return frame;
+    }
+
+    RGB referenceAverage(const std::vector<uint8_t>& frame, std::size_t stride, const FrameZone& zone)
+    {
+        uint64_t sums[3] = {0, 0, 0};
+        for (unsigned int row = zone.top; row < zone.top + zone.height; ++row)
+        {
+            for (unsigned int column = zone.left; column < zone.left + zone.width; ++column)
+            {
+                for (int channel = 0; channel < 3; ++channel)
+                {
+                    sums[channel] += frame[row * stride + 3 * column + channel];
+                }
+            }
+        }
+        const uint64_t count = uint64_t(zone.width) * zone.height;
+        return {static_cast<uint8_t>((sums[0] + count / 2) / count),
+            static_cast<uint8_t>((sums[1] + count / 2) / count),
+            static_cast<uint8_t>((sums[2] + count / 2) / count)};
+    }
+} // namespace
+
+TEST(ZoneExtractor, Constructor)
+{
+    ZoneExtractor extractor(64, 48, {{1, 0, 0, 64, 48}, {2, 10, 20, 5, 28}});
+    EXPECT_EQ(64u, extractor.getFrameWidth());
+    EXPECT_EQ(48u, extractor.getFrameHeight());
+    ASSERT_EQ(2u, extractor.getZones().size());
+    EXPECT_EQ(2, extractor.getZones()[1].lightId);
+
+    EXPECT_THROW(ZoneExtractor(64, 48, {{1, 0, 0, 0, 48}}), HueException);
+    EXPECT_THROW(ZoneExtractor(64, 48, {{1, 0, 0, 65, 48}}), HueException);
+    EXPECT_THROW(ZoneExtractor(64, 48, {{1, 60, 0, 5, 48}}), HueException);
+    EXPECT_THROW(ZoneExtractor(64, 48, {{1, 0, 47, 64, 2}}), HueException);
+    EXPECT_THROW(ZoneExtractor(64, 48, {{1, 0, 4294967295u, 64, 2}}), HueException);
+}
+
+TEST(ZoneExtractor, process)
+{
+    // Widths that do not fill whole registers and a row padding
+    const unsigned int width = 101;
+    const unsigned int height = 37;
+    const std::size_t stride = 3 * width + 5;
+    const std::vector<uint8_t> frame = createFrame(height, stride);
+    const std::vector<FrameZone> zones
+        = {{1, 0, 0, width, height}, {2, 3, 5, 5, 3}, {3, 33, 7, 40, 10}, {4, 60, 0, 41, 37}, {5, 100, 36, 1, 1}};
+    ZoneExtractor extractor(width, height, zones);
+
+    const ColorConversion::Simd levels[]
+        = {ColorConversion::Simd::NONE, ColorConversion::Simd::SSE2, ColorConversion::Simd::AVX2};
+    for (ColorConversion::Simd simd : levels)
+    {
+        extractor.process(frame.data(), stride, simd);
+        for (std::size_t i = 0; i < zones.size(); ++i)
+        {
+            const RGB expected = referenceAverage(frame, stride, zones[i]);
+            const RGB color = extractor.getColor(i);
+            EXPECT_EQ(expected.r, color.r) << "simd " << static_cast<int>(simd) << " zone " << i;
+            EXPECT_EQ(expected.g, color.g) << "simd " << static_cast<int>(simd) << " zone " << i;
+            EXPECT_EQ(expected.b, color.b) << "simd " << static_cast<int>(simd) << " zone " << i;
+            const XY xy = ColorConversion::rgbToXY(color.r, color.g, color.b);
+            EXPECT_NEAR(xy.x, extractor.getXY(i).x, 1e-6f);
+            EXPECT_NEAR(xy.y, extractor.getXY(i).y, 1e-6f);
+            const int maxComponent = std::max({color.r, color.g, color.b});
+            EXPECT_NEAR(maxComponent, extractor.getBrightness(i), 1);
+        }
+    }
+
+    // Black uses the lowest brightness, white the highest
+    std::vector<uint8_t> black(stride * height, 0);
+    extractor.process(black.data(), stride);
+    EXPECT_EQ(1, extractor.getBrightness(0));
+    EXPECT_EQ(0.0f, extractor.getXY(0).x);
+    std::vector<uint8_t> white(stride * height, 255);
+    extractor.process(white.data(), stride);
+    EXPECT_EQ(254, extractor.getBrightness(0));
+    EXPECT_NEAR(0.3227f, extractor.getXY(0).x, 1e-3f);
+}
+
+TEST(ZoneExtractor, send)
+{
+    using namespace ::testing;
+    std::shared_ptr<MockHttpHandler> handler(std::make_shared<MockHttpHandler>());
+    nlohmann::json bridge_state = {{"lights", nlohmann::json::object()}};
+    for (const char* id : {"1", "2"})
+    {
+        bridge_state["lights"][id] = {{"state", {{"on", true}, {"bri", 254}, {"colormode", "xy"},
+                                                    {"xy", {0.3, 0.3}}, {"reachable", true}}},
+            {"type", "Extended color light"}, {"name", "Hue lamp"}, {"modelid", "LCT010"}};
+    }
+    bridge_state["lights"]["2"]["state"]["on"] = false;
+    EXPECT_CALL(*handler, GETJson("/api/" + getBridgeUsername(), nlohmann::json::object(), getBridgeIp(), 80))
+        .Times(AtLeast(1))
+        .WillRepeatedly(Return(bridge_state));
+    Hue test_bridge(getBridgeIp(), getBridgePort(), getBridgeUsername(), handler);
+
+    // Left half red, right half blue
+    const unsigned int width = 8;
+    const unsigned int height = 2;
+    std::vector<uint8_t> frame(3 * width * height, 0);
+    for (unsigned int i = 0; i < width * height; ++i)
+    {
+        frame[3 * i + ((i % width) < width / 2 ? 0 : 2)] = 255;
+    }
+    ZoneExtractor extractor(width, height, {{1, 0, 0, width / 2, height}, {2, width / 2, 0, width / 2, height}});
+    extractor.process(frame.data(), 3 * width);
+
+    const XY red = ColorConversion::clampToGamut(extractor.getXY(0), ColorType::GAMUT_C);
+    EXPECT_CALL(*handler, PUTJson("/api/" + getBridgeUsername() + "/lights/1/state", _, getBridgeIp(), 80))
+        .Times(1)
+        .WillOnce(Invoke([&](const std::string&, const nlohmann::json& body, const std::string&, int) {
+            EXPECT_EQ(0u, body.count("on"));
+            EXPECT_NEAR(red.x, body["xy"][0].get<double>(), 1e-4);
+            EXPECT_NEAR(red.y, body["xy"][1].get<double>(), 1e-4);
+            EXPECT_EQ(254, body["bri"]);
+            EXPECT_EQ(1, body["transitiontime"]);
+            return nlohmann::json::array();
+        }));
+    // Light 2 is turned on, its error is returned
+    EXPECT_CALL(*handler, PUTJson("/api/" + getBridgeUsername() + "/lights/2/state", _, getBridgeIp(), 80))
+        .Times(1)
+        .WillOnce(Invoke([](const std::string&, const nlohmann::json& body, const std::string&, int) {
+            EXPECT_EQ(true, body["on"]);
+            EXPECT_EQ(254, body["bri"]);
+            return nlohmann::json{{{"error", {{"type", 201}, {"address", "/lights/2/state/bri"},
+                {"description", "parameter, bri, is not modifiable. Device is set to off."}}}}};
+        }));
+    Result<void> result = extractor.send(test_bridge);
+    EXPECT_FALSE(result.ok());
+    EXPECT_EQ(201, result.getError().getCode());
+}
+
+TEST(ZoneExtractor, sendBlack)
+{
+    using namespace ::testing;
+    std::shared_ptr<MockHttpHandler> handler(std::make_shared<MockHttpHandler>());
+    nlohmann::json bridge_state = {{"lights", nlohmann::json::object()}};
+    for (const char* id : {"1", "2"})
+    {
+        bridge_state["lights"][id] = {{"state", {{"on", true}, {"bri", 254}, {"colormode", "xy"},
+                                                    {"xy", {0.3, 0.3}}, {"reachable", true}}},
+            {"type", "Extended color light"}, {"name", "Hue lamp"}, {"modelid", "LCT010"}};
+    }
+    bridge_state["lights"]["2"]["state"]["on"] = false;
+    EXPECT_CALL(*handler, GETJson("/api/" + getBridgeUsername(), nlohmann::json::object(), getBridgeIp(), 80))
+        .Times(AtLeast(1))
+        .WillRepeatedly(Return(bridge_state));
+    Hue test_bridge(getBridgeIp(), getBridgePort(), getBridgeUsername(), handler);
+
+    // Left half black like a letterbox bar, right half almost black
+    const unsigned int width = 8;
+    const unsigned int height = 2;
+    std::vector<uint8_t> frame(3 * width * height, 0);
+    for (unsigned int i = 0; i < width * height; ++i)
+    {
+        if ((i % width) >= width / 2)
+        {
+            frame[3 * i] = 3;
+            frame[3 * i + 1] = 1;
+        }
+    }
+    ZoneExtractor extractor(width, height, {{1, 0, 0, width / 2, height}, {2, width / 2, 0, width / 2, height}});
+    extractor.process(frame.data(), 3 * width);
+
+    // Light 1 is turned off instead of showing the blue corner of the gamut
+    EXPECT_CALL(*handler, PUTJson("/api/" + getBridgeUsername() + "/lights/1/state", _, getBridgeIp(), 80))
+        .Times(1)
+        .WillOnce(Invoke([](const std::string&, const nlohmann::json& body, const std::string&, int) {
+            EXPECT_EQ(false, body["on"]);
+            EXPECT_EQ(0u, body.count("xy"));
+            EXPECT_EQ(0u, body.count("bri"));
+            EXPECT_EQ(4, body["transitiontime"]);
+            return nlohmann::json{{{"success", {{"/lights/1/state/on", false}}}},
+                {{"success", {{"/lights/1/state/transitiontime", 4}}}}};
+        }));
+    // Light 2 is already off, nothing is sent
+    EXPECT_CALL(*handler, PUTJson("/api/" + getBridgeUsername() + "/lights/2/state", _, getBridgeIp(), 80))
+        .Times(0);
+    EXPECT_TRUE(extractor.send(test_bridge, 4).ok());
+    Mock::VerifyAndClearExpectations(handler.get());
+
+    // The accepted request is in the cached state, so light 1 is not turned off again
+    EXPECT_CALL(*handler, GETJson(_, _, _, _)).Times(0);
+    EXPECT_CALL(*handler, PUTJson(_, _, _, _)).Times(0);
+    EXPECT_TRUE(extractor.send(test_bridge, 4).ok());
+    Mock::VerifyAndClearExpectations(handler.get());
+
+    // And it is turned on again without a refresh when the zone is not black anymore
+    std::fill(frame.begin(), frame.end(), 255);
+    extractor.process(frame.data(), 3 * width);
+    EXPECT_CALL(*handler, PUTJson("/api/" + getBridgeUsername() + "/lights/1/state", _, getBridgeIp(), 80))
+        .Times(1)
+        .WillOnce(Invoke([](const std::string&, const nlohmann::json& body, const std::string&, int) {
+            EXPECT_EQ(true, body["on"]);
+            return nlohmann::json::array();
+        }));
+    EXPECT_CALL(*handler, PUTJson("/api/" + getBridgeUsername() + "/lights/2/state", _, getBridgeIp(), 80))
+        .Times(1)
+        .WillOnce(Return(nlohmann::json::array()));
+    EXPECT_TRUE(extractor.send(test_bridge, 4).ok());
+}